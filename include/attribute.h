@@ -82,6 +82,41 @@ class CallbackHandle : public std::enable_shared_from_this<CallbackHandle>
     std::string _attribute{""};
 };
 
+/*************/
+// Handle to an attribute name, interned once to an integer ID shared by all objects
+// Accessing attributes through a handle avoids hashing the name at each call
+class AttributeHandle
+{
+  public:
+    AttributeHandle() = default;
+
+    /**
+     * \brief Constructor, interning the given name. The same name always gives the same ID.
+     * \param name Attribute name
+     */
+    explicit AttributeHandle(const std::string& name);
+
+    bool operator==(const AttributeHandle& handle) const { return _id == handle._id; }
+    bool operator!=(const AttributeHandle& handle) const { return _id != handle._id; }
+    explicit operator bool() const { return _id != _invalidId; }
+
+    /**
+     * \brief Get the interned ID
+     * \return Return the ID
+     */
+    uint32_t getId() const { return _id; }
+
+    /**
+     * \brief Get the attribute name
+     * \return Return the name, or an empty string if the handle is invalid
+     */
+    std::string getName() const;
+
+  private:
+    static const uint32_t _invalidId = 0xFFFFFFFF;
+    uint32_t _id{_invalidId};
+};
+
 /*************/
 class AttributeFunctor
 {
@@ -137,12 +172,24 @@ class AttributeFunctor
      */
     Values operator()() const;
 
+    /**
+     * \brief Get the stored values, as operator()() does, into the given Values. For default attributes, the storage of the given Values is reused.
+     * \param values Values to fill
+     */
+    void get(Values& values) const;
+
     /**
      * \brief Tells whether the setter and getters are the default ones or not.
      * \return Returns true if the setter and getter are the default ones.
      */
     bool isDefault() const { return _defaultSetAndGet; }
 
+    /**
+     * \brief Tells whether the attribute can be read, either through a getter function or the default one.
+     * \return Returns true if the attribute has a getter.
+     */
+    bool hasGetter() const { return _defaultSetAndGet || static_cast<bool>(_getFunc); }
+
     /**
      * \brief Ask whether to update the Scene object (if this attribute is hosted by a World object).
      * \return Returns true if the World should update this attribute in the distant Scene object.
@@ -155,6 +202,14 @@ class AttributeFunctor
      */
     void doUpdateDistant(bool update) { _doUpdateDistant = update; }
 
+    /**
+     * \brief Update the snapshot of the values sent to the distant objects, if the values differ from it.
+     * \param values Current values of the attribute
+     * \param tick Current tick, starting at 1, which becomes the version of the snapshot if it is updated
+     * \return Returns the version of the snapshot, which is the tick at which the values last changed
+     */
+    uint64_t updateDistantSnapshot(const Values& values, uint64_t tick);
+
     /**
      * \brief Get the types of the wanted arguments.
      * \return Returns the expected types in a Values.
@@ -255,6 +310,9 @@ class AttributeFunctor
     bool _defaultSetAndGet{true};
     bool _doUpdateDistant{false}; // True if the World should send this attr values to Scenes
     bool _savable{true};          // True if this attribute should be saved
+
+    Values _distantSnapshot{};           // Values last sent to the Scenes
+    uint64_t _distantSnapshotVersion{0}; // Tick at which the values last changed, 0 if never sent
 };
 
 } // end of namespace
@@ -29,13 +29,13 @@
 #include <condition_variable>
 #include <future>
 #include <json/json.h>
-#include <list>
 #include <map>
 #include <unordered_map>
 
 #include "./attribute.h"
 #include "./coretypes.h"
 #include "./log.h"
+#include "./task_queue.h"
 #include "./timer.h"
 
 namespace Splash
@@ -107,6 +107,13 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     AttributeFunctor& operator[](const std::string& attr);
 
+    /**
+     * \brief Access the attributes through operator[], using an attribute handle.
+     * \param handle Handle to the attribute, which must exist
+     * \return Returns a reference to the attribute.
+     */
+    AttributeFunctor& operator[](const AttributeHandle& handle) { return *findAttribute(handle); }
+
     /**
      * \brief Get the real type of this BaseObject, as a std::string.
      * \return Returns the type.
@@ -176,6 +183,18 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     const std::vector<std::shared_ptr<BaseObject>> getLinkedObjects();
 
+    /**
+     * \brief Get the objects this object is linked to, as raw pointers which may outlive the objects
+     * \return Return the parents
+     */
+    const std::vector<BaseObject*>& getParents() const { return _parents; }
+
+    /**
+     * \brief Get the version of the links between all objects, incremented each time any object is linked or unlinked
+     * \return Return the version
+     */
+    static uint64_t getLinksVersion() { return _linksVersion.load(std::memory_order_acquire); }
+
     /**
      * \brief Set the specified attribute
      * \param attrib Attribute name
@@ -184,6 +203,14 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     bool setAttribute(const std::string& attrib, const Values& args);
 
+    /**
+     * \brief Set the specified attribute, using an attribute handle
+     * \param handle Attribute handle
+     * \param args Values object which holds attribute values
+     * \return Returns true if the parameter exists and was set
+     */
+    bool setAttribute(const AttributeHandle& handle, const Values& args);
+
     /**
      * \brief Get the specified attribute
      * \param attrib Attribute name
@@ -194,6 +221,16 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     bool getAttribute(const std::string& attrib, Values& args, bool includeDistant = false, bool includeNonSavable = false) const;
 
+    /**
+     * \brief Get the specified attribute, using an attribute handle. The storage of args is reused when possible.
+     * \param handle Attribute handle
+     * \param args Values object which will hold the attribute values
+     * \param includeDistant Return true even if the attribute is distant
+     * \param includeNonSavable Return true even if the attribute is not savable
+     * \return Return true if the parameter exists and is savable
+     */
+    bool getAttribute(const AttributeHandle& handle, Values& args, bool includeDistant = false, bool includeNonSavable = false) const;
+
     /**
      * \brief Get all the savable attributes as a map
      * \param includeDistant Also include the distant attributes
@@ -204,9 +241,11 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
     /**
      * \brief Get the map of the attributes which should be updated from World to Scene
      * \brief This is the case when the distant object is different from the World one
+     * \param tick Current tick, starting at 1, marking the attributes which changed since the last call
+     * \param sinceTick Only the attributes which changed after this tick are returned. If 0, all of them are
      * \return Returns a map of the distant attributes
      */
-    std::unordered_map<std::string, Values> getDistantAttributes() const;
+    std::unordered_map<std::string, Values> getDistantAttributes(uint64_t tick, uint64_t sinceTick);
 
     /**
      * \brief Get the savability for this object
@@ -235,7 +274,11 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      * Set the object as a ghost, meaning it mimics an object in another scene
      * \param ghost If true, set as ghost
      */
-    inline void setGhost(bool ghost) { _ghost = ghost; }
+    inline void setGhost(bool ghost)
+    {
+        _ghost = ghost;
+        _renderingStateVersion.fetch_add(1, std::memory_order_release);
+    }
 
     /**
      * Get whether the object ghosts an object in another scene
@@ -282,6 +325,13 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     AttributeFunctor::Sync getAttributeSyncMethod(const std::string& name);
 
+    /**
+     * \brief Check whether repeated sets of an attribute can be replaced by the last one. This is the case for attributes holding a state, which have a getter.
+     * \param name Attribute name
+     * \return Return true if the sets can be coalesced
+     */
+    bool isAttributeCoalescable(const std::string& name);
+
     /**
      * Register a callback to any call to the setter
      * \param attr Attribute to add a callback to
@@ -309,6 +359,12 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
      */
     Priority getRenderingPriority() const { return (Priority)((int)_renderingPriority + _priorityShift); }
 
+    /**
+     * \brief Get the version of the rendering state of all objects, incremented each time the rendering priority or the ghost status of any object changes
+     * \return Return the version
+     */
+    static uint64_t getRenderingStateVersion() { return _renderingStateVersion.load(std::memory_order_acquire); }
+
     /**
      * Set the object's category
      * \param category Category
@@ -359,27 +415,54 @@ class BaseObject : public std::enable_shared_from_this<BaseObject>
     std::vector<std::weak_ptr<BaseObject>> _linkedObjects; //!< Children of this object
 
     std::unordered_map<std::string, AttributeFunctor> _attribFunctions; //!< Map of all attributes
+    std::vector<AttributeFunctor*> _attribHandles{};                    //!< Attributes of _attribFunctions, indexed by their handle ID
     bool _updatedParams{true};                                          //!< True if the parameters have been updated and the object needs to reflect these changes
 
     std::future<void> _asyncTask{};
     std::mutex _asyncTaskMutex{};
 
-    std::list<std::function<void()>> _taskQueue;
-    std::recursive_mutex _taskMutex;
+    TaskQueue _taskQueue{}; //!< Tasks to run from the thread owning the object, added from any thread
 
     bool _ghost{false}; //!< True if the object ghosts an object in another scene
 
+    static std::atomic<uint64_t> _renderingStateVersion; //!< Version of the rendering priorities and ghost status of all objects
+    static std::atomic<uint64_t> _linksVersion;          //!< Version of the links between all objects
+
     /**
      * Add a new task to the queue
      * \param task Task function
+     * \param key Coalescing key. If not empty, only the last task added with this key before the queue is run will be run
      */
-    void addTask(const std::function<void()>& task);
+    void addTask(const std::function<void()>& task, const std::string& key = "");
 
     /**
      * \brief Initialize some generic attributes
      */
     void init();
 
+    /**
+     * \brief Get the attribute corresponding to the given handle
+     * \param handle Attribute handle
+     * \return Return a pointer to the attribute, or nullptr if it does not exist
+     */
+    AttributeFunctor* findAttribute(const AttributeHandle& handle) const
+    {
+        auto id = handle.getId();
+        return id < _attribHandles.size() ? _attribHandles[id] : nullptr;
+    }
+
+    /**
+     * \brief Update the handle table for the given attribute, to be called whenever _attribFunctions is modified
+     * \param name Attribute name
+     * \param attribute Pointer to the attribute, or nullptr if it was removed
+     */
+    void setAttributeHandle(const std::string& name, AttributeFunctor* attribute);
+
+    /**
+     * \brief Remove all the attributes
+     */
+    void clearAttributes();
+
     /**
      * \brief Add a new attribute to this object
      * \param name Attribute name
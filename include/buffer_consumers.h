@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @buffer_consumers.h
+ * The BufferConsumers class, keeping track of the Scenes consuming each buffer
+ */
+
+#ifndef SPLASH_BUFFER_CONSUMERS_H
+#define SPLASH_BUFFER_CONSUMERS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Splash
+{
+
+class BaseObject;
+
+/*************/
+class BufferConsumers
+{
+  public:
+    /**
+     * \brief Get the BufferObjects consumed among the given objects.
+     * A BufferObject is consumed if it is linked, directly or through other objects, to a rendered object other than a media
+     * \param objects Objects of a Scene, by key
+     * \return Return the keys of the consumed BufferObjects, which are the names they are received under
+     */
+    static std::unordered_set<std::string> getConsumedBuffers(const std::unordered_map<std::string, std::shared_ptr<BaseObject>>& objects);
+
+    /**
+     * \brief Set the buffers consumed by a Scene
+     * \param scene Scene name
+     * \param buffers Consumed buffers
+     * \return Return the buffers which the Scene did not consume before
+     */
+    std::unordered_set<std::string> setConsumers(const std::string& scene, const std::unordered_set<std::string>& buffers);
+
+    /**
+     * \brief Forget about a Scene, which does not consume anything anymore
+     * \param scene Scene name
+     */
+    void removeScene(const std::string& scene);
+
+    /**
+     * \brief Forget about all Scenes
+     */
+    void clear();
+
+    /**
+     * \brief Get the Scenes consuming a buffer
+     * \param buffer Buffer name
+     * \return Return a pointer to the Scenes, or nullptr if no Scene consumes the buffer, in which case it should not be sent
+     */
+    const std::vector<std::string>* getDestinations(const std::string& buffer) const;
+
+  private:
+    std::map<std::string, std::unordered_set<std::string>> _consumers{};       //!< Buffers consumed by each Scene
+    std::unordered_map<std::string, std::vector<std::string>> _destinations{}; //!< Scenes consuming each buffer
+
+    /**
+     * \brief Compute the Scenes consuming each buffer, from the buffers consumed by each Scene
+     */
+    void updateDestinations();
+};
+
+} // end of namespace
+
+#endif // SPLASH_BUFFER_CONSUMERS_H
@@ -31,6 +31,7 @@
 #include <json/json.h>
 #include <list>
 #include <map>
+#include <memory>
 #include <shared_mutex>
 #include <unordered_map>
 
@@ -40,6 +41,30 @@
 namespace Splash
 {
 
+/*************/
+/**
+ * Content of a BufferObject, shared as is with objects living in the same process
+ */
+struct BufferSnapshot
+{
+    virtual ~BufferSnapshot() = default;
+};
+
+/*************/
+/**
+ * Snapshot holding an immutable buffer. The owner never modifies it once shared, and replaces it instead
+ */
+template <typename T>
+struct SharedBufferSnapshot : public BufferSnapshot
+{
+    SharedBufferSnapshot(std::shared_ptr<const T> buffer)
+        : content(std::move(buffer))
+    {
+    }
+
+    std::shared_ptr<const T> content;
+};
+
 /*************/
 class BufferObject : public BaseObject
 {
@@ -54,6 +79,11 @@ class BufferObject : public BaseObject
         registerAttributes();
     }
 
+    /**
+     * \brief Destructor, waits for any ongoing deserialization
+     */
+    virtual ~BufferObject() override;
+
     /**
      * Lock the buffer, useful while reading. Use with care
      * Note that only write mutex is needed, as it also disables reading
@@ -119,6 +149,20 @@ class BufferObject : public BaseObject
      */
     void setSerializedObject(std::shared_ptr<SerializedObject> obj);
 
+    /**
+     * \brief Get a snapshot of the current content, to be shared with an object of the same type living in the same process.
+     * This avoids serializing and copying the buffer.
+     * \return Return the snapshot, or nullptr if not supported by this object
+     */
+    virtual std::shared_ptr<BufferSnapshot> getSnapshot() const { return {}; }
+
+    /**
+     * \brief Set the next content of the object from a snapshot, without copying it. It is used on the next update.
+     * \param snapshot Snapshot, as returned by getSnapshot()
+     * \return Return false if the snapshot is not supported, in which case the serialized form should be used
+     */
+    virtual bool setSnapshot(const std::shared_ptr<BufferSnapshot>& snapshot) { return false; }
+
   protected:
     mutable Spinlock _readMutex;                      //!< Read mutex locked when the object is read from
     mutable std::shared_timed_mutex _writeMutex;      //!< Write mutex locked when the object is written to
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @buffer_pool.h
+ * The BufferPool class, caching the aligned memory used by large buffers
+ */
+
+#ifndef SPLASH_BUFFER_POOL_H
+#define SPLASH_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace Splash
+{
+
+/*************/
+class BufferPool
+{
+  public:
+    static const size_t cacheLineSize = 64;
+    static const size_t pageSize = 4096;
+    static const size_t hugePageSize = 2 * 1024 * 1024;
+
+    /**
+     * \brief Get the singleton
+     * \return Return the pool
+     */
+    static BufferPool& get()
+    {
+        // Never destroyed, as buffers can be released by static objects
+        static auto instance = new BufferPool;
+        return *instance;
+    }
+
+    /**
+     * \brief Other constructors and operators
+     */
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * \brief Allocate a buffer, reusing a cached one of the same size class if possible.
+     * Buffers are aligned to a cache line, or to a page starting from a page, or to a huge page if enabled.
+     * \param size Requested size in bytes
+     * \param capacity Set to the usable size of the buffer, which is the size of its class
+     * \return Return the buffer, or nullptr if the allocation failed
+     */
+    void* allocate(size_t size, size_t& capacity);
+
+    /**
+     * \brief Give back a buffer to the pool, which caches it. If the cache is full, the least recently released buffers are freed to make room for it.
+     * \param buffer Buffer to release
+     * \param capacity Capacity of the buffer, as returned by allocate()
+     */
+    void release(void* buffer, size_t capacity);
+
+    /**
+     * \brief Get the size class of an allocation. Classes are spaced by a quarter of the power of two below them,
+     * so that at most 25% of an allocation is unused.
+     * \param size Requested size in bytes
+     * \return Return the size of the class
+     */
+    static size_t getClassSize(size_t size);
+
+    /**
+     * \brief Set the maximum amount of memory kept in cache, releasing cached buffers if needed
+     * \param size Cache size in bytes
+     */
+    void setCacheSize(size_t size);
+
+    /**
+     * \brief Get the maximum amount of memory kept in cache
+     * \return Return the cache size in bytes
+     */
+    size_t getCacheSize() const;
+
+    /**
+     * \brief Set the duration after which a cached buffer which has not been reused is released by releaseExpired()
+     * \param age Duration in us
+     */
+    void setMaxAge(int64_t age);
+
+    /**
+     * \brief Get the duration after which unused cached buffers are released
+     * \return Return the duration in us
+     */
+    int64_t getMaxAge() const;
+
+    /**
+     * \brief Enable transparent huge pages for buffers of at least a huge page. Has no effect where not supported.
+     * \param enable If true, enable huge pages
+     */
+    void setHugePages(bool enable);
+
+    /**
+     * \brief Get whether huge pages are enabled
+     * \return Return true if they are
+     */
+    bool getHugePages() const;
+
+    /**
+     * \brief Release all cached buffers
+     */
+    void trim();
+
+    /**
+     * \brief Release the cached buffers which have not been reused for longer than the maximum age. Meant to be called periodically.
+     */
+    void releaseExpired();
+
+    /**
+     * \brief Get the memory currently allocated through the pool and not yet released
+     * \return Return the size in bytes
+     */
+    size_t getBytesInUse() const { return _bytesInUse.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Get the memory currently cached by the pool
+     * \return Return the size in bytes
+     */
+    size_t getBytesCached() const { return _bytesCached.load(std::memory_order_relaxed); }
+
+  private:
+    struct CachedBuffer
+    {
+        void* buffer{nullptr};
+        int64_t releaseTime{0}; //!< In us, from an arbitrary epoch
+    };
+
+    mutable std::mutex _mutex{};
+    std::map<size_t, std::deque<CachedBuffer>> _cachedBuffers{}; //!< Cached buffers by size class, from the least to the most recently released
+    size_t _cacheSize{256 * 1024 * 1024};
+    int64_t _maxAge{10000000};
+    bool _hugePages{false};
+
+    std::atomic<size_t> _bytesInUse{0};
+    std::atomic<size_t> _bytesCached{0};
+
+    BufferPool() = default;
+    ~BufferPool() = default;
+
+    /**
+     * \brief Get the current time
+     * \return Return the time in us
+     */
+    static int64_t getTime();
+
+    /**
+     * \brief Release the least recently released buffers until the cache fits the given size. Must be called with the mutex locked
+     * \param size Maximum cache size
+     */
+    void shrinkCache(size_t size);
+};
+
+} // end of namespace
+
+#endif // SPLASH_BUFFER_POOL_H
@@ -230,8 +230,24 @@ class Camera : public BaseObject
     // Color correction
     Values _colorLUT{0};
     bool _isColorLUTActivated{false};
+    bool _updateColorLUT{true}; // Set to true if the LUT has to be sent to the GPU
     glm::mat3 _colorMixMatrix;
 
+    // Parameters shared by the shaders of all objects through the CameraUniforms block, in the std140 layout.
+    // The color LUT follows, as 256 vec3 padded to vec4.
+    struct CameraUniforms
+    {
+        float wireframeColor[4];
+        float fovAndColorBalance[4];
+        float cameraAttributes[2];
+        int32_t showCameraCount;
+        int32_t isColorLUT;
+        float colorMixMatrix[12]; // Three columns padded to four floats
+    };
+    static_assert(sizeof(CameraUniforms) == 96, "CameraUniforms does not match the std140 layout of the GLSL block");
+    CameraUniforms _cameraUniforms{};
+    GLuint _cameraUniformsBuffer{0};
+
     // Some default models use in various situations
     std::list<std::shared_ptr<Mesh>> _modelMeshes;
     std::unordered_map<std::string, std::shared_ptr<Object>> _models;
@@ -305,6 +321,11 @@ class Camera : public BaseObject
      */
     void sendCalibrationPointsToObjects();
 
+    /**
+     * \brief Update the camera uniform buffer with the parts which changed, and bind it
+     */
+    void updateCameraUniforms();
+
     /**
      * \brief Register new functors to modify attributes
      */
@@ -138,6 +138,7 @@ class PythonEmbedded : public ControllerObject
     static PyObject* pythonGetInterpreterName(PyObject* self, PyObject* args);
     static PyObject* pythonGetLogs(PyObject* self, PyObject* args);
     static PyObject* pythonGetTimings(PyObject* self, PyObject* args);
+    static PyObject* pythonGetTimingStats(PyObject* self, PyObject* args);
     static PyObject* pythonGetMasterClock(PyObject* self, PyObject* args);
     static PyObject* pythonGetObjectList(PyObject* self, PyObject* args);
     static PyObject* pythonGetObjectTypes(PyObject* self, PyObject* args);
@@ -106,6 +106,19 @@ class Geometry : public BufferObject
      */
     bool deserialize(const std::shared_ptr<SerializedObject>& obj) override;
 
+    /**
+     * \brief Get a snapshot holding the serialized geometry
+     * \return Return the snapshot
+     */
+    std::shared_ptr<BufferSnapshot> getSnapshot() const override;
+
+    /**
+     * \brief Use the serialized geometry shared by another Geometry
+     * \param snapshot Snapshot of the other Geometry
+     * \return Return true if the snapshot holds a valid geometry
+     */
+    bool setSnapshot(const std::shared_ptr<BufferSnapshot>& snapshot) override;
+
     /**
      * \brief Get whether the alternative buffers have been resized during the last feedback call
      * \return Return true if the buffers have been resized
@@ -163,7 +176,7 @@ class Geometry : public BufferObject
     bool _buffersResized{false}; // Holds whether the alternative buffers have been resized in the previous feedback
     bool _useAlternativeBuffers{false};
 
-    SerializedObject _serializedMesh{};
+    std::shared_ptr<const SerializedObject> _serializedMesh{}; //!< Geometry received from another process or object, shared and never modified
 
     int _verticesNumber{0};
     int _alternativeVerticesNumber{0};
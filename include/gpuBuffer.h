@@ -50,7 +50,7 @@ class GpuBuffer
      * \param size Number of entries
      * \param data Pointer to data to initialized the buffer with
      */
-    GpuBuffer(GLint elementSize, GLenum type, GLenum usage, size_t size, GLvoid* data = nullptr);
+    GpuBuffer(GLint elementSize, GLenum type, GLenum usage, size_t size, const GLvoid* data = nullptr);
 
     /**
      * \brief Destructor
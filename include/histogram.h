@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @histogram.h
+ * The Histogram class, a lock-free log-linear histogram of durations
+ */
+
+#ifndef SPLASH_HISTOGRAM_H
+#define SPLASH_HISTOGRAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace Splash
+{
+
+/*************/
+class Histogram
+{
+  public:
+    /**
+     * Summary of the recorded values
+     */
+    struct Stats
+    {
+        uint64_t count{0};
+        uint64_t min{0};
+        uint64_t mean{0};
+        uint64_t p50{0};
+        uint64_t p95{0};
+        uint64_t p99{0};
+        uint64_t max{0};
+    };
+
+    /**
+     * \brief Constructor
+     */
+    Histogram() { reset(); }
+
+    /**
+     * \brief Other constructors and operators
+     */
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    /**
+     * \brief Record a value. Lock-free, can be called concurrently from any thread.
+     * \param value Value to record, clamped to the maximum trackable value
+     */
+    void record(uint64_t value)
+    {
+        value = value > _maxValue ? _maxValue : value;
+        _buckets[getBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+
+        auto currentMin = _min.load(std::memory_order_relaxed);
+        while (value < currentMin && !_min.compare_exchange_weak(currentMin, value, std::memory_order_relaxed))
+            ;
+        auto currentMax = _max.load(std::memory_order_relaxed);
+        while (value > currentMax && !_max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed))
+            ;
+    }
+
+    /**
+     * \brief Clear all recorded values
+     */
+    void reset()
+    {
+        for (auto& bucket : _buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Compute the statistics of the given histograms, taken as a whole
+     * \param histograms Pointers to the histograms
+     * \param count Number of histograms
+     * \return Return the statistics
+     */
+    static Stats getStats(const Histogram* const* histograms, size_t count)
+    {
+        Stats stats;
+        uint64_t sum = 0;
+        uint64_t min = std::numeric_limits<uint64_t>::max();
+        uint64_t max = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            stats.count += histograms[i]->_count.load(std::memory_order_relaxed);
+            sum += histograms[i]->_sum.load(std::memory_order_relaxed);
+            min = std::min(min, histograms[i]->_min.load(std::memory_order_relaxed));
+            max = std::max(max, histograms[i]->_max.load(std::memory_order_relaxed));
+        }
+
+        if (stats.count == 0)
+            return stats;
+
+        stats.min = min;
+        stats.max = max;
+        stats.mean = sum / stats.count;
+
+        // Counts are read bucket by bucket while other threads may be recording,
+        // so the targets are computed from the sum of the buckets and not from _count
+        uint64_t total = 0;
+        for (uint32_t b = 0; b < _bucketCount; ++b)
+            for (size_t i = 0; i < count; ++i)
+                total += histograms[i]->_buckets[b].load(std::memory_order_relaxed);
+
+        const uint64_t targets[3] = {(total * 50 + 99) / 100, (total * 95 + 99) / 100, (total * 99 + 99) / 100};
+        uint64_t* results[3] = {&stats.p50, &stats.p95, &stats.p99};
+        uint64_t cumulated = 0;
+        uint32_t target = 0;
+        for (uint32_t b = 0; b < _bucketCount && target < 3; ++b)
+        {
+            for (size_t i = 0; i < count; ++i)
+                cumulated += histograms[i]->_buckets[b].load(std::memory_order_relaxed);
+            while (target < 3 && cumulated >= std::max<uint64_t>(targets[target], 1))
+            {
+                *results[target] = std::min(std::max(getBucketValue(b), min), max);
+                ++target;
+            }
+        }
+
+        return stats;
+    }
+
+    /**
+     * \brief Compute the statistics of this histogram
+     * \return Return the statistics
+     */
+    Stats getStats() const
+    {
+        const Histogram* self = this;
+        return getStats(&self, 1);
+    }
+
+    /**
+     * \brief Get the index of the bucket holding the given value
+     * Values lower than 2^_subBucketBits each have their own bucket, higher ones are split into
+     * powers of two, each divided into 2^_subBucketBits linear sub-buckets. The relative error is thus
+     * bounded by 1 / 2^_subBucketBits.
+     * \param value Value
+     * \return Return the bucket index
+     */
+    static uint32_t getBucketIndex(uint64_t value)
+    {
+        if (value < _subBucketCount)
+            return static_cast<uint32_t>(value);
+        uint32_t msb = 63 - __builtin_clzll(value);
+        uint32_t shift = msb - _subBucketBits;
+        return (shift + 1) * _subBucketCount + static_cast<uint32_t>((value >> shift) - _subBucketCount);
+    }
+
+    /**
+     * \brief Get the value represented by the given bucket, which is the middle of its range
+     * \param index Bucket index
+     * \return Return the value
+     */
+    static uint64_t getBucketValue(uint32_t index)
+    {
+        if (index < _subBucketCount)
+            return index;
+        uint32_t shift = index / _subBucketCount - 1;
+        uint64_t lower = (static_cast<uint64_t>(_subBucketCount) + index % _subBucketCount) << shift;
+        return lower + ((1ull << shift) >> 1);
+    }
+
+  private:
+    static const uint32_t _subBucketBits = 5;
+    static const uint32_t _subBucketCount = 1 << _subBucketBits;
+    static const uint32_t _maxValueBits = 36; // About 19 hours, when recording microseconds
+    static const uint64_t _maxValue = (1ull << _maxValueBits) - 1;
+    static const uint32_t _bucketCount = (_maxValueBits - _subBucketBits + 1) * _subBucketCount;
+
+    std::atomic<uint32_t> _buckets[_bucketCount];
+    std::atomic<uint64_t> _count{0};
+    std::atomic<uint64_t> _sum{0};
+    std::atomic<uint64_t> _min{0};
+    std::atomic<uint64_t> _max{0};
+};
+
+} // end of namespace
+
+#endif // SPLASH_HISTOGRAM_H
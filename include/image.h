@@ -119,6 +119,19 @@ class Image : public BufferObject
      */
     bool deserialize(const std::shared_ptr<SerializedObject>& obj) override;
 
+    /**
+     * \brief Get a snapshot sharing the current image buffer
+     * \return Return the snapshot
+     */
+    std::shared_ptr<BufferSnapshot> getSnapshot() const override;
+
+    /**
+     * \brief Use the image buffer shared by another Image as the next image
+     * \param snapshot Snapshot of the other Image
+     * \return Return true if the snapshot holds an image
+     */
+    bool setSnapshot(const std::shared_ptr<BufferSnapshot>& snapshot) override;
+
     /**
      * \brief Set the path to read from
      * \param filename File path
@@ -146,8 +159,9 @@ class Image : public BufferObject
   protected:
     Values _mediaInfo{};
 
-    std::unique_ptr<ImageBuffer> _image;
-    std::unique_ptr<ImageBuffer> _bufferImage;
+    std::shared_ptr<const ImageBuffer> _image;         //!< Current image, never modified as it can be shared with other Images
+    std::unique_ptr<ImageBuffer> _bufferImage;         //!< Next image, written to by derived classes. Holds the previous image after an update, if not shared
+    std::shared_ptr<const ImageBuffer> _snapshotImage; //!< Next image, shared by an Image from the same process
     std::string _filepath;
     bool _flip{false};
     bool _flop{false};
@@ -177,9 +191,6 @@ class Image : public BufferObject
     void registerAttributes();
 
   private:
-    // Deserialization is done in this buffer, to avoid realloc
-    ImageBuffer _bufferDeserialize;
-
     /**
      * Add more media info, to be implemented by derived classes
      */
@@ -48,6 +48,25 @@ class ImageBufferSpec
         FLOAT = 4
     };
 
+    enum class Format : uint8_t
+    {
+        UNKNOWN = 0,
+        R,
+        RG,
+        RGB,
+        RGBA,
+        BGR,
+        BGRA,
+        YUYV,
+        UYVY,
+        RGB_DXT1,
+        RGBA_DXT5,
+        YCoCg_DXT5
+    };
+
+    static const size_t headerSize = 64;    //!< Size of the binary header, keeping the data which follows it aligned to a cache line
+    static const uint16_t headerVersion = 1; //!< Current version of the binary header
+
     /**
      * \brief Constructor
      */
@@ -58,39 +77,51 @@ class ImageBufferSpec
      * \param w Width
      * \param h Height
      * \param c Channel count
-     * \param b Bit per pixej
-     * \param f Format as a string
+     * \param b Bit per pixel
+     * \param t Channel type
+     * \param f Pixel format. If unknown, it is deduced from the channel count
      */
-    ImageBufferSpec(unsigned int w, unsigned int h, unsigned int c, uint8_t b, ImageBufferSpec::Type t = Type::UINT8, const std::string& f = "RGBA")
+    ImageBufferSpec(unsigned int w, unsigned int h, unsigned int c, uint8_t b, ImageBufferSpec::Type t = Type::UINT8, Format f = Format::RGBA)
         : width(w)
         , height(h)
         , channels(c)
         , bpp(b)
         , type(t)
+        , format(f)
     {
-        if (f.empty())
+        if (format == Format::UNKNOWN)
         {
             switch (c)
             {
             default:
             case 1:
-                format = "R";
+                format = Format::R;
                 break;
             case 2:
-                format = "RG";
+                format = Format::RG;
                 break;
             case 3:
-                format = "RGB";
+                format = Format::RGB;
                 break;
             case 4:
-                format = "RGBA";
+                format = Format::RGBA;
                 break;
             }
         }
-        else
-        {
-            format = f;
-        }
+    }
+
+    /**
+     * \brief Constructor
+     * \param w Width
+     * \param h Height
+     * \param c Channel count
+     * \param b Bit per pixel
+     * \param t Channel type
+     * \param f Pixel format as a string, as found in configurations and scripts
+     */
+    ImageBufferSpec(unsigned int w, unsigned int h, unsigned int c, uint8_t b, ImageBufferSpec::Type t, const std::string& f)
+        : ImageBufferSpec(w, h, c, b, t, formatFromString(f))
+    {
     }
 
     uint32_t width{0};
@@ -98,40 +129,43 @@ class ImageBufferSpec
     uint32_t channels{0};
     uint8_t bpp{0};
     ImageBufferSpec::Type type{Type::UINT8};
-    std::string format{};
+    Format format{Format::UNKNOWN};
     bool videoFrame{true};
 
     inline bool operator==(const ImageBufferSpec& spec) const
     {
-        if (width != spec.width)
-            return false;
-        if (height != spec.height)
-            return false;
-        if (channels != spec.channels)
-            return false;
-        if (bpp != spec.bpp)
-            return false;
-        if (type != spec.type)
-            return false;
-        if (format != spec.format)
-            return false;
-
-        return true;
+        return width == spec.width && height == spec.height && channels == spec.channels && bpp == spec.bpp && type == spec.type && format == spec.format;
     }
 
     inline bool operator!=(const ImageBufferSpec& spec) const { return !(*this == spec); }
 
     /**
-     * \brief Convert the spec to a string
-     * \return Return a string representation of the spec
+     * \brief Get the pixel format matching a string
+     * \param format Format name, for example "RGBA" or "YUYV"
+     * \return Return the format, or Format::UNKNOWN
+     */
+    static Format formatFromString(const std::string& format);
+
+    /**
+     * \brief Get the name of a pixel format
+     * \param format Pixel format
+     * \return Return the format name, or an empty string if unknown
+     */
+    static std::string formatToString(Format format);
+
+    /**
+     * \brief Write the spec as a fixed-size binary header
+     * \param header Destination, at least headerSize bytes long
      */
-    std::string to_string();
+    void writeHeader(char* header) const;
 
     /**
-     * \brief Update from a spec string
-     * \param spec Spec string
+     * \brief Update from a binary header
+     * \param header Header, as written by writeHeader
+     * \param size Size available to read from
+     * \return Return false if the header is invalid or of an unsupported version, in which case the spec is not modified
      */
-    void from_string(const std::string& spec);
+    bool readHeader(const char* header, size_t size);
 
     /**
      * \brief Get channel size in bytes
@@ -161,6 +195,13 @@ class ImageBuffer
      */
     ImageBuffer(const ImageBufferSpec& spec);
 
+    /**
+     * \brief Constructor, using the given buffer as is. Its size must match the spec
+     * \param spec Image spec
+     * \param buffer Buffer holding the image data
+     */
+    ImageBuffer(const ImageBufferSpec& spec, ResizableArray<char>&& buffer);
+
     /**
      * \brief Destructor
      */
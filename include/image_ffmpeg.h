@@ -33,6 +33,7 @@
 #include <future>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -96,6 +97,11 @@ class Image_FFmpeg : public Image
     std::vector<int64_t> _framesSize{};
     int64_t _maximumBufferSize{(int64_t)1 << 29};
 
+    // Frames which have been displayed, recycled by the read loop instead of allocating new ones
+    std::mutex _framePoolMutex{};
+    std::vector<std::unique_ptr<ImageBuffer>> _framePool{};
+    uint64_t _frameAllocations{0}; //!< Allocations since the last decoded frame, only used by the read loop
+
     std::mutex _videoQueueMutex;
     std::mutex _videoSeekMutex;
     std::mutex _videoEndMutex;
@@ -147,6 +153,19 @@ class Image_FFmpeg : public Image
      */
     std::string tagToFourCC(unsigned int tag);
 
+    /**
+     * \brief Get a frame buffer from the pool, or allocate one if none matches the spec
+     * \param spec Frame spec
+     * \return Return the frame buffer
+     */
+    std::unique_ptr<ImageBuffer> getPooledFrame(const ImageBufferSpec& spec);
+
+    /**
+     * \brief Give back a frame buffer to the pool. The pool holds at most half of _maximumBufferSize.
+     * \param frame Frame buffer
+     */
+    void recycleFrame(std::unique_ptr<ImageBuffer>&& frame);
+
     /**
      * \brief Free everything related to FFmpeg
      */
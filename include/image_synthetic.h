@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @image_synthetic.h
+ * The Image_Synthetic class, generating frames for benchmarking purposes
+ */
+
+#ifndef SPLASH_IMAGE_SYNTHETIC_H
+#define SPLASH_IMAGE_SYNTHETIC_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "./config.h"
+
+#include "./attribute.h"
+#include "./coretypes.h"
+#include "./image.h"
+
+namespace Splash
+{
+
+class Image_Synthetic : public Image
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param root Root object
+     */
+    Image_Synthetic(RootObject* root);
+
+    /**
+     * \brief Destructor
+     */
+    ~Image_Synthetic() final;
+
+    /**
+     * No copy constructor
+     */
+    Image_Synthetic(const Image_Synthetic&) = delete;
+    Image_Synthetic& operator=(const Image_Synthetic&) = delete;
+
+  private:
+    unsigned int _width{1920};
+    unsigned int _height{1080};
+    std::atomic<float> _framerate{60.f};
+
+    std::mutex _generateMutex{};
+    std::thread _generateThread{};
+    std::atomic_bool _continueGenerating{false};
+    ImageBuffer _generateBuffer{};
+    uint64_t _frameIndex{0};
+
+    /**
+     * \brief Base init for the class
+     */
+    void init();
+
+    /**
+     * \brief Start generating frames, stopping any previous generation
+     */
+    void startGenerating();
+
+    /**
+     * \brief Stop generating frames
+     */
+    void stopGenerating();
+
+    /**
+     * \brief Frame generation loop
+     */
+    void generateLoop();
+
+    /**
+     * \brief Fill the given buffer with the pattern for the given frame
+     * \param buffer Image buffer
+     * \param frameIndex Index of the frame
+     */
+    static void fillFrame(ImageBuffer& buffer, uint64_t frameIndex);
+
+    /**
+     * \brief Register new functors to modify attributes
+     */
+    void registerAttributes();
+};
+
+} // end of namespace
+
+#endif // SPLASH_IMAGE_SYNTHETIC_H
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @inflight_buffers.h
+ * The InFlightBuffers class, holding the buffers being sent until the transport releases them
+ */
+
+#ifndef SPLASH_INFLIGHT_BUFFERS_H
+#define SPLASH_INFLIGHT_BUFFERS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "./coretypes.h"
+#include "./timer.h"
+
+namespace Splash
+{
+
+/*************/
+class InFlightBuffers
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param latencyTimer Name of the timer recording the duration between the moment a buffer is tracked and its release
+     */
+    explicit InFlightBuffers(const std::string& latencyTimer);
+
+    /**
+     * \brief Other constructors and operators
+     */
+    InFlightBuffers(const InFlightBuffers&) = delete;
+    InFlightBuffers& operator=(const InFlightBuffers&) = delete;
+
+    /**
+     * \brief Keep a buffer alive until it is released
+     * \param buffer Buffer being sent
+     * \return Return the hint to give to release(), which identifies the buffer
+     */
+    void* track(std::shared_ptr<SerializedObject> buffer);
+
+    /**
+     * \brief Release a tracked buffer, waking up the waiters if it was the last one. Its signature matches zmq_free_fn.
+     * \param data Pointer to the buffer data, unused
+     * \param hint Hint returned by track()
+     */
+    static void release(void* data, void* hint);
+
+    /**
+     * \brief Wait for all tracked buffers to be released
+     * \param maximumWait Maximum waiting time
+     * \return Return true if all buffers were released in time
+     */
+    bool waitForRelease(std::chrono::milliseconds maximumWait);
+
+    /**
+     * \brief Get the number of buffers not released yet
+     * \return Return the number of buffers
+     */
+    size_t getCount() const;
+
+  private:
+    /**
+     * A tracked buffer. Slots are never removed, so that their address stays valid while used as a hint
+     */
+    struct Slot
+    {
+        InFlightBuffers* owner{nullptr};
+        uint32_t index{0};
+        std::shared_ptr<SerializedObject> buffer{nullptr};
+        int64_t trackTime{0};
+    };
+
+    mutable std::mutex _mutex{};
+    std::condition_variable _releaseCondition{};
+    std::deque<Slot> _slots{};
+    std::vector<uint32_t> _freeSlots{};
+    size_t _count{0};
+    Timer::Handle _latencyTimer;
+};
+
+} // end of namespace
+
+#endif // SPLASH_INFLIGHT_BUFFERS_H
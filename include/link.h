@@ -27,16 +27,19 @@
 
 #include <atomic>
 #include <chrono>
-#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <zmq.hpp>
 
 #include "./config.h"
 #include "./coretypes.h"
+#include "./inflight_buffers.h"
+#include "./shm_ring.h"
 
 namespace Splash
 {
@@ -48,6 +51,15 @@ class BufferObject;
 class Link
 {
   public:
+    /**
+     * Transport used to send buffers to other processes
+     */
+    enum class BufferTransport : uint8_t
+    {
+        zmq = 0, //!< Buffers are sent through the ZMQ socket
+        shm = 1  //!< Buffers are written to a shared memory ring, only their descriptor goes through ZMQ
+    };
+
     /**
      * \brief Constructor
      * \param root Root object
@@ -83,15 +95,19 @@ class Link
      * \brief Send a buffer to the connected peers
      * \param name Buffer name
      * \param buffer Serialized buffer
+     * \param destinations Peers to send the buffer to. If empty, it is sent to all connected peers
      */
-    bool sendBuffer(const std::string& name, std::shared_ptr<SerializedObject> buffer);
+    bool sendBuffer(const std::string& name, std::shared_ptr<SerializedObject> buffer, const std::vector<std::string>& destinations = {});
 
     /**
-     * \brief Send a buffer to the connected peers
+     * \brief Send a buffer to the connected peers. Peers living in the same process get a snapshot of the object
+     * if in-process transfer is enabled and the object supports it, otherwise the object is serialized once by the calling thread.
+     * Callers on the main loop should only give the inner peers here, and send a buffer serialized beforehand to the other ones.
      * \param name Buffer name
-     * \param object Object to get a serialized version from
+     * \param object Object to send the content of
+     * \param destinations Peers to send the buffer to. If empty, it is sent to all connected peers
      */
-    bool sendBuffer(const std::string& name, const std::shared_ptr<BufferObject>& object);
+    bool sendBuffer(const std::string& name, const std::shared_ptr<BufferObject>& object, const std::vector<std::string>& destinations = {});
 
     /**
      * \brief Send a message to connected peers
@@ -112,6 +128,49 @@ class Link
     template <typename T>
     bool sendMessage(const std::string& name, const std::string& attribute, const std::vector<T>& message);
 
+    /**
+     * \brief Start batching the messages sent to connected processes, until flushMessageBatch() is called
+     * Batches can be nested, messages are sent when the outermost one is flushed
+     */
+    void beginMessageBatch();
+
+    /**
+     * \brief Send all batched messages as a single frame
+     */
+    void flushMessageBatch();
+
+    /**
+     * \brief Set the transport used to send buffers to connected processes
+     * Falls back to ZMQ if the shared memory ring can not be created, or when all its slots are in use
+     * \param transport Buffer transport
+     */
+    void setBufferTransport(BufferTransport transport);
+
+    /**
+     * \brief Get the current buffer transport
+     * \return Return the buffer transport
+     */
+    BufferTransport getBufferTransport() const { return _bufferTransport; }
+
+    /**
+     * \brief Enable sharing buffer objects with peers living in the same process as snapshots, instead of serializing them
+     * \param enable If true, enable in-process transfer
+     */
+    void setInProcessTransfer(bool enable) { _inProcessTransfer = enable; }
+
+    /**
+     * \brief Get whether buffer objects are shared with peers living in the same process
+     * \return Return true if in-process transfer is enabled
+     */
+    bool getInProcessTransfer() const { return _inProcessTransfer; }
+
+    /**
+     * \brief Check whether a peer lives in the same process
+     * \param name Peer name
+     * \return Return true if the peer is connected through its pointer
+     */
+    bool isInnerPeer(const std::string& name) const;
+
     /**
      * \brief Check that all buffers were sent to the client
      * \param maximumWait Maximum waiting time
@@ -138,19 +197,68 @@ class Link
     std::shared_ptr<zmq::socket_t> _socketMessageIn;
     std::shared_ptr<zmq::socket_t> _socketMessageOut;
 
-    std::deque<std::shared_ptr<SerializedObject>> _otgBuffers;
-    Spinlock _otgMutex;
-    std::atomic_int _otgNumber{0};
+    InFlightBuffers _inFlightBuffers; //!< Buffers sent through ZMQ, held until ZMQ is done with them
+
+    // Messages are sent as a single frame each, or as a batch of messages. Object and attribute names
+    // are interned, their numeric ID is defined in the frame preceding their first use
+    std::vector<char> _messageFrame{};                           //!< Frame currently being encoded
+    int _messageBatchDepth{0};                                   //!< Batching is active if greater than 0
+    std::unordered_map<std::string, uint32_t> _internedNames{};  //!< Names sent so far, with their ID
+    bool _resetInternedNames{false};                             //!< Set when a peer connects, the names are interned again from the next frame
+    std::map<std::string, std::vector<std::string>> _peerNames{}; //!< Names received from each peer, only accessed by the input thread
+
+    std::atomic<BufferTransport> _bufferTransport{BufferTransport::zmq};
+    std::atomic_bool _inProcessTransfer{true};
+    std::unique_ptr<ShmRing> _shmWriter{nullptr};                     //!< Ring used to send buffers, if any
+    std::map<std::string, std::unique_ptr<ShmRing>> _shmReaders{}; //!< Rings opened to receive buffers, only accessed by the input thread
 
     std::thread _bufferInThread;
     std::thread _messageInThread;
 
     /**
-     * \brief Callback to remove the shared_ptr to a sent buffer
-     * \param data Pointer to sent data
-     * \param hint Pointer to the Link
+     * \brief Get the topics to publish a buffer to, for the peers in other processes
+     * \param destinations Peers to send the buffer to. If empty, it is sent to all connected peers
+     * \param readerCount Set to the number of peers which will read the buffer
+     * \return Return the topics
+     */
+    std::vector<std::string> getOuterTopics(const std::vector<std::string>& destinations, size_t& readerCount) const;
+
+    /**
+     * \brief Publish a buffer to the peers in other processes
+     * \param name Buffer name
+     * \param buffer Serialized buffer
+     * \param topics Topics to publish to, as returned by getOuterTopics
+     * \param readerCount Number of peers which will read the buffer
+     */
+    void publishBuffer(const std::string& name, const std::shared_ptr<SerializedObject>& buffer, const std::vector<std::string>& topics, size_t readerCount);
+
+    /**
+     * \brief Add a message to the current frame, starting the frame if needed
+     * \param name Destination object name
+     * \param attribute Attribute
+     * \param message Message
      */
-    static void freeOlderBuffer(void* data, void* hint);
+    void encodeMessage(const std::string& name, const std::string& attribute, const Values& message);
+
+    /**
+     * \brief Get the ID of the given name, adding its definition to the current frame if needed
+     * \param name Name to intern
+     * \return Return the name ID
+     */
+    uint32_t internName(const std::string& name);
+
+    /**
+     * \brief Send the current frame to the connected processes
+     */
+    void sendMessageFrame();
+
+    /**
+     * \brief Decode a frame received from another Link, and apply the messages it holds
+     * \param data Frame data
+     * \param size Frame size
+     * \return Return false if the frame is malformed
+     */
+    bool handleMessageFrame(const char* data, size_t size);
 
     /**
      * \brief Message input thread function
@@ -161,6 +269,13 @@ class Link
      * \brief Buffer input thread function
      */
     void handleInputBuffers();
+
+    /**
+     * \brief Get a buffer from a shared memory ring, given its descriptor
+     * \param descriptor Buffer descriptor
+     * \return Return the buffer, or nullptr if it could not be read
+     */
+    std::shared_ptr<SerializedObject> readFromRing(const ShmRing::Descriptor& descriptor);
 };
 
 /*************/
@@ -26,11 +26,13 @@
 #define SPLASH_LOG_H
 
 #include <chrono>
+#include <cstdlib>
 #include <ctime>
 #include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <tuple>
@@ -40,6 +42,7 @@
 #include "./config.h"
 
 #include "./coretypes.h"
+#include "./log_writer.h"
 #include "./spinlock.h"
 
 #define SPLASH_LOG_FILE "/var/log/splash.log"
@@ -188,9 +191,60 @@ class Log
 
     /**
      * \brief Activate logging to /var/log/splash.log
+     * Messages are written to the file from a background thread, and dropped if they come in faster than they can be written
      * \param active Activated if true
      */
-    void logToFile(bool activate) { _logToFile = activate; }
+    void logToFile(bool activate)
+    {
+        std::shared_ptr<LogWriter> fileWriter;
+        {
+            std::lock_guard<Spinlock> lock(_mutex);
+            if (activate == static_cast<bool>(_fileWriter))
+                return;
+
+            if (activate)
+            {
+                _fileWriter = std::make_shared<LogWriter>(SPLASH_LOG_FILE);
+                if (!*_fileWriter)
+                    _fileWriter.reset();
+            }
+            else
+            {
+                // The writer is destroyed outside of the lock, as it writes the remaining messages
+                std::swap(fileWriter, _fileWriter);
+            }
+        }
+
+        static bool flushAtExit = false;
+        if (activate && !flushAtExit)
+        {
+            flushAtExit = true;
+            std::atexit([]() { Log::get().logToFile(false); });
+        }
+    }
+
+    /**
+     * \brief Wait for the messages sent so far to be written to the log file, if logging to file
+     */
+    void flushFile()
+    {
+        std::unique_lock<Spinlock> lock(_mutex);
+        auto fileWriter = _fileWriter;
+        lock.unlock();
+
+        if (fileWriter)
+            fileWriter->flush();
+    }
+
+    /**
+     * \brief Get the number of messages which could not be written to the log file
+     * \return Return the drop count for the current log file
+     */
+    uint64_t getFileDropCount()
+    {
+        std::lock_guard<Spinlock> lock(_mutex);
+        return _fileWriter ? _fileWriter->getDroppedCount() : 0;
+    }
 
     /**
      * \brief Set the verbosity of the console output
@@ -235,7 +289,7 @@ class Log
   private:
     mutable Spinlock _mutex;
     std::deque<std::pair<std::string, Priority>> _logs;
-    bool _logToFile{false};
+    std::shared_ptr<LogWriter> _fileWriter{};
     int _logLength{500};
     int _logPointer{0};
     Priority _verbosity{MESSAGE};
@@ -243,6 +297,9 @@ class Log
     std::string _tempString;
     Priority _tempPriority{MESSAGE};
 
+    std::time_t _lastTime{0};
+    char _lastTimeString[64]{};
+
     /*****/
     template <typename T, typename... Ts>
     void addToString(std::string& str, const T& t, Ts&... args) const
@@ -273,10 +330,17 @@ class Log
     template <typename... T>
     void rec(Priority p, T... args)
     {
+        // The time string has a precision of one second, no need to format it for every message
         std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
         std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-        char time_c[64];
-        strftime(time_c, 64, "%FT%T", std::localtime(&now_c));
+        if (now_c != _lastTime)
+        {
+            std::tm localTime;
+            localtime_r(&now_c, &localTime);
+            strftime(_lastTimeString, 64, "%FT%T", &localTime);
+            _lastTime = now_c;
+        }
+        const char* time_c = _lastTimeString;
 
         std::string timedMsg;
         std::string type;
@@ -293,15 +357,11 @@ class Log
 
         addToString(timedMsg, args...);
 
-        // Write to log file, if we may
-        if (_logToFile)
+        // Send to the log file writer, if we may
+        if (_fileWriter)
         {
-            std::ofstream logFile(SPLASH_LOG_FILE, std::ostream::out | std::ostream::app);
-            if (logFile.good())
-            {
-                logFile << timedMsg << "\n";
-                logFile.close();
-            }
+            std::string record = timedMsg;
+            _fileWriter->push(std::move(record));
         }
 
         // Write to console
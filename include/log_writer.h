@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @log_writer.h
+ * The LogWriter class, writing log records to a file from a background thread
+ */
+
+#ifndef SPLASH_LOG_WRITER_H
+#define SPLASH_LOG_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Splash
+{
+
+/*************/
+class LogWriter
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param path Path to the log file, opened in append mode
+     * \param capacity Number of records the ring can hold, rounded up to a power of two
+     * \param maxFileSize Size over which the file is rotated, in bytes. No rotation if set to 0.
+     * \param maxBackups Number of rotated files to keep, as path.1 to path.N
+     */
+    explicit LogWriter(const std::string& path, uint32_t capacity = 4096, uint64_t maxFileSize = 16 * 1024 * 1024, uint32_t maxBackups = 3);
+
+    /**
+     * \brief Destructor, writes the remaining records before returning
+     */
+    ~LogWriter();
+
+    /**
+     * \brief Other constructors and operators
+     */
+    LogWriter(const LogWriter&) = delete;
+    LogWriter& operator=(const LogWriter&) = delete;
+
+    /**
+     * \brief Safe bool idiom
+     */
+    explicit operator bool() const { return _thread.joinable(); }
+
+    /**
+     * \brief Push a record to be written. Lock-free, never blocks.
+     * \param record Record, without the trailing end of line. It is moved from only on success.
+     * \return Return false if the ring is full, in which case the record is dropped and counted
+     */
+    bool push(std::string&& record);
+
+    /**
+     * \brief Wait for all the records pushed so far to be written to the file
+     */
+    void flush();
+
+    /**
+     * \brief Get the number of records dropped since the creation of the writer
+     * \return Return the drop count
+     */
+    uint64_t getDroppedCount() const { return _dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * \brief Get the path of the log file
+     * \return Return the path
+     */
+    const std::string& getPath() const { return _path; }
+
+  private:
+    /**
+     * Slot of the ring. The sequence tells whether it is free to write (sequence == position)
+     * or ready to be read (sequence == position + 1), as in Vyukov's bounded queue.
+     */
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};
+        std::string record{};
+    };
+
+    std::string _path{""};
+    std::FILE* _file{nullptr};
+    uint64_t _fileSize{0};
+    uint64_t _maxFileSize{0};
+    uint32_t _maxBackups{0};
+
+    std::unique_ptr<Slot[]> _slots{};
+    uint64_t _mask{0};
+    std::atomic<uint64_t> _writePosition{0};
+    uint64_t _readPosition{0}; //!< Only accessed by the writer thread
+    std::atomic<uint64_t> _dropped{0};
+    uint64_t _reportedDrops{0};
+
+    std::thread _thread{};
+    std::mutex _wakeMutex{};
+    std::condition_variable _wakeCondition{};
+    std::atomic_bool _wakeRequested{false};
+    std::atomic_bool _stop{false};
+
+    std::mutex _flushMutex{};
+    std::condition_variable _flushCondition{};
+    std::atomic<uint64_t> _writtenPosition{0};
+
+    /**
+     * \brief Background thread, writing the records by batches
+     */
+    void run();
+
+    /**
+     * \brief Write all the available records
+     * \param batch Buffer used to batch the records, reused between calls
+     */
+    void writeRecords(std::string& batch);
+
+    /**
+     * \brief Rotate the log file: path.N-1 becomes path.N, ..., path becomes path.1
+     */
+    void rotate();
+};
+
+} // end of namespace
+
+#endif // SPLASH_LOG_WRITER_H
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @mapped_file.h
+ * The MappedFile class, a read-only memory mapping of a whole file
+ */
+
+#ifndef SPLASH_MAPPED_FILE_H
+#define SPLASH_MAPPED_FILE_H
+
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Splash
+{
+
+/*************/
+class MappedFile
+{
+  public:
+    /**
+     * \brief Constructor, mapping the whole file. Empty files are not mapped.
+     * \param filename File to map
+     * \param sequential If true, hint the kernel that the file will be read sequentially
+     */
+    explicit MappedFile(const std::string& filename, bool sequential = true)
+    {
+        auto file = open(filename.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat fileStat;
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            auto data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = static_cast<const char*>(data);
+                _size = fileStat.st_size;
+                _stat = fileStat;
+#ifdef MADV_SEQUENTIAL
+                if (sequential)
+                    madvise(data, _size, MADV_SEQUENTIAL);
+#endif
+            }
+        }
+        close(file);
+    }
+
+    /**
+     * \brief Destructor
+     */
+    ~MappedFile()
+    {
+        if (_data)
+            munmap(const_cast<char*>(_data), _size);
+    }
+
+    /**
+     * \brief Other constructors and operators
+     */
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * \brief Get the content of the file
+     * \return Return a pointer to the content, or nullptr if the file could not be mapped
+     */
+    const char* data() const { return _data; }
+
+    /**
+     * \brief Get the size of the file
+     * \return Return the size in bytes
+     */
+    size_t size() const { return _size; }
+
+    /**
+     * \brief Get the status of the file when it was mapped
+     * \return Return the file status
+     */
+    const struct stat& getStat() const { return _stat; }
+
+  private:
+    const char* _data{nullptr};
+    size_t _size{0};
+    struct stat _stat{};
+};
+
+} // end of namespace
+
+#endif // SPLASH_MAPPED_FILE_H
@@ -43,6 +43,34 @@ namespace Splash
 class Mesh : public BufferObject
 {
   public:
+    /**
+     * \brief Read-only view over an attribute of a mesh, seen as a 1D array of floats.
+     * The view keeps the mesh it points to alive, and stays valid as meshes are never modified once set.
+     */
+    class AttributeView
+    {
+      public:
+        AttributeView() = default;
+        AttributeView(std::shared_ptr<const void> owner, const float* data, size_t size)
+            : _owner(std::move(owner))
+            , _data(data)
+            , _size(size)
+        {
+        }
+
+        const float* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        const float* begin() const { return _data; }
+        const float* end() const { return _data + _size; }
+        float operator[](size_t index) const { return _data[index]; }
+
+      private:
+        std::shared_ptr<const void> _owner{};
+        const float* _data{nullptr};
+        size_t _size{0};
+    };
+
     /**
      * \brief Constructor
      * \param root Root object
@@ -69,28 +97,52 @@ class Mesh : public BufferObject
     bool operator==(Mesh& otherMesh) const;
 
     /**
-     * \brief Get a 1D vector of all points of the mesh, in normalized coordinates
+     * \brief Get a view over all points of the mesh, in normalized coordinates, as 4 floats per vertex
+     * \return Return a view over the points of the mesh
+     */
+    AttributeView getVertCoordsView() const;
+
+    /**
+     * \brief Get a view over the UV coordinates for all points, as 2 floats per vertex, same order as getVertCoordsView()
+     * \return Return a view over the UV coordinates
+     */
+    AttributeView getUVCoordsView() const;
+
+    /**
+     * \brief Get a view over the normal at each vertex, as 4 floats per vertex with w set to 0, same order as getVertCoordsView()
+     * \return Return a view over the normals
+     */
+    AttributeView getNormalsView() const;
+
+    /**
+     * \brief Get a view over the annexe at each vertex, as 4 floats per vertex, same order as getVertCoordsView()
+     * \return Return a view over the annexes, empty if the mesh has none
+     */
+    AttributeView getAnnexeView() const;
+
+    /**
+     * \brief Get a copy of all points of the mesh as a 1D vector, see getVertCoordsView()
      * \return Return a vector representing all points of the mesh
      */
-    virtual std::vector<float> getVertCoords() const;
+    std::vector<float> getVertCoords() const;
 
     /**
-     * \brief Get a 1D vector of the UV coordinates for all points, same order as getVertCoords()
+     * \brief Get a copy of the UV coordinates as a 1D vector, see getUVCoordsView()
      * \return Return a vector representing the UV coordinates
      */
-    virtual std::vector<float> getUVCoords() const;
+    std::vector<float> getUVCoords() const;
 
     /**
-     * \brief Get a 1D vector of the normal at each vertex, same order as getVertCoords(), normalized coords
+     * \brief Get a copy of the normals as a 1D vector, see getNormalsView()
      * \return Return a vector representing the normals
      */
-    virtual std::vector<float> getNormals() const;
+    std::vector<float> getNormals() const;
 
     /**
-     * \brief Get a 1D vector of the annexe at each vertex, same order as getVertCoords()
+     * \brief Get a copy of the annexes as a 1D vector, see getAnnexeView()
      * \return Return a vector representing the annexes
      */
-    virtual std::vector<float> getAnnexe() const;
+    std::vector<float> getAnnexe() const;
 
     /**
      * \brief Read / update the mesh
@@ -112,6 +164,19 @@ class Mesh : public BufferObject
      */
     bool deserialize(const std::shared_ptr<SerializedObject>& obj) override;
 
+    /**
+     * \brief Get a snapshot sharing the current mesh
+     * \return Return the snapshot
+     */
+    std::shared_ptr<BufferSnapshot> getSnapshot() const override;
+
+    /**
+     * \brief Use the mesh shared by another Mesh as the next mesh
+     * \param snapshot Snapshot of the other Mesh
+     * \return Return true if the snapshot holds a mesh
+     */
+    bool setSnapshot(const std::shared_ptr<BufferSnapshot>& snapshot) override;
+
     /**
      * \brief Update the content of the mesh
      */
@@ -120,17 +185,22 @@ class Mesh : public BufferObject
   protected:
     bool _worldObject{false};
 
+    /**
+     * Structure of arrays holding the mesh, each attribute being stored contiguously
+     * with the layout used for serialization and by the GPU buffers
+     */
     struct MeshContainer
     {
         std::vector<glm::vec4> vertices;
         std::vector<glm::vec2> uvs;
-        std::vector<glm::vec3> normals;
+        std::vector<glm::vec4> normals; //!< Normals, with w set to 0
         std::vector<glm::vec4> annexe;
     };
 
     std::string _filepath{};
-    MeshContainer _mesh;
-    MeshContainer _bufferMesh;
+    std::shared_ptr<const MeshContainer> _mesh{std::make_shared<MeshContainer>()}; //!< Current mesh, never modified as it can be shared with other Meshes
+    MeshContainer _bufferMesh;                                                   //!< Next mesh, written to by derived classes
+    std::shared_ptr<const MeshContainer> _snapshotMesh{};                        //!< Next mesh, shared by a Mesh from the same process
     bool _meshUpdated{false};
     bool _benchmark{false};
     int _planeSubdivisions{0};
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @mesh_cache.h
+ * The MeshCache class, keeping on disk the meshes loaded from files
+ */
+
+#ifndef SPLASH_MESH_CACHE_H
+#define SPLASH_MESH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace Splash
+{
+
+/*************/
+class MeshCache
+{
+  public:
+    static const uint16_t fileVersion = 1;
+
+    /**
+     * Description of a source file, identifying the content a cached mesh has been converted from
+     */
+    struct Source
+    {
+        std::string path{};          //!< Canonical path
+        uint64_t size{0};            //!< Size in bytes
+        int64_t modificationTime{0}; //!< In nanoseconds
+        uint64_t contentHash{0};
+    };
+
+    /**
+     * \brief Get the singleton
+     * \return Return the cache
+     */
+    static MeshCache& get()
+    {
+        static auto instance = new MeshCache;
+        return *instance;
+    }
+
+    /**
+     * \brief Other constructors and operators
+     */
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    /**
+     * \brief Describe the given source file. This has to be done before parsing it, so that a file modified while being parsed does not get cached as unchanged.
+     * \param sourcePath Path of the source file
+     * \param source Set to the description of the file
+     * \return Return false if the file could not be read
+     */
+    static bool getSource(const std::string& sourcePath, Source& source);
+
+    /**
+     * \brief Read the mesh cached for the given source file.
+     * The cached mesh is only used if the source path, size, modification time and content hash all match.
+     * \param source Description of the source file
+     * \param vertices Set to the vertices, as 4 floats each
+     * \param uvs Set to the UV coordinates
+     * \param normals Set to the normals, with w set to 0
+     * \return Return false if there is no valid cached mesh for this source
+     */
+    bool read(const Source& source, std::vector<glm::vec4>& vertices, std::vector<glm::vec2>& uvs, std::vector<glm::vec4>& normals);
+
+    /**
+     * \brief Cache a mesh loaded from the given source file, then evict the least recently used meshes if the cache is full
+     * \param source Description of the source file, taken before parsing it
+     * \param vertices Vertices
+     * \param uvs UV coordinates
+     * \param normals Normals
+     * \return Return true if the mesh has been cached
+     */
+    bool write(const Source& source, const std::vector<glm::vec4>& vertices, const std::vector<glm::vec2>& uvs, const std::vector<glm::vec4>& normals);
+
+    /**
+     * \brief Get the path of the cache file for the given source file
+     * \param sourcePath Path of the source file
+     * \return Return the path of the cache file, or an empty string if the cache is disabled
+     */
+    std::string getCachePath(const std::string& sourcePath) const;
+
+    /**
+     * \brief Get whether the cache is enabled, which is the case once a directory has been set
+     * \return Return true if the cache is enabled
+     */
+    bool isEnabled() const { return !getDirectory().empty(); }
+
+    /**
+     * \brief Set the directory holding the cache, created if needed. An empty path disables the cache, which is the default.
+     * \param directory Cache directory
+     */
+    void setDirectory(const std::string& directory);
+
+    /**
+     * \brief Get the cache directory
+     * \return Return the cache directory
+     */
+    std::string getDirectory() const;
+
+    /**
+     * \brief Set the maximum size of the cache, evicting the least recently used meshes if needed
+     * \param size Size in bytes
+     */
+    void setMaxSize(size_t size);
+
+    /**
+     * \brief Get the maximum size of the cache
+     * \return Return the size in bytes
+     */
+    size_t getMaxSize() const;
+
+  private:
+    mutable std::mutex _mutex{};
+    std::string _directory{};
+    size_t _maxSize{1024 * 1024 * 1024};
+
+    MeshCache() = default;
+    ~MeshCache() = default;
+
+    /**
+     * \brief Remove the least recently used cache files until the cache fits its maximum size. Must be called with the mutex locked
+     */
+    void evict();
+};
+
+} // end of namespace
+
+#endif // SPLASH_MESH_CACHE_H
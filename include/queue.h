@@ -25,6 +25,7 @@
 #ifndef SPLASH_QUEUE_H
 #define SPLASH_QUEUE_H
 
+#include <future>
 #include <glm/glm.hpp>
 #include <list>
 #include <memory>
@@ -125,12 +126,50 @@ class Queue : public BufferObject
     int64_t _startTime{-1};   // Beginning of the current loop, in us
     int64_t _currentTime{-1}; // Elapsed time since _startTime
 
+    // The next source is opened in the background, and swapped in when it starts
+    int64_t _prerollDuration{2000000}; // Time before its start when a source gets prerolled, in us
+    std::shared_ptr<BufferObject> _prerollSource{nullptr};
+    int32_t _prerollIndex{-1}; // Playlist index of the prerolled source, -1 if it does not match the playlist anymore
+    std::future<void> _prerollFuture{};
+
     /**
      * \brief Clean the playlist for holes and overlaps
      * \param playlist Playlist to clean
      */
     void cleanPlaylist(std::vector<Source>& playlist);
 
+    /**
+     * \brief Create a source and open its file. The source is paused, to be started when it gets displayed.
+     * \param sourceParameters Source parameters
+     * \return Return the source, or nullptr if its type is not valid
+     */
+    std::shared_ptr<BufferObject> createSource(const Source& sourceParameters);
+
+    /**
+     * \brief Find the playlist entry playing at the given time, the playlist being sorted by start time
+     * \param time Time, in us
+     * \return Return the index of the entry, or the playlist size if there is none
+     */
+    uint32_t findSourceIndex(int64_t time) const;
+
+    /**
+     * \brief Start prerolling the entry following the current one, if it starts soon enough
+     */
+    void prerollNextSource();
+
+    /**
+     * \brief Get the prerolled source, if it matches the given playlist entry
+     * \param index Playlist index
+     * \return Return the prerolled source, or nullptr
+     */
+    std::shared_ptr<BufferObject> takePrerolledSource(int32_t index);
+
+    /**
+     * \brief Release a source from a worker thread, as closing a file can take some time
+     * \param source Source to release
+     */
+    static void releaseSource(std::shared_ptr<BufferObject>&& source);
+
     /**
      * Regist\brief er new functors to modify attributes
      */
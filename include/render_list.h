@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @render_list.h
+ * The RenderList class, holding the objects to render sorted by rendering priority
+ */
+
+#ifndef SPLASH_RENDER_LIST_H
+#define SPLASH_RENDER_LIST_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./base_object.h"
+
+namespace Splash
+{
+
+/*************/
+class RenderList
+{
+  public:
+    /**
+     * Objects sharing the same rendering priority, as a range of the object list
+     */
+    struct Group
+    {
+        BaseObject::Priority priority{BaseObject::Priority::NO_RENDER};
+        size_t begin{0};
+        size_t end{0};
+    };
+
+    /**
+     * \brief Rebuild the list if objects were added or removed since the last call, or if the rendering state of any object changed.
+     * Ghosts and objects which are not rendered are skipped. Objects are sorted by increasing priority, and inside a priority they
+     * keep the iteration order of the map.
+     * \param objects Objects to render
+     * \param objectsGeneration Generation of the objects, which the caller increments each time the map is modified
+     * \return Return true if the list has been rebuilt
+     */
+    bool update(const std::unordered_map<std::string, std::shared_ptr<BaseObject>>& objects, uint64_t objectsGeneration);
+
+    /**
+     * \brief Get the objects to render, in rendering order
+     * \return Return the objects
+     */
+    const std::vector<std::shared_ptr<BaseObject>>& getObjects() const { return _objects; }
+
+    /**
+     * \brief Get the groups of objects sharing the same priority, in rendering order
+     * \return Return the groups
+     */
+    const std::vector<Group>& getGroups() const { return _groups; }
+
+  private:
+    std::vector<std::shared_ptr<BaseObject>> _objects{};
+    std::vector<Group> _groups{};
+
+    bool _isBuilt{false};
+    uint64_t _objectsGeneration{0};
+    uint64_t _renderingStateVersion{0};
+};
+
+} // end of namespace
+
+#endif // SPLASH_RENDER_LIST_H
@@ -25,8 +25,13 @@
 #ifndef SPLASH_RESIZABLE_ARRAY_H
 #define SPLASH_RESIZABLE_ARRAY_H
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <type_traits>
+
+#include "./buffer_pool.h"
 
 namespace Splash
 {
@@ -35,7 +40,11 @@ namespace Splash
 template <typename T>
 class ResizableArray
 {
+    static_assert(std::is_trivially_copyable<T>::value, "ResizableArray only holds trivially copyable types");
+
   public:
+    using ReleaseFunction = std::function<void(T*)>;
+
     /**
      * \brief Constructor with an initial size
      * \param size Initial array size
@@ -50,30 +59,38 @@ class ResizableArray
     ResizableArray(T* start, T* end)
     {
         if (end <= start)
-        {
-            _size = 0;
-            _shift = 0;
-            _buffer.reset();
-
             return;
-        }
 
-        _size = static_cast<size_t>(end - start);
-        _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
+        allocate(static_cast<size_t>(end - start));
         memcpy(_buffer.get(), start, _size * sizeof(T));
     }
 
+    /**
+     * \brief Constructor wrapping an external buffer, without copying it
+     * The array does not own the memory: the release function is called instead of delete[] when the buffer is not used anymore
+     * \param data Pointer to the external buffer
+     * \param size Buffer size
+     * \param release Function called with the data pointer upon release
+     */
+    ResizableArray(T* data, size_t size, const ReleaseFunction& release)
+        : _size(size)
+        , _shift(0)
+        , _capacity(size)
+        , _buffer(data, Deleter(release))
+    {
+    }
+
     /**
      * \brief Copy constructor
      * \param a ResizableArray to copy
      */
     ResizableArray(const ResizableArray& a)
     {
-        _size = a.size();
-        _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
-        memcpy(data(), a.data(), _size);
+        if (a._size == 0)
+            return;
+
+        allocate(a._size);
+        memcpy(data(), a.data(), _size * sizeof(T));
     }
 
     /**
@@ -83,12 +100,16 @@ class ResizableArray
     ResizableArray(ResizableArray&& a)
         : _size(a._size)
         , _shift(a._shift)
+        , _capacity(a._capacity)
         , _buffer(std::move(a._buffer))
     {
+        a._size = 0;
+        a._shift = 0;
+        a._capacity = 0;
     }
 
     /**
-     * \brief Copy operator
+     * \brief Copy operator. The current buffer is reused if it is large enough and not an external one.
      * \param a ResizableArray to copy from
      */
     ResizableArray& operator=(const ResizableArray& a)
@@ -96,11 +117,23 @@ class ResizableArray
         if (this == &a)
             return *this;
 
-        _size = a.size();
-        _shift = 0;
-        _buffer = std::unique_ptr<T[]>(new T[_size]);
-        memcpy(data(), a.data(), _size);
+        if (a._size == 0)
+        {
+            resize(0);
+            return *this;
+        }
+
+        if (_buffer && !_buffer.get_deleter()._release && a._size <= _capacity)
+        {
+            _size = a._size;
+            _shift = 0;
+        }
+        else
+        {
+            allocate(a._size);
+        }
 
+        memcpy(data(), a.data(), _size * sizeof(T));
         return *this;
     }
 
@@ -115,8 +148,13 @@ class ResizableArray
 
         _size = a._size;
         _shift = a._shift;
+        _capacity = a._capacity;
         _buffer = std::move(a._buffer);
 
+        a._size = 0;
+        a._shift = 0;
+        a._capacity = 0;
+
         return *this;
     }
 
@@ -153,7 +191,14 @@ class ResizableArray
     inline size_t size() const { return _size; }
 
     /**
-     * \brief Resize the buffer
+     * \brief Get the number of elements the buffer can hold without being reallocated
+     * \return Return the capacity, starting from data()
+     */
+    inline size_t capacity() const { return _capacity - _shift; }
+
+    /**
+     * \brief Resize the buffer. It is only reallocated if its capacity is not sufficient, and released if the new size is 0.
+     * The data is kept up to the smallest of the old and new sizes.
      * \param size New size
      */
     inline void resize(size_t size)
@@ -162,24 +207,72 @@ class ResizableArray
         {
             _size = 0;
             _shift = 0;
+            _capacity = 0;
             _buffer.reset(nullptr);
+            return;
         }
 
-        auto newBuffer = std::unique_ptr<T[]>(new T[size]);
-        if (size >= _size)
-            memcpy(newBuffer.get(), _buffer.get(), _size);
-        else
-            memcpy(newBuffer.get(), _buffer.get(), size);
+        if (_buffer && _shift + size <= _capacity)
+        {
+            _size = size;
+            return;
+        }
 
-        std::swap(_buffer, newBuffer);
-        _size = size;
-        _shift = 0;
+        auto oldBuffer = std::move(_buffer);
+        auto oldData = oldBuffer.get() + _shift;
+        auto oldSize = _size;
+
+        allocate(size);
+        if (oldBuffer && _buffer)
+            memcpy(_buffer.get(), oldData, std::min(oldSize, _size) * sizeof(T));
     }
 
   private:
-    size_t _size{0};                       //!< Buffer size
-    size_t _shift{0};                      //!< Buffer shift
-    std::unique_ptr<T[]> _buffer{nullptr}; //!< Pointer to the buffer data
+    /**
+     * Deleter handling both buffers from the BufferPool and external ones
+     */
+    struct Deleter
+    {
+        Deleter() = default;
+        explicit Deleter(const ReleaseFunction& release)
+            : _release(release)
+        {
+        }
+        explicit Deleter(size_t capacity)
+            : _capacity(capacity)
+        {
+        }
+
+        void operator()(T* ptr) const
+        {
+            if (_release)
+                _release(ptr);
+            else
+                BufferPool::get().release(ptr, _capacity);
+        }
+
+        ReleaseFunction _release{};
+        size_t _capacity{0}; //!< Capacity of the buffer in bytes, if it comes from the pool
+    };
+
+    size_t _size{0};                                //!< Buffer size
+    size_t _shift{0};                               //!< Buffer shift
+    size_t _capacity{0};                            //!< Buffer capacity, from the start of the buffer
+    std::unique_ptr<T[], Deleter> _buffer{nullptr}; //!< Pointer to the buffer data
+
+    /**
+     * \brief Replace the buffer with a new one from the pool, without copying the data
+     * \param size Number of elements
+     */
+    void allocate(size_t size)
+    {
+        size_t capacity = 0;
+        auto buffer = static_cast<T*>(BufferPool::get().allocate(size * sizeof(T), capacity));
+        _buffer = std::unique_ptr<T[], Deleter>(buffer, Deleter(capacity));
+        _size = buffer ? size : 0;
+        _shift = 0;
+        _capacity = capacity / sizeof(T);
+    }
 };
 
 } // end of namespace
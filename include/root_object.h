@@ -31,6 +31,7 @@
 #include <list>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "./base_object.h"
 #include "./factory.h"
@@ -39,6 +40,7 @@
 namespace Splash
 {
 
+struct BufferSnapshot;
 class ControllerObject;
 class Queue;
 class UserInput;
@@ -118,6 +120,14 @@ class RootObject : public BaseObject
      */
     void setFromSerializedObject(const std::string& name, std::shared_ptr<SerializedObject> obj);
 
+    /**
+     * \brief Set a BufferObject from a snapshot shared by an object living in the same process
+     * \param name Object name
+     * \param snapshot Snapshot
+     * \return Return false if the object does not exist or does not support this snapshot
+     */
+    bool setFromSnapshot(const std::string& name, const std::shared_ptr<BufferSnapshot>& snapshot);
+
     /**
      * \brief Send the given serialized buffer through the link
      * \param name Destination BufferObject name
@@ -131,10 +141,17 @@ class RootObject : public BaseObject
      */
     std::unique_lock<std::recursive_mutex> getLockOnObjects() { return std::move(std::unique_lock<std::recursive_mutex>(_objectsMutex)); }
 
+    /**
+     * \brief Get the names of the BufferObjects updated since the last call
+     * \return Return the names of the updated BufferObjects
+     */
+    std::unordered_set<std::string> getUpdatedBufferObjects();
+
     /**
      * \brief Signals that a BufferObject has been updated
+     * \param name Name of the updated BufferObject. If empty, waiting threads are only woken up
      */
-    void signalBufferObjectUpdated();
+    void signalBufferObjectUpdated(const std::string& name = "");
 
   protected:
     std::string _configurationPath{""}; //!< Path to the configuration file
@@ -155,14 +172,17 @@ class RootObject : public BaseObject
     std::mutex _bufferObjectUpdatedMutex{};
     Spinlock _bufferObjectSingleMutex{};
     bool _bufferObjectUpdated = ATOMIC_FLAG_INIT;
+    std::unordered_set<std::string> _updatedBufferObjects{}; //!< BufferObjects updated since the last call to getUpdatedBufferObjects
 
     // Tasks queue
     std::mutex _recurringTaskMutex{};
     std::map<std::string, std::function<void()>> _recurringTasks{};
+    std::atomic_ullong* _taskQueueDepth{nullptr}; //!< Gauge holding the number of tasks waiting when runTasks was last called
 
     mutable std::recursive_mutex _objectsMutex{};                            //!< Used in registration and unregistration of objects
     std::atomic_bool _objectsCurrentlyUpdated{false};                        //!< Prevents modification of objects from multiple places at the same time
     std::unordered_map<std::string, std::shared_ptr<BaseObject>> _objects{}; //!< Map of all the objects
+    std::atomic<uint64_t> _objectsGeneration{0};                             //!< Incremented each time _objects is modified
 
     /**
      * \brief Wait for a BufferObject update. This does not prevent spurious wakeups.
@@ -29,6 +29,7 @@
 #include <cstddef>
 #include <future>
 #include <list>
+#include <unordered_set>
 #include <vector>
 
 #include "./config.h"
@@ -39,8 +40,10 @@
 #include "./attribute.h"
 #include "./coretypes.h"
 #include "./factory.h"
+#include "./render_list.h"
 #include "./root_object.h"
 #include "./spinlock.h"
+#include "./texture_upload_list.h"
 
 namespace Splash
 {
@@ -48,6 +51,7 @@ namespace Splash
 class ControllerObject;
 class Gui;
 class Scene;
+class Window;
 
 /*************/
 //! Scene class, which does the rendering on a given GPU
@@ -253,6 +257,8 @@ class Scene : public RootObject
     int _swapInterval{1}; //!< Global value for the swap interval, default for all windows
     unsigned long long _targetFrameDuration{0}; //!< Duration in microseconds of a frame at the refresh rate of the
                                                 //!< primary monitor
+    int64_t _lastTimingsSent{0};                  //!< Last time the timings were sent to the World
+    static const int64_t _timingsPeriod{1000000}; //!< Period at which timings are sent to the World, in us
 
     // Texture upload context
     std::future<void> _textureUploadFuture;
@@ -260,6 +266,16 @@ class Scene : public RootObject
     std::atomic_bool _textureUploadDone{false};
     Spinlock _textureMutex; //!< Sync between texture and render loops
     GLsync _textureUploadFence{nullptr}, _cameraDrawnFence{nullptr};
+    TextureUploadList _textureUploadList{}; //!< Gives the textures to upload from the updated images
+
+    // BufferObjects consumed by this Scene, as last sent to the World
+    std::unordered_set<std::string> _consumedBufferObjects{};
+    uint64_t _consumedObjectsGeneration{0};
+    uint64_t _consumedLinksVersion{0};
+
+    // Objects to render, only rebuilt when needed
+    RenderList _renderList{};
+    std::vector<std::shared_ptr<Window>> _windows{};
 
     // NV Swap group specific
     GLuint _maxSwapGroups{0};
@@ -309,6 +325,17 @@ class Scene : public RootObject
     static void glMsgCallback(GLenum, GLenum, GLuint, GLenum, GLsizei, const GLchar*, void*);
 #endif
 
+    /**
+     * \brief Send to the World the names of the BufferObjects consumed by this Scene, if they changed since the last call.
+     * A BufferObject is consumed if it is linked, directly or through other objects, to a rendered object other than a media
+     */
+    void sendBufferConsumersToWorld();
+
+    /**
+     * \brief Send the last durations and the statistics of the timers of this Scene to the World
+     */
+    void sendTimingsToWorld();
+
     /**
      * \brief Texture update loop
      */
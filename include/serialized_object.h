@@ -54,11 +54,21 @@ struct SerializedObject
     {
     }
 
+    /**
+     * \brief Constructor taking ownership of an existing array
+     * \param data Array to move from
+     */
+    explicit SerializedObject(ResizableArray<char>&& data)
+        : _data(std::move(data))
+    {
+    }
+
     /**
      * \brief Get the pointer to the data
      * \return Return a pointer to the data
      */
     char* data() { return _data.data(); }
+    const char* data() const { return _data.data(); }
 
     /**
      * \brief Get ownership over the inner buffer. Use with caution, as it invalidates the SerializedObject
@@ -70,7 +80,7 @@ struct SerializedObject
      * \brief Get the size of the data
      * \return Return the size
      */
-    std::size_t size() { return _data.size(); }
+    std::size_t size() const { return _data.size(); }
 
     /**
      * \brief Modify the size of the data
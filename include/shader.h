@@ -26,6 +26,7 @@
 #define SPLASH_SHADER_H
 
 #include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -85,6 +86,11 @@ class Shader : public BaseObject
         window
     };
 
+    //! Binding point of the CameraUniforms block, shared by all shaders and filled by the cameras
+    static const GLuint cameraUniformsBinding{2};
+    //! Binding point of the other uniform blocks, each shader binding its own buffers to it when activated
+    static const GLuint blockUniformsBinding{1};
+
     /**
      * \brief Constructor
      * \param type Shader type
@@ -181,6 +187,32 @@ class Shader : public BaseObject
      */
     void setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4& mp);
 
+    /**
+     * \brief Set the value of a uniform, converted to the type declared in the GLSL source
+     * The value is only sent to the GPU by updateUniforms, and only if it changed.
+     * \param name Uniform name
+     * \param values Uniform values, either flat or as a single nested Values for arrays
+     */
+    void setUniform(const std::string& name, const Values& values);
+
+    /**
+     * \brief Set the value of a float uniform from raw data, without going through Values
+     * Uniforms not declared in the linked program are ignored.
+     * \param name Uniform name
+     * \param data Pointer to the values
+     * \param count Number of floats
+     */
+    void setUniform(const std::string& name, const float* data, size_t count);
+
+    /**
+     * \brief Set the value of an integer uniform from raw data, without going through Values
+     * Uniforms not declared in the linked program are ignored.
+     * \param name Uniform name
+     * \param data Pointer to the values
+     * \param count Number of integers
+     */
+    void setUniform(const std::string& name, const int32_t* data, size_t count);
+
     /**
      * \brief Set the currently queued uniforms updates
      */
@@ -196,17 +228,28 @@ class Shader : public BaseObject
     GLuint _program{0};
     bool _isLinked = {false};
 
+    /**
+     * Uniform values are stored in preallocated memory, in the GLSL type of the uniform,
+     * so that they can be compared and sent to the GPU without any conversion
+     */
     struct Uniform
     {
         std::string type{""};
-        Values values{};
         GLint glIndex{-1};
         GLuint glBuffer{0};
         bool glBufferReady{false};
+        bool isInteger{false};
+        int components{0}; //!< Scalars per element: 1 to 4 for vectors, 9 and 16 for matrices, 0 for samplers
+        int arraySize{1};
+        std::vector<float> floats{};
+        std::vector<int32_t> ints{};
+        Values pending{}; //!< Values set before the uniform has been parsed
+        bool isDirty{false};
     };
-    std::map<std::string, Uniform> _uniforms;
+    std::map<std::string, Uniform> _uniforms; // Elements are never erased, pointers to them stay valid
     std::unordered_map<std::string, std::string> _uniformsDocumentation;
-    std::vector<std::string> _uniformsToUpdate;
+    std::vector<Uniform*> _uniformsToUpdate;
+    std::vector<Uniform*> _uniformBlocks; // Uniform blocks with their own buffer, bound at each activation
     std::vector<std::shared_ptr<Texture>> _textures; // Currently used textures
     std::string _currentProgramName{};
 
@@ -237,6 +280,38 @@ class Shader : public BaseObject
      */
     void parseUniforms(const std::string& src);
 
+    /**
+     * \brief Allocate the storage of a uniform according to its type, and read its default value from the program
+     * \param name Uniform name
+     * \param uniform Uniform
+     */
+    void allocateUniform(const std::string& name, Uniform& uniform);
+
+    /**
+     * \brief Write values into the storage of a uniform, marking it as dirty if they changed
+     * \param uniform Uniform
+     * \param values Values
+     * \param offset Index of the first value to write
+     */
+    void writeUniform(Uniform& uniform, const Values& values, size_t offset);
+
+    /**
+     * \brief Write raw data into the storage of a uniform, marking it as dirty if it changed
+     * \param uniform Uniform
+     * \param data Data
+     * \param count Number of scalars
+     */
+    template <typename T>
+    void writeUniform(Uniform& uniform, const T* data, size_t count);
+
+    /**
+     * \brief Set the value of a uniform from the "uniform" attribute or setUniform
+     * \param name Uniform name
+     * \param values Values
+     * \param offset Index of the first value in values
+     */
+    void setUniformValues(const std::string& name, const Values& values, size_t offset);
+
     /**
      * \brief Get a string expression of the shader type, used for logging
      * \param type Shader type
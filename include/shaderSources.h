@@ -144,6 +144,20 @@ struct ShaderSources
                 yuv = pow(yuv, vec3(2.2));
                 return yuv;
             }
+        )"},
+        //
+        // Per-camera parameters, filled once per frame by the camera. The layout must match Camera::CameraUniforms
+        {"cameraUniforms", R"(
+            layout(std140) uniform CameraUniforms
+            {
+                vec4 _wireframeColor;
+                vec4 _fovAndColorBalance; // fovX and fovY, r/g and b/g
+                vec2 _cameraAttributes; // blendWidth and brightness
+                int _showCameraCount;
+                int _isColorLUT;
+                mat3 _colorMixMatrix;
+                vec3 _colorLUT[256];
+            };
         )"}};
 
 /**
@@ -1151,6 +1165,7 @@ struct ShaderSources
      */
     const std::string VERTEX_SHADER_TEXTURE{R"(
         #include getSmoothBlendFromVertex
+        #include cameraUniforms
 
         layout(location = 0) in vec4 _vertex;
         layout(location = 1) in vec2 _texcoord;
@@ -1159,7 +1174,6 @@ struct ShaderSources
 
         uniform mat4 _modelViewProjectionMatrix;
         uniform mat4 _normalMatrix;
-        uniform vec2 _cameraAttributes = vec2(0.05, 1.0); // blendWidth and brightness
 
         out VertexData
         {
@@ -1196,6 +1210,8 @@ struct ShaderSources
     const std::string FRAGMENT_SHADER_TEXTURE{R"(
         #define PI 3.14159265359
 
+        #include cameraUniforms
+
     #ifdef TEXTURE_RECT
         uniform sampler2DRect _tex0;
     #else
@@ -1209,16 +1225,8 @@ struct ShaderSources
         uniform vec2 _tex0_size = vec2(1.0);
         uniform vec2 _tex1_size = vec2(1.0);
 
-        uniform int _showCameraCount = 0;
         uniform int _sideness = 0;
         uniform int _textureNbr = 0;
-        uniform vec2 _cameraAttributes = vec2(0.05, 1.0); // blendWidth and brightness
-        uniform vec4 _fovAndColorBalance = vec4(0.0, 0.0, 1.0, 1.0); // fovX and fovY, r/g and b/g
-        uniform int _isColorLUT = 0;
-        uniform vec3 _colorLUT[256];
-        uniform mat3 _colorMixMatrix = mat3(1.0, 0.0, 0.0,
-                                            0.0, 1.0, 0.0,
-                                            0.0, 0.0, 1.0);
         uniform float _normalExp = 0.0;
 
         in VertexData
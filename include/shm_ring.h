@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @shm_ring.h
+ * The ShmRing class, a ring of POSIX shared memory slots used to send buffers between processes
+ */
+
+#ifndef SPLASH_SHM_RING_H
+#define SPLASH_SHM_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "./coretypes.h"
+
+namespace Splash
+{
+
+/*************/
+class ShmRing
+{
+  public:
+    static const uint32_t maxSlots = 32;
+    static const size_t maxNameLength = 64;
+
+    enum class Mode : uint8_t
+    {
+        Writer,
+        Reader
+    };
+
+    /**
+     * Descriptor of a buffer written in the ring, sent to the readers through the control path
+     */
+    struct Descriptor
+    {
+        char ring[maxNameLength]; //!< Name of the ring
+        uint32_t slot;            //!< Slot holding the buffer
+        uint64_t sequence;        //!< Sequence number of the write, used to detect reclaimed slots
+        uint64_t size;            //!< Size of the buffer
+    };
+
+    /**
+     * \brief Constructor
+     * \param name Name of the ring, as given to shm_open
+     * \param mode Writer creates the shared memory, reader attaches to it
+     * \param slotCount Number of slots, only used by the writer
+     */
+    ShmRing(const std::string& name, Mode mode, uint32_t slotCount = 8);
+
+    /**
+     * \brief Destructor
+     */
+    ~ShmRing();
+
+    /**
+     * \brief Other constructors and operators
+     */
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * \brief Safe bool idiom
+     */
+    explicit operator bool() const { return _control != nullptr; }
+
+    /**
+     * \brief Get the ring name
+     * \return Return the name
+     */
+    const std::string& getName() const { return _name; }
+
+    /**
+     * \brief Copy a buffer into a free slot. Writer only.
+     * \param data Pointer to the data
+     * \param size Data size
+     * \param readers Number of readers which will receive the descriptor
+     * \param descriptor Descriptor to send to the readers
+     * \return Return false if no slot is available, in which case the caller should fallback to another transport
+     */
+    bool write(const char* data, size_t size, uint32_t readers, Descriptor& descriptor);
+
+    /**
+     * \brief Get a buffer from the ring, without copying it. Reader only.
+     * The slot is held until the returned object is destroyed.
+     * \param descriptor Descriptor received from the writer
+     * \return Return the buffer, or nullptr if the slot has been reclaimed in the meantime
+     */
+    std::shared_ptr<SerializedObject> read(const Descriptor& descriptor);
+
+  private:
+    /**
+     * Per-slot state, shared between the processes
+     */
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<int32_t> pending; //!< Readers which have not received the descriptor yet
+        std::atomic<int32_t> held;    //!< Readers currently holding the slot
+        std::atomic<int64_t> timestamp;
+    };
+
+    /**
+     * Control block, mapped at the start of the control segment
+     */
+    struct Control
+    {
+        uint32_t magic;
+        uint32_t slotCount;
+        Slot slots[maxSlots];
+    };
+
+    /**
+     * Mapping of a slot segment in the current process
+     */
+    struct Mapping
+    {
+        Mapping(char* data, size_t size)
+            : data(data)
+            , size(size)
+        {
+        }
+        ~Mapping();
+        char* data{nullptr};
+        size_t size{0};
+    };
+
+    static const uint32_t _magic = 0x53504c53;         // "SPLS"
+    static const int64_t _staleSlotTimeout = 1000000; // Reclaim slots whose descriptor got lost after 1 sec
+
+    std::string _name{""};
+    Mode _mode{Mode::Writer};
+    std::shared_ptr<Mapping> _controlMapping{nullptr}; //!< Kept alive by the buffers read from the ring
+    Control* _control{nullptr};
+    uint64_t _sequence{0};
+    uint32_t _nextSlot{0};
+
+    std::mutex _mappingsMutex{};
+    std::vector<std::shared_ptr<Mapping>> _mappings{};
+
+    /**
+     * \brief Get the shared memory name of the given slot
+     * \param slot Slot index
+     * \return Return the name
+     */
+    std::string getSlotName(uint32_t slot) const { return _name + "_" + std::to_string(slot); }
+
+    /**
+     * \brief Map the given slot, growing it if needed (writer) or remapping it if it grew (reader)
+     * \param slot Slot index
+     * \param size Minimum size of the mapping
+     * \return Return the mapping, or nullptr if something went wrong
+     */
+    std::shared_ptr<Mapping> mapSlot(uint32_t slot, size_t size);
+
+    /**
+     * \brief Try to acquire the given slot for writing
+     * \param slot Slot index
+     * \return Return true if the slot has been acquired
+     */
+    bool acquireSlot(uint32_t slot);
+};
+
+} // end of namespace
+
+#endif // SPLASH_SHM_RING_H
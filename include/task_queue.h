@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @task_queue.h
+ * The TaskQueue class, a bounded multi-producer single-consumer queue of tasks
+ */
+
+#ifndef SPLASH_TASK_QUEUE_H
+#define SPLASH_TASK_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./coretypes.h"
+
+namespace Splash
+{
+
+/*************/
+class TaskQueue
+{
+  public:
+    using Task = std::function<void()>;
+
+    /**
+     * \brief Constructor
+     * \param capacity Number of preallocated slots, rounded up to a power of two
+     */
+    explicit TaskQueue(size_t capacity = 64);
+
+    /**
+     * \brief Other constructors and operators
+     */
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    /**
+     * \brief Change the number of preallocated slots. Not thread safe, must be called before any task is added
+     * \param capacity Number of slots, rounded up to a power of two
+     */
+    void setCapacity(size_t capacity);
+
+    /**
+     * \brief Add a task to the queue. Can be called from any thread, and does not lock unless the queue is full,
+     * in which case tasks are kept in an unbounded overflow list until the queue is drained.
+     * \param task Task to add
+     * \param key Coalescing key. If not empty, among the tasks sharing the same key only the last one added before run() is called is run
+     */
+    void push(Task task, const std::string& key = "");
+
+    /**
+     * \brief Run the tasks added so far, in the order they were added. Tasks added while running are kept for the next call.
+     * Only one thread runs the tasks at once, other calls return immediately.
+     * \return Return the number of tasks which were queued, including the coalesced ones
+     */
+    size_t run();
+
+    /**
+     * \brief Get the approximate number of tasks waiting to be run
+     * \return Return the number of tasks
+     */
+    size_t getDepth() const;
+
+  private:
+    /**
+     * A slot of the ring, the sequence telling whether it is ready to be written or read
+     */
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence{0};
+        Task task{};
+        std::string key{};
+    };
+
+    struct Entry
+    {
+        Task task{};
+        std::string key{};
+    };
+
+    std::unique_ptr<Cell[]> _cells{};
+    uint64_t _mask{0};
+    std::atomic<uint64_t> _enqueuePosition{0};
+    std::atomic<uint64_t> _dequeuePosition{0}; //!< Only written by the thread running the tasks
+
+    mutable Spinlock _overflowMutex{};
+    std::deque<Entry> _overflow{};
+    std::atomic_bool _isOverflowing{false}; //!< While true, tasks go to the overflow list to keep their order
+
+    std::mutex _runMutex{};
+    std::vector<Entry> _runningTasks{};                      //!< Storage for the tasks being run, reused between calls
+    std::unordered_map<std::string, size_t> _lastKeyIndex{}; //!< Index of the last task for each coalescing key
+
+    /**
+     * \brief Add a task to the overflow list
+     * \param task Task to add
+     * \param key Coalescing key
+     */
+    void pushToOverflow(Task&& task, const std::string& key);
+};
+
+} // end of namespace
+
+#endif // SPLASH_TASK_QUEUE_H
@@ -25,6 +25,7 @@
 #ifndef SPLASH_TEXTURE_IMAGE_H
 #define SPLASH_TEXTURE_IMAGE_H
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <glm/glm.hpp>
@@ -113,6 +114,18 @@ class Texture_Image : public Texture
      */
     std::unordered_map<std::string, Values> getShaderUniforms() const { return _shaderUniforms; }
 
+    /**
+     * \brief Get the image this texture is set from
+     * \return Return the image, or nullptr if none
+     */
+    std::shared_ptr<Image> getImage() const;
+
+    /**
+     * \brief Get the version of the links between textures and images, incremented each time a texture is set from another image
+     * \return Return the links version
+     */
+    static uint64_t getImageLinksVersion() { return _imageLinksVersion; }
+
     /**
      * \brief Get spec of the texture
      * \return Return the spec
@@ -171,11 +184,20 @@ class Texture_Image : public Texture
     void update() final;
 
   private:
+    static constexpr int _pboCount{3};           //!< Depth of the PBO ring
+    static constexpr size_t _pboAlignment{256}; //!< Alignment of the slots in the PBO ring
+
     GLuint _glTex{0};
-    GLuint _pbos[2];
     int _multisample{0};
     bool _cubemap{false};
-    int _pboReadIndex{0};
+
+    // PBO ring, allocated as immutable storage and mapped once for its whole life
+    GLuint _pbo{0};
+    GLubyte* _pboMapping{nullptr};
+    size_t _pboSlotSize{0};
+    GLsync _pboFences[_pboCount]{}; //!< Set when an upload from the slot has been issued, waited for before writing the slot again
+    int _pboWriteIndex{0};
+    int _pboPendingIndex{-1}; //!< Slot being filled with the next frame, or -1
     std::vector<std::future<void>> _pboCopyThreads;
 
     // Store some texture parameters
@@ -190,6 +212,7 @@ class Texture_Image : public Texture
     GLint _activeTexture{0}; // Texture unit to which the texture is bound
 
     std::weak_ptr<Image> _img;
+    static std::atomic<uint64_t> _imageLinksVersion; //!< Incremented each time any texture is set from another image
 
     // Parameters to send to the shader
     std::unordered_map<std::string, Values> _shaderUniforms;
@@ -207,12 +230,23 @@ class Texture_Image : public Texture
     GLenum getChannelOrder(const ImageBufferSpec& spec);
 
     /**
-     * \brief Update the pbos according to the parameters
-     * \param width Width
-     * \param height Height
-     * \param bytes Bytes per pixel
+     * \brief Make sure the PBO ring can hold images of the given size. The ring is only reallocated if it grows.
+     * \param size Image size in bytes
+     * \return Return false if the ring could not be allocated
+     */
+    bool updatePbos(size_t size);
+
+    /**
+     * \brief Get a slot of the PBO ring for writing, waiting for the last upload from it to be done
+     * \param index Slot index
+     * \return Return a pointer to the mapped slot
+     */
+    GLubyte* acquirePboSlot(int index);
+
+    /**
+     * \brief Delete the PBO ring, after waiting for the pending uploads
      */
-    void updatePbos(int width, int height, int bytes);
+    void deletePbos();
 
     /**
      * \brief Register new functors to modify attributes
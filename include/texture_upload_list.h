@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @texture_upload_list.h
+ * The TextureUploadList class, giving the textures to upload from the updated images
+ */
+
+#ifndef SPLASH_TEXTURE_UPLOAD_LIST_H
+#define SPLASH_TEXTURE_UPLOAD_LIST_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "./base_object.h"
+#include "./texture_image.h"
+
+namespace Splash
+{
+
+/*************/
+class TextureUploadList
+{
+  public:
+    /**
+     * \brief Get the textures set from the given updated BufferObjects. The map from images to textures is rebuilt if objects were
+     * added or removed since the last call, or if any texture has been set from another image.
+     * \param objects All objects
+     * \param objectsGeneration Generation of the objects, which the caller increments each time the map is modified
+     * \param updatedBufferObjects Names of the BufferObjects updated since the last call
+     * \return Return the textures to upload
+     */
+    std::vector<std::shared_ptr<Texture_Image>> getTextures(const std::unordered_map<std::string, std::shared_ptr<BaseObject>>& objects,
+        uint64_t objectsGeneration,
+        const std::unordered_set<std::string>& updatedBufferObjects);
+
+  private:
+    std::unordered_map<std::string, std::vector<std::weak_ptr<Texture_Image>>> _texturesPerImage{};
+
+    bool _isBuilt{false};
+    uint64_t _objectsGeneration{0};
+    uint64_t _imageLinksVersion{0};
+};
+
+} // end of namespace
+
+#endif // SPLASH_TEXTURE_UPLOAD_LIST_H
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @thread_pool.h
+ * The ThreadPool class, a persistent work-stealing pool of worker threads
+ */
+
+#ifndef SPLASH_THREAD_POOL_H
+#define SPLASH_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "./spinlock.h"
+
+namespace Splash
+{
+
+/*************/
+class ThreadPool
+{
+  public:
+    /**
+     * \brief Get the singleton, shared by all objects of the process
+     * \return Return the ThreadPool singleton
+     */
+    static ThreadPool& get()
+    {
+        static auto instance = new ThreadPool;
+        return *instance;
+    }
+
+    /**
+     * \brief Constructor
+     * \param workerCount Number of worker threads, defaults to the number of cores
+     */
+    explicit ThreadPool(unsigned int workerCount = 0);
+
+    /**
+     * \brief Destructor, runs all remaining tasks before returning
+     */
+    ~ThreadPool();
+
+    /**
+     * \brief Other constructors and operators
+     */
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \brief Add a task to the pool
+     * Tasks added from a worker go to the queue of this worker, other ones are spread among workers
+     * \param task Task to run
+     * \return Return a future for the task. Contrary to std::async, its destructor does not wait for the task to finish.
+     */
+    std::future<void> enqueue(const std::function<void()>& task);
+
+    /**
+     * \brief Wait for the given futures to be ready
+     * Workers run pending tasks while waiting, so it is safe to wait from inside a task. Other threads simply block.
+     * \param futures Futures to wait for
+     */
+    void waitFor(std::vector<std::future<void>>& futures);
+
+    /**
+     * \brief Wait for the given future to be ready, running pending tasks meanwhile if called from a worker
+     * \param future Future to wait for
+     */
+    void waitFor(std::future<void>& future);
+
+    /**
+     * \brief Get the number of worker threads
+     * \return Return the worker count
+     */
+    unsigned int getWorkerCount() const { return _workerCount; }
+
+    /**
+     * \brief Set the number of worker threads. Pending tasks are run before the workers are replaced.
+     * \param workerCount Worker count, defaults to the number of cores if set to 0
+     */
+    void setWorkerCount(unsigned int workerCount);
+
+    /**
+     * \brief Set the CPU cores the workers can run on. An empty list removes the constraint.
+     * \param cores List of cores
+     * \return Return false if one of the cores is not reachable
+     */
+    bool setAffinity(const std::vector<int>& cores);
+
+  private:
+    using Task = std::function<void()>;
+
+    struct Worker
+    {
+        Spinlock mutex{};
+        std::deque<Task> tasks{};
+        std::thread thread{};
+    };
+
+    mutable std::shared_timed_mutex _workersMutex{}; //!< Locked exclusively when the workers are replaced
+    std::vector<std::unique_ptr<Worker>> _workers{};
+    std::atomic_uint _workerCount{0};
+    std::atomic_uint _nextWorker{0};
+    std::vector<int> _affinity{};
+
+    std::mutex _sleepMutex{};
+    std::condition_variable _sleepCondition{};
+    std::atomic_int _pendingTasks{0};
+    std::atomic_bool _stopWorkers{false};
+
+    /**
+     * \brief Start the given number of workers
+     * \param workerCount Worker count
+     */
+    void startWorkers(unsigned int workerCount);
+
+    /**
+     * \brief Stop all workers, after they ran the pending tasks
+     */
+    void stopWorkers();
+
+    /**
+     * \brief Get the index of the worker running in the current thread
+     * \return Return the worker index, or -1 if not called from a worker of this pool
+     */
+    int getCurrentWorkerIndex() const;
+
+    /**
+     * \brief Get a task, from the given worker's queue first, then stealing from the other workers
+     * \param workerIndex Index of the worker to start with, or -1
+     * \param task Task to run
+     * \return Return true if a task was found
+     */
+    bool popTask(int workerIndex, Task& task);
+
+    /**
+     * \brief Worker thread function
+     * \param workerIndex Worker index
+     */
+    void workerLoop(unsigned int workerIndex);
+};
+
+} // end of namespace
+
+#endif // SPLASH_THREAD_POOL_H
@@ -29,13 +29,17 @@
 #include <chrono>
 #include <ctime>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "./config.h"
 #include "./coretypes.h"
+#include "./histogram.h"
 #include "./spinlock.h"
 
 namespace Splash
@@ -44,6 +48,9 @@ namespace Splash
 class Timer
 {
   public:
+    using Handle = uint32_t; //!< Pre-registered timer, see getHandle()
+    using Stats = Histogram::Stats;
+
     /**
      * \brief Get the singleton
      * \return Return the Timer singleton
@@ -77,6 +84,202 @@ class Timer
      */
     bool isLoose() const { return _looseClock; }
 
+    /**
+     * \brief Get the handle of the given timer, registering it if needed
+     * Handles are meant to be retrieved once and kept, as recording through them does not involve any lookup nor lock
+     * Past the maximum number of timers, a warning is logged and nothing gets recorded through the returned handle
+     * \param name Timer name
+     * \return Return the handle
+     */
+    Handle getHandle(const std::string& name);
+
+    /**
+     * \brief Start a duration measurement. The start time is kept per thread.
+     * \param handle Timer handle
+     */
+    void start(Handle handle)
+    {
+        if (!_enabled)
+            return;
+
+        auto& startTimes = getThreadStartTimes();
+        if (startTimes.size() <= handle)
+            startTimes.resize(handle + 1, -1);
+        startTimes[handle] = getTime();
+    }
+
+    /**
+     * \brief End a duration measurement started from the same thread, and record it
+     * \param handle Timer handle
+     */
+    void stop(Handle handle)
+    {
+        if (!_enabled)
+            return;
+
+        auto& startTimes = getThreadStartTimes();
+        if (startTimes.size() <= handle || startTimes[handle] < 0)
+            return;
+
+        auto currentTime = getTime();
+        record(handle, currentTime - startTimes[handle], currentTime);
+        startTimes[handle] = -1;
+    }
+
+    /**
+     * \brief Record a duration into the histogram of the given timer
+     * \param handle Timer handle
+     * \param duration Duration in us
+     */
+    void record(Handle handle, unsigned long long duration) { record(handle, duration, getTime()); }
+
+    /**
+     * \brief Get the statistics of the given timer, over the last one to two windows
+     * \param handle Timer handle
+     * \return Return the statistics, with a count of 0 if nothing was recorded lately
+     */
+    Stats getStats(Handle handle) const
+    {
+        if (handle >= _entryCount.load(std::memory_order_acquire))
+            return {};
+
+        const auto& entry = getEntry(handle);
+        auto window = _statsWindow.load(std::memory_order_relaxed);
+        auto elapsed = getTime() - entry.windowStart.load(std::memory_order_acquire);
+        auto current = entry.currentWindow.load(std::memory_order_acquire);
+
+        // The previous window is only relevant if the current one is not complete yet
+        if (elapsed < window)
+        {
+            const Histogram* windows[2] = {&entry.windows[0], &entry.windows[1]};
+            return Histogram::getStats(windows, 2);
+        }
+        else if (elapsed < 2 * window)
+        {
+            return entry.windows[current].getStats();
+        }
+
+        return {};
+    }
+
+    /**
+     * \brief Get the statistics of the given timer, which can be local or received from another process
+     * \param name Timer name
+     * \return Return the statistics, with a count of 0 if the timer is unknown
+     */
+    Stats getStats(const std::string& name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_entriesMutex);
+            auto handleIt = _handles.find(name);
+            if (handleIt != _handles.end())
+                return getStats(handleIt->second);
+        }
+
+        std::lock_guard<Spinlock> lock(_remoteStatsMutex);
+        auto statsIt = _remoteStats.find(name);
+        if (statsIt != _remoteStats.end())
+            return statsIt->second;
+        return {};
+    }
+
+    /**
+     * \brief Get the statistics of all timers, local ones and those received from other processes
+     * \param includeRemote If false, only the timers measured in this process are returned
+     * \return Return a map of the statistics, by timer name
+     */
+    std::unordered_map<std::string, Stats> getAllStats(bool includeRemote = true)
+    {
+        std::unordered_map<std::string, Stats> allStats;
+        if (includeRemote)
+        {
+            std::lock_guard<Spinlock> lock(_remoteStatsMutex);
+            allStats = _remoteStats;
+        }
+
+        auto entryCount = _entryCount.load(std::memory_order_acquire);
+        for (Handle handle = 0; handle < entryCount; ++handle)
+        {
+            auto stats = getStats(handle);
+            if (stats.count != 0)
+                allStats[getEntry(handle).name] = stats;
+        }
+
+        return allStats;
+    }
+
+    /**
+     * \brief Set the statistics of a timer measured in another process. Used for transmitting timings between pairs
+     * \param name Timer name
+     * \param stats Statistics
+     */
+    void setRemoteStats(const std::string& name, const Stats& stats)
+    {
+        std::lock_guard<Spinlock> lock(_remoteStatsMutex);
+        _remoteStats[name] = stats;
+    }
+
+    /**
+     * \brief Set the duration of the windows the statistics are computed over. They are computed over the last one to two windows.
+     * \param duration Window duration in us
+     */
+    void setStatsWindow(int64_t duration) { _statsWindow.store(std::max<int64_t>(duration, 1), std::memory_order_relaxed); }
+
+    /**
+     * \brief Clear the statistics of all local timers, and start new windows
+     * Values recorded concurrently may be lost
+     */
+    void resetStats()
+    {
+        auto currentTime = getTime();
+        auto entryCount = _entryCount.load(std::memory_order_acquire);
+        for (Handle handle = 0; handle < entryCount; ++handle)
+        {
+            auto& entry = getEntry(handle);
+            entry.windows[0].reset();
+            entry.windows[1].reset();
+            entry.windowStart.store(currentTime, std::memory_order_release);
+        }
+    }
+
+    /**
+     * \brief Convert statistics to Values, to send them through messages
+     * \param stats Statistics
+     * \return Return the statistics as {count, min, mean, p50, p95, p99, max}
+     */
+    static Values statsToValues(const Stats& stats)
+    {
+        return {static_cast<int64_t>(stats.count),
+            static_cast<int64_t>(stats.min),
+            static_cast<int64_t>(stats.mean),
+            static_cast<int64_t>(stats.p50),
+            static_cast<int64_t>(stats.p95),
+            static_cast<int64_t>(stats.p99),
+            static_cast<int64_t>(stats.max)};
+    }
+
+    /**
+     * \brief Convert Values back to statistics
+     * \param values Values, as output by statsToValues
+     * \param offset Index of the first value to read
+     * \param stats Statistics
+     * \return Return false if there are not enough values
+     */
+    static bool statsFromValues(const Values& values, size_t offset, Stats& stats)
+    {
+        if (values.size() < offset + 7)
+            return false;
+
+        stats.count = values[offset].as<int64_t>();
+        stats.min = values[offset + 1].as<int64_t>();
+        stats.mean = values[offset + 2].as<int64_t>();
+        stats.p50 = values[offset + 3].as<int64_t>();
+        stats.p95 = values[offset + 4].as<int64_t>();
+        stats.p99 = values[offset + 5].as<int64_t>();
+        stats.max = values[offset + 6].as<int64_t>();
+        return true;
+    }
+
     /**
      * \brief Start a duration measurement
      * \param name Duration name
@@ -86,12 +289,22 @@ class Timer
         if (!_enabled)
             return;
 
-        auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
-        auto timeIt = _timeMap.find(name);
-        if (timeIt == _timeMap.end())
-            _timeMap[name].store(currentTime, std::memory_order_acq_rel);
-        else
-            timeIt->second = currentTime;
+        auto currentTime = getTime();
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
+            auto timeIt = _timeMap.find(name);
+            if (timeIt != _timeMap.end())
+            {
+                timeIt->second.time.store(currentTime, std::memory_order_release);
+                return;
+            }
+        }
+
+        auto handle = getHandle(name);
+        std::unique_lock<std::shared_timed_mutex> lock(_mapsMutex);
+        auto& timePoint = _timeMap[name];
+        timePoint.handle = handle;
+        timePoint.time.store(currentTime, std::memory_order_release);
     }
 
     /**
@@ -103,17 +316,17 @@ class Timer
         if (!_enabled)
             return;
 
+        std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
         auto timeIt = _timeMap.find(name);
-        if (timeIt != _timeMap.end())
-        {
-            auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (timeIt == _timeMap.end())
+            return;
 
-            auto durationIt = _durationMap.find(name);
-            if (durationIt == _durationMap.end())
-                _durationMap[name].store(currentTime - timeIt->second.load(std::memory_order_acq_rel), std::memory_order_acq_rel);
-            else
-                durationIt->second = currentTime - timeIt->second.load(std::memory_order_acq_rel);
-        }
+        auto currentTime = getTime();
+        auto duration = currentTime - timeIt->second.time.load(std::memory_order_acquire);
+        record(timeIt->second.handle, duration, currentTime);
+        lock.unlock();
+
+        setDuration(name, duration);
     }
 
     /**
@@ -127,15 +340,15 @@ class Timer
         if (!_enabled)
             return false;
 
-        if (_timeMap.find(name) == _timeMap.end())
-            return false;
-
-        auto currentTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
         auto timeIt = _timeMap.find(name);
-        auto durationIt = _durationMap.find(name);
-        unsigned long long elapsed;
+        if (timeIt == _timeMap.end())
+            return false;
 
-        elapsed = currentTime - timeIt->second.load(std::memory_order_acq_rel);
+        auto currentTime = getTime();
+        unsigned long long elapsed = currentTime - timeIt->second.time.load(std::memory_order_acquire);
+        record(timeIt->second.handle, std::max(duration, elapsed), currentTime);
+        lock.unlock();
 
         timespec nap;
         nap.tv_sec = 0;
@@ -148,10 +361,7 @@ class Timer
             overtime = true;
         }
 
-        if (durationIt == _durationMap.end())
-            _durationMap[name].store(std::max(duration, elapsed), std::memory_order_acq_rel);
-        else
-            durationIt->second = std::max(duration, elapsed);
+        setDuration(name, std::max(duration, elapsed));
 
         nanosleep(&nap, NULL);
 
@@ -165,6 +375,7 @@ class Timer
      */
     unsigned long long getDuration(const std::string& name) const
     {
+        std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
         auto durationIt = _durationMap.find(name);
         if (durationIt == _durationMap.end())
             return 0;
@@ -173,10 +384,24 @@ class Timer
 
     /**
      * \brief Get the whole duration map
+     * Iterating over it is not thread-safe as timers can be added concurrently, prefer getDurations()
      * \return Return the whole duration map
      */
     const std::unordered_map<std::string, std::atomic_ullong>& getDurationMap() const { return _durationMap; }
 
+    /**
+     * \brief Get a copy of the last occurence of all durations
+     * \return Return a map of the durations in us, by timer name
+     */
+    std::unordered_map<std::string, unsigned long long> getDurations() const
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
+        std::unordered_map<std::string, unsigned long long> durations;
+        for (const auto& duration : _durationMap)
+            durations[duration.first] = duration.second;
+        return durations;
+    }
+
     /**
      * \brief Set an element in the duration map. Used for transmitting timings between pairs
      * \param name Duration name
@@ -184,11 +409,30 @@ class Timer
      */
     void setDuration(const std::string& name, unsigned long long value)
     {
-        auto durationIt = _durationMap.find(name);
-        if (durationIt == _durationMap.end())
-            _durationMap[name].store(value, std::memory_order_acq_rel);
-        else
-            durationIt->second = value;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
+            auto durationIt = _durationMap.find(name);
+            if (durationIt != _durationMap.end())
+            {
+                durationIt->second = value;
+                return;
+            }
+        }
+
+        std::unique_lock<std::shared_timed_mutex> lock(_mapsMutex);
+        _durationMap[name].store(value, std::memory_order_release);
+    }
+
+    /**
+     * \brief Get an element of the duration map, registering it if needed. Used for gauges, which hold the last value of a quantity
+     * The element stays valid for the lifetime of the Timer, so that it can be set repeatedly without any lookup
+     * \param name Gauge name
+     * \return Return the gauge value
+     */
+    std::atomic_ullong& getGauge(const std::string& name)
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(_mapsMutex);
+        return _durationMap[name];
     }
 
     /**
@@ -198,7 +442,13 @@ class Timer
      */
     unsigned long long sinceLastSeen(const std::string& name)
     {
-        if (_timeMap.find(name) == _timeMap.end())
+        bool isKnown = false;
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(_mapsMutex);
+            isKnown = _timeMap.find(name) != _timeMap.end();
+        }
+
+        if (!isKnown)
         {
             start(name);
             return 0;
@@ -331,15 +581,104 @@ class Timer
      */
     static inline int64_t getTime() { return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
 
+  private:
+    /**
+     * Start time of a timer used through the string API
+     */
+    struct TimePoint
+    {
+        std::atomic_llong time{0};
+        Handle handle{0};
+    };
+
+    /**
+     * Histograms of a registered timer. Two windows are used alternatively, the older one being
+     * cleared when the current one is older than the window duration.
+     */
+    struct Entry
+    {
+        Entry(const std::string& name, int64_t time)
+            : name(name)
+            , windowStart(time)
+        {
+        }
+
+        std::string name;
+        Histogram windows[2];
+        std::atomic_uint currentWindow{0};
+        std::atomic<int64_t> windowStart{0};
+    };
+
+    // Entries are allocated by blocks which never move, so that they can be read without locking while others are added
+    static const Handle _entriesPerBlock = 256;
+    static const Handle _maxBlocks = 256;
+    static const Handle _maxEntries = _entriesPerBlock * _maxBlocks;
+
   private:
     Timer() {}
     ~Timer() {}
     Timer(const Timer&) = delete;
     const Timer& operator=(const Timer&) = delete;
 
+    /**
+     * \brief Get the start times of the registered timers for the current thread
+     * \return Return the start times, indexed by handle
+     */
+    static std::vector<int64_t>& getThreadStartTimes()
+    {
+        static thread_local std::vector<int64_t> startTimes;
+        return startTimes;
+    }
+
+    /**
+     * \brief Get the entry of a registered timer
+     * \param handle Timer handle, lower than the entry count
+     * \return Return the entry
+     */
+    Entry& getEntry(Handle handle) const { return *_entryBlocks[handle / _entriesPerBlock][handle % _entriesPerBlock]; }
+
+    /**
+     * \brief Record a duration, rotating the windows if needed
+     * \param handle Timer handle
+     * \param duration Duration in us
+     * \param currentTime Current time in us
+     */
+    void record(Handle handle, unsigned long long duration, int64_t currentTime)
+    {
+        if (handle >= _entryCount.load(std::memory_order_acquire))
+            return;
+
+        auto& entry = getEntry(handle);
+        auto window = _statsWindow.load(std::memory_order_relaxed);
+        auto windowStart = entry.windowStart.load(std::memory_order_relaxed);
+        if (currentTime - windowStart >= window && entry.windowStart.compare_exchange_strong(windowStart, currentTime))
+        {
+            // Only the thread which won the exchange rotates the windows
+            auto current = entry.currentWindow.load(std::memory_order_relaxed);
+            auto next = 1 - current;
+            entry.windows[next].reset();
+            if (currentTime - windowStart >= 2 * window)
+                entry.windows[current].reset();
+            entry.currentWindow.store(next, std::memory_order_release);
+        }
+
+        entry.windows[entry.currentWindow.load(std::memory_order_acquire)].record(duration);
+    }
+
   private:
-    std::unordered_map<std::string, std::atomic_ullong> _timeMap;
+    mutable std::shared_timed_mutex _mapsMutex{}; //!< Locked exclusively when a timer is added to the string maps
+    std::unordered_map<std::string, TimePoint> _timeMap;
     std::unordered_map<std::string, std::atomic_ullong> _durationMap;
+
+    std::mutex _entriesMutex{}; //!< Only locked when registering timers
+    std::unordered_map<std::string, Handle> _handles{};
+    std::unique_ptr<std::unique_ptr<Entry>[]> _entryBlocks[_maxBlocks]{};
+    std::atomic<Handle> _entryCount{0};
+    std::atomic<int64_t> _statsWindow{1000000};
+
+    Spinlock _remoteStatsMutex{};
+    std::unordered_map<std::string, Stats> _remoteStats{};
+
     std::atomic_ullong _currentDuration{0};
     bool _isDurationSet{false};
     std::thread::id _durationThreadId;
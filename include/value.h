@@ -25,116 +25,170 @@
 #ifndef SPLASH_VALUE_H
 #define SPLASH_VALUE_H
 
-#include <deque>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace Splash
 {
 
 struct Value;
-typedef std::deque<Value> Values;
+
+/*************/
+/**
+ * Contiguous list of values. push_front and pop_front are kept from the time
+ * Values was a std::deque, but they are linear in the number of values.
+ */
+class Values : public std::vector<Value>
+{
+  public:
+    using std::vector<Value>::vector;
+    Values() = default;
+
+    void push_front(const Value& value);
+    void push_front(Value&& value);
+    void pop_front();
+};
 
 /*************/
 struct Value
 {
   public:
-    enum Type
+    enum Type : uint8_t
     {
-        i = 0,  // integer
-        f,      // float
-        s,      // string
-        v       // values
+        i = 0, // integer
+        f,     // float
+        s,     // string
+        v,     // values
+        fa,    // array of floats, stored contiguously
+        ia     // array of 32 bits integers, stored contiguously
     };
 
-    Value() {}
+    Value() { _storage.i = 0; }
 
     template <class T, typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
     Value(T v, std::string name = "")
-        : _i(v)
-        , _type(Type::i)
-        , _name(name)
+        : _type(Type::i)
     {
+        _storage.i = v;
+        setName(std::move(name));
     }
 
     template <class T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
     Value(T v, std::string name = "")
-        : _f(v)
-        , _type(Type::f)
-        , _name(name)
+        : _type(Type::f)
     {
+        _storage.f = v;
+        setName(std::move(name));
     }
 
     template <class T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
     Value(T v, std::string name = "")
-        : _s(v)
-        , _type(Type::s)
-        , _name(name)
+        : _type(Type::s)
     {
+        if (v.size() <= _inlineCapacity)
+            setInlineString(v.data(), v.size());
+        else
+            _storage.s = new std::string(std::move(v));
+        setName(std::move(name));
     }
 
     template <class T, typename std::enable_if<std::is_same<T, const char*>::value>::type* = nullptr>
     Value(T c, std::string name = "")
-        : _s(std::string(c))
-        , _type(Type::s)
-        , _name(name)
+        : _type(Type::s)
     {
+        auto length = strlen(c);
+        if (length <= _inlineCapacity)
+            setInlineString(c, length);
+        else
+            _storage.s = new std::string(c, length);
+        setName(std::move(name));
     }
 
     template <class T, typename std::enable_if<std::is_same<T, Values>::value>::type* = nullptr>
     Value(T v, std::string name = "")
-        : _v(std::unique_ptr<Values>(new Values(v)))
-        , _type(Type::v)
-        , _name(name)
+        : _type(Type::v)
     {
+        _storage.v = new Values(std::move(v));
+        setName(std::move(name));
+    }
+
+    template <class T, typename std::enable_if<std::is_same<T, std::vector<float>>::value>::type* = nullptr>
+    Value(T v, std::string name = "")
+        : _type(Type::fa)
+    {
+        _storage.fa = new std::vector<float>(std::move(v));
+        setName(std::move(name));
+    }
+
+    template <class T, typename std::enable_if<std::is_same<T, std::vector<int32_t>>::value>::type* = nullptr>
+    Value(T v, std::string name = "")
+        : _type(Type::ia)
+    {
+        _storage.ia = new std::vector<int32_t>(std::move(v));
+        setName(std::move(name));
+    }
+
+    template <class InputIt>
+    Value(InputIt first, InputIt last)
+        : _type(Type::v)
+    {
+        _storage.v = new Values();
+        auto it = first;
+        while (it != last)
+        {
+            _storage.v->push_back(Value(*it));
+            ++it;
+        }
     }
 
-    Value(const Value& v) { operator=(v); }
+    Value(const Value& v) { copyFrom(v); }
+    Value(Value&& v) noexcept { moveFrom(v); }
+    ~Value() { release(); }
 
     Value& operator=(const Value& v)
     {
         if (this != &v)
         {
-            _type = v._type;
-            switch (_type)
+            // Strings with a heap buffer reuse it
+            if (_type == Type::s && !_isInline && v._type == Type::s && !v._isInline)
             {
-            case Type::i:
-                _i = v._i;
-                break;
-            case Type::f:
-                _f = v._f;
-                break;
-            case Type::s:
-            case Type::v:
-                break;
+                *_storage.s = *v._storage.s;
             }
-            _name = v._name;
-            _s = v._s;
-            _v = std::unique_ptr<Values>(new Values());
-            if (v._v)
-                *_v = *(v._v);
+            else
+            {
+                release();
+                copyFrom(v);
+                return *this;
+            }
+
+            if (v._name)
+                setName(*v._name);
+            else
+                _name.reset();
         }
 
         return *this;
     }
 
-    Value& operator[](const std::string& name)
+    Value& operator=(Value&& v) noexcept
     {
-        _name = name;
+        if (this != &v)
+        {
+            release();
+            moveFrom(v);
+        }
+
         return *this;
     }
 
-    template <class InputIt>
-    Value(InputIt first, InputIt last)
-        : _type(Type::v)
-        , _v(std::unique_ptr<Values>(new Values()))
+    Value& operator[](const std::string& name)
     {
-        auto it = first;
-        while (it != last)
-        {
-            _v->push_back(Value(*it));
-            ++it;
-        }
+        setName(name);
+        return *this;
     }
 
     bool operator==(const Value& v) const
@@ -142,7 +196,7 @@ struct Value
         if (_type != v._type)
             return false;
 
-        if (_name != v._name)
+        if (isNamed() != v.isNamed() || (isNamed() && *_name != *v._name))
             return false;
 
         switch (_type)
@@ -150,29 +204,48 @@ struct Value
         default:
             return false;
         case Type::i:
-            return _i == v._i;
+            return _storage.i == v._storage.i;
         case Type::f:
-            return _f == v._f;
+            return _storage.f == v._storage.f;
         case Type::s:
-            return _s == v._s;
+            return size() == v.size() && memcmp(getChars(), v.getChars(), size()) == 0;
         case Type::v:
-            if (_v->size() != v._v->size())
+        {
+            if (_storage.v->size() != v._storage.v->size())
                 return false;
             bool isEqual = true;
-            for (int i = 0; i < _v->size(); ++i)
-                isEqual &= (_v->at(i) == v._v->at(i));
+            for (size_t i = 0; i < _storage.v->size(); ++i)
+                isEqual &= ((*_storage.v)[i] == (*v._storage.v)[i]);
             return isEqual;
         }
+        case Type::fa:
+            return *_storage.fa == *v._storage.fa;
+        case Type::ia:
+            return *_storage.ia == *v._storage.ia;
+        }
     }
 
     bool operator!=(const Value& v) const { return !operator==(v); }
 
+    /**
+     * \brief Access an element of a Values. For all other types, including numeric arrays, return the value itself
+     * \param index Element index
+     * \return Return the element
+     */
     Value& operator[](int index)
     {
         if (_type != Type::v)
             return *this;
         else
-            return _v->at(index);
+            return _storage.v->at(index);
+    }
+
+    const Value& operator[](int index) const
+    {
+        if (_type != Type::v)
+            return *this;
+        else
+            return _storage.v->at(index);
     }
 
     template <class T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
@@ -183,11 +256,11 @@ struct Value
         default:
             return "";
         case Type::i:
-            return std::to_string(_i);
+            return std::to_string(_storage.i);
         case Type::f:
-            return std::to_string(_f);
+            return std::to_string(_storage.f);
         case Type::s:
-            return _s;
+            return _isInline ? std::string(_storage.chars, _length) : *_storage.s;
         }
     }
 
@@ -199,13 +272,13 @@ struct Value
         default:
             return 0;
         case Type::i:
-            return _i;
+            return _storage.i;
         case Type::f:
-            return _f;
+            return _storage.f;
         case Type::s:
             try
             {
-                return std::stof(_s);
+                return std::stof(as<std::string>());
             }
             catch (...)
             {
@@ -222,13 +295,47 @@ struct Value
         default:
             return {};
         case Type::i:
-            return {_i};
+            return {_storage.i};
         case Type::f:
-            return {_f};
+            return {_storage.f};
         case Type::s:
-            return {_s};
+            return {as<std::string>()};
         case Type::v:
-            return *_v;
+            return *_storage.v;
+        case Type::fa:
+            return Values(_storage.fa->begin(), _storage.fa->end());
+        case Type::ia:
+            return Values(_storage.ia->begin(), _storage.ia->end());
+        }
+    }
+
+    /**
+     * \brief Get the content as a numeric array. Numbers, Values of numbers and numeric arrays of any type are converted.
+     * \return Return the array
+     */
+    template <class T,
+        typename std::enable_if<std::is_same<T, std::vector<float>>::value || std::is_same<T, std::vector<int32_t>>::value>::type* = nullptr>
+    T as() const
+    {
+        switch (_type)
+        {
+        default:
+            return {};
+        case Type::i:
+        case Type::f:
+            return {as<typename T::value_type>()};
+        case Type::v:
+        {
+            T array;
+            array.reserve(_storage.v->size());
+            for (const auto& value : *_storage.v)
+                array.push_back(value.as<typename T::value_type>());
+            return array;
+        }
+        case Type::fa:
+            return T(_storage.fa->begin(), _storage.fa->end());
+        case Type::ia:
+            return T(_storage.ia->begin(), _storage.ia->end());
         }
     }
 
@@ -239,23 +346,39 @@ struct Value
         default:
             return nullptr;
         case Type::i:
-            return (void*)&_i;
+            return (void*)&_storage.i;
         case Type::f:
-            return (void*)&_f;
+            return (void*)&_storage.f;
         case Type::s:
-            return (void*)_s.c_str();
+            return (void*)getChars();
+        case Type::fa:
+            return (void*)_storage.fa->data();
+        case Type::ia:
+            return (void*)_storage.ia->data();
         }
     }
 
-    std::string getName() const { return _name; }
-    void setName(const std::string& name) { _name = name; }
-    bool isNamed() const { return !_name.empty(); }
+    const void* data() const { return const_cast<Value*>(this)->data(); }
+
+    std::string getName() const { return _name ? *_name : std::string(); }
+    void setName(const std::string& name)
+    {
+        if (name.empty())
+            _name.reset();
+        else if (_name)
+            *_name = name;
+        else
+            _name = std::unique_ptr<std::string>(new std::string(name));
+    }
+    bool isNamed() const { return _name != nullptr; }
 
     Type getType() const { return _type; }
     char getTypeAsChar() const
     {
         switch (_type)
         {
+        default:
+            return 'n';
         case Type::i:
             return 'n';
         case Type::f:
@@ -263,10 +386,16 @@ struct Value
         case Type::s:
             return 's';
         case Type::v:
+        case Type::fa:
+        case Type::ia:
             return 'v';
         }
     }
 
+    /**
+     * \brief Get the size of the value: the byte count for numbers, the character count for strings and the element count otherwise
+     * \return Return the size
+     */
     int size() const
     {
         switch (_type)
@@ -274,27 +403,149 @@ struct Value
         default:
             return 0;
         case Type::i:
-            return sizeof(_i);
+            return sizeof(_storage.i);
         case Type::f:
-            return sizeof(_f);
+            return sizeof(_storage.f);
         case Type::s:
-            return _s.size();
+            return _isInline ? _length : _storage.s->size();
         case Type::v:
-            return _v->size();
+            return _storage.v->size();
+        case Type::fa:
+            return _storage.fa->size();
+        case Type::ia:
+            return _storage.ia->size();
         }
     }
 
   private:
-    Type _type{Type::i};
-    std::string _name{""};
-    union {
-        int64_t _i{0};
-        double _f;
+    static const size_t _inlineCapacity = 15; //!< Strings up to this length are stored inline, without allocation
+
+    union Storage {
+        int64_t i;
+        double f;
+        char chars[_inlineCapacity + 1];
+        std::string* s;
+        Values* v;
+        std::vector<float>* fa;
+        std::vector<int32_t>* ia;
     };
-    std::string _s{""};
-    std::unique_ptr<Values> _v{nullptr};
+
+    Storage _storage;
+    std::unique_ptr<std::string> _name{nullptr}; //!< Only allocated for named values
+    Type _type{Type::i};
+    bool _isInline{false}; //!< True if the string is held by _storage.chars
+    uint8_t _length{0};    //!< Length of the inline string
+
+    const char* getChars() const { return _isInline ? _storage.chars : _storage.s->c_str(); }
+
+    void setInlineString(const char* chars, size_t length)
+    {
+        memcpy(_storage.chars, chars, length);
+        _storage.chars[length] = '\0';
+        _length = static_cast<uint8_t>(length);
+        _isInline = true;
+    }
+
+    /**
+     * \brief Copy the given value, this one being empty
+     * \param v Value to copy
+     */
+    void copyFrom(const Value& v)
+    {
+        _type = v._type;
+        _isInline = v._isInline;
+        _length = v._length;
+        switch (_type)
+        {
+        default:
+            _storage = v._storage;
+            break;
+        case Type::s:
+            if (_isInline)
+                _storage = v._storage;
+            else
+                _storage.s = new std::string(*v._storage.s);
+            break;
+        case Type::v:
+            _storage.v = new Values(*v._storage.v);
+            break;
+        case Type::fa:
+            _storage.fa = new std::vector<float>(*v._storage.fa);
+            break;
+        case Type::ia:
+            _storage.ia = new std::vector<int32_t>(*v._storage.ia);
+            break;
+        }
+        if (v._name)
+            _name = std::unique_ptr<std::string>(new std::string(*v._name));
+    }
+
+    /**
+     * \brief Take the content of the given value, this one being empty. The given value is left as a null integer.
+     * \param v Value to move from
+     */
+    void moveFrom(Value& v) noexcept
+    {
+        _type = v._type;
+        _isInline = v._isInline;
+        _length = v._length;
+        _storage = v._storage;
+        _name = std::move(v._name);
+
+        v._type = Type::i;
+        v._isInline = false;
+        v._storage.i = 0;
+    }
+
+    /**
+     * \brief Free the heap storage, if any, leaving a null integer
+     */
+    void release()
+    {
+        switch (_type)
+        {
+        default:
+            break;
+        case Type::s:
+            if (!_isInline)
+                delete _storage.s;
+            break;
+        case Type::v:
+            delete _storage.v;
+            break;
+        case Type::fa:
+            delete _storage.fa;
+            break;
+        case Type::ia:
+            delete _storage.ia;
+            break;
+        }
+
+        _type = Type::i;
+        _isInline = false;
+        _storage.i = 0;
+        _name.reset();
+    }
 };
 
+/*************/
+inline void Values::push_front(const Value& value)
+{
+    insert(begin(), value);
+}
+
+/*************/
+inline void Values::push_front(Value&& value)
+{
+    insert(begin(), std::move(value));
+}
+
+/*************/
+inline void Values::pop_front()
+{
+    erase(begin());
+}
+
 } // end of namespace
 
 #endif // SPLASH_VALUE_H
@@ -36,6 +36,7 @@
 #include "./config.h"
 
 #include "./attribute.h"
+#include "./buffer_consumers.h"
 #include "./coretypes.h"
 #include "./factory.h"
 #if HAVE_PORTAUDIO
@@ -105,6 +106,12 @@ class World : public RootObject
     unsigned int _worldFramerate{60}; //!< World framerate, default 60, because synchronous tasks need the loop to run
     std::string _blendingMode{};      //!< Blending mode: can be none, once or continuous
     bool _runInBackground{false};     //!< If true, no window will be created
+    int64_t _timingsPeriod{250000};   //!< Period at which timings are sent to the master Scene, in us
+    int64_t _lastTimingsSent{0};      //!< Last time the timings were sent to the master Scene
+
+    // Distant attributes are only sent when they change
+    uint64_t _distantAttributesTick{0};      //!< Incremented at each World loop
+    std::atomic_bool _fullDistantSync{true}; //!< If true, all distant attributes are sent during the next loop
 
     bool _runAsChild{false}; //!< If true, runs as a child process
     std::string _childSceneName{"scene"};
@@ -118,6 +125,9 @@ class World : public RootObject
     std::atomic_int _nextId{0};
     std::map<std::string, std::vector<std::string>> _objectDest;
 
+    // Buffers are only serialized and sent if some Scene consumes them, and only to these Scenes
+    BufferConsumers _bufferConsumers{};
+
     std::string _configFilename;  //!< Configuration file path
     std::string _projectFilename; //!< Project configuration file path
     Json::Value _config;          //!< Configuration as JSon
@@ -129,6 +139,12 @@ class World : public RootObject
     // Synchronization testings
     int _swapSynchronizationTesting{0}; //!< If not 0, number of frames to keep the same color
 
+    // Benchmark mode
+    int64_t _benchmarkDuration{0};                  //!< Duration of the measures in us, 0 if not benchmarking
+    int64_t _benchmarkStart{0};                     //!< Time at which the measures start, after the warmup
+    bool _benchmarkStarted{false};                  //!< True once the warmup is over
+    static const int64_t _benchmarkWarmup{2000000}; //!< Warmup duration in us, not taken into account in the measures
+
     /**
      * \brief Add an object to the world (used for Images and Meshes currently)
      * \param type Object type
@@ -220,6 +236,16 @@ class World : public RootObject
      */
     bool loadProject(const std::string& filename);
 
+    /**
+     * \brief Print the results of the benchmark, gathering the timings from all Scenes
+     */
+    void printBenchmarkReport();
+
+    /**
+     * \brief Run the benchmark state machine: warmup, measures, then report and quit
+     */
+    void updateBenchmark();
+
     /**
      * \brief Parse the given arguments
      * \param argc Argument count
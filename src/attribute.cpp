@@ -10,6 +10,51 @@ namespace Splash
 
 atomic_uint CallbackHandle::_nextCallbackId{1};
 
+namespace
+{
+/*************/
+// Interned attribute names, shared by all AttributeHandles
+struct AttributeNames
+{
+    mutex namesMutex{};
+    unordered_map<string, uint32_t> ids{};
+    vector<string> names{};
+};
+
+AttributeNames& getAttributeNames()
+{
+    static AttributeNames attributeNames;
+    return attributeNames;
+}
+} // end of anonymous namespace
+
+/*************/
+AttributeHandle::AttributeHandle(const string& name)
+{
+    auto& attributeNames = getAttributeNames();
+    lock_guard<mutex> lock(attributeNames.namesMutex);
+    auto idIt = attributeNames.ids.find(name);
+    if (idIt != attributeNames.ids.end())
+    {
+        _id = idIt->second;
+        return;
+    }
+
+    _id = static_cast<uint32_t>(attributeNames.names.size());
+    attributeNames.ids.emplace(name, _id);
+    attributeNames.names.push_back(name);
+}
+
+/*************/
+string AttributeHandle::getName() const
+{
+    auto& attributeNames = getAttributeNames();
+    lock_guard<mutex> lock(attributeNames.namesMutex);
+    if (_id >= attributeNames.names.size())
+        return {};
+    return attributeNames.names[_id];
+}
+
 /*************/
 CallbackHandle::~CallbackHandle()
 {
@@ -52,6 +97,8 @@ AttributeFunctor& AttributeFunctor::operator=(AttributeFunctor&& a)
         _valuesTypes = move(a._valuesTypes);
         _defaultSetAndGet = move(a._defaultSetAndGet);
         _doUpdateDistant = move(a._doUpdateDistant);
+        _distantSnapshot = move(a._distantSnapshot);
+        _distantSnapshotVersion = move(a._distantSnapshotVersion);
         _savable = move(a._savable);
     }
 
@@ -127,6 +174,36 @@ Values AttributeFunctor::operator()() const
     return _getFunc();
 }
 
+/*************/
+void AttributeFunctor::get(Values& values) const
+{
+    if (!_getFunc && _defaultSetAndGet)
+    {
+        lock_guard<mutex> lock(_defaultFuncMutex);
+        values = _values;
+    }
+    else if (!_getFunc)
+    {
+        values.clear();
+    }
+    else
+    {
+        values = _getFunc();
+    }
+}
+
+/*************/
+uint64_t AttributeFunctor::updateDistantSnapshot(const Values& values, uint64_t tick)
+{
+    if (_distantSnapshotVersion == 0 || values != _distantSnapshot)
+    {
+        _distantSnapshot = values;
+        _distantSnapshotVersion = tick;
+    }
+
+    return _distantSnapshotVersion;
+}
+
 /*************/
 Values AttributeFunctor::getArgsTypes() const
 {
@@ -9,6 +9,9 @@ using namespace std;
 namespace Splash
 {
 
+atomic<uint64_t> BaseObject::_renderingStateVersion{0};
+atomic<uint64_t> BaseObject::_linksVersion{0};
+
 /*************/
 AttributeFunctor& BaseObject::operator[](const string& attr)
 {
@@ -17,10 +20,9 @@ AttributeFunctor& BaseObject::operator[](const string& attr)
 }
 
 /*************/
-void BaseObject::addTask(const function<void()>& task)
+void BaseObject::addTask(const function<void()>& task, const string& key)
 {
-    lock_guard<recursive_mutex> lock(_taskMutex);
-    _taskQueue.push_back(task);
+    _taskQueue.push(task, key);
 }
 
 /*************/
@@ -28,7 +30,10 @@ void BaseObject::linkToParent(BaseObject* obj)
 {
     auto parentIt = find(_parents.begin(), _parents.end(), obj);
     if (parentIt == _parents.end())
+    {
         _parents.push_back(obj);
+        _linksVersion.fetch_add(1, std::memory_order_release);
+    }
     return;
 }
 
@@ -37,7 +42,10 @@ void BaseObject::unlinkFromParent(BaseObject* obj)
 {
     auto parentIt = find(_parents.begin(), _parents.end(), obj);
     if (parentIt != _parents.end())
+    {
         _parents.erase(parentIt);
+        _linksVersion.fetch_add(1, std::memory_order_release);
+    }
     return;
 }
 
@@ -110,6 +118,7 @@ bool BaseObject::setAttribute(const string& attrib, const Values& args)
             return false;
 
         attribFunction = result.first;
+        setAttributeHandle(attrib, &attribFunction->second);
     }
 
     if (!attribFunction->second.isDefault())
@@ -119,6 +128,36 @@ bool BaseObject::setAttribute(const string& attrib, const Values& args)
     return attribResult && attribNotPresent;
 }
 
+/*************/
+bool BaseObject::setAttribute(const AttributeHandle& handle, const Values& args)
+{
+    auto attribute = findAttribute(handle);
+    if (!attribute)
+        return handle ? setAttribute(handle.getName(), args) : false;
+
+    if (!attribute->isDefault())
+        _updatedParams = true;
+    return (*attribute)(args);
+}
+
+/*************/
+bool BaseObject::getAttribute(const AttributeHandle& handle, Values& args, bool includeDistant, bool includeNonSavable) const
+{
+    auto attribute = findAttribute(handle);
+    if (!attribute)
+    {
+        args.clear();
+        return false;
+    }
+
+    attribute->get(args);
+
+    if ((!attribute->savable() && !includeNonSavable) || (attribute->isDefault() && !includeDistant))
+        return false;
+
+    return true;
+}
+
 /*************/
 bool BaseObject::getAttribute(const string& attrib, Values& args, bool includeDistant, bool includeNonSavable) const
 {
@@ -153,7 +192,7 @@ unordered_map<string, Values> BaseObject::getAttributes(bool includeDistant) con
 }
 
 /*************/
-unordered_map<string, Values> BaseObject::getDistantAttributes() const
+unordered_map<string, Values> BaseObject::getDistantAttributes(uint64_t tick, uint64_t sinceTick)
 {
     unordered_map<string, Values> attribs;
     for (auto& attr : _attribFunctions)
@@ -165,6 +204,9 @@ unordered_map<string, Values> BaseObject::getDistantAttributes() const
         if (getAttribute(attr.first, values, false, true) == false || values.size() == 0)
             continue;
 
+        if (attr.second.updateDistantSnapshot(values, tick) <= sinceTick)
+            continue;
+
         attribs[attr.first] = values;
     }
 
@@ -202,6 +244,10 @@ Json::Value BaseObject::getValuesAsJson(const Values& values, bool asObject) con
                     jsValue[v.getName()] = getValuesAsJson(vv, false);
                 break;
             }
+            case Value::fa:
+            case Value::ia:
+                jsValue[v.getName()] = getValuesAsJson(v.as<Values>(), false);
+                break;
             }
         }
     }
@@ -232,6 +278,10 @@ Json::Value BaseObject::getValuesAsJson(const Values& values, bool asObject) con
                     jsValue.append(getValuesAsJson(vv, false));
                 break;
             }
+            case Value::fa:
+            case Value::ia:
+                jsValue.append(getValuesAsJson(v.as<Values>(), false));
+                break;
             }
         }
     }
@@ -289,6 +339,15 @@ AttributeFunctor::Sync BaseObject::getAttributeSyncMethod(const string& name)
         return AttributeFunctor::Sync::no_sync;
 }
 
+/*************/
+bool BaseObject::isAttributeCoalescable(const string& name)
+{
+    auto attr = _attribFunctions.find(name);
+    if (attr == _attribFunctions.end())
+        return false;
+    return attr->second.hasGetter();
+}
+
 /*************/
 CallbackHandle BaseObject::registerCallback(const string& attr, AttributeFunctor::Callback cb)
 {
@@ -318,6 +377,7 @@ bool BaseObject::setRenderingPriority(Priority priority)
     if (priority < Priority::PRE_CAMERA || priority >= Priority::POST_WINDOW)
         return false;
     _renderingPriority = priority;
+    _renderingStateVersion.fetch_add(1, std::memory_order_release);
     return true;
 }
 
@@ -355,6 +415,7 @@ void BaseObject::registerAttributes()
     addAttribute("priorityShift",
         [&](const Values& args) {
             _priorityShift = args[0].as<int>();
+            _renderingStateVersion.fetch_add(1, std::memory_order_release);
             return true;
         },
         [&]() -> Values { return {_priorityShift}; },
@@ -390,17 +451,21 @@ void BaseObject::registerAttributes()
 /*************/
 AttributeFunctor& BaseObject::addAttribute(const string& name, const function<bool(const Values&)>& set, const vector<char>& types)
 {
-    _attribFunctions[name] = AttributeFunctor(name, set, types);
-    _attribFunctions[name].setObjectName(_type);
-    return _attribFunctions[name];
+    auto& attribute = _attribFunctions[name];
+    attribute = AttributeFunctor(name, set, types);
+    attribute.setObjectName(_type);
+    setAttributeHandle(name, &attribute);
+    return attribute;
 }
 
 /*************/
 AttributeFunctor& BaseObject::addAttribute(const string& name, const function<bool(const Values&)>& set, const function<const Values()>& get, const vector<char>& types)
 {
-    _attribFunctions[name] = AttributeFunctor(name, set, get, types);
-    _attribFunctions[name].setObjectName(_type);
-    return _attribFunctions[name];
+    auto& attribute = _attribFunctions[name];
+    attribute = AttributeFunctor(name, set, get, types);
+    attribute.setObjectName(_type);
+    setAttributeHandle(name, &attribute);
+    return attribute;
 }
 
 /*************/
@@ -426,7 +491,26 @@ void BaseObject::removeAttribute(const string& name)
 {
     auto attr = _attribFunctions.find(name);
     if (attr != _attribFunctions.end())
+    {
         _attribFunctions.erase(attr);
+        setAttributeHandle(name, nullptr);
+    }
+}
+
+/*************/
+void BaseObject::clearAttributes()
+{
+    _attribFunctions.clear();
+    _attribHandles.clear();
+}
+
+/*************/
+void BaseObject::setAttributeHandle(const string& name, AttributeFunctor* attribute)
+{
+    auto id = AttributeHandle(name).getId();
+    if (id >= _attribHandles.size())
+        _attribHandles.resize(id + 1, nullptr);
+    _attribHandles[id] = attribute;
 }
 
 /*************/
@@ -443,9 +527,6 @@ void BaseObject::setAttributeParameter(const string& name, bool savable, bool up
 /*************/
 void BaseObject::runTasks()
 {
-    lock_guard<recursive_mutex> lock(_taskMutex);
-    for (auto& task : _taskQueue)
-        task();
-    _taskQueue.clear();
+    _taskQueue.run();
 }
 }
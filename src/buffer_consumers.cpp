@@ -0,0 +1,100 @@
+#include "./buffer_consumers.h"
+
+#include "./base_object.h"
+#include "./buffer_object.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+unordered_set<string> BufferConsumers::getConsumedBuffers(const unordered_map<string, shared_ptr<BaseObject>>& objects)
+{
+    // Parents are raw pointers which may outlive their object, so only the given objects are followed
+    unordered_set<BaseObject*> registeredObjects;
+    for (const auto& obj : objects)
+        registeredObjects.insert(obj.second.get());
+
+    unordered_set<string> consumedBuffers;
+    for (const auto& obj : objects)
+    {
+        if (!dynamic_pointer_cast<BufferObject>(obj.second))
+            continue;
+
+        vector<BaseObject*> toVisit{obj.second.get()};
+        unordered_set<BaseObject*> visited{obj.second.get()};
+        bool isConsumed = false;
+        while (!toVisit.empty() && !isConsumed)
+        {
+            auto object = toVisit.back();
+            toVisit.pop_back();
+            for (auto parent : object->getParents())
+            {
+                if (registeredObjects.find(parent) == registeredObjects.end() || !visited.insert(parent).second)
+                    continue;
+
+                if (parent->getRenderingPriority() > BaseObject::Priority::MEDIA)
+                {
+                    isConsumed = true;
+                    break;
+                }
+                toVisit.push_back(parent);
+            }
+        }
+
+        // Objects are received under their key, which differs from their name for Queue sources
+        if (isConsumed)
+            consumedBuffers.insert(obj.first);
+    }
+
+    return consumedBuffers;
+}
+
+/*************/
+unordered_set<string> BufferConsumers::setConsumers(const string& scene, const unordered_set<string>& buffers)
+{
+    auto& sceneConsumers = _consumers[scene];
+    unordered_set<string> newBuffers;
+    for (const auto& name : buffers)
+        if (sceneConsumers.find(name) == sceneConsumers.end())
+            newBuffers.insert(name);
+
+    sceneConsumers = buffers;
+    updateDestinations();
+    return newBuffers;
+}
+
+/*************/
+void BufferConsumers::removeScene(const string& scene)
+{
+    if (_consumers.erase(scene) != 0)
+        updateDestinations();
+}
+
+/*************/
+void BufferConsumers::clear()
+{
+    _consumers.clear();
+    _destinations.clear();
+}
+
+/*************/
+const vector<string>* BufferConsumers::getDestinations(const string& buffer) const
+{
+    auto destinationsIt = _destinations.find(buffer);
+    if (destinationsIt == _destinations.end())
+        return nullptr;
+    return &destinationsIt->second;
+}
+
+/*************/
+void BufferConsumers::updateDestinations()
+{
+    _destinations.clear();
+    for (const auto& scene : _consumers)
+        for (const auto& name : scene.second)
+            _destinations[name].push_back(scene.first);
+}
+
+} // end of namespace
@@ -1,12 +1,20 @@
 #include "./buffer_object.h"
 
 #include "./root_object.h"
+#include "./thread_pool.h"
 
 using namespace std;
 
 namespace Splash
 {
 
+/*************/
+BufferObject::~BufferObject()
+{
+    // Contrary to the ones from std::async, futures from the pool do not wait on destruction
+    ThreadPool::get().waitFor(_deserializeFuture);
+}
+
 /**************/
 void BufferObject::setNotUpdated()
 {
@@ -36,7 +44,7 @@ void BufferObject::setSerializedObject(shared_ptr<SerializedObject> obj)
         _newSerializedObject = true;
 
         // Deserialize it right away, in a separate thread
-        _deserializeFuture = async(launch::async, [this]() {
+        _deserializeFuture = ThreadPool::get().enqueue([this]() {
             lock_guard<shared_timed_mutex> lock(_writeMutex);
             deserialize();
             _serializedObjectWaiting.store(false, std::memory_order_acq_rel);
@@ -50,7 +58,7 @@ void BufferObject::updateTimestamp()
     _timestamp = Timer::getTime();
     _updatedBuffer = true;
     if (_root)
-        _root->signalBufferObjectUpdated();
+        _root->signalBufferObjectUpdated(_name);
 }
 
 } // end of namespace
@@ -0,0 +1,214 @@
+#include "./buffer_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sys/mman.h>
+
+using namespace std;
+
+namespace Splash
+{
+
+const size_t BufferPool::cacheLineSize;
+const size_t BufferPool::pageSize;
+const size_t BufferPool::hugePageSize;
+
+/*************/
+void* BufferPool::allocate(size_t size, size_t& capacity)
+{
+    capacity = 0;
+    if (size == 0)
+        return nullptr;
+
+    auto classSize = getClassSize(size);
+    size_t alignment = cacheLineSize;
+    bool useHugePages = false;
+
+    {
+        lock_guard<mutex> lock(_mutex);
+        auto cachedIt = _cachedBuffers.find(classSize);
+        if (cachedIt != _cachedBuffers.end() && !cachedIt->second.empty())
+        {
+            // The most recently released buffer is the most likely to still be in cache
+            auto buffer = cachedIt->second.back().buffer;
+            cachedIt->second.pop_back();
+            _bytesCached.fetch_sub(classSize, memory_order_relaxed);
+            _bytesInUse.fetch_add(classSize, memory_order_relaxed);
+            capacity = classSize;
+            return buffer;
+        }
+
+        if (_hugePages && classSize >= hugePageSize)
+        {
+            alignment = hugePageSize;
+            useHugePages = true;
+        }
+        else if (classSize >= pageSize)
+        {
+            alignment = pageSize;
+        }
+    }
+
+    void* buffer = nullptr;
+    if (posix_memalign(&buffer, alignment, classSize) != 0)
+        return nullptr;
+
+#ifdef MADV_HUGEPAGE
+    if (useHugePages)
+        madvise(buffer, classSize, MADV_HUGEPAGE);
+#else
+    (void)useHugePages;
+#endif
+
+    _bytesInUse.fetch_add(classSize, memory_order_relaxed);
+    capacity = classSize;
+    return buffer;
+}
+
+/*************/
+void BufferPool::release(void* buffer, size_t capacity)
+{
+    if (!buffer)
+        return;
+
+    _bytesInUse.fetch_sub(capacity, memory_order_relaxed);
+
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (capacity <= _cacheSize)
+        {
+            shrinkCache(_cacheSize - capacity);
+            _cachedBuffers[capacity].push_back({buffer, getTime()});
+            _bytesCached.fetch_add(capacity, memory_order_relaxed);
+            return;
+        }
+    }
+
+    free(buffer);
+}
+
+/*************/
+size_t BufferPool::getClassSize(size_t size)
+{
+    if (size <= cacheLineSize)
+        return cacheLineSize;
+
+    size_t power = cacheLineSize;
+    while (power * 2 < size)
+        power *= 2;
+
+    auto step = max(power / 4, cacheLineSize);
+    return (size + step - 1) / step * step;
+}
+
+/*************/
+void BufferPool::setCacheSize(size_t size)
+{
+    lock_guard<mutex> lock(_mutex);
+    _cacheSize = size;
+    shrinkCache(_cacheSize);
+}
+
+/*************/
+size_t BufferPool::getCacheSize() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _cacheSize;
+}
+
+/*************/
+void BufferPool::setMaxAge(int64_t age)
+{
+    lock_guard<mutex> lock(_mutex);
+    _maxAge = max<int64_t>(age, 0);
+}
+
+/*************/
+int64_t BufferPool::getMaxAge() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _maxAge;
+}
+
+/*************/
+void BufferPool::setHugePages(bool enable)
+{
+    lock_guard<mutex> lock(_mutex);
+    if (_hugePages == enable)
+        return;
+
+    // Cached buffers do not have the right alignment anymore
+    _hugePages = enable;
+    shrinkCache(0);
+}
+
+/*************/
+bool BufferPool::getHugePages() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _hugePages;
+}
+
+/*************/
+void BufferPool::trim()
+{
+    lock_guard<mutex> lock(_mutex);
+    shrinkCache(0);
+}
+
+/*************/
+void BufferPool::releaseExpired()
+{
+    lock_guard<mutex> lock(_mutex);
+    auto expirationTime = getTime() - _maxAge;
+    for (auto cachedIt = _cachedBuffers.begin(); cachedIt != _cachedBuffers.end();)
+    {
+        auto& buffers = cachedIt->second;
+        while (!buffers.empty() && buffers.front().releaseTime <= expirationTime)
+        {
+            free(buffers.front().buffer);
+            buffers.pop_front();
+            _bytesCached.fetch_sub(cachedIt->first, memory_order_relaxed);
+        }
+
+        if (buffers.empty())
+            cachedIt = _cachedBuffers.erase(cachedIt);
+        else
+            ++cachedIt;
+    }
+}
+
+/*************/
+int64_t BufferPool::getTime()
+{
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*************/
+void BufferPool::shrinkCache(size_t size)
+{
+    while (_bytesCached.load(memory_order_relaxed) > size)
+    {
+        // The least recently released buffer of each class is the first one, the oldest of them goes first
+        auto oldestIt = _cachedBuffers.end();
+        for (auto cachedIt = _cachedBuffers.begin(); cachedIt != _cachedBuffers.end(); ++cachedIt)
+        {
+            if (cachedIt->second.empty())
+                continue;
+            if (oldestIt == _cachedBuffers.end() || cachedIt->second.front().releaseTime < oldestIt->second.front().releaseTime)
+                oldestIt = cachedIt;
+        }
+
+        if (oldestIt == _cachedBuffers.end())
+            return;
+
+        free(oldestIt->second.front().buffer);
+        oldestIt->second.pop_front();
+        _bytesCached.fetch_sub(oldestIt->first, memory_order_relaxed);
+        if (oldestIt->second.empty())
+            _cachedBuffers.erase(oldestIt);
+    }
+}
+
+} // end of namespace
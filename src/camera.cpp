@@ -90,6 +90,9 @@ Camera::Camera(RootObject* root)
 /*************/
 Camera::~Camera()
 {
+    if (_cameraUniformsBuffer != 0)
+        glDeleteBuffers(1, &_cameraUniformsBuffer);
+
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Camera::~Camera - Destructor" << Log::endl;
 #endif
@@ -593,6 +596,8 @@ void Camera::render()
 
     if (!_hidden)
     {
+        updateCameraUniforms();
+
         // Draw the objects
         for (auto& o : _objects)
         {
@@ -602,27 +607,12 @@ void Camera::render()
 
             obj->activate();
 
-            vec2 colorBalance = colorBalanceFromTemperature(_colorTemperature);
-            obj->getShader()->setAttribute("uniform", {"_wireframeColor", _wireframeColor.x, _wireframeColor.y, _wireframeColor.z, _wireframeColor.w});
-            obj->getShader()->setAttribute("uniform", {"_cameraAttributes", _blendWidth, _brightness});
-            obj->getShader()->setAttribute("uniform", {"_fovAndColorBalance", _fov * _width / _height * M_PI / 180.0, _fov * M_PI / 180.0, colorBalance.x, colorBalance.y});
-            obj->getShader()->setAttribute("uniform", {"_showCameraCount", (int)_showCameraCount});
-            if (_colorLUT.size() == 768 && _isColorLUTActivated)
-            {
-                obj->getShader()->setAttribute("uniform", {"_colorLUT", _colorLUT});
-                obj->getShader()->setAttribute("uniform", {"_isColorLUT", 1});
-
-                Values m(10);
-                m[0] = "_colorMixMatrix";
-                for (int u = 0; u < 3; ++u)
-                    for (int v = 0; v < 3; ++v)
-                        m[u * 3 + v + 1] = _colorMixMatrix[u][v];
-                obj->getShader()->setAttribute("uniform", m);
-            }
-            else
-            {
-                obj->getShader()->setAttribute("uniform", {"_isColorLUT", 0});
-            }
+            // Shaders which do not use the CameraUniforms block get these as regular uniforms, only sent if they changed
+            auto shader = obj->getShader();
+            shader->setUniform("_wireframeColor", _cameraUniforms.wireframeColor, 4);
+            shader->setUniform("_cameraAttributes", _cameraUniforms.cameraAttributes, 2);
+            shader->setUniform("_fovAndColorBalance", _cameraUniforms.fovAndColorBalance, 4);
+            shader->setUniform("_showCameraCount", &_cameraUniforms.showCameraCount, 1);
 
             obj->setViewProjectionMatrix(computeViewMatrix(), computeProjectionMatrix());
             obj->draw();
@@ -899,12 +889,15 @@ double Camera::cameraCalibration_f(const gsl_vector* v, void* params)
     double cy = gsl_vector_get(v, 2);
 
     // Check whether the camera parameters are locked
-    if (camera["fov"].isLocked())
-        fov = camera["fov"]()[0].as<float>();
-    if (camera["principalPoint"].isLocked())
+    static const AttributeHandle fovAttribute("fov");
+    static const AttributeHandle principalPointAttribute("principalPoint");
+    if (camera[fovAttribute].isLocked())
+        fov = camera[fovAttribute]()[0].as<float>();
+    if (camera[principalPointAttribute].isLocked())
     {
-        cx = camera["principalPoint"]()[0].as<float>();
-        cy = camera["principalPoint"]()[1].as<float>();
+        auto principalPoint = camera[principalPointAttribute]();
+        cx = principalPoint[0].as<float>();
+        cy = principalPoint[1].as<float>();
     }
 
     // Some limits for the calibration parameters
@@ -1052,6 +1045,58 @@ void Camera::sendCalibrationPointsToObjects()
     }
 }
 
+/*************/
+void Camera::updateCameraUniforms()
+{
+    const GLsizeiptr lutSize = 256 * 4 * sizeof(float);
+
+    bool isNewBuffer = false;
+    if (_cameraUniformsBuffer == 0)
+    {
+        glCreateBuffers(1, &_cameraUniformsBuffer);
+        glNamedBufferData(_cameraUniformsBuffer, sizeof(CameraUniforms) + lutSize, nullptr, GL_DYNAMIC_DRAW);
+        isNewBuffer = true;
+        _updateColorLUT = true;
+    }
+
+    vec2 colorBalance = colorBalanceFromTemperature(_colorTemperature);
+    bool isColorLUT = _colorLUT.size() == 768 && _isColorLUTActivated;
+
+    CameraUniforms uniforms{};
+    for (int i = 0; i < 4; ++i)
+        uniforms.wireframeColor[i] = _wireframeColor[i];
+    uniforms.fovAndColorBalance[0] = _fov * _width / _height * M_PI / 180.0;
+    uniforms.fovAndColorBalance[1] = _fov * M_PI / 180.0;
+    uniforms.fovAndColorBalance[2] = colorBalance.x;
+    uniforms.fovAndColorBalance[3] = colorBalance.y;
+    uniforms.cameraAttributes[0] = _blendWidth;
+    uniforms.cameraAttributes[1] = _brightness;
+    uniforms.showCameraCount = _showCameraCount;
+    uniforms.isColorLUT = isColorLUT;
+    for (int u = 0; u < 3; ++u)
+        for (int v = 0; v < 3; ++v)
+            uniforms.colorMixMatrix[u * 4 + v] = isColorLUT ? _colorMixMatrix[u][v] : (u == v ? 1.f : 0.f);
+
+    if (isNewBuffer || memcmp(&uniforms, &_cameraUniforms, sizeof(CameraUniforms)) != 0)
+    {
+        _cameraUniforms = uniforms;
+        glNamedBufferSubData(_cameraUniformsBuffer, 0, sizeof(CameraUniforms), &_cameraUniforms);
+    }
+
+    // The LUT is only sent when it is modified
+    if (isColorLUT && _updateColorLUT)
+    {
+        vector<float> lut(256 * 4, 0.f);
+        for (int i = 0; i < 256; ++i)
+            for (int c = 0; c < 3; ++c)
+                lut[i * 4 + c] = _colorLUT[i * 3 + c].as<float>();
+        glNamedBufferSubData(_cameraUniformsBuffer, sizeof(CameraUniforms), lutSize, lut.data());
+        _updateColorLUT = false;
+    }
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::cameraUniformsBinding, _cameraUniformsBuffer);
+}
+
 /*************/
 void Camera::registerAttributes()
 {
@@ -1409,6 +1454,7 @@ void Camera::registerAttributes()
                     return false;
 
             _colorLUT = args[0].as<Values>();
+            _updateColorLUT = true;
 
             return true;
         },
@@ -2,6 +2,8 @@
 
 #include <future>
 
+#include "thread_pool.h"
+
 using namespace std;
 
 namespace Splash
@@ -12,7 +14,8 @@ void hapDecodeCallback(HapDecodeWorkFunction func, void* p, unsigned int count,
 {
     vector<future<void>> threads;
     for (unsigned int i = 0; i < count; ++i)
-        threads.push_back(async(launch::async, [=]() { func(p, i); }));
+        threads.push_back(ThreadPool::get().enqueue([=]() { func(p, i); }));
+    ThreadPool::get().waitFor(threads);
 }
 
 /*************/
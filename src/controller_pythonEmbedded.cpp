@@ -748,7 +748,7 @@ PyDoc_STRVAR(pythonGetTimings_doc__,
 
 PyObject* PythonEmbedded::pythonGetTimings(PyObject* self, PyObject* args)
 {
-    auto& timings = Timer::get().getDurationMap();
+    auto timings = Timer::get().getDurations();
     PyObject* pythonTimerDict = PyDict_New();
     for (auto& t : timings)
     {
@@ -760,6 +760,46 @@ PyObject* PythonEmbedded::pythonGetTimings(PyObject* self, PyObject* args)
     return pythonTimerDict;
 }
 
+/*************/
+PyDoc_STRVAR(pythonGetTimingStats_doc__,
+    "Get the statistics of the timings from Splash, over the last second, in microseconds\n"
+    "\n"
+    "splash.get_timing_stats()\n"
+    "\n"
+    "Returns:\n"
+    "  A dict of the timers, each one being a dict with keys count, min, mean, p50, p95, p99 and max\n"
+    "\n"
+    "Raises:\n"
+    "  splash.error: if Splash instance is not available");
+
+PyObject* PythonEmbedded::pythonGetTimingStats(PyObject* self, PyObject* args)
+{
+    auto allStats = Timer::get().getAllStats();
+    PyObject* pythonStatsDict = PyDict_New();
+    for (auto& t : allStats)
+    {
+        PyObject* val = Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+            "count",
+            static_cast<unsigned long long>(t.second.count),
+            "min",
+            static_cast<unsigned long long>(t.second.min),
+            "mean",
+            static_cast<unsigned long long>(t.second.mean),
+            "p50",
+            static_cast<unsigned long long>(t.second.p50),
+            "p95",
+            static_cast<unsigned long long>(t.second.p95),
+            "p99",
+            static_cast<unsigned long long>(t.second.p99),
+            "max",
+            static_cast<unsigned long long>(t.second.max));
+        PyDict_SetItemString(pythonStatsDict, t.first.c_str(), val);
+        Py_DECREF(val);
+    }
+
+    return pythonStatsDict;
+}
+
 /*************/
 PyDoc_STRVAR(pythonGetMasterClock_doc__,
     "Get the master clock from Splash, in milliseconds\n"
@@ -1648,6 +1688,7 @@ PyMethodDef PythonEmbedded::SplashMethods[] = {
     {(const char*)"get_object_list", (PyCFunction)PythonEmbedded::pythonGetObjectList, METH_VARARGS, pythonGetObjectList_doc__},
     {(const char*)"get_logs", (PyCFunction)PythonEmbedded::pythonGetLogs, METH_VARARGS, pythonGetLogs_doc__},
     {(const char*)"get_timings", (PyCFunction)PythonEmbedded::pythonGetTimings, METH_VARARGS, pythonGetTimings_doc__},
+    {(const char*)"get_timing_stats", (PyCFunction)PythonEmbedded::pythonGetTimingStats, METH_VARARGS, pythonGetTimingStats_doc__},
     {(const char*)"get_master_clock", (PyCFunction)PythonEmbedded::pythonGetMasterClock, METH_VARARGS, pythonGetMasterClock_doc__},
     {(const char*)"get_object_types", (PyCFunction)PythonEmbedded::pythonGetObjectTypes, METH_VARARGS, pythonGetObjectTypes_doc__},
     {(const char*)"get_object_description", (PyCFunction)PythonEmbedded::pythonGetObjectDescription, METH_VARARGS, pythonGetObjectDescription_doc__},
@@ -1923,7 +1964,7 @@ PyObject* PythonEmbedded::convertFromValue(const Value& value, bool toDict)
             pyValue = Py_BuildValue("f", v.as<float>());
         else if (v.getType() == Value::Type::s)
             pyValue = Py_BuildValue("s", v.as<string>().c_str());
-        else if (v.getType() == Value::Type::v)
+        else if (v.getTypeAsChar() == 'v') // Values and numeric arrays
         {
             auto values = v.as<Values>();
             if (toDict)
@@ -17,6 +17,7 @@
 #include "./image_gphoto.h"
 #endif
 #include "./image_ffmpeg.h"
+#include "./image_synthetic.h"
 #if HAVE_OPENCV
 #include "./image_opencv.h"
 #endif
@@ -290,6 +291,20 @@ void Factory::registerObjects()
         "Image object reading frames from a video file.",
         true);
 
+    _objectBook["image_synthetic"] = Page(
+        [&]() {
+            shared_ptr<BaseObject> object;
+            if (!_scene)
+                object = dynamic_pointer_cast<BaseObject>(make_shared<Image_Synthetic>(_root));
+            else
+                object = dynamic_pointer_cast<BaseObject>(make_shared<Image>(_root));
+            return object;
+        },
+        BaseObject::Category::IMAGE,
+        "synthetic image",
+        "Image object generating frames at a given resolution and rate, for benchmarking purposes.",
+        true);
+
 #if HAVE_GPHOTO
     _objectBook["image_gphoto"] = Page(
         [&]() {
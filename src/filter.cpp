@@ -312,7 +312,7 @@ bool Filter::setFilterSource(const string& source)
     _screen->deactivate();
 
     // Unregister previous automatically added uniforms
-    _attribFunctions.clear();
+    clearAttributes();
     registerAttributes();
 
     // Register the attributes corresponding to the shader uniforms
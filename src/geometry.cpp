@@ -173,7 +173,35 @@ bool Geometry::deserialize(const shared_ptr<SerializedObject>& obj)
         return false;
     }
 
-    _serializedMesh = std::move(*obj);
+    _serializedMesh = obj;
+    return true;
+}
+
+/*************/
+shared_ptr<BufferSnapshot> Geometry::getSnapshot() const
+{
+    // The buffers are read back once, and the result is shared as is
+    shared_ptr<const SerializedObject> serializedMesh = serialize();
+    return make_shared<SharedBufferSnapshot<SerializedObject>>(serializedMesh);
+}
+
+/*************/
+bool Geometry::setSnapshot(const shared_ptr<BufferSnapshot>& snapshot)
+{
+    auto geometrySnapshot = dynamic_pointer_cast<SharedBufferSnapshot<SerializedObject>>(snapshot);
+    if (!geometrySnapshot || !geometrySnapshot->content || geometrySnapshot->content->size() < sizeof(int))
+        return false;
+
+    const auto& serializedMesh = geometrySnapshot->content;
+    auto verticesNumber = *(int*)(serializedMesh->data());
+    if (serializedMesh->size() != verticesNumber * 4 * 14 + 4)
+    {
+        Log::get() << Log::WARNING << "Geometry::" << __FUNCTION__ << " - Shared buffer size does not match its header. Dropping." << Log::endl;
+        return false;
+    }
+
+    lock_guard<shared_timed_mutex> lock(_writeMutex);
+    _serializedMesh = serializedMesh;
     return true;
 }
 
@@ -204,8 +232,8 @@ float Geometry::pickVertex(dvec3 p, dvec3& v)
         return distance;
     auto mesh = _mesh.lock();
 
-    vector<float> vertices = mesh->getVertCoords();
-    for (int i = 0; i < vertices.size(); i += 4)
+    auto vertices = mesh->getVertCoordsView();
+    for (size_t i = 0; i < vertices.size(); i += 4)
     {
         dvec3 vertex(vertices[i], vertices[i + 1], vertices[i + 2]);
         float dist = length(p - vertex);
@@ -250,24 +278,25 @@ void Geometry::update()
     {
         mesh->update();
 
-        vector<float> vertices = mesh->getVertCoords();
+        // Views keep the mesh alive without copying it, until the GPU buffers are filled
+        auto vertices = mesh->getVertCoordsView();
         if (vertices.size() == 0)
             return;
         _verticesNumber = vertices.size() / 4;
         _glBuffers[0] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _verticesNumber, vertices.data());
 
-        vector<float> texcoords = mesh->getUVCoords();
+        auto texcoords = mesh->getUVCoordsView();
         if (texcoords.size() == 0)
             return;
         _glBuffers[1] = make_shared<GpuBuffer>(2, GL_FLOAT, GL_STATIC_DRAW, _verticesNumber, texcoords.data());
 
-        vector<float> normals = mesh->getNormals();
+        auto normals = mesh->getNormalsView();
         if (normals.size() == 0)
             return;
         _glBuffers[2] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _verticesNumber, normals.data());
 
         // An additional annexe buffer, to be filled by compute shaders. Contains a vec4 for each vertex
-        vector<float> annexe = mesh->getAnnexe();
+        auto annexe = mesh->getAnnexeView();
         if (annexe.size() == 0)
             _glBuffers[3] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _verticesNumber, nullptr);
         else
@@ -296,38 +325,45 @@ void Geometry::update()
     }
 
     // If a serialized geometry is present, we use it as the alternative buffer
-    if (!_onMasterScene && _serializedMesh.size() != 0)
+    shared_ptr<const SerializedObject> serializedMesh{};
+    if (!_onMasterScene)
+    {
+        shared_lock<shared_timed_mutex> lock(_writeMutex);
+        serializedMesh = _serializedMesh;
+    }
+
+    if (serializedMesh && serializedMesh->size() != 0)
     {
         lock_guard<shared_timed_mutex> lock(_writeMutex);
 
         if (_glTemporaryBuffers.size() != 4)
             _glTemporaryBuffers.resize(4);
 
-        _temporaryVerticesNumber = *(int*)(_serializedMesh.data());
+        _temporaryVerticesNumber = *(int*)(serializedMesh->data());
         _temporaryBufferSize = _temporaryVerticesNumber;
 
         if (!_glTemporaryBuffers[0])
-            _glTemporaryBuffers[0] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, _serializedMesh.data() + 4);
+            _glTemporaryBuffers[0] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, serializedMesh->data() + 4);
         else
-            _glTemporaryBuffers[0]->setBufferFromVector(vector<char>(_serializedMesh.data() + 4, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 4));
+            _glTemporaryBuffers[0]->setBufferFromVector(vector<char>(serializedMesh->data() + 4, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 4));
 
         if (!_glTemporaryBuffers[1])
-            _glTemporaryBuffers[1] = make_shared<GpuBuffer>(2, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 4);
+            _glTemporaryBuffers[1] = make_shared<GpuBuffer>(2, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 4);
         else
             _glTemporaryBuffers[1]->setBufferFromVector(
-                vector<char>(_serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 4, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 6));
+                vector<char>(serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 4, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 6));
 
         if (!_glTemporaryBuffers[2])
-            _glTemporaryBuffers[2] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 6);
+            _glTemporaryBuffers[2] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 6);
         else
             _glTemporaryBuffers[2]->setBufferFromVector(
-                vector<char>(_serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 6, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 10));
+                vector<char>(serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 6, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 10));
 
         if (!_glTemporaryBuffers[3])
-            _glTemporaryBuffers[3] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 10);
+            _glTemporaryBuffers[3] = make_shared<GpuBuffer>(4, GL_FLOAT, GL_STATIC_DRAW, _temporaryVerticesNumber, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 10);
         else
             _glTemporaryBuffers[3]->setBufferFromVector(
-                vector<char>(_serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 10, _serializedMesh.data() + 4 + _temporaryVerticesNumber * 4 * 14));
+                vector<char>(serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 10, serializedMesh->data() + 4 + _temporaryVerticesNumber * 4 * 14));
 
         swapBuffers();
         _buffersDirty = true;
@@ -6,7 +6,7 @@ namespace Splash
 {
 
 /*************/
-GpuBuffer::GpuBuffer(GLint elementSize, GLenum type, GLenum usage, size_t size, GLvoid* data)
+GpuBuffer::GpuBuffer(GLint elementSize, GLenum type, GLenum usage, size_t size, const GLvoid* data)
 {
     glCreateBuffers(1, &_glId);
     switch (type)
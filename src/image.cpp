@@ -11,10 +11,10 @@
 
 #include "./log.h"
 #include "./osUtils.h"
+#include "./thread_pool.h"
 #include "./timer.h"
 
 #define SPLASH_IMAGE_COPY_THREADS 2
-#define SPLASH_IMAGE_SERIALIZED_HEADER_SIZE 4096
 
 using namespace std;
 
@@ -97,19 +97,17 @@ void Image::set(const ImageBuffer& img)
 {
     lock_guard<Spinlock> lockRead(_readMutex);
     if (_image)
-        *_image = img;
+        _image = make_shared<ImageBuffer>(img);
 }
 
 /*************/
 void Image::set(unsigned int w, unsigned int h, unsigned int channels, ImageBufferSpec::Type type)
 {
     ImageBufferSpec spec(w, h, channels, 8 * sizeof(channels) * (int)type, type);
-    ImageBuffer img(spec);
+    auto img = make_shared<ImageBuffer>(spec);
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = unique_ptr<ImageBuffer>(new ImageBuffer());
-    std::swap(*_image, img);
+    _image = std::move(img);
     updateTimestamp();
 }
 
@@ -121,24 +119,16 @@ shared_ptr<SerializedObject> Image::serialize() const
     if (Timer::get().isDebug())
         Timer::get() << "serialize " + _name;
 
-    // We first get the xml version of the specs, and pack them into the obj
+    // We first write the binary header holding the specs, the image following it
     if (!_image)
         return {};
-    string xmlSpec = _image->getSpec().to_string();
-    int nbrChar = xmlSpec.size();
-    int imgSize = _image->getSpec().rawSize();
-    int totalSize = SPLASH_IMAGE_SERIALIZED_HEADER_SIZE + imgSize;
+    auto spec = _image->getSpec();
+    int imgSize = spec.rawSize();
+    int totalSize = ImageBufferSpec::headerSize + imgSize;
 
     auto obj = make_shared<SerializedObject>(totalSize);
-
-    auto currentObjPtr = obj->data();
-    const char* ptr = reinterpret_cast<const char*>(&nbrChar);
-    copy(ptr, ptr + sizeof(nbrChar), currentObjPtr);
-    currentObjPtr += sizeof(nbrChar);
-
-    const char* charPtr = reinterpret_cast<const char*>(xmlSpec.c_str());
-    copy(charPtr, charPtr + nbrChar, currentObjPtr);
-    currentObjPtr = obj->data() + SPLASH_IMAGE_SERIALIZED_HEADER_SIZE;
+    spec.writeHeader(obj->data());
+    auto currentObjPtr = obj->data() + ImageBufferSpec::headerSize;
 
     // And then, the image
     const char* imgPtr = reinterpret_cast<const char*>(_image->data());
@@ -149,8 +139,9 @@ shared_ptr<SerializedObject> Image::serialize() const
         vector<future<void>> threads;
         int stride = SPLASH_IMAGE_COPY_THREADS;
         for (int i = 0; i < stride - 1; ++i)
-            threads.push_back(async(launch::async, ([=]() { copy(imgPtr + imgSize / stride * i, imgPtr + imgSize / stride * (i + 1), currentObjPtr + imgSize / stride * i); })));
+            threads.push_back(ThreadPool::get().enqueue([=]() { copy(imgPtr + imgSize / stride * i, imgPtr + imgSize / stride * (i + 1), currentObjPtr + imgSize / stride * i); }));
         copy(imgPtr + imgSize / stride * (stride - 1), imgPtr + imgSize, currentObjPtr + imgSize / stride * (stride - 1));
+        ThreadPool::get().waitFor(threads);
     }
 
     if (Timer::get().isDebug())
@@ -168,52 +159,53 @@ bool Image::deserialize(const shared_ptr<SerializedObject>& obj)
     if (Timer::get().isDebug())
         Timer::get() << "deserialize " + _name;
 
-    // First, we get the size of the metadata
-    int nbrChar;
-    char* ptr = reinterpret_cast<char*>(&nbrChar);
-
-    auto currentObjPtr = obj->data();
-    copy(currentObjPtr, currentObjPtr + sizeof(nbrChar), ptr);
-    currentObjPtr += sizeof(nbrChar);
-
-    try
-    {
-        char xmlSpecChar[nbrChar];
-        ptr = reinterpret_cast<char*>(xmlSpecChar);
-        copy(currentObjPtr, currentObjPtr + nbrChar, ptr);
-        currentObjPtr = obj->data() + SPLASH_IMAGE_SERIALIZED_HEADER_SIZE;
-        string xmlSpec(xmlSpecChar);
-
-        ImageBufferSpec spec;
-        spec.from_string(xmlSpec.c_str());
-
-        ImageBufferSpec curSpec = _bufferDeserialize.getSpec();
-        if (spec != curSpec)
-            _bufferDeserialize = ImageBuffer(spec);
-
-        auto rawBuffer = obj->grabData();
-        rawBuffer.shift(SPLASH_IMAGE_SERIALIZED_HEADER_SIZE);
-        _bufferDeserialize.setRawBuffer(std::move(rawBuffer));
-
-        if (!_bufferImage)
-            _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer());
-        std::swap(*_bufferImage, _bufferDeserialize);
-        _imageUpdated = true;
-
-        updateTimestamp();
-    }
-    catch (...)
+    ImageBufferSpec spec;
+    if (!spec.readHeader(obj->data(), obj->size()) || obj->size() < ImageBufferSpec::headerSize + spec.rawSize())
     {
         Log::get() << Log::ERROR << "Image::" << __FUNCTION__ << " - Unable to deserialize the given object" << Log::endl;
         return false;
     }
 
+    // The image uses the received buffer as is
+    auto rawBuffer = obj->grabData();
+    rawBuffer.shift(ImageBufferSpec::headerSize);
+    _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer(spec, std::move(rawBuffer)));
+    _imageUpdated = true;
+
+    updateTimestamp();
+
     if (Timer::get().isDebug())
         Timer::get() >> "deserialize " + _name;
 
     return true;
 }
 
+/*************/
+shared_ptr<BufferSnapshot> Image::getSnapshot() const
+{
+    lock_guard<Spinlock> lock(_readMutex);
+    if (!_image)
+        return {};
+    return make_shared<SharedBufferSnapshot<ImageBuffer>>(_image);
+}
+
+/*************/
+bool Image::setSnapshot(const shared_ptr<BufferSnapshot>& snapshot)
+{
+    auto imageSnapshot = dynamic_pointer_cast<SharedBufferSnapshot<ImageBuffer>>(snapshot);
+    if (!imageSnapshot || !imageSnapshot->content)
+        return false;
+
+    {
+        lock_guard<Spinlock> lock(_readMutex);
+        _snapshotImage = imageSnapshot->content;
+        _imageUpdated = true;
+    }
+
+    updateTimestamp();
+    return true;
+}
+
 /*************/
 bool Image::read(const string& filename)
 {
@@ -242,7 +234,7 @@ bool Image::readFile(const string& filename)
         return false;
     }
 
-    auto spec = ImageBufferSpec(w, h, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+    auto spec = ImageBufferSpec(w, h, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA);
     spec.videoFrame = false;
 
     auto img = ImageBuffer(spec);
@@ -267,7 +259,10 @@ void Image::zero()
     if (!_image)
         return;
 
-    _image->zero();
+    // The current image may be shared, so it is replaced instead of modified
+    auto img = make_shared<ImageBuffer>(_image->getSpec());
+    img->zero();
+    _image = std::move(img);
 }
 
 /*************/
@@ -277,9 +272,18 @@ void Image::update()
     {
         lock_guard<Spinlock> lockRead(_readMutex);
         shared_lock<shared_timed_mutex> lockWrite(_writeMutex);
-        _image.swap(_bufferImage);
+        auto previousImage = std::move(_image);
+        if (_snapshotImage)
+            _image = std::move(_snapshotImage);
+        else if (_bufferImage)
+            _image = std::move(_bufferImage);
         _imageUpdated = false;
 
+        // If no other Image shares the previous image, it becomes the next buffer so that derived classes can
+        // write to it or recycle it. Otherwise it is released once the last Image sharing it lets it go.
+        if (!_bufferImage && previousImage && previousImage.use_count() == 1)
+            _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer(std::move(const_cast<ImageBuffer&>(*previousImage))));
+
         if (_remoteType.empty() || _type == _remoteType)
             updateMediaInfo();
     }
@@ -298,7 +302,7 @@ void Image::updateMediaInfo()
     mediaInfo.push_back(Value(spec.height, "height"));
     mediaInfo.push_back(Value(spec.bpp, "bpp"));
     mediaInfo.push_back(Value(spec.channels, "channels"));
-    mediaInfo.push_back(Value(spec.format, "format"));
+    mediaInfo.push_back(Value(ImageBufferSpec::formatToString(spec.format), "format"));
     mediaInfo.push_back(Value(_srgb, "srgb"));
     updateMoreMediaInfo(mediaInfo);
     std::swap(_mediaInfo, mediaInfo);
@@ -344,9 +348,7 @@ void Image::createDefaultImage()
     img.zero();
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = unique_ptr<ImageBuffer>(new ImageBuffer());
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
@@ -370,9 +372,7 @@ void Image::createPattern()
         }
 
     lock_guard<Spinlock> lock(_readMutex);
-    if (!_image)
-        _image = unique_ptr<ImageBuffer>(new ImageBuffer());
-    std::swap(*_image, img);
+    _image = make_shared<ImageBuffer>(std::move(img));
     updateTimestamp();
 }
 
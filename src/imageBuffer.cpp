@@ -1,103 +1,116 @@
 #include "./imageBuffer.h"
 
+#include <cstring>
+#include <utility>
+#include <vector>
+
 using namespace std;
 
 namespace Splash
 {
 
+const size_t ImageBufferSpec::headerSize;
+const uint16_t ImageBufferSpec::headerVersion;
+
+namespace
+{
+const uint32_t headerMagic = 0x4D495053; // "SPIM", in little endian
+
+/**
+ * Binary header of a serialized image. Any change to its layout must come with an increment of the version
+ */
+struct SpecHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint32_t type;
+    uint8_t bpp;
+    uint8_t format;
+    uint8_t videoFrame;
+};
+
+static_assert(sizeof(SpecHeader) <= ImageBufferSpec::headerSize, "The image header does not fit in its reserved size");
+
+const vector<pair<ImageBufferSpec::Format, string>> formatNames{{ImageBufferSpec::Format::R, "R"},
+    {ImageBufferSpec::Format::RG, "RG"},
+    {ImageBufferSpec::Format::RGB, "RGB"},
+    {ImageBufferSpec::Format::RGBA, "RGBA"},
+    {ImageBufferSpec::Format::BGR, "BGR"},
+    {ImageBufferSpec::Format::BGRA, "BGRA"},
+    {ImageBufferSpec::Format::YUYV, "YUYV"},
+    {ImageBufferSpec::Format::UYVY, "UYVY"},
+    {ImageBufferSpec::Format::RGB_DXT1, "RGB_DXT1"},
+    {ImageBufferSpec::Format::RGBA_DXT5, "RGBA_DXT5"},
+    {ImageBufferSpec::Format::YCoCg_DXT5, "YCoCg_DXT5"}};
+}
+
 /*************/
-string ImageBufferSpec::to_string()
+ImageBufferSpec::Format ImageBufferSpec::formatFromString(const string& format)
 {
-    string spec;
-    spec += std::to_string(width);
-    spec += ";";
-    spec += std::to_string(height);
-    spec += ";";
-    spec += std::to_string(channels);
-    spec += ";";
-    spec += std::to_string(bpp);
-    spec += ";";
-
-    switch (type)
-    {
-    case Type::UINT8:
-        spec += "0";
-        break;
-    case Type::UINT16:
-        spec += "1";
-        break;
-    case Type::FLOAT:
-        spec += "2";
-        break;
-    }
-    spec += ";";
-    spec += format;
-    spec += ";";
-    spec += std::to_string(static_cast<int>(videoFrame));
-    spec += ";";
-
-    return spec;
+    for (const auto& formatName : formatNames)
+        if (formatName.second == format)
+            return formatName.first;
+    return Format::UNKNOWN;
 }
 
 /*************/
-void ImageBufferSpec::from_string(const string& spec)
+string ImageBufferSpec::formatToString(Format format)
 {
-    auto prev = 0;
-
-    // Width
-    auto curr = spec.find(";");
-    if (curr == string::npos)
-        return;
-    width = stoi(spec.substr(prev, curr));
-
-    // Height
-    auto roi = spec.substr(curr + 1);
-    curr = roi.find(";");
-    if (curr == string::npos)
-        return;
-    height = stoi(roi.substr(0, curr));
-
-    // Channels
-    roi = roi.substr(curr + 1);
-    curr = roi.find(";");
-    if (curr == string::npos)
-        return;
-    channels = stoi(roi.substr(0, curr));
-
-    // Bits per pixel
-    roi = roi.substr(curr + 1);
-    curr = roi.find(";");
-    if (curr == string::npos)
-        return;
-    bpp = stoi(roi.substr(0, curr));
-
-    // Type
-    roi = roi.substr(curr + 1);
-    curr = roi.find(";");
-    if (curr == string::npos)
-        return;
-    switch (stoi(roi.substr(prev, curr)))
-    {
-    case 0:
-        type = Type::UINT8;
-        break;
-    case 1:
-        type = Type::UINT16;
-        break;
-    case 2:
-        type = Type::FLOAT;
-        break;
-    }
-
-    // Format
-    roi = roi.substr(curr + 1);
-    curr = roi.find(";");
-    format = roi.substr(0, curr);
-
-    // Video frame
-    roi = roi.substr(curr + 1);
-    curr = roi.find(";");
-    videoFrame = static_cast<bool>(stoi(roi.substr(0, curr)));
+    for (const auto& formatName : formatNames)
+        if (formatName.first == format)
+            return formatName.second;
+    return {};
+}
+
+/*************/
+void ImageBufferSpec::writeHeader(char* header) const
+{
+    SpecHeader specHeader;
+    memset(&specHeader, 0, sizeof(specHeader));
+    specHeader.magic = headerMagic;
+    specHeader.version = headerVersion;
+    specHeader.size = headerSize;
+    specHeader.width = width;
+    specHeader.height = height;
+    specHeader.channels = channels;
+    specHeader.type = static_cast<uint32_t>(type);
+    specHeader.bpp = bpp;
+    specHeader.format = static_cast<uint8_t>(format);
+    specHeader.videoFrame = videoFrame;
+
+    memset(header, 0, headerSize);
+    memcpy(header, &specHeader, sizeof(specHeader));
+}
+
+/*************/
+bool ImageBufferSpec::readHeader(const char* header, size_t size)
+{
+    if (size < headerSize)
+        return false;
+
+    SpecHeader specHeader;
+    memcpy(&specHeader, header, sizeof(specHeader));
+    if (specHeader.magic != headerMagic || specHeader.version != headerVersion || specHeader.size != headerSize)
+        return false;
+
+    auto headerType = static_cast<Type>(specHeader.type);
+    if (headerType != Type::UINT8 && headerType != Type::UINT16 && headerType != Type::FLOAT)
+        return false;
+    if (specHeader.format > static_cast<uint8_t>(Format::YCoCg_DXT5))
+        return false;
+
+    width = specHeader.width;
+    height = specHeader.height;
+    channels = specHeader.channels;
+    type = headerType;
+    bpp = specHeader.bpp;
+    format = static_cast<Format>(specHeader.format);
+    videoFrame = specHeader.videoFrame != 0;
+    return true;
 }
 
 /*************/
@@ -106,6 +119,13 @@ ImageBuffer::ImageBuffer(const ImageBufferSpec& spec)
     init(spec);
 }
 
+/*************/
+ImageBuffer::ImageBuffer(const ImageBufferSpec& spec, ResizableArray<char>&& buffer)
+    : _spec(spec)
+    , _buffer(std::move(buffer))
+{
+}
+
 /*************/
 ImageBuffer::~ImageBuffer()
 {
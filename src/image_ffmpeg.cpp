@@ -68,6 +68,40 @@ void Image_FFmpeg::freeFFmpegObjects()
         avformat_close_input(&_avContext);
         _avContext = nullptr;
     }
+
+    lock_guard<mutex> lockPool(_framePoolMutex);
+    _framePool.clear();
+}
+
+/*************/
+unique_ptr<ImageBuffer> Image_FFmpeg::getPooledFrame(const ImageBufferSpec& spec)
+{
+    {
+        lock_guard<mutex> lockPool(_framePoolMutex);
+        while (!_framePool.empty())
+        {
+            auto frame = std::move(_framePool.back());
+            _framePool.pop_back();
+            // Frames with another spec are left over from a previous file, drop them
+            if (frame->getSpec() == spec)
+                return frame;
+        }
+    }
+
+    ++_frameAllocations;
+    return unique_ptr<ImageBuffer>(new ImageBuffer(spec));
+}
+
+/*************/
+void Image_FFmpeg::recycleFrame(unique_ptr<ImageBuffer>&& frame)
+{
+    if (!frame || frame->getSize() == 0)
+        return;
+
+    lock_guard<mutex> lockPool(_framePoolMutex);
+    if (static_cast<int64_t>((_framePool.size() + 1) * frame->getSize()) > _maximumBufferSize / 2)
+        return;
+    _framePool.push_back(std::move(frame));
 }
 
 /*************/
@@ -326,9 +360,6 @@ void Image_FFmpeg::readLoop()
         return;
     }
 
-    int numBytes = av_image_get_buffer_size(AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
-    vector<unsigned char> buffer(numBytes);
-
     struct SwsContext* swsContext;
     if (!isHap)
     {
@@ -342,8 +373,6 @@ void Image_FFmpeg::readLoop()
             nullptr,
             nullptr,
             nullptr);
-
-        av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, buffer.data(), AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
     }
 
     AVPacket packet;
@@ -383,13 +412,13 @@ void Image_FFmpeg::readLoop()
 
                     if (frameFinished)
                     {
-                        sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, videoCodecContext->height, rgbFrame->data, rgbFrame->linesize);
-
-                        ImageBufferSpec spec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
-                        img.reset(new ImageBuffer(spec));
+                        // Convert directly into the frame buffer
+                        ImageBufferSpec spec(videoCodecContext->width, videoCodecContext->height, 3, 16, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::YUYV);
+                        img = getPooledFrame(spec);
 
-                        unsigned char* pixels = reinterpret_cast<unsigned char*>(img->data());
-                        copy(buffer.begin(), buffer.end(), pixels);
+                        auto pixels = reinterpret_cast<uint8_t*>(img->data());
+                        av_image_fill_arrays(rgbFrame->data, rgbFrame->linesize, pixels, AV_PIX_FMT_YUYV422, videoCodecContext->width, videoCodecContext->height, 1);
+                        sws_scale(swsContext, (const uint8_t* const*)frame->data, frame->linesize, 0, videoCodecContext->height, rgbFrame->data, rgbFrame->linesize);
 
                         if (packet.pts != AV_NOPTS_VALUE)
                             timing = static_cast<uint64_t>((double)av_frame_get_best_effort_timestamp(frame) * _videoTimeBase * 1e6);
@@ -433,8 +462,8 @@ void Image_FFmpeg::readLoop()
                             return;
                         }
 
-                        spec.format = {textureFormat};
-                        img.reset(new ImageBuffer(spec));
+                        spec.format = ImageBufferSpec::formatFromString(textureFormat);
+                        img = getPooledFrame(spec);
 
                         unsigned long outputBufferBytes = spec.width * spec.height * spec.channels;
 
@@ -450,6 +479,18 @@ void Image_FFmpeg::readLoop()
                     }
                 }
 
+                // Report the buffer allocations needed for this frame, which should drop to zero once the pool is filled
+                if (!hasFrame)
+                {
+                    recycleFrame(std::move(img));
+                }
+                else
+                {
+                    if (Timer::get().isDebug())
+                        Timer::get().setDuration("image_ffmpeg_allocations " + _name, _frameAllocations);
+                    _frameAllocations = 0;
+                }
+
                 int64_t totalBufferSize = 0;
                 {
                     lock_guard<mutex> lockFrames(_videoQueueMutex);
@@ -528,7 +569,17 @@ void Image_FFmpeg::readLoop()
             }
         }
 
-        // This prevents looping to happen before the queue has been consumed
+        // Wait for the display loop to move the remaining frames to its local queue. It holds _videoEndMutex while
+        // showing them, so locking it below makes the seek to the beginning wait until they have all been displayed
+        while (_continueRead)
+        {
+            {
+                lock_guard<mutex> lockQueue(_videoQueueMutex);
+                if (_timedFrames.empty())
+                    break;
+            }
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
         lock_guard<mutex> lockEnd(_videoEndMutex);
         // Seek to the beginning, or whatever time is set in _trimStart
         seek(_trimStart);
@@ -635,6 +686,22 @@ void Image_FFmpeg::seek_async(float seconds)
 void Image_FFmpeg::videoDisplayLoop()
 {
     auto previousTime = 0;
+    auto frameDisplayed = false;
+
+    auto displayFrame = [&](TimedFrame& timedFrame) {
+        _elapsedTime = timedFrame.timing;
+
+        lock_guard<shared_timed_mutex> lock(_writeMutex);
+        if (!_bufferImage)
+            _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer());
+        std::swap(_bufferImage, timedFrame.frame);
+        _imageUpdated = true;
+        updateTimestamp();
+        frameDisplayed = true;
+
+        // The frame we got back is not used anymore
+        recycleFrame(std::move(timedFrame.frame));
+    };
 
     while (_continueRead)
     {
@@ -680,6 +747,15 @@ void Image_FFmpeg::videoDisplayLoop()
             // Show the frame at the right timing, according to clocks
             //
             TimedFrame& timedFrame = localQueue[0];
+
+            // The first frame is shown even when paused, so that a source opened paused (i.e. prerolled by a Queue) is ready to be displayed
+            if (!frameDisplayed && (_paused || (clockIsPaused && useClock)))
+            {
+                displayFrame(timedFrame);
+                localQueue.pop_front();
+                continue;
+            }
+
             if (timedFrame.timing != 0ull)
             {
                 if (_paused || (clockIsPaused && useClock))
@@ -731,14 +807,7 @@ void Image_FFmpeg::videoDisplayLoop()
                 if (waitTime > 2e3) // we don't wait if the frame is due for the next few ms
                     this_thread::sleep_for(chrono::microseconds(waitTime));
 
-                _elapsedTime = timedFrame.timing;
-
-                lock_guard<shared_timed_mutex> lock(_writeMutex);
-                if (!_bufferImage)
-                    _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer());
-                std::swap(_bufferImage, timedFrame.frame);
-                _imageUpdated = true;
-                updateTimestamp();
+                displayFrame(timedFrame);
             }
 
             localQueue.pop_front();
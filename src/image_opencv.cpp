@@ -115,7 +115,7 @@ void Image_OpenCV::readLoop()
         if (spec.width != capture.rows || spec.height != capture.cols || spec.channels != capture.channels())
         {
             ImageBufferSpec newSpec(capture.cols, capture.rows, capture.channels(), 8 * capture.channels(), ImageBufferSpec::Type::UINT8);
-            newSpec.format = "BGR";
+            newSpec.format = ImageBufferSpec::Format::BGR;
             _readBuffer = ImageBuffer(newSpec);
         }
         unsigned char* pixels = reinterpret_cast<unsigned char*>(_readBuffer.data());
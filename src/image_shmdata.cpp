@@ -17,6 +17,7 @@
 #include "cgUtils.h"
 #include "log.h"
 #include "osUtils.h"
+#include "thread_pool.h"
 #include "timer.h"
 
 #define SPLASH_SHMDATA_THREADS 2
@@ -247,7 +248,7 @@ void Image_Shmdata::readHapFrame(void* data, int data_size)
         else
             return;
 
-        spec.format = textureFormat;
+        spec.format = ImageBufferSpec::formatFromString(textureFormat);
         _readerBuffer = ImageBuffer(spec);
     }
 
@@ -273,15 +274,13 @@ void Image_Shmdata::readUncompressedFrame(void* data, int data_size)
     {
         ImageBufferSpec spec(_width, _height, _channels, 8 * _channels, ImageBufferSpec::Type::UINT8);
         if (_green < _blue)
-            spec.format = "BGR";
+            spec.format = _channels == 4 ? ImageBufferSpec::Format::BGRA : ImageBufferSpec::Format::BGR;
         else
-            spec.format = "RGB";
-        if (_channels == 4)
-            spec.format.push_back('A');
+            spec.format = _channels == 4 ? ImageBufferSpec::Format::RGBA : ImageBufferSpec::Format::RGB;
 
         if (_is420 || _is422)
         {
-            spec.format = "UYVY";
+            spec.format = ImageBufferSpec::Format::UYVY;
             spec.bpp = 16;
         }
 
@@ -295,7 +294,7 @@ void Image_Shmdata::readUncompressedFrame(void* data, int data_size)
         for (int block = 0; block < SPLASH_SHMDATA_THREADS; ++block)
         {
             int size = _width * _height * _channels * sizeof(char);
-            threads.push_back(async(launch::async, [=]() {
+            threads.push_back(ThreadPool::get().enqueue([=]() {
                 int sizeOfBlock; // We compute the size of the block, to handle image size non divisible by SPLASH_SHMDATA_THREADS
                 if (size - size / SPLASH_SHMDATA_THREADS * block < 2 * size / SPLASH_SHMDATA_THREADS)
                     sizeOfBlock = size - size / SPLASH_SHMDATA_THREADS * block;
@@ -305,6 +304,7 @@ void Image_Shmdata::readUncompressedFrame(void* data, int data_size)
                 memcpy(pixels + size / SPLASH_SHMDATA_THREADS * block, (const char*)data + size / SPLASH_SHMDATA_THREADS * block, sizeOfBlock);
             }));
         }
+        ThreadPool::get().waitFor(threads);
     }
     else if (_is420)
     {
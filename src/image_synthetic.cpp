@@ -0,0 +1,149 @@
+#include "./image_synthetic.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "./log.h"
+#include "./timer.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+Image_Synthetic::Image_Synthetic(RootObject* root)
+    : Image(root)
+{
+    init();
+}
+
+/*************/
+Image_Synthetic::~Image_Synthetic()
+{
+    stopGenerating();
+}
+
+/*************/
+void Image_Synthetic::init()
+{
+    _type = "image_synthetic";
+    registerAttributes();
+
+    // This is used for getting documentation "offline"
+    if (!_root)
+        return;
+
+    startGenerating();
+}
+
+/*************/
+void Image_Synthetic::startGenerating()
+{
+    lock_guard<mutex> lock(_generateMutex);
+    _continueGenerating = false;
+    if (_generateThread.joinable())
+        _generateThread.join();
+
+    _generateBuffer = ImageBuffer(ImageBufferSpec(_width, _height, 4, 32, ImageBufferSpec::Type::UINT8));
+    _continueGenerating = true;
+    _generateThread = thread([&]() { generateLoop(); });
+}
+
+/*************/
+void Image_Synthetic::stopGenerating()
+{
+    lock_guard<mutex> lock(_generateMutex);
+    _continueGenerating = false;
+    if (_generateThread.joinable())
+        _generateThread.join();
+}
+
+/*************/
+void Image_Synthetic::generateLoop()
+{
+    auto spec = _generateBuffer.getSpec();
+    auto nextFrameTime = chrono::steady_clock::now();
+    while (_continueGenerating)
+    {
+        if (Timer::get().isDebug())
+            Timer::get() << "generate " + _name;
+
+        fillFrame(_generateBuffer, _frameIndex++);
+
+        {
+            lock_guard<shared_timed_mutex> lockWrite(_writeMutex);
+            if (!_bufferImage)
+                _bufferImage = unique_ptr<ImageBuffer>(new ImageBuffer());
+            // The previous buffer is swapped back, and reused for the next frame
+            std::swap(*_bufferImage, _generateBuffer);
+            _imageUpdated = true;
+            updateTimestamp();
+        }
+
+        if (Timer::get().isDebug())
+            Timer::get() >> "generate " + _name;
+
+        // The buffer swapped back may come from a previous resolution
+        if (_generateBuffer.getSpec() != spec)
+            _generateBuffer = ImageBuffer(spec);
+
+        // Keep a steady rate, without trying to catch up if late
+        nextFrameTime += chrono::microseconds(static_cast<int64_t>(1e6 / max(_framerate.load(), 1.f)));
+        auto now = chrono::steady_clock::now();
+        if (nextFrameTime > now)
+            this_thread::sleep_until(nextFrameTime);
+        else
+            nextFrameTime = now;
+    }
+}
+
+/*************/
+void Image_Synthetic::fillFrame(ImageBuffer& buffer, uint64_t frameIndex)
+{
+    // Horizontal bands scrolling down by one line per frame, cheap enough not to weigh on the measures
+    auto spec = buffer.getSpec();
+    auto rowSize = static_cast<size_t>(spec.width) * spec.pixelBytes();
+    auto pixels = reinterpret_cast<uint8_t*>(buffer.data());
+    for (uint32_t y = 0; y < spec.height; ++y)
+        memset(pixels + y * rowSize, static_cast<int>((y + frameIndex) & 0xFF), rowSize);
+}
+
+/*************/
+void Image_Synthetic::registerAttributes()
+{
+    Image::registerAttributes();
+
+    addAttribute("size",
+        [&](const Values& args) {
+            auto width = args[0].as<int>();
+            auto height = args[1].as<int>();
+            if (width <= 0 || height <= 0)
+                return false;
+
+            _width = width;
+            _height = height;
+            if (_root)
+                startGenerating();
+            return true;
+        },
+        [&]() -> Values {
+            return {(int)_width, (int)_height};
+        },
+        {'n', 'n'});
+    setAttributeDescription("size", "Resolution of the generated frames");
+
+    addAttribute("framerate",
+        [&](const Values& args) {
+            auto framerate = args[0].as<float>();
+            if (framerate <= 0.f)
+                return false;
+            _framerate = framerate;
+            return true;
+        },
+        [&]() -> Values { return {_framerate.load()}; },
+        {'n'});
+    setAttributeDescription("framerate", "Rate at which frames are generated, in frames per second");
+}
+
+} // end of namespace
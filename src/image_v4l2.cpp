@@ -475,10 +475,10 @@ bool Image_V4L2::openCaptureDevice(const std::string& devicePath)
     {
     default:
     case V4L2_PIX_FMT_RGB24:
-        _spec = ImageBufferSpec(_outputWidth, _outputHeight, 3, 24, ImageBufferSpec::Type::UINT8, "RGB");
+        _spec = ImageBufferSpec(_outputWidth, _outputHeight, 3, 24, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGB);
         break;
     case V4L2_PIX_FMT_YUYV:
-        _spec = ImageBufferSpec(_outputWidth, _outputHeight, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV");
+        _spec = ImageBufferSpec(_outputWidth, _outputHeight, 3, 16, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::YUYV);
         break;
     }
 
@@ -0,0 +1,86 @@
+#include "./inflight_buffers.h"
+
+#include "./log.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+InFlightBuffers::InFlightBuffers(const string& latencyTimer)
+    : _latencyTimer(Timer::get().getHandle(latencyTimer))
+{
+}
+
+/*************/
+void* InFlightBuffers::track(shared_ptr<SerializedObject> buffer)
+{
+    lock_guard<mutex> lock(_mutex);
+
+    Slot* slot = nullptr;
+    if (_freeSlots.empty())
+    {
+        _slots.emplace_back();
+        slot = &_slots.back();
+        slot->owner = this;
+        slot->index = static_cast<uint32_t>(_slots.size() - 1);
+    }
+    else
+    {
+        slot = &_slots[_freeSlots.back()];
+        _freeSlots.pop_back();
+    }
+
+    slot->buffer = std::move(buffer);
+    slot->trackTime = Timer::getTime();
+    ++_count;
+
+    return slot;
+}
+
+/*************/
+void InFlightBuffers::release(void* /*data*/, void* hint)
+{
+    auto slot = static_cast<Slot*>(hint);
+    if (!slot || !slot->owner)
+    {
+        Log::get() << Log::WARNING << "InFlightBuffers::" << __FUNCTION__ << " - Invalid buffer hint" << Log::endl;
+        return;
+    }
+
+    auto owner = slot->owner;
+    shared_ptr<SerializedObject> buffer;
+    {
+        lock_guard<mutex> lock(owner->_mutex);
+        if (!slot->buffer)
+        {
+            Log::get() << Log::WARNING << "InFlightBuffers::" << __FUNCTION__ << " - Buffer released more than once" << Log::endl;
+            return;
+        }
+
+        // The buffer is freed outside of the lock, as it can be large
+        buffer = std::move(slot->buffer);
+        slot->buffer.reset();
+        Timer::get().record(owner->_latencyTimer, Timer::getTime() - slot->trackTime);
+        owner->_freeSlots.push_back(slot->index);
+        if (--owner->_count == 0)
+            owner->_releaseCondition.notify_all();
+    }
+}
+
+/*************/
+bool InFlightBuffers::waitForRelease(chrono::milliseconds maximumWait)
+{
+    unique_lock<mutex> lock(_mutex);
+    return _releaseCondition.wait_for(lock, maximumWait, [&]() { return _count == 0; });
+}
+
+/*************/
+size_t InFlightBuffers::getCount() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _count;
+}
+
+} // end of namespace
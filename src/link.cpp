@@ -13,8 +13,198 @@ using namespace std;
 namespace Splash
 {
 
+namespace
+{
+
+/*************/
+enum class MessageRecord : uint8_t
+{
+    nameDefinition = 0, //!< Followed by the name ID and the name
+    message = 1         //!< Followed by the target name ID, the attribute name ID and the Values
+};
+
+const uint32_t maxValuesDepth = 64;
+
+/*************/
+template <typename T>
+void appendPod(vector<char>& frame, const T& value)
+{
+    auto data = reinterpret_cast<const char*>(&value);
+    frame.insert(frame.end(), data, data + sizeof(T));
+}
+
+/*************/
+void appendString(vector<char>& frame, const string& str)
+{
+    appendPod(frame, static_cast<uint32_t>(str.size()));
+    frame.insert(frame.end(), str.begin(), str.end());
+}
+
+/*************/
+void appendValues(vector<char>& frame, const Values& values)
+{
+    appendPod(frame, static_cast<uint32_t>(values.size()));
+    for (const auto& value : values)
+    {
+        auto valueType = value.getType();
+        appendPod(frame, static_cast<uint8_t>(valueType));
+        appendString(frame, value.getName());
+
+        switch (valueType)
+        {
+        case Value::Type::i:
+            appendPod(frame, value.as<int64_t>());
+            break;
+        case Value::Type::f:
+            appendPod(frame, value.as<double>());
+            break;
+        case Value::Type::s:
+            appendString(frame, value.as<string>());
+            break;
+        case Value::Type::v:
+            appendValues(frame, value.as<Values>());
+            break;
+        case Value::Type::fa:
+        case Value::Type::ia:
+        {
+            // Both array types hold 4 bytes elements
+            auto data = static_cast<const char*>(value.data());
+            appendPod(frame, static_cast<uint32_t>(value.size()));
+            frame.insert(frame.end(), data, data + value.size() * 4);
+            break;
+        }
+        }
+    }
+}
+
+/*************/
+class FrameReader
+{
+  public:
+    FrameReader(const char* data, size_t size)
+        : _current(data)
+        , _end(data + size)
+    {
+    }
+
+    bool atEnd() const { return _current >= _end; }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        if (static_cast<size_t>(_end - _current) < sizeof(T))
+            return false;
+        memcpy(&value, _current, sizeof(T));
+        _current += sizeof(T);
+        return true;
+    }
+
+    bool readString(string& str)
+    {
+        uint32_t size;
+        if (!read(size) || static_cast<size_t>(_end - _current) < size)
+            return false;
+        str.assign(_current, size);
+        _current += size;
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& array)
+    {
+        uint32_t size;
+        if (!read(size) || static_cast<size_t>(_end - _current) / sizeof(T) < size)
+            return false;
+        array.resize(size);
+        memcpy(array.data(), _current, size * sizeof(T));
+        _current += size * sizeof(T);
+        return true;
+    }
+
+    bool readValues(Values& values, uint32_t depth = 0)
+    {
+        uint32_t size;
+        if (depth > maxValuesDepth || !read(size))
+            return false;
+
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            uint8_t valueType;
+            string valueName;
+            if (!read(valueType) || !readString(valueName))
+                return false;
+
+            switch (valueType)
+            {
+            default:
+                return false;
+            case Value::Type::i:
+            {
+                int64_t value;
+                if (!read(value))
+                    return false;
+                values.emplace_back(std::move(value));
+                break;
+            }
+            case Value::Type::f:
+            {
+                double value;
+                if (!read(value))
+                    return false;
+                values.emplace_back(std::move(value));
+                break;
+            }
+            case Value::Type::s:
+            {
+                string value;
+                if (!readString(value))
+                    return false;
+                values.emplace_back(std::move(value));
+                break;
+            }
+            case Value::Type::v:
+            {
+                Values value;
+                if (!readValues(value, depth + 1))
+                    return false;
+                values.emplace_back(std::move(value));
+                break;
+            }
+            case Value::Type::fa:
+            {
+                vector<float> value;
+                if (!readArray(value))
+                    return false;
+                values.emplace_back(std::move(value));
+                break;
+            }
+            case Value::Type::ia:
+            {
+                vector<int32_t> value;
+                if (!readArray(value))
+                    return false;
+                values.emplace_back(std::move(value));
+                break;
+            }
+            }
+
+            if (!valueName.empty())
+                values.back().setName(valueName);
+        }
+
+        return true;
+    }
+
+  private:
+    const char* _current;
+    const char* _end;
+};
+
+} // end of anonymous namespace
+
 /*************/
 Link::Link(RootObject* root, const string& name)
+    : _inFlightBuffers("bufferSendLatency_" + name)
 {
     try
     {
@@ -91,6 +281,12 @@ void Link::connectTo(const string& name)
 
     // Wait a bit for the connection to be up
     this_thread::sleep_for(chrono::milliseconds(100));
+
+    // The new peer does not know about the names interned so far, they are defined again from the next frame on
+    {
+        lock_guard<Spinlock> lock(_msgSendMutex);
+        _resetInternedNames = true;
+    }
     _connectedToOuter = true;
 }
 
@@ -140,86 +336,205 @@ void Link::disconnectFrom(const std::string& name)
 /*************/
 bool Link::waitForBufferSending(chrono::milliseconds maximumWait)
 {
-    bool returnValue;
-    chrono::milliseconds totalWait{0};
+    return _inFlightBuffers.waitForRelease(maximumWait);
+}
+
+/*************/
+bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer, const vector<string>& destinations)
+{
+    auto isDestination = [&](const string& peer) { return destinations.empty() || find(destinations.begin(), destinations.end(), peer) != destinations.end(); };
+
+    size_t readerCount = 0;
+    auto topics = getOuterTopics(destinations, readerCount);
 
-    while (true)
+    if (_connectedToInner)
     {
-        if (_otgNumber == 0)
-        {
-            returnValue = true;
-            break;
-        }
-        if (totalWait > maximumWait)
+        for (auto& rootObjectIt : _connectedTargetPointers)
         {
-            returnValue = false;
-            break;
+            auto rootObject = rootObjectIt.second;
+            if (!rootObject || !isDestination(rootObjectIt.first))
+                continue;
+
+            // If the buffer is also sent to another process, we make a copy of the buffer right now
+            if (!topics.empty())
+            {
+                auto copiedBuffer = make_shared<SerializedObject>();
+                *copiedBuffer = *buffer;
+                rootObject->setFromSerializedObject(name, copiedBuffer);
+            }
+            else
+            {
+                rootObject->setFromSerializedObject(name, buffer);
+            }
         }
-        totalWait = totalWait + chrono::milliseconds(1);
-        this_thread::sleep_for(chrono::milliseconds(1));
     }
 
-    return returnValue;
+    if (!topics.empty())
+        publishBuffer(name, buffer, topics, readerCount);
+
+    return true;
 }
 
 /*************/
-bool Link::sendBuffer(const string& name, shared_ptr<SerializedObject> buffer)
+bool Link::sendBuffer(const string& name, const shared_ptr<BufferObject>& object, const vector<string>& destinations)
 {
+    auto isDestination = [&](const string& peer) { return destinations.empty() || find(destinations.begin(), destinations.end(), peer) != destinations.end(); };
+
+    size_t readerCount = 0;
+    auto topics = getOuterTopics(destinations, readerCount);
+
+    // The object is serialized at most once, and only if needed
+    shared_ptr<SerializedObject> buffer{nullptr};
+
     if (_connectedToInner)
     {
+        shared_ptr<BufferSnapshot> snapshot{nullptr};
         for (auto& rootObjectIt : _connectedTargetPointers)
         {
             auto rootObject = rootObjectIt.second;
-            // If there is also a connection to another process,
-            // we make a copy of the buffer right now
-            if (rootObject && _connectedToOuter)
+            if (!rootObject || !isDestination(rootObjectIt.first))
+                continue;
+
+            // Peers from the same process share the content of the object, without copy
+            if (_inProcessTransfer)
+            {
+                if (!snapshot)
+                    snapshot = object->getSnapshot();
+                if (snapshot && rootObject->setFromSnapshot(name, snapshot))
+                    continue;
+            }
+
+            if (!buffer)
+                buffer = object->serialize();
+            if (!buffer)
+                return false;
+
+            if (!topics.empty())
             {
                 auto copiedBuffer = make_shared<SerializedObject>();
                 *copiedBuffer = *buffer;
                 rootObject->setFromSerializedObject(name, copiedBuffer);
             }
-            else if (rootObject)
+            else
             {
                 rootObject->setFromSerializedObject(name, buffer);
             }
         }
     }
 
-    if (_connectedToOuter)
+    if (topics.empty())
+        return true;
+
+    if (!buffer)
+        buffer = object->serialize();
+    if (!buffer)
+        return false;
+
+    publishBuffer(name, buffer, topics, readerCount);
+    return true;
+}
+
+/*************/
+bool Link::isInnerPeer(const string& name) const
+{
+    auto peerIt = _connectedTargetPointers.find(name);
+    return peerIt != _connectedTargetPointers.end() && peerIt->second != nullptr;
+}
+
+/*************/
+vector<string> Link::getOuterTopics(const vector<string>& destinations, size_t& readerCount) const
+{
+    // Each process subscribes to the buffers published with its name as first frame, and to broadcast ones
+    vector<string> topics;
+    readerCount = 0;
+    if (!_connectedToOuter)
+        return topics;
+
+    if (destinations.empty())
     {
-        try
-        {
-            lock_guard<Spinlock> lock(_bufferSendMutex);
-            auto bufferPtr = buffer.get();
+        topics.push_back(SPLASH_ALL_PEERS);
+        readerCount = _connectedTargets.size();
+    }
+    else
+    {
+        for (const auto& target : _connectedTargets)
+            if (find(destinations.begin(), destinations.end(), target) != destinations.end())
+                topics.push_back(target);
+        readerCount = topics.size();
+    }
 
-            _otgMutex.lock();
-            _otgBuffers.push_back(buffer);
-            _otgMutex.unlock();
+    return topics;
+}
 
-            _otgNumber.fetch_add(1, std::memory_order_acq_rel);
+/*************/
+void Link::publishBuffer(const string& name, const shared_ptr<SerializedObject>& buffer, const vector<string>& topics, size_t readerCount)
+{
+    try
+    {
+        lock_guard<Spinlock> lock(_bufferSendMutex);
+
+        // If possible the buffer is copied once into shared memory, and only its descriptor is sent
+        auto transport = BufferTransport::zmq;
+        ShmRing::Descriptor descriptor;
+        if (_bufferTransport == BufferTransport::shm && _shmWriter && _shmWriter->write(buffer->data(), buffer->size(), readerCount, descriptor))
+            transport = BufferTransport::shm;
+
+        for (const auto& topic : topics)
+        {
+            zmq::message_t msg(topic.size() + 1);
+            memcpy(msg.data(), (void*)topic.c_str(), topic.size() + 1);
+            _socketBufferOut->send(msg, ZMQ_SNDMORE);
 
-            zmq::message_t msg(name.size() + 1);
+            msg.rebuild(name.size() + 1);
             memcpy(msg.data(), (void*)name.c_str(), name.size() + 1);
             _socketBufferOut->send(msg, ZMQ_SNDMORE);
 
-            msg.rebuild(bufferPtr->data(), bufferPtr->size(), Link::freeOlderBuffer, this);
-            _socketBufferOut->send(msg);
-        }
-        catch (const zmq::error_t& e)
-        {
-            if (errno != ETERM)
-                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
+            msg.rebuild(sizeof(transport));
+            memcpy(msg.data(), (void*)&transport, sizeof(transport));
+            _socketBufferOut->send(msg, ZMQ_SNDMORE);
+
+            if (transport == BufferTransport::shm)
+            {
+                msg.rebuild(sizeof(descriptor));
+                memcpy(msg.data(), (void*)&descriptor, sizeof(descriptor));
+                _socketBufferOut->send(msg);
+            }
+            else
+            {
+                // Each destination gets its own message, holding the buffer until it is sent
+                auto bufferPtr = buffer.get();
+                auto hint = _inFlightBuffers.track(buffer);
+                msg.rebuild(bufferPtr->data(), bufferPtr->size(), InFlightBuffers::release, hint);
+                _socketBufferOut->send(msg);
+            }
         }
     }
-
-    return true;
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
+    }
 }
 
 /*************/
-bool Link::sendBuffer(const string& name, const shared_ptr<BufferObject>& object)
+void Link::setBufferTransport(BufferTransport transport)
 {
-    auto buffer = object->serialize();
-    return sendBuffer(name, std::move(buffer));
+    lock_guard<Spinlock> lock(_bufferSendMutex);
+
+    if (transport == BufferTransport::shm && !_shmWriter)
+    {
+        auto socketPrefix = _rootObject->getSocketPrefix();
+        auto ringName = string("/splash_") + (socketPrefix.empty() ? "" : socketPrefix + "_") + "ring_" + _name;
+        auto ring = unique_ptr<ShmRing>(new ShmRing(ringName, ShmRing::Mode::Writer));
+        if (!*ring)
+        {
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Unable to create the shared memory ring, buffers will be sent through ZMQ" << Log::endl;
+            return;
+        }
+        _shmWriter = std::move(ring);
+    }
+
+    _bufferTransport = transport;
 }
 
 /*************/
@@ -237,72 +552,10 @@ bool Link::sendMessage(const string& name, const string& attribute, const Values
 
     if (_connectedToOuter)
     {
-        try
-        {
-            lock_guard<Spinlock> lock(_msgSendMutex);
-
-            // First we send the name of the target
-            zmq::message_t msg(name.size() + 1);
-            memcpy(msg.data(), (void*)name.c_str(), name.size() + 1);
-            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-            // And the target's attribute
-            msg.rebuild(attribute.size() + 1);
-            memcpy(msg.data(), (void*)attribute.c_str(), attribute.size() + 1);
-            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-            // Helper function to send messages
-            std::function<void(const Values& message)> sendMessage;
-            sendMessage = [&](const Values& message) {
-                // Size of the message
-                int size = message.size();
-                msg.rebuild(sizeof(size));
-                memcpy(msg.data(), (void*)&size, sizeof(size));
-
-                if (message.size() == 0)
-                    _socketMessageOut->send(msg);
-                else
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-                for (int i = 0; i < message.size(); ++i)
-                {
-                    auto v = message[i];
-                    Value::Type valueType = v.getType();
-
-                    msg.rebuild(sizeof(valueType));
-                    memcpy(msg.data(), (void*)&valueType, sizeof(valueType));
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-                    std::string valueName = v.getName();
-                    msg.rebuild(sizeof(valueName) + 1);
-                    memcpy(msg.data(), valueName.c_str(), sizeof(valueName) + 1);
-                    _socketMessageOut->send(msg, ZMQ_SNDMORE);
-
-                    if (valueType == Value::Type::v)
-                        sendMessage(v.as<Values>());
-                    else
-                    {
-                        int valueSize = (valueType == Value::Type::s) ? v.size() + 1 : v.size();
-                        void* value = v.data();
-                        msg.rebuild(valueSize);
-                        memcpy(msg.data(), value, valueSize);
-
-                        if (i != message.size() - 1)
-                            _socketMessageOut->send(msg, ZMQ_SNDMORE);
-                        else
-                            _socketMessageOut->send(msg);
-                    }
-                }
-            };
-
-            // Send the message
-            sendMessage(message);
-        }
-        catch (const zmq::error_t& e)
-        {
-            if (errno != ETERM)
-                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
-        }
+        lock_guard<Spinlock> lock(_msgSendMutex);
+        encodeMessage(name, attribute, message);
+        if (_messageBatchDepth == 0)
+            sendMessageFrame();
     }
 
 // We don't display broadcast messages, for visibility
@@ -315,91 +568,164 @@ bool Link::sendMessage(const string& name, const string& attribute, const Values
 }
 
 /*************/
-void Link::freeOlderBuffer(void* data, void* hint)
+void Link::beginMessageBatch()
 {
-    Link* ctx = (Link*)hint;
-    lock_guard<Spinlock> lock(ctx->_otgMutex);
-    int index = 0;
-    for (; index < ctx->_otgBuffers.size(); ++index)
-        if (ctx->_otgBuffers[index]->data() == data)
-            break;
+    lock_guard<Spinlock> lock(_msgSendMutex);
+    ++_messageBatchDepth;
+}
 
-    if (index >= ctx->_otgBuffers.size())
-    {
-        Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Buffer to free not found in currently sent buffers list" << Log::endl;
+/*************/
+void Link::flushMessageBatch()
+{
+    lock_guard<Spinlock> lock(_msgSendMutex);
+    if (_messageBatchDepth == 0)
         return;
+
+    --_messageBatchDepth;
+    if (_messageBatchDepth == 0 && !_messageFrame.empty())
+        sendMessageFrame();
+}
+
+/*************/
+uint32_t Link::internName(const string& name)
+{
+    auto nameIt = _internedNames.find(name);
+    if (nameIt != _internedNames.end())
+        return nameIt->second;
+
+    auto id = static_cast<uint32_t>(_internedNames.size());
+    _internedNames.emplace(name, id);
+
+    appendPod(_messageFrame, MessageRecord::nameDefinition);
+    appendPod(_messageFrame, id);
+    appendString(_messageFrame, name);
+
+    return id;
+}
+
+/*************/
+void Link::encodeMessage(const string& name, const string& attribute, const Values& message)
+{
+    // Each frame starts with the name of the sender, which identifies the interned names
+    if (_messageFrame.empty())
+    {
+        // Interned names are only reset between frames, so that a frame never refers to names defined before the reset
+        if (_resetInternedNames)
+        {
+            _internedNames.clear();
+            _resetInternedNames = false;
+        }
+        appendString(_messageFrame, _name);
     }
-    ctx->_otgBuffers.erase(ctx->_otgBuffers.begin() + index);
-    ctx->_otgNumber.fetch_sub(1, std::memory_order_acq_rel);
+
+    auto nameId = internName(name);
+    auto attributeId = internName(attribute);
+
+    appendPod(_messageFrame, MessageRecord::message);
+    appendPod(_messageFrame, nameId);
+    appendPod(_messageFrame, attributeId);
+    appendValues(_messageFrame, message);
 }
 
 /*************/
-void Link::handleInputMessages()
+void Link::sendMessageFrame()
 {
     try
     {
-        // We don't want to miss a message: set the high water mark to a high value
-        int hwm = 1000;
-        _socketMessageIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
+        zmq::message_t msg(_messageFrame.size());
+        memcpy(msg.data(), _messageFrame.data(), _messageFrame.size());
+        _socketMessageOut->send(msg);
+    }
+    catch (const zmq::error_t& e)
+    {
+        if (errno != ETERM)
+            Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Exception: " << e.what() << Log::endl;
+    }
 
-        _socketMessageIn->bind((_basePath + "msg_" + _name).c_str());
-        _socketMessageIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+    _messageFrame.clear();
+}
 
-        // Helper function to receive messages
-        zmq::message_t msg;
-        std::function<Values(void)> recvMessage;
-        recvMessage = [&]() -> Values {
-            _socketMessageIn->recv(&msg); // size of the message
-            int size = *(int*)msg.data();
+/*************/
+bool Link::handleMessageFrame(const char* data, size_t size)
+{
+    FrameReader reader(data, size);
 
-            Values values;
-            for (int i = 0; i < size; ++i)
-            {
-                _socketMessageIn->recv(&msg);
-                Value::Type valueType = *(Value::Type*)msg.data();
-
-                _socketMessageIn->recv(&msg);
-                string valueName(static_cast<char*>(msg.data()));
-
-                if (valueType == Value::Type::v)
-                {
-                    values.push_back(recvMessage());
-                }
-                else
-                {
-                    _socketMessageIn->recv(&msg);
-                    if (valueType == Value::Type::i)
-                        values.push_back(*(int64_t*)msg.data());
-                    else if (valueType == Value::Type::f)
-                        values.push_back(*(double*)msg.data());
-                    else if (valueType == Value::Type::s)
-                        values.push_back(string((char*)msg.data()));
-                }
-
-                if (!valueName.empty())
-                    values.back().setName(valueName);
-            }
-            return values;
-        };
+    string sender;
+    if (!reader.readString(sender))
+        return false;
+    auto& names = _peerNames[sender];
 
-        while (true)
+    while (!reader.atEnd())
+    {
+        MessageRecord record;
+        if (!reader.read(record))
+            return false;
+
+        if (record == MessageRecord::nameDefinition)
         {
-            _socketMessageIn->recv(&msg); // name of the target
-            string name((char*)msg.data());
-            _socketMessageIn->recv(&msg); // target's attribute
-            string attribute((char*)msg.data());
+            uint32_t id;
+            string name;
+            // IDs are given in order, so a valid ID is either known or the next one
+            if (!reader.read(id) || !reader.readString(name) || id > names.size())
+                return false;
+            if (id == names.size())
+                names.push_back(name);
+            else
+                names[id] = name;
+        }
+        else if (record == MessageRecord::message)
+        {
+            uint32_t nameId, attributeId;
+            Values values;
+            if (!reader.read(nameId) || !reader.read(attributeId) || !reader.readValues(values))
+                return false;
 
-            Values values = recvMessage();
+            if (nameId >= names.size() || attributeId >= names.size())
+            {
+                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Received a message with unknown names from " << sender << ", dropping it" << Log::endl;
+                continue;
+            }
 
+            const auto& name = names[nameId];
+            const auto& attribute = names[attributeId];
             if (_rootObject)
                 _rootObject->set(name, attribute, values);
 // We don't display broadcast messages, for visibility
 #ifdef DEBUG
             if (name != SPLASH_ALL_PEERS)
-                Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " (" << root->getName() << ")"
+                Log::get() << Log::DEBUGGING << "Link::" << __FUNCTION__ << " (" << _rootObject->getName() << ")"
                            << " - Receiving message for " << name << "::" << attribute << Log::endl;
 #endif
         }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*************/
+void Link::handleInputMessages()
+{
+    try
+    {
+        // We don't want to miss a message: set the high water mark to a high value
+        int hwm = 1000;
+        _socketMessageIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
+
+        _socketMessageIn->bind((_basePath + "msg_" + _name).c_str());
+        _socketMessageIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+
+        while (true)
+        {
+            zmq::message_t msg;
+            _socketMessageIn->recv(&msg);
+
+            if (!handleMessageFrame(static_cast<const char*>(msg.data()), msg.size()))
+                Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Received a malformed message frame" << Log::endl;
+        }
     }
     catch (const zmq::error_t& e)
     {
@@ -420,19 +746,40 @@ void Link::handleInputBuffers()
         _socketBufferIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
 
         _socketBufferIn->bind((_basePath + "buf_" + _name).c_str());
-        _socketBufferIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0); // We subscribe to all incoming messages
+        // We subscribe to the buffers sent to this process, and to those sent to all of them
+        for (const auto& topic : {_name, string(SPLASH_ALL_PEERS)})
+            _socketBufferIn->setsockopt(ZMQ_SUBSCRIBE, topic.c_str(), topic.size() + 1);
 
         while (true)
         {
             zmq::message_t msg;
 
+            // The first frame holds the destination, already filtered by the subscription
+            _socketBufferIn->recv(&msg);
+
             _socketBufferIn->recv(&msg);
             string name((char*)msg.data());
 
             _socketBufferIn->recv(&msg);
-            shared_ptr<SerializedObject> buffer = make_shared<SerializedObject>((char*)msg.data(), (char*)msg.data() + msg.size());
+            auto transport = *(BufferTransport*)msg.data();
 
-            if (_rootObject)
+            shared_ptr<SerializedObject> buffer;
+            if (transport == BufferTransport::shm)
+            {
+                _socketBufferIn->recv(&msg);
+                if (msg.size() == sizeof(ShmRing::Descriptor))
+                    buffer = readFromRing(*(ShmRing::Descriptor*)msg.data());
+            }
+            else
+            {
+                // The received message is kept alive by the buffer, which avoids copying it
+                auto message = make_shared<zmq::message_t>();
+                _socketBufferIn->recv(message.get());
+                auto data = ResizableArray<char>(static_cast<char*>(message->data()), message->size(), [message](char*) {});
+                buffer = make_shared<SerializedObject>(std::move(data));
+            }
+
+            if (buffer && _rootObject)
                 _rootObject->setFromSerializedObject(name, std::move(buffer));
         }
     }
@@ -443,6 +790,27 @@ void Link::handleInputBuffers()
     }
 
     _socketBufferIn.reset();
+    _shmReaders.clear();
+}
+
+/*************/
+shared_ptr<SerializedObject> Link::readFromRing(const ShmRing::Descriptor& descriptor)
+{
+    auto ringName = string(descriptor.ring, strnlen(descriptor.ring, ShmRing::maxNameLength));
+    auto ringIt = _shmReaders.find(ringName);
+    if (ringIt == _shmReaders.end())
+    {
+        auto ring = unique_ptr<ShmRing>(new ShmRing(ringName, ShmRing::Mode::Reader));
+        if (!*ring)
+            return {nullptr};
+        ringIt = _shmReaders.emplace(ringName, std::move(ring)).first;
+    }
+
+    auto buffer = ringIt->second->read(descriptor);
+    if (!buffer)
+        Log::get() << Log::WARNING << "Link::" << __FUNCTION__ << " - Unable to read buffer from shared memory ring " << ringName << Log::endl;
+
+    return buffer;
 }
 
 } // end of namespace
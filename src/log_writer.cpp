@@ -0,0 +1,202 @@
+#include "./log_writer.h"
+
+#include <chrono>
+
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace Splash
+{
+
+namespace
+{
+const auto writerPeriod = chrono::milliseconds(100); // Maximum delay before a record reaches the file
+}
+
+/*************/
+LogWriter::LogWriter(const string& path, uint32_t capacity, uint64_t maxFileSize, uint32_t maxBackups)
+    : _path(path)
+    , _maxFileSize(maxFileSize)
+    , _maxBackups(maxBackups)
+{
+    uint64_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+    _mask = size - 1;
+    _slots = unique_ptr<Slot[]>(new Slot[size]);
+    for (uint64_t i = 0; i < size; ++i)
+        _slots[i].sequence.store(i, memory_order_relaxed);
+
+    _file = fopen(_path.c_str(), "a");
+    if (!_file)
+        return;
+
+    struct stat fileStat;
+    if (stat(_path.c_str(), &fileStat) == 0)
+        _fileSize = fileStat.st_size;
+
+    _thread = thread([&]() { run(); });
+}
+
+/*************/
+LogWriter::~LogWriter()
+{
+    if (_thread.joinable())
+    {
+        _stop = true;
+        {
+            lock_guard<mutex> lock(_wakeMutex);
+            _wakeCondition.notify_one();
+        }
+        _thread.join();
+    }
+
+    if (_file)
+        fclose(_file);
+}
+
+/*************/
+bool LogWriter::push(string&& record)
+{
+    if (!_thread.joinable())
+        return false;
+
+    auto position = _writePosition.load(memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true)
+    {
+        slot = &_slots[position & _mask];
+        auto sequence = slot->sequence.load(memory_order_acquire);
+        auto difference = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+        if (difference == 0)
+        {
+            if (_writePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // The writer thread is late by a whole ring, drop the record instead of waiting
+            _dropped.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = _writePosition.load(memory_order_relaxed);
+        }
+    }
+
+    slot->record.swap(record);
+    slot->sequence.store(position + 1, memory_order_release);
+
+    // Wake the writer early if the ring is getting full
+    if (position - _writtenPosition.load(memory_order_relaxed) > _mask / 2 && !_wakeRequested.exchange(true))
+        _wakeCondition.notify_one();
+
+    return true;
+}
+
+/*************/
+void LogWriter::flush()
+{
+    if (!_thread.joinable())
+        return;
+
+    auto target = _writePosition.load(memory_order_acquire);
+    unique_lock<mutex> lock(_flushMutex);
+    while (_writtenPosition.load(memory_order_acquire) < target)
+    {
+        if (!_wakeRequested.exchange(true))
+            _wakeCondition.notify_one();
+        _flushCondition.wait_for(lock, chrono::milliseconds(10));
+    }
+}
+
+/*************/
+void LogWriter::run()
+{
+    string batch;
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(_wakeMutex);
+            _wakeCondition.wait_for(lock, writerPeriod, [&]() { return _wakeRequested.load() || _stop.load(); });
+        }
+        _wakeRequested = false;
+
+        writeRecords(batch);
+
+        if (_stop)
+        {
+            // Records pushed while stopping are written too
+            writeRecords(batch);
+            break;
+        }
+    }
+}
+
+/*************/
+void LogWriter::writeRecords(string& batch)
+{
+    batch.clear();
+
+    auto position = _readPosition;
+    while (true)
+    {
+        auto& slot = _slots[position & _mask];
+        if (slot.sequence.load(memory_order_acquire) != position + 1)
+            break;
+
+        batch += slot.record;
+        batch += '\n';
+        slot.record.clear();
+        slot.sequence.store(position + _mask + 1, memory_order_release);
+        ++position;
+    }
+    _readPosition = position;
+
+    auto dropped = _dropped.load(memory_order_relaxed);
+    if (dropped != _reportedDrops)
+    {
+        batch += "LogWriter - " + to_string(dropped - _reportedDrops) + " log record(s) dropped, the logging rate is too high\n";
+        _reportedDrops = dropped;
+    }
+
+    if (!batch.empty())
+    {
+        if (_maxFileSize != 0 && _fileSize + batch.size() > _maxFileSize)
+            rotate();
+
+        if (_file)
+        {
+            _fileSize += fwrite(batch.data(), 1, batch.size(), _file);
+            fflush(_file);
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(_flushMutex);
+        _writtenPosition.store(position, memory_order_release);
+    }
+    _flushCondition.notify_all();
+}
+
+/*************/
+void LogWriter::rotate()
+{
+    if (_file)
+        fclose(_file);
+
+    if (_maxBackups != 0)
+    {
+        for (uint32_t i = _maxBackups - 1; i > 0; --i)
+            std::rename((_path + "." + to_string(i)).c_str(), (_path + "." + to_string(i + 1)).c_str());
+        std::rename(_path.c_str(), (_path + ".1").c_str());
+    }
+
+    // Without backups, the file is simply truncated
+    _file = fopen(_path.c_str(), _maxBackups != 0 ? "a" : "w");
+    _fileSize = 0;
+}
+
+} // end of namespace
@@ -1,6 +1,10 @@
 #include "mesh.h"
 
+#include <cmath>
+#include <cstring>
+
 #include "./log.h"
+#include "./mesh_cache.h"
 #include "./meshLoader.h"
 #include "./osUtils.h"
 #include "./root_object.h"
@@ -11,6 +15,39 @@ using namespace std;
 namespace Splash
 {
 
+static_assert(sizeof(glm::vec4) == 4 * sizeof(float) && sizeof(glm::vec2) == 2 * sizeof(float), "Mesh attributes are expected to be tightly packed");
+
+namespace
+{
+/*************/
+template <typename T>
+Mesh::AttributeView makeAttributeView(const shared_ptr<const void>& owner, const vector<T>& attribute)
+{
+    return Mesh::AttributeView(owner, reinterpret_cast<const float*>(attribute.data()), attribute.size() * sizeof(T) / sizeof(float));
+}
+
+/*************/
+template <typename T>
+void writeAttribute(const vector<T>& attribute, char*& ptr)
+{
+    const auto size = attribute.size() * sizeof(T);
+    if (size != 0)
+        memcpy(ptr, attribute.data(), size);
+    ptr += size;
+}
+
+/*************/
+template <typename T>
+void readAttribute(vector<T>& attribute, size_t count, const char*& ptr)
+{
+    attribute.resize(count);
+    const auto size = count * sizeof(T);
+    if (size != 0)
+        memcpy(attribute.data(), ptr, size);
+    ptr += size;
+}
+}
+
 /*************/
 Mesh::Mesh(RootObject* root)
     : BufferObject(root)
@@ -52,61 +89,59 @@ bool Mesh::operator==(Mesh& otherMesh) const
 }
 
 /*************/
-vector<float> Mesh::getVertCoords() const
+Mesh::AttributeView Mesh::getVertCoordsView() const
 {
     lock_guard<Spinlock> lock(_readMutex);
-    vector<float> coords;
-    for (auto& v : _mesh.vertices)
-    {
-        coords.push_back(v[0]);
-        coords.push_back(v[1]);
-        coords.push_back(v[2]);
-        coords.push_back(v[3]);
-    }
-    return coords;
+    return makeAttributeView(_mesh, _mesh->vertices);
 }
 
 /*************/
-vector<float> Mesh::getUVCoords() const
+Mesh::AttributeView Mesh::getUVCoordsView() const
 {
     lock_guard<Spinlock> lock(_readMutex);
-    vector<float> coords;
-    for (auto& u : _mesh.uvs)
-    {
-        coords.push_back(u[0]);
-        coords.push_back(u[1]);
-    }
-    return coords;
+    return makeAttributeView(_mesh, _mesh->uvs);
 }
 
 /*************/
-vector<float> Mesh::getNormals() const
+Mesh::AttributeView Mesh::getNormalsView() const
 {
     lock_guard<Spinlock> lock(_readMutex);
-    vector<float> normals;
-    for (auto& n : _mesh.normals)
-    {
-        normals.push_back(n[0]);
-        normals.push_back(n[1]);
-        normals.push_back(n[2]);
-        normals.push_back(0.f);
-    }
-    return normals;
+    return makeAttributeView(_mesh, _mesh->normals);
 }
 
 /*************/
-vector<float> Mesh::getAnnexe() const
+Mesh::AttributeView Mesh::getAnnexeView() const
 {
     lock_guard<Spinlock> lock(_readMutex);
-    vector<float> annexe;
-    for (auto& a : _mesh.annexe)
-    {
-        annexe.push_back(a[0]);
-        annexe.push_back(a[1]);
-        annexe.push_back(a[2]);
-        annexe.push_back(a[3]);
-    }
-    return annexe;
+    return makeAttributeView(_mesh, _mesh->annexe);
+}
+
+/*************/
+vector<float> Mesh::getVertCoords() const
+{
+    auto view = getVertCoordsView();
+    return vector<float>(view.begin(), view.end());
+}
+
+/*************/
+vector<float> Mesh::getUVCoords() const
+{
+    auto view = getUVCoordsView();
+    return vector<float>(view.begin(), view.end());
+}
+
+/*************/
+vector<float> Mesh::getNormals() const
+{
+    auto view = getNormalsView();
+    return vector<float>(view.begin(), view.end());
+}
+
+/*************/
+vector<float> Mesh::getAnnexe() const
+{
+    auto view = getAnnexeView();
+    return vector<float>(view.begin(), view.end());
 }
 
 /*************/
@@ -114,20 +149,34 @@ bool Mesh::read(const string& filename)
 {
     if (!_isConnectedToRemote)
     {
-        Loader::Obj objLoader;
-        if (!objLoader.load(filename))
+        // Meshes are cached once converted, to skip parsing unchanged files on the next loads. The source is described
+        // before being parsed, so that a file modified in the meantime is not cached as unchanged.
+        MeshContainer mesh;
+        auto& meshCache = MeshCache::get();
+        MeshCache::Source source;
+        bool useCache = meshCache.isEnabled() && MeshCache::getSource(filename, source);
+        if (!useCache || !meshCache.read(source, mesh.vertices, mesh.uvs, mesh.normals))
         {
-            Log::get() << Log::WARNING << "Mesh::" << __FUNCTION__ << " - Unable to read the specified mesh file: " << filename << Log::endl;
-            return false;
-        }
+            Loader::Obj objLoader;
+            if (!objLoader.load(filename))
+            {
+                Log::get() << Log::WARNING << "Mesh::" << __FUNCTION__ << " - Unable to read the specified mesh file: " << filename << Log::endl;
+                return false;
+            }
 
-        MeshContainer mesh;
-        mesh.vertices = objLoader.getVertices();
-        mesh.uvs = objLoader.getUVs();
-        mesh.normals = objLoader.getNormals();
+            mesh.vertices = objLoader.getVertices();
+            mesh.uvs = objLoader.getUVs();
+            auto normals = objLoader.getNormals();
+            mesh.normals.reserve(normals.size());
+            for (const auto& normal : normals)
+                mesh.normals.emplace_back(normal, 0.f);
+
+            if (useCache)
+                meshCache.write(source, mesh.vertices, mesh.uvs, mesh.normals);
+        }
 
         lock_guard<shared_timed_mutex> lock(_writeMutex);
-        _mesh = mesh;
+        _mesh = make_shared<MeshContainer>(std::move(mesh));
         updateTimestamp();
     }
 
@@ -137,36 +186,30 @@ bool Mesh::read(const string& filename)
 /*************/
 shared_ptr<SerializedObject> Mesh::serialize() const
 {
-    auto obj = make_shared<SerializedObject>();
-
     if (Timer::get().isDebug())
         Timer::get() << "serialize " + _name;
 
-    // For this, we will use the getVertex, getUV, etc. methods to create a serialized representation of the mesh
-    vector<vector<float>> data;
-    data.push_back(getVertCoords());
-    data.push_back(getUVCoords());
-    data.push_back(getNormals());
-    data.push_back(getAnnexe());
+    // The mesh is never modified once set, so it can be copied from without holding the lock
+    shared_ptr<const MeshContainer> mesh;
+    {
+        lock_guard<Spinlock> lock(_readMutex);
+        mesh = _mesh;
+    }
 
-    lock_guard<Spinlock> lock(_readMutex);
-    int nbrVertices = data[0].size() / 4;
-    int totalSize = sizeof(nbrVertices); // We add to all this the total number of vertices
-    for (auto& d : data)
-        totalSize += d.size() * sizeof(d[0]);
-    obj->resize(totalSize);
+    // Layout: the number of vertices, followed by each attribute copied as is
+    int nbrVertices = mesh->vertices.size();
+    auto totalSize = sizeof(nbrVertices) + mesh->vertices.size() * sizeof(glm::vec4) + mesh->uvs.size() * sizeof(glm::vec2) + mesh->normals.size() * sizeof(glm::vec4) +
+                     mesh->annexe.size() * sizeof(glm::vec4);
+    auto obj = make_shared<SerializedObject>(totalSize);
 
     auto currentObjPtr = obj->data();
-    const char* ptr = reinterpret_cast<const char*>(&nbrVertices);
-    copy(ptr, ptr + sizeof(nbrVertices), currentObjPtr);
+    memcpy(currentObjPtr, &nbrVertices, sizeof(nbrVertices));
     currentObjPtr += sizeof(nbrVertices);
 
-    for (auto& d : data)
-    {
-        ptr = reinterpret_cast<const char*>(d.data());
-        copy(ptr, ptr + d.size() * sizeof(float), currentObjPtr);
-        currentObjPtr += d.size() * sizeof(float);
-    }
+    writeAttribute(mesh->vertices, currentObjPtr);
+    writeAttribute(mesh->uvs, currentObjPtr);
+    writeAttribute(mesh->normals, currentObjPtr);
+    writeAttribute(mesh->annexe, currentObjPtr);
 
     if (Timer::get().isDebug())
         Timer::get() >> "serialize " + _name;
@@ -177,7 +220,7 @@ shared_ptr<SerializedObject> Mesh::serialize() const
 /*************/
 bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
 {
-    if (obj.get() == nullptr || obj->size() == 0)
+    if (obj.get() == nullptr || obj->size() < sizeof(int))
         return false;
 
     if (Timer::get().isDebug())
@@ -185,94 +228,59 @@ bool Mesh::deserialize(const shared_ptr<SerializedObject>& obj)
 
     // First, we get the number of vertices
     int nbrVertices;
-    char* ptr = reinterpret_cast<char*>(&nbrVertices);
-
-    auto currentObjPtr = obj->data();
-    copy(currentObjPtr, currentObjPtr + sizeof(nbrVertices), ptr); // This will fail if float have different size between sender and receiver
+    const char* currentObjPtr = obj->data();
+    memcpy(&nbrVertices, currentObjPtr, sizeof(nbrVertices)); // This will fail if float have different size between sender and receiver
     currentObjPtr += sizeof(nbrVertices);
 
-    if (nbrVertices < 0 || nbrVertices > obj->size())
+    const auto vertexSize = sizeof(glm::vec4) + sizeof(glm::vec2) + sizeof(glm::vec4);
+    if (nbrVertices < 0 || obj->size() < sizeof(nbrVertices) + static_cast<size_t>(nbrVertices) * vertexSize)
     {
         Log::get() << Log::WARNING << "Mesh::" << __FUNCTION__ << " - Bad buffer received, discarding" << Log::endl;
         return false;
     }
 
-    vector<vector<float>> data;
-    data.push_back(vector<float>(nbrVertices * 4));
-    data.push_back(vector<float>(nbrVertices * 2));
-    data.push_back(vector<float>(nbrVertices * 4));
+    // Check whether there is an annexe buffer in all this
+    const bool hasAnnexe = nbrVertices > 0 && obj->size() >= sizeof(nbrVertices) + static_cast<size_t>(nbrVertices) * (vertexSize + sizeof(glm::vec4));
 
-    bool hasAnnexe = false;
-    if (obj->size() > nbrVertices * 4 * 14) // Check whether there is an annexe buffer in all this
-    {
-        hasAnnexe = true;
-        data.push_back(vector<float>(nbrVertices * 4));
-    }
-
-    // Let's read the values
-    try
-    {
-        for (auto& d : data)
-        {
-            ptr = reinterpret_cast<char*>(d.data());
-            copy(currentObjPtr, currentObjPtr + d.size() * sizeof(float), ptr);
-            currentObjPtr += d.size() * sizeof(float);
-        }
+    MeshContainer mesh;
+    readAttribute(mesh.vertices, nbrVertices, currentObjPtr);
+    readAttribute(mesh.uvs, nbrVertices, currentObjPtr);
+    readAttribute(mesh.normals, nbrVertices, currentObjPtr);
+    if (hasAnnexe)
+        readAttribute(mesh.annexe, nbrVertices, currentObjPtr);
 
-        // Next step: use these values to reset the vertices of _mesh
-        MeshContainer mesh;
+    _bufferMesh = std::move(mesh);
+    _meshUpdated = true;
 
-        mesh.vertices.resize(nbrVertices);
-        for (unsigned int i = 0; i < nbrVertices; ++i)
-        {
-            mesh.vertices[i][0] = data[0][i * 4 + 0];
-            mesh.vertices[i][1] = data[0][i * 4 + 1];
-            mesh.vertices[i][2] = data[0][i * 4 + 2];
-            mesh.vertices[i][3] = data[0][i * 4 + 3];
-        }
+    updateTimestamp();
 
-        mesh.uvs.resize(nbrVertices);
-        for (unsigned int i = 0; i < nbrVertices; ++i)
-        {
-            mesh.uvs[i][0] = data[1][i * 2 + 0];
-            mesh.uvs[i][1] = data[1][i * 2 + 1];
-        }
+    if (Timer::get().isDebug())
+        Timer::get() >> "deserialize " + _name;
 
-        mesh.normals.resize(nbrVertices);
-        for (unsigned int i = 0; i < nbrVertices; ++i)
-        {
-            mesh.normals[i][0] = data[2][i * 4 + 0];
-            mesh.normals[i][1] = data[2][i * 4 + 1];
-            mesh.normals[i][2] = data[2][i * 4 + 2];
-        }
+    return true;
+}
 
-        if (hasAnnexe)
-        {
-            mesh.annexe.resize(nbrVertices);
-            for (unsigned int i = 0; i < nbrVertices; ++i)
-            {
-                mesh.annexe[i][0] = data[3][i * 4 + 0];
-                mesh.annexe[i][1] = data[3][i * 4 + 1];
-                mesh.annexe[i][2] = data[3][i * 4 + 2];
-                mesh.annexe[i][3] = data[3][i * 4 + 3];
-            }
-        }
+/*************/
+shared_ptr<BufferSnapshot> Mesh::getSnapshot() const
+{
+    lock_guard<Spinlock> lock(_readMutex);
+    return make_shared<SharedBufferSnapshot<MeshContainer>>(_mesh);
+}
 
-        _bufferMesh = mesh;
-        _meshUpdated = true;
+/*************/
+bool Mesh::setSnapshot(const shared_ptr<BufferSnapshot>& snapshot)
+{
+    auto meshSnapshot = dynamic_pointer_cast<SharedBufferSnapshot<MeshContainer>>(snapshot);
+    if (!meshSnapshot || !meshSnapshot->content)
+        return false;
 
-        updateTimestamp();
-    }
-    catch (...)
     {
-        createDefaultMesh();
-        Log::get()(Log::ERROR, __FUNCTION__, " - Unable to deserialize the given object");
-        return false;
+        lock_guard<Spinlock> lock(_readMutex);
+        _snapshotMesh = meshSnapshot->content;
+        _meshUpdated = true;
     }
 
-    if (Timer::get().isDebug())
-        Timer::get() >> "deserialize " + _name;
-
+    updateTimestamp();
     return true;
 }
 
@@ -283,7 +291,15 @@ void Mesh::update()
     {
         lock_guard<Spinlock> lock(_readMutex);
         shared_lock<shared_timed_mutex> lockWrite(_writeMutex);
-        _mesh = _bufferMesh;
+        if (_snapshotMesh)
+        {
+            _mesh = std::move(_snapshotMesh);
+        }
+        else
+        {
+            _mesh = make_shared<MeshContainer>(std::move(_bufferMesh));
+            _bufferMesh = MeshContainer();
+        }
         _meshUpdated = false;
     }
     else if (_benchmark)
@@ -340,17 +356,17 @@ void Mesh::createDefaultMesh(int subdiv)
             mesh.uvs.push_back(uvs[u + 1 + (v + 1) * (subdiv + 2)]);
             mesh.uvs.push_back(uvs[u + (v + 1) * (subdiv + 2)]);
 
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
         }
     }
 
     lock_guard<shared_timed_mutex> lock(_writeMutex);
-    _mesh = std::move(mesh);
+    _mesh = make_shared<MeshContainer>(std::move(mesh));
 
     updateTimestamp();
 }
@@ -379,6 +395,22 @@ void Mesh::registerAttributes()
         },
         {'n'});
     setAttributeDescription("benchmark", "Set to 1 to resend the image even when not updated");
+
+    addAttribute("vertexCount",
+        [&](const Values& args) {
+            auto vertexCount = args[0].as<int>();
+            if (vertexCount <= 0)
+                return false;
+            // The plane is made of 6 * (subdivisions + 1)^2 vertices
+            createDefaultMesh(static_cast<int>(ceil(sqrt(vertexCount / 6.0))) - 1);
+            return true;
+        },
+        [&]() -> Values {
+            shared_lock<shared_timed_mutex> lock(_writeMutex);
+            return {static_cast<int>(_mesh->vertices.size())};
+        },
+        {'n'});
+    setAttributeDescription("vertexCount", "Replace the mesh with a plane made of at least the given number of vertices, for benchmarking purposes");
 }
 
 } // end of namespace
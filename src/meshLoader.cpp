@@ -0,0 +1,394 @@
+#include "./meshLoader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+
+#include "./mapped_file.h"
+#include "./thread_pool.h"
+
+using namespace std;
+
+namespace Splash
+{
+namespace Loader
+{
+
+/*************/
+struct Obj::Chunk
+{
+    vector<glm::vec4> vertices{};
+    vector<glm::vec2> uvs{};
+    vector<glm::vec3> normals{};
+    vector<FaceVertex> faces{};
+    vector<pair<size_t, uint8_t>> relativeIds{}; //!< Face vertices holding ids relative to the chunk, with a mask of these ids
+};
+
+namespace
+{
+const uint8_t relativeVertex = 1;
+const uint8_t relativeUV = 2;
+const uint8_t relativeNormal = 4;
+
+/*************/
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/*************/
+inline bool isEndOfLine(char c)
+{
+    return c == '\n' || c == '\r';
+}
+
+/*************/
+inline const char* skipBlanks(const char* ptr)
+{
+    while (isBlank(*ptr))
+        ++ptr;
+    return ptr;
+}
+
+/*************/
+// Parse up to count floats from the current line, the same way std::stof does
+int parseFloats(const char* ptr, float* values, int count)
+{
+    int index = 0;
+    while (index < count)
+    {
+        ptr = skipBlanks(ptr);
+        if (isEndOfLine(*ptr))
+            break;
+
+        char* next = nullptr;
+        values[index] = strtof(ptr, &next);
+        if (next == ptr)
+            break;
+        ptr = next;
+        ++index;
+    }
+    return index;
+}
+
+/*************/
+// Parse an integer, the same way std::stoi does. Leaves ptr untouched if there is none
+bool parseInt(const char*& ptr, int& value)
+{
+    auto current = ptr;
+    bool negative = false;
+    if (*current == '-' || *current == '+')
+        negative = *(current++) == '-';
+    if (*current < '0' || *current > '9')
+        return false;
+
+    int result = 0;
+    while (*current >= '0' && *current <= '9')
+        result = result * 10 + (*(current++) - '0');
+
+    value = negative ? -result : result;
+    ptr = current;
+    return true;
+}
+
+/*************/
+// Convert an OBJ index to an id. Negative indices count backwards from the last element, and are kept relative to the chunk
+void resolveIndex(int index, size_t count, int& id, uint8_t& mask, uint8_t relativeFlag)
+{
+    if (index < 0)
+    {
+        id = static_cast<int>(count) + index;
+        mask |= relativeFlag;
+    }
+    else
+    {
+        id = index - 1;
+    }
+}
+}
+
+const size_t Obj::minChunkSize;
+
+/*************/
+bool Obj::load(const string& filename)
+{
+    MappedFile file(filename);
+    if (!file.data())
+        return false;
+
+    _vertices.clear();
+    _uvs.clear();
+    _normals.clear();
+    _faces.clear();
+
+    // Chunks hold whole lines, each one ending with a line feed. This keeps the parser from reading past
+    // the mapping, so the last line is copied if the file does not end with a line feed.
+    auto data = file.data();
+    auto linesEnd = data + file.size();
+    while (linesEnd != data && *(linesEnd - 1) != '\n')
+        --linesEnd;
+    string lastLine(linesEnd, data + file.size());
+    if (!lastLine.empty())
+        lastLine.push_back('\n');
+
+    auto& threadPool = ThreadPool::get();
+    size_t linesSize = linesEnd - data;
+    size_t chunkCount = max<size_t>(1, min<size_t>(threadPool.getWorkerCount(), linesSize / minChunkSize));
+
+    vector<const char*> bounds{data};
+    for (size_t i = 1; i < chunkCount; ++i)
+    {
+        auto bound = max(data + linesSize * i / chunkCount, bounds.back());
+        auto lineFeed = static_cast<const char*>(memchr(bound, '\n', linesEnd - bound));
+        bounds.push_back(lineFeed ? lineFeed + 1 : linesEnd);
+    }
+    bounds.push_back(linesEnd);
+
+    vector<Chunk> chunks(chunkCount + 1);
+    if (chunkCount == 1)
+    {
+        parseChunk(bounds[0], bounds[1], chunks[0]);
+    }
+    else
+    {
+        // The calling thread parses the first chunk itself, then only waits for the futures of this load
+        vector<future<void>> futures;
+        for (size_t i = 1; i < chunkCount; ++i)
+            futures.push_back(threadPool.enqueue([&, i]() { parseChunk(bounds[i], bounds[i + 1], chunks[i]); }));
+        parseChunk(bounds[0], bounds[1], chunks[0]);
+        threadPool.waitFor(futures);
+    }
+    parseChunk(lastLine.data(), lastLine.data() + lastLine.size(), chunks.back());
+
+    // Merge the chunks in order, so that the result is the same as when parsing sequentially
+    size_t vertexCount = 0, uvCount = 0, normalCount = 0, faceVertexCount = 0;
+    for (const auto& chunk : chunks)
+    {
+        vertexCount += chunk.vertices.size();
+        uvCount += chunk.uvs.size();
+        normalCount += chunk.normals.size();
+        faceVertexCount += chunk.faces.size();
+    }
+    _vertices.reserve(vertexCount);
+    _uvs.reserve(uvCount);
+    _normals.reserve(normalCount);
+    _faces.reserve(faceVertexCount);
+
+    for (auto& chunk : chunks)
+    {
+        appendChunk(chunk);
+        chunk = Chunk();
+    }
+
+    // Check that we have faces and vertices, and that faces only refer to existing data
+    bool facesAreValid = checkFaces();
+    if (!facesAreValid)
+        Log::get() << Log::WARNING << "Loader::Obj::" << __FUNCTION__ << " - Faces refer to missing vertices, UVs or normals in file " << filename << Log::endl;
+
+    if (_vertices.size() == 0 || _faces.size() == 0 || !facesAreValid)
+    {
+        _vertices.clear();
+        _faces.clear();
+        _uvs.clear();
+        _normals.clear();
+
+        return false;
+    }
+
+    return true;
+}
+
+/*************/
+vector<glm::vec4> Obj::getVertices() const
+{
+    vector<glm::vec4> vertices;
+    vertices.reserve(_faces.size());
+
+    for (const auto& faceVertex : _faces)
+        vertices.push_back(_vertices[faceVertex.vertexId]);
+
+    return vertices;
+}
+
+/*************/
+vector<glm::vec2> Obj::getUVs() const
+{
+    vector<glm::vec2> uvs;
+    uvs.reserve(_faces.size());
+
+    for (size_t i = 0; i < _faces.size(); i += 3)
+    {
+        if (_faces[i].uvId == -1)
+        {
+            uvs.insert(uvs.end(), 3, glm::vec2(0.f, 0.f));
+        }
+        else
+        {
+            uvs.push_back(_uvs[_faces[i].uvId]);
+            uvs.push_back(_uvs[_faces[i + 1].uvId]);
+            uvs.push_back(_uvs[_faces[i + 2].uvId]);
+        }
+    }
+
+    return uvs;
+}
+
+/*************/
+vector<glm::vec3> Obj::getNormals() const
+{
+    vector<glm::vec3> normals;
+    normals.reserve(_faces.size());
+
+    for (size_t i = 0; i < _faces.size(); i += 3)
+    {
+        if (_faces[i].normalId == -1)
+        {
+            auto edge1 = glm::vec3(_vertices[_faces[i + 1].vertexId] - _vertices[_faces[i].vertexId]);
+            auto edge2 = glm::vec3(_vertices[_faces[i + 2].vertexId] - _vertices[_faces[i].vertexId]);
+            auto normal = glm::normalize(glm::cross(edge1, edge2));
+            normals.insert(normals.end(), 3, normal);
+        }
+        else
+        {
+            normals.push_back(_normals[_faces[i].normalId]);
+            normals.push_back(_normals[_faces[i + 1].normalId]);
+            normals.push_back(_normals[_faces[i + 2].normalId]);
+        }
+    }
+
+    return normals;
+}
+
+/*************/
+void Obj::parseChunk(const char* begin, const char* end, Chunk& chunk)
+{
+    for (auto line = begin; line < end;)
+    {
+        auto lineEnd = static_cast<const char*>(memchr(line, '\n', end - line));
+
+        if (line[0] == 'v' && isBlank(line[1]))
+        {
+            glm::vec4 vertex(0.f, 0.f, 0.f, 1.f);
+            parseFloats(line + 2, &vertex[0], 4);
+            chunk.vertices.push_back(vertex);
+        }
+        else if (line[0] == 'v' && line[1] == 't' && isBlank(line[2]))
+        {
+            glm::vec2 uv(0.f, 0.f);
+            parseFloats(line + 3, &uv[0], 2);
+            chunk.uvs.push_back(uv);
+        }
+        else if (line[0] == 'v' && line[1] == 'n' && isBlank(line[2]))
+        {
+            glm::vec3 normal(0.f, 0.f, 0.f);
+            parseFloats(line + 3, &normal[0], 3);
+            chunk.normals.push_back(normal);
+        }
+        else if (line[0] == 'f' && isBlank(line[1]))
+        {
+            // Face vertices are either v, v/vt, v//vn or v/vt/vn
+            FaceVertex face[4];
+            uint8_t masks[4]{0, 0, 0, 0};
+            int faceSize = 0;
+            for (auto ptr = skipBlanks(line + 2); !isEndOfLine(*ptr); ptr = skipBlanks(ptr))
+            {
+                FaceVertex faceVertex;
+                uint8_t mask = 0;
+                int index = 0;
+                if (!parseInt(ptr, index))
+                    break;
+                resolveIndex(index, chunk.vertices.size(), faceVertex.vertexId, mask, relativeVertex);
+
+                if (*ptr == '/')
+                {
+                    ++ptr;
+                    if (parseInt(ptr, index))
+                        resolveIndex(index, chunk.uvs.size(), faceVertex.uvId, mask, relativeUV);
+                    if (*ptr == '/')
+                    {
+                        ++ptr;
+                        if (parseInt(ptr, index))
+                            resolveIndex(index, chunk.normals.size(), faceVertex.normalId, mask, relativeNormal);
+                    }
+                }
+
+                while (!isBlank(*ptr) && !isEndOfLine(*ptr))
+                    ++ptr;
+
+                // Only tris and quads are supported, additional vertices are ignored
+                if (faceSize < 4)
+                {
+                    face[faceSize] = faceVertex;
+                    masks[faceSize] = mask;
+                }
+                ++faceSize;
+            }
+
+            // We triangulate faces right away if needed
+            static const int triangle[] = {0, 1, 2};
+            static const int quad[] = {0, 1, 2, 2, 3, 0};
+            const int* order = faceSize == 3 ? triangle : quad;
+            const int orderSize = faceSize == 3 ? 3 : (faceSize >= 4 ? 6 : 0);
+            for (int i = 0; i < orderSize; ++i)
+            {
+                if (masks[order[i]] != 0)
+                    chunk.relativeIds.emplace_back(chunk.faces.size(), masks[order[i]]);
+                chunk.faces.push_back(face[order[i]]);
+            }
+        }
+
+        line = lineEnd + 1;
+    }
+}
+
+/*************/
+void Obj::appendChunk(Chunk& chunk)
+{
+    const auto vertexOffset = static_cast<int>(_vertices.size());
+    const auto uvOffset = static_cast<int>(_uvs.size());
+    const auto normalOffset = static_cast<int>(_normals.size());
+    const auto faceOffset = _faces.size();
+
+    _vertices.insert(_vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+    _uvs.insert(_uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+    _normals.insert(_normals.end(), chunk.normals.begin(), chunk.normals.end());
+    _faces.insert(_faces.end(), chunk.faces.begin(), chunk.faces.end());
+
+    for (const auto& relativeId : chunk.relativeIds)
+    {
+        auto& faceVertex = _faces[faceOffset + relativeId.first];
+        if (relativeId.second & relativeVertex)
+            faceVertex.vertexId += vertexOffset;
+        if (relativeId.second & relativeUV)
+            faceVertex.uvId += uvOffset;
+        if (relativeId.second & relativeNormal)
+            faceVertex.normalId += normalOffset;
+    }
+}
+
+/*************/
+bool Obj::checkFaces() const
+{
+    auto isValid = [](int id, size_t count) { return id >= 0 && static_cast<size_t>(id) < count; };
+
+    for (size_t i = 0; i < _faces.size(); i += 3)
+    {
+        const bool hasUVs = _faces[i].uvId != -1;
+        const bool hasNormals = _faces[i].normalId != -1;
+        for (size_t v = i; v < i + 3; ++v)
+        {
+            if (!isValid(_faces[v].vertexId, _vertices.size()))
+                return false;
+            if (hasUVs && !isValid(_faces[v].uvId, _uvs.size()))
+                return false;
+            if (hasNormals && !isValid(_faces[v].normalId, _normals.size()))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+} // end of namespace
+} // end of namespace
@@ -138,12 +138,12 @@ void Mesh_BezierPatch::createPatch(Patch& patch)
             mesh.uvs.push_back(patch.uvs[u + (v + 1) * width]);
             mesh.uvs.push_back(patch.uvs[u + 1 + v * width]);
 
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
         }
     }
     _bezierControl = mesh;
@@ -223,12 +223,12 @@ void Mesh_BezierPatch::updatePatch()
             mesh.uvs.push_back(uvs[u + 1 + (v + 1) * _patchResolution]);
             mesh.uvs.push_back(uvs[u + (v + 1) * _patchResolution]);
 
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
-            mesh.normals.push_back(glm::vec3(0.0, 0.0, 1.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
+            mesh.normals.push_back(glm::vec4(0.0, 0.0, 1.0, 0.0));
         }
     }
 
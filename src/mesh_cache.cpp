@@ -0,0 +1,321 @@
+#include "./mesh_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utime.h>
+
+#include "./log.h"
+#include "./mapped_file.h"
+#include "./osUtils.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+const uint16_t MeshCache::fileVersion;
+
+namespace
+{
+const uint32_t cacheMagic = 0x434D5053; // "SPMC", in little endian
+const string cacheExtension = ".mesh";
+
+/*************/
+// Header of the cache files, followed by the source path, the vertices, the UVs and the normals
+struct CacheHeader
+{
+    uint32_t magic{cacheMagic};
+    uint16_t version{MeshCache::fileVersion};
+    uint16_t headerSize{sizeof(CacheHeader)};
+    uint32_t pathSize{0};
+    uint32_t reserved{0};
+    uint64_t sourceSize{0};
+    int64_t sourceModificationTime{0}; //!< In nanoseconds
+    uint64_t contentHash{0};
+    uint64_t vertexCount{0};
+    uint64_t uvCount{0};
+    uint64_t normalCount{0};
+};
+
+/*************/
+// Fast non-cryptographic hash, reading 32 bytes per iteration over four independent lanes
+uint64_t hashContent(const char* data, size_t size)
+{
+    const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    auto rotate = [](uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); };
+
+    uint64_t lanes[4] = {prime1 + prime2, prime2, 0, 0 - prime1};
+    size_t position = 0;
+    for (; position + 32 <= size; position += 32)
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            uint64_t word;
+            memcpy(&word, data + position + lane * 8, sizeof(word));
+            lanes[lane] = rotate(lanes[lane] + word * prime2, 31) * prime1;
+        }
+    }
+
+    uint64_t hash = size;
+    for (auto lane : lanes)
+        hash = rotate(hash ^ (rotate(lane * prime2, 31) * prime1), 27) * prime1 + prime2;
+    for (; position < size; ++position)
+        hash = rotate(hash ^ (static_cast<uint8_t>(data[position]) * prime1), 11) * prime2;
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    return hash;
+}
+
+/*************/
+// Get the modification time of a file, in nanoseconds
+int64_t getModificationTime(const struct stat& fileStat)
+{
+    return static_cast<int64_t>(fileStat.st_mtim.tv_sec) * 1000000000 + fileStat.st_mtim.tv_nsec;
+}
+
+/*************/
+// Resolve the path of a source file, so that a file gets the same key whatever the path used to reach it
+string getCanonicalPath(const string& path)
+{
+    char resolvedPath[PATH_MAX];
+    if (realpath(path.c_str(), resolvedPath) == nullptr)
+        return path;
+    return string(resolvedPath);
+}
+
+/*************/
+bool createDirectories(const string& directory)
+{
+    for (size_t position = directory.find('/', 1); position != string::npos; position = directory.find('/', position + 1))
+        mkdir(directory.substr(0, position).c_str(), 0755);
+    mkdir(directory.c_str(), 0755);
+    return Utils::isDir(directory);
+}
+
+/*************/
+template <typename T>
+void readAttribute(vector<T>& attribute, size_t count, const char*& ptr)
+{
+    attribute.resize(count);
+    if (count != 0)
+        memcpy(attribute.data(), ptr, count * sizeof(T));
+    ptr += count * sizeof(T);
+}
+
+/*************/
+template <typename T>
+void writeAttribute(ofstream& file, const vector<T>& attribute)
+{
+    file.write(reinterpret_cast<const char*>(attribute.data()), attribute.size() * sizeof(T));
+}
+}
+
+/*************/
+bool MeshCache::getSource(const string& sourcePath, Source& source)
+{
+    source.path = getCanonicalPath(sourcePath);
+    MappedFile sourceFile(source.path);
+    if (!sourceFile.data())
+        return false;
+
+    source.size = sourceFile.size();
+    source.modificationTime = getModificationTime(sourceFile.getStat());
+    source.contentHash = hashContent(sourceFile.data(), sourceFile.size());
+    return true;
+}
+
+/*************/
+bool MeshCache::read(const Source& source, vector<glm::vec4>& vertices, vector<glm::vec2>& uvs, vector<glm::vec4>& normals)
+{
+    auto cachePath = getCachePath(source.path);
+    if (cachePath.empty())
+        return false;
+
+    MappedFile cacheFile(cachePath);
+    if (!cacheFile.data() || cacheFile.size() < sizeof(CacheHeader))
+        return false;
+
+    CacheHeader header;
+    memcpy(&header, cacheFile.data(), sizeof(header));
+    if (header.magic != cacheMagic || header.version != fileVersion || header.headerSize != sizeof(CacheHeader))
+        return false;
+
+    const auto maxCount = cacheFile.size() / sizeof(glm::vec2);
+    if (header.pathSize > cacheFile.size() || header.vertexCount > maxCount || header.uvCount > maxCount || header.normalCount > maxCount)
+        return false;
+    const auto expectedSize =
+        sizeof(CacheHeader) + header.pathSize + header.vertexCount * sizeof(glm::vec4) + header.uvCount * sizeof(glm::vec2) + header.normalCount * sizeof(glm::vec4);
+    if (cacheFile.size() != expectedSize)
+    {
+        Log::get() << Log::WARNING << "MeshCache::" << __FUNCTION__ << " - Cache file " << cachePath << " does not have the expected size, ignoring it" << Log::endl;
+        return false;
+    }
+
+    // Check that the source has not changed since it was cached
+    auto ptr = cacheFile.data() + sizeof(CacheHeader);
+    if (source.path != string(ptr, header.pathSize))
+        return false;
+    ptr += header.pathSize;
+
+    if (source.size != header.sourceSize || source.modificationTime != header.sourceModificationTime || source.contentHash != header.contentHash)
+        return false;
+
+    readAttribute(vertices, header.vertexCount, ptr);
+    readAttribute(uvs, header.uvCount, ptr);
+    readAttribute(normals, header.normalCount, ptr);
+
+    // Mark the cache file as recently used
+    utime(cachePath.c_str(), nullptr);
+
+    return true;
+}
+
+/*************/
+bool MeshCache::write(const Source& source, const vector<glm::vec4>& vertices, const vector<glm::vec2>& uvs, const vector<glm::vec4>& normals)
+{
+    auto cachePath = getCachePath(source.path);
+    if (cachePath.empty())
+        return false;
+
+    CacheHeader header;
+    header.pathSize = source.path.size();
+    header.sourceSize = source.size;
+    header.sourceModificationTime = source.modificationTime;
+    header.contentHash = source.contentHash;
+    header.vertexCount = vertices.size();
+    header.uvCount = uvs.size();
+    header.normalCount = normals.size();
+
+    auto directory = cachePath.substr(0, cachePath.rfind('/') + 1);
+    if (!createDirectories(directory))
+    {
+        Log::get() << Log::WARNING << "MeshCache::" << __FUNCTION__ << " - Unable to create the cache directory " << directory << Log::endl;
+        return false;
+    }
+
+    // Write to a temporary file first, so that readers never see a partial cache file
+    static atomic_uint temporaryIndex{0};
+    auto temporaryPath = cachePath + "." + to_string(getpid()) + "_" + to_string(temporaryIndex++) + ".tmp";
+    {
+        ofstream file(temporaryPath, ios::out | ios::binary | ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(source.path.data(), source.path.size());
+        writeAttribute(file, vertices);
+        writeAttribute(file, uvs);
+        writeAttribute(file, normals);
+        if (!file.good())
+        {
+            file.close();
+            unlink(temporaryPath.c_str());
+            Log::get() << Log::WARNING << "MeshCache::" << __FUNCTION__ << " - Unable to write cache file " << cachePath << Log::endl;
+            return false;
+        }
+    }
+
+    if (rename(temporaryPath.c_str(), cachePath.c_str()) != 0)
+    {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+
+    lock_guard<mutex> lock(_mutex);
+    evict();
+    return true;
+}
+
+/*************/
+string MeshCache::getCachePath(const string& sourcePath) const
+{
+    auto directory = getDirectory();
+    if (directory.empty())
+        return {};
+
+    auto canonicalPath = getCanonicalPath(sourcePath);
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hashContent(canonicalPath.data(), canonicalPath.size())));
+    return directory + name + cacheExtension;
+}
+
+/*************/
+void MeshCache::setDirectory(const string& directory)
+{
+    lock_guard<mutex> lock(_mutex);
+    _directory = directory;
+    if (!_directory.empty() && _directory.back() != '/')
+        _directory += "/";
+}
+
+/*************/
+string MeshCache::getDirectory() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _directory;
+}
+
+/*************/
+void MeshCache::setMaxSize(size_t size)
+{
+    lock_guard<mutex> lock(_mutex);
+    _maxSize = size;
+    evict();
+}
+
+/*************/
+size_t MeshCache::getMaxSize() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _maxSize;
+}
+
+/*************/
+void MeshCache::evict()
+{
+    if (_directory.empty() || !Utils::isDir(_directory))
+        return;
+
+    struct CacheFile
+    {
+        string path;
+        size_t size;
+        int64_t lastUse;
+    };
+
+    vector<CacheFile> cacheFiles;
+    size_t totalSize = 0;
+    for (const auto& filename : Utils::listDirContent(_directory))
+    {
+        if (filename.size() <= cacheExtension.size() || filename.compare(filename.size() - cacheExtension.size(), cacheExtension.size(), cacheExtension) != 0)
+            continue;
+
+        auto path = _directory + filename;
+        struct stat fileStat;
+        if (stat(path.c_str(), &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+            continue;
+
+        cacheFiles.push_back({path, static_cast<size_t>(fileStat.st_size), getModificationTime(fileStat)});
+        totalSize += fileStat.st_size;
+    }
+
+    if (totalSize <= _maxSize)
+        return;
+
+    // Least recently used files go first
+    sort(cacheFiles.begin(), cacheFiles.end(), [](const CacheFile& lhs, const CacheFile& rhs) { return lhs.lastUse < rhs.lastUse; });
+    for (const auto& cacheFile : cacheFiles)
+    {
+        if (totalSize <= _maxSize)
+            break;
+        if (unlink(cacheFile.path.c_str()) == 0)
+            totalSize -= cacheFile.size;
+    }
+}
+
+} // end of namespace
@@ -72,7 +72,7 @@ void Mesh_Shmdata::onData(void* data, int data_size)
 
     vector<glm::vec4> vertices(verticeNbr);
     vector<glm::vec2> uvs(verticeNbr);
-    vector<glm::vec3> normals(verticeNbr);
+    vector<glm::vec4> normals(verticeNbr);
 
     floatPtr += 2;
     // First, create the vertices with no UV, normals or faces
@@ -80,7 +80,7 @@ void Mesh_Shmdata::onData(void* data, int data_size)
     {
         vertices[v] = glm::vec4(floatPtr[0], floatPtr[1], floatPtr[2], 1.f);
         uvs[v] = glm::vec2(floatPtr[3], floatPtr[4]);
-        normals[v] = glm::vec3(floatPtr[5], floatPtr[6], floatPtr[7]);
+        normals[v] = glm::vec4(floatPtr[5], floatPtr[6], floatPtr[7], 0.f);
         floatPtr += 8;
     }
 
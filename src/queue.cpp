@@ -1,8 +1,10 @@
 #include "queue.h"
 
 #include <algorithm>
+#include <chrono>
 
 #include "./log.h"
+#include "./thread_pool.h"
 #include "./timer.h"
 #include "./world.h"
 
@@ -30,6 +32,8 @@ Queue::Queue(RootObject* root)
 /*************/
 Queue::~Queue()
 {
+    if (_prerollFuture.valid())
+        ThreadPool::get().waitFor(_prerollFuture);
 }
 
 /*************/
@@ -85,13 +89,7 @@ void Queue::update()
     }
 
     // Get the current index regarding the current time
-    uint32_t sourceIndex = 0;
-    for (auto& playSource : _playlist)
-    {
-        if (playSource.start <= _currentTime && playSource.stop > _currentTime)
-            break;
-        sourceIndex++;
-    }
+    uint32_t sourceIndex = findSourceIndex(_currentTime);
 
     // If loop is activated, and master clock is not used
     if (!_useClock && _loop && sourceIndex >= _playlist.size())
@@ -111,6 +109,7 @@ void Queue::update()
         }
 
         _currentSourceIndex = sourceIndex;
+        releaseSource(std::move(_currentSource));
 
         if (sourceIndex >= _playlist.size())
         {
@@ -121,44 +120,31 @@ void Queue::update()
         {
             auto& sourceParameters = _playlist[_currentSourceIndex];
 
-            if (!_currentSource || _currentSource->getType() != sourceParameters.type)
-                _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
+            // Use the prerolled source if it is the right one, otherwise open the file right now
+            _currentSource = takePrerolledSource(_currentSourceIndex);
+            if (!_currentSource)
+                _currentSource = createSource(sourceParameters);
 
             if (_currentSource)
-                _playing = true;
-            else
-                _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
-            dynamic_pointer_cast<Image>(_currentSource)->zero();
-            dynamic_pointer_cast<Image>(_currentSource)->setName(_name + DISTANT_NAME_SUFFIX);
-
-            _currentSource->setAttribute("file", {sourceParameters.filename});
-
-            if (_useClock && !sourceParameters.freeRun)
             {
-                // If we use the master clock, set a timeshift to be correctly placed in the video
-                // (as the source gets its clock from the same Timer)
-                _currentSource->setAttribute("timeShift", {-(float)sourceParameters.start / 1e6});
-                _currentSource->setAttribute("useClock", {1});
+                _playing = true;
             }
             else
             {
-                _currentSource->setAttribute("useClock", {0});
+                _currentSource = dynamic_pointer_cast<BufferObject>(_factory->create("image"));
+                dynamic_pointer_cast<Image>(_currentSource)->zero();
+                _currentSource->setName(_name + DISTANT_NAME_SUFFIX);
             }
 
+            _currentSource->setAttribute("pause", {0});
             _root->sendMessage(_name, "source", {sourceParameters.type});
 
-            for (const auto& arg : sourceParameters.args)
-            {
-                if (!arg.isNamed())
-                    continue;
-
-                _currentSource->setAttribute(arg.getName(), arg.as<Values>());
-            }
-
             Log::get() << Log::MESSAGE << "Queue::" << __FUNCTION__ << " - Playing file: " << sourceParameters.filename << Log::endl;
         }
     }
 
+    prerollNextSource();
+
     if (!_useClock && !_playlist[_currentSourceIndex].freeRun && _seeked)
     {
         // If we don't use the master clock, we want to seek accordingly in the file
@@ -170,6 +156,120 @@ void Queue::update()
         _currentSource->update();
 }
 
+/*************/
+shared_ptr<BufferObject> Queue::createSource(const Source& sourceParameters)
+{
+    auto source = dynamic_pointer_cast<BufferObject>(_factory->create(sourceParameters.type));
+    if (!source)
+        return {nullptr};
+
+    auto image = dynamic_pointer_cast<Image>(source);
+    if (image)
+        image->zero();
+    source->setName(_name + DISTANT_NAME_SUFFIX);
+
+    // Videos opened paused still decode and show their first frame
+    source->setAttribute("pause", {1});
+    source->setAttribute("file", {sourceParameters.filename});
+
+    if (_useClock && !sourceParameters.freeRun)
+    {
+        // If we use the master clock, set a timeshift to be correctly placed in the video
+        // (as the source gets its clock from the same Timer)
+        source->setAttribute("timeShift", {-(float)sourceParameters.start / 1e6});
+        source->setAttribute("useClock", {1});
+    }
+    else
+    {
+        source->setAttribute("useClock", {0});
+    }
+
+    for (const auto& arg : sourceParameters.args)
+    {
+        if (!arg.isNamed())
+            continue;
+
+        source->setAttribute(arg.getName(), arg.as<Values>());
+    }
+
+    return source;
+}
+
+/*************/
+uint32_t Queue::findSourceIndex(int64_t time) const
+{
+    auto sourceIt = upper_bound(_playlist.begin(), _playlist.end(), time, [](int64_t t, const Source& source) { return t < source.start; });
+    if (sourceIt == _playlist.begin())
+        return _playlist.size();
+
+    --sourceIt;
+    if (sourceIt->stop <= time)
+        return _playlist.size();
+
+    return static_cast<uint32_t>(sourceIt - _playlist.begin());
+}
+
+/*************/
+void Queue::prerollNextSource()
+{
+    // A preroll outdated by a playlist change is dropped once done, so that the new next source can be prerolled
+    if (_prerollFuture.valid() && _prerollIndex == -1 && _prerollFuture.wait_for(chrono::seconds(0)) == future_status::ready)
+    {
+        _prerollFuture = future<void>();
+        releaseSource(std::move(_prerollSource));
+    }
+
+    if (_prerollFuture.valid() || _currentSourceIndex < 0 || _currentSourceIndex >= static_cast<int32_t>(_playlist.size()))
+        return;
+
+    auto nextIndex = _currentSourceIndex + 1;
+    auto nextStart = _playlist[_currentSourceIndex].stop;
+    if (nextIndex >= static_cast<int32_t>(_playlist.size()))
+    {
+        if (_useClock || !_loop)
+            return;
+        nextIndex = 0;
+    }
+
+    if (nextStart - _currentTime > _prerollDuration)
+        return;
+
+    _prerollIndex = nextIndex;
+    auto sourceParameters = _playlist[nextIndex];
+    _prerollFuture = ThreadPool::get().enqueue([=]() { _prerollSource = createSource(sourceParameters); });
+}
+
+/*************/
+shared_ptr<BufferObject> Queue::takePrerolledSource(int32_t index)
+{
+    if (!_prerollFuture.valid())
+        return {nullptr};
+
+    // The preroll started long enough ago to be done, except after a seek
+    ThreadPool::get().waitFor(_prerollFuture);
+    _prerollFuture = future<void>();
+
+    auto source = std::move(_prerollSource);
+    if (_prerollIndex != index)
+    {
+        releaseSource(std::move(source));
+        return {nullptr};
+    }
+
+    return source;
+}
+
+/*************/
+void Queue::releaseSource(shared_ptr<BufferObject>&& source)
+{
+    if (!source)
+        return;
+
+    // The holder makes sure the last reference is dropped by the worker
+    auto holder = make_shared<shared_ptr<BufferObject>>(std::move(source));
+    ThreadPool::get().enqueue([holder]() { holder->reset(); });
+}
+
 /*************/
 void Queue::cleanPlaylist(vector<Source>& playlist)
 {
@@ -302,6 +402,7 @@ void Queue::registerAttributes()
         [&](const Values& args) {
             lock_guard<mutex> lock(_playlistMutex);
             _playlist.clear();
+            _prerollIndex = -1; // Any prerolled source is outdated
 
             for (auto& it : args)
             {
@@ -0,0 +1,54 @@
+#include "./render_list.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+bool RenderList::update(const unordered_map<string, shared_ptr<BaseObject>>& objects, uint64_t objectsGeneration)
+{
+    auto renderingStateVersion = BaseObject::getRenderingStateVersion();
+    if (_isBuilt && objectsGeneration == _objectsGeneration && renderingStateVersion == _renderingStateVersion)
+        return false;
+
+    vector<pair<BaseObject::Priority, shared_ptr<BaseObject>>> entries;
+    entries.reserve(objects.size());
+    for (auto& obj : objects)
+    {
+        // Ghosts are not updated in the render loop
+        if (obj.second->isGhost())
+            continue;
+
+        auto priority = obj.second->getRenderingPriority();
+        if (priority == BaseObject::Priority::NO_RENDER)
+            continue;
+
+        entries.emplace_back(priority, obj.second);
+    }
+
+    // Stable, to keep the order of the map inside a priority
+    stable_sort(entries.begin(), entries.end(), [](const pair<BaseObject::Priority, shared_ptr<BaseObject>>& a, const pair<BaseObject::Priority, shared_ptr<BaseObject>>& b) {
+        return a.first < b.first;
+    });
+
+    _objects.clear();
+    _groups.clear();
+    for (auto& entry : entries)
+    {
+        if (_groups.empty() || _groups.back().priority != entry.first)
+            _groups.push_back({entry.first, _objects.size(), _objects.size()});
+        _objects.push_back(std::move(entry.second));
+        _groups.back().end = _objects.size();
+    }
+
+    _isBuilt = true;
+    _objectsGeneration = objectsGeneration;
+    _renderingStateVersion = renderingStateVersion;
+    return true;
+}
+
+} // end of namespace
@@ -1,6 +1,9 @@
 #include "./root_object.h"
 
+#include <algorithm>
+
 #include "./buffer_object.h"
+#include "./buffer_pool.h"
 
 using namespace std;
 
@@ -11,7 +14,17 @@ namespace Splash
 RootObject::RootObject()
     : _factory(unique_ptr<Factory>(new Factory(this)))
 {
+    // All messages received through the Link go through the task queue
+    _taskQueue.setCapacity(4096);
     registerAttributes();
+
+    // Buffers cached for too long are given back to the system, and the memory held by the pool is shown along with the timings
+    addRecurringTask("bufferPool", []() {
+        auto& bufferPool = BufferPool::get();
+        bufferPool.releaseExpired();
+        Timer::get().setDuration("bufferPool_inUse_kB", bufferPool.getBytesInUse() / 1024);
+        Timer::get().setDuration("bufferPool_cached_kB", bufferPool.getBytesCached() / 1024);
+    });
 }
 
 /*************/
@@ -46,6 +59,7 @@ shared_ptr<BaseObject> RootObject::createObject(const string& type, const string
     object->setName(name);
     object->setSavable(false);
     _objects[name] = object;
+    ++_objectsGeneration;
     return object;
 }
 
@@ -56,7 +70,10 @@ void RootObject::disposeObject(const string& name)
 
     auto objectIt = _objects.find(name);
     if (objectIt != _objects.end() && objectIt->second.unique())
+    {
         _objects.erase(objectIt);
+        ++_objectsGeneration;
+    }
 }
 
 /*************/
@@ -83,11 +100,15 @@ bool RootObject::set(const string& name, const string& attrib, const Values& arg
 
     if (async)
     {
-        addTask([=]() {
-            auto objectIt = _objects.find(name);
-            if (objectIt != _objects.end())
-                objectIt->second->setAttribute(attrib, args);
-        });
+        // Only the last of the values received for a given attribute during a loop is applied
+        auto key = objectIt != _objects.end() && objectIt->second->isAttributeCoalescable(attrib) ? name + '\0' + attrib : string();
+        addTask(
+            [=]() {
+                auto objectIt = _objects.find(name);
+                if (objectIt != _objects.end())
+                    objectIt->second->setAttribute(attrib, args);
+            },
+            key);
     }
     else
     {
@@ -117,10 +138,36 @@ void RootObject::setFromSerializedObject(const string& name, shared_ptr<Serializ
 }
 
 /*************/
-void RootObject::signalBufferObjectUpdated()
+bool RootObject::setFromSnapshot(const string& name, const shared_ptr<BufferSnapshot>& snapshot)
+{
+    auto objectIt = _objects.find(name);
+    if (objectIt == _objects.end())
+        return false;
+
+    auto object = dynamic_pointer_cast<BufferObject>(objectIt->second);
+    if (!object)
+        return false;
+
+    return object->setSnapshot(snapshot);
+}
+
+/*************/
+unordered_set<string> RootObject::getUpdatedBufferObjects()
+{
+    unordered_set<string> updatedBufferObjects;
+    unique_lock<mutex> lockCondition(_bufferObjectUpdatedMutex);
+    swap(updatedBufferObjects, _updatedBufferObjects);
+    return updatedBufferObjects;
+}
+
+/*************/
+void RootObject::signalBufferObjectUpdated(const string& name)
 {
     unique_lock<mutex> lockCondition(_bufferObjectUpdatedMutex);
 
+    if (!name.empty())
+        _updatedBufferObjects.insert(name);
+
     _bufferObjectUpdated = true;
     // Only a single buffer has to wave for update at a time
     if (!_bufferObjectSingleMutex.try_lock())
@@ -201,17 +248,43 @@ void RootObject::registerAttributes()
         _answerCondition.notify_one();
         return true;
     });
+
+    addAttribute("bufferPoolSize",
+        [&](const Values& args) {
+            BufferPool::get().setCacheSize(static_cast<size_t>(std::max(0, args[0].as<int>())) * 1024 * 1024);
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(BufferPool::get().getCacheSize() / (1024 * 1024))}; },
+        {'n'});
+    setAttributeDescription("bufferPoolSize", "Maximum memory in MB kept by the buffer pool for reuse, the least recently released buffers being freed first");
+
+    addAttribute("bufferPoolMaxAge",
+        [&](const Values& args) {
+            BufferPool::get().setMaxAge(static_cast<int64_t>(args[0].as<float>() * 1e6));
+            return true;
+        },
+        [&]() -> Values { return {static_cast<float>(BufferPool::get().getMaxAge()) / 1e6f}; },
+        {'n'});
+    setAttributeDescription("bufferPoolMaxAge", "Duration in seconds after which a buffer kept by the buffer pool is freed if it has not been reused");
+
+    addAttribute("bufferPoolHugePages",
+        [&](const Values& args) {
+            BufferPool::get().setHugePages(args[0].as<bool>());
+            return true;
+        },
+        [&]() -> Values { return {BufferPool::get().getHugePages()}; },
+        {'n'});
+    setAttributeDescription("bufferPoolHugePages", "If set to 1, large buffers use transparent huge pages where supported");
 }
 
 /*************/
 void RootObject::runTasks()
 {
-    unique_lock<recursive_mutex> lockTasks(_taskMutex);
-    decltype(_taskQueue) tasks;
-    std::swap(tasks, _taskQueue);
-    lockTasks.unlock();
-    for (auto& task : tasks)
-        task();
+    // The name of the object is only known once it is constructed
+    if (!_taskQueueDepth)
+        _taskQueueDepth = &Timer::get().getGauge("taskQueueDepth_" + _name);
+    _taskQueueDepth->store(_taskQueue.getDepth(), std::memory_order_relaxed);
+    _taskQueue.run();
 
     unique_lock<mutex> lockRecurrsiveTasks(_recurringTaskMutex);
     for (auto& task : _recurringTasks)
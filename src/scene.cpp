@@ -2,6 +2,8 @@
 
 #include <utility>
 
+#include "./buffer_consumers.h"
+#include "./buffer_object.h"
 #include "./camera.h"
 #include "./controller_blender.h"
 #include "./controller_gui.h"
@@ -17,6 +19,7 @@
 #include "./queue.h"
 #include "./texture.h"
 #include "./texture_image.h"
+#include "./thread_pool.h"
 #include "./timer.h"
 #include "./userInput_dragndrop.h"
 #include "./userInput_joystick.h"
@@ -139,6 +142,7 @@ std::shared_ptr<BaseObject> Scene::add(const string& type, const string& name)
             _objects[to_string(obj->getId())] = obj;
         else
             _objects[realName] = obj;
+        ++_objectsGeneration;
 
         // Some objects have to be connected to the gui (if the Scene is master)
         if (_gui != nullptr)
@@ -174,6 +178,7 @@ void Scene::addGhost(const string& type, const string& name)
         obj->setGhost(true);
         _objects.erase(obj->getName());
         _objects[obj->getName()] = obj;
+        ++_objectsGeneration;
     }
 }
 
@@ -330,7 +335,10 @@ void Scene::remove(const string& name)
     lock_guard<recursive_mutex> lockObjects(_objectsMutex);
 
     if (_objects.find(name) != _objects.end())
+    {
         _objects.erase(name);
+        ++_objectsGeneration;
+    }
 }
 
 /*************/
@@ -340,34 +348,20 @@ void Scene::render()
 #ifdef PROFILE
         PROFILEGL("Render loop")
 #endif
-        // Create lists of objects to update and to render
-        map<Priority, vector<shared_ptr<BaseObject>>> objectList{};
         {
             lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+
+            // We run all pending tasks for every object
             for (auto& obj : _objects)
-            {
-                // We also run all pending tasks for every object
                 obj.second->runTasks();
 
-                // Ghosts are not updated in the render loop
-                if (obj.second->isGhost())
-                    continue;
-
-                auto priority = obj.second->getRenderingPriority();
-                if (priority == Priority::NO_RENDER)
-                    continue;
-
-                auto listIt = objectList.find(priority);
-                if (listIt == objectList.end())
-                {
-                    auto entry = objectList.emplace(std::make_pair(priority, vector<shared_ptr<BaseObject>>()));
-                    if (entry.second == true)
-                        listIt = entry.first;
-                    else
-                        continue;
-                }
-
-                listIt->second.push_back(obj.second);
+            // The list of objects to render is only rebuilt if objects or priorities changed
+            if (_renderList.update(_objects, _objectsGeneration))
+            {
+                _windows.clear();
+                for (auto& obj : _objects)
+                    if (obj.second->getType() == "window")
+                        _windows.push_back(dynamic_pointer_cast<Window>(obj.second));
             }
         }
 
@@ -376,10 +370,11 @@ void Scene::render()
         bool firstTextureSync = true; // Sync with the texture upload the first time we need textures
         bool firstWindowSync = true;  // Sync with the texture upload the last time we need textures
         auto textureLock = unique_lock<Spinlock>(_textureMutex, defer_lock);
-        for (auto& objPriority : objectList)
+        const auto& renderObjects = _renderList.getObjects();
+        for (const auto& group : _renderList.getGroups())
         {
             // If the objects needs some Textures, we need to sync
-            if (firstTextureSync && objPriority.first > Priority::BLENDING && objPriority.first < Priority::POST_CAMERA)
+            if (firstTextureSync && group.priority > Priority::BLENDING && group.priority < Priority::POST_CAMERA)
             {
 #ifdef PROFILE
                 PROFILEGL("texture upload lock");
@@ -395,11 +390,11 @@ void Scene::render()
                 firstTextureSync = false;
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() << objPriority.second[0]->getType();
+            Timer::get() << renderObjects[group.begin]->getType();
 
-            for (auto& obj : objPriority.second)
+            for (auto index = group.begin; index < group.end; ++index)
             {
+                const auto& obj = renderObjects[index];
 #ifdef PROFILE
                 PROFILEGL("object " + obj->getName());
 #endif
@@ -420,10 +415,9 @@ void Scene::render()
                 obj->render();
             }
 
-            if (objPriority.second.size() != 0)
-                Timer::get() >> objPriority.second[0]->getType();
+            Timer::get() >> renderObjects[group.begin]->getType();
 
-            if (firstWindowSync && objPriority.first >= Priority::POST_CAMERA)
+            if (firstWindowSync && group.priority >= Priority::POST_CAMERA)
             {
 #ifdef PROFILE
                 PROFILEGL("texture upload unlock");
@@ -441,9 +435,8 @@ void Scene::render()
 #endif
             // Swap all buffers at once
             Timer::get() << "swap";
-            for (auto& obj : _objects)
-                if (obj.second->getType() == "window")
-                    dynamic_pointer_cast<Window>(obj.second)->swapBuffers();
+            for (auto& window : _windows)
+                window->swapBuffers();
             Timer::get() >> "swap";
         }
     }
@@ -475,6 +468,11 @@ void Scene::run()
         // Execute waiting tasks
         runTasks();
 
+        sendBufferConsumersToWorld();
+
+        if (Timer::getTime() - _lastTimingsSent >= _timingsPeriod)
+            sendTimingsToWorld();
+
         if (!_started)
         {
             this_thread::sleep_for(chrono::milliseconds(50));
@@ -500,6 +498,46 @@ void Scene::run()
 #endif
 }
 
+/*************/
+void Scene::sendBufferConsumersToWorld()
+{
+    auto linksVersion = BaseObject::getLinksVersion();
+    if (_objectsGeneration == _consumedObjectsGeneration && linksVersion == _consumedLinksVersion)
+        return;
+
+    unordered_set<string> consumedBufferObjects;
+    {
+        lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+        _consumedObjectsGeneration = _objectsGeneration;
+        _consumedLinksVersion = linksVersion;
+        consumedBufferObjects = BufferConsumers::getConsumedBuffers(_objects);
+    }
+
+    if (consumedBufferObjects == _consumedBufferObjects)
+        return;
+
+    _consumedBufferObjects = std::move(consumedBufferObjects);
+    Values consumers{_name};
+    for (const auto& name : _consumedBufferObjects)
+        consumers.push_back(name);
+    sendMessageToWorld("bufferConsumers", consumers);
+}
+
+/*************/
+void Scene::sendTimingsToWorld()
+{
+    _lastTimingsSent = Timer::getTime();
+
+    auto stats = Timer::get().getAllStats(false);
+    for (const auto& timer : stats)
+    {
+        Values timing{_name, timer.first, (int)Timer::get().getDuration(timer.first)};
+        for (auto& v : Timer::statsToValues(timer.second))
+            timing.push_back(v);
+        sendMessageToWorld("sceneDuration", timing);
+    }
+}
+
 /*************/
 void Scene::updateInputs()
 {
@@ -556,16 +594,13 @@ void Scene::textureUploadRun()
 
             Timer::get() << "textureUpload";
 
-            vector<shared_ptr<Texture>> textures;
+            // Only the textures set from an image updated since the last upload are uploaded. If the objects
+            // are being modified, the updated images are kept for the next iteration
+            vector<shared_ptr<Texture_Image>> textures;
             bool expectedAtomicValue = false;
             if (_objectsCurrentlyUpdated.compare_exchange_strong(expectedAtomicValue, true, std::memory_order_acquire))
             {
-                for (auto& obj : _objects)
-                {
-                    auto texture = dynamic_pointer_cast<Texture>(obj.second);
-                    if (texture)
-                        textures.emplace_back(texture);
-                }
+                textures = _textureUploadList.getTextures(_objects, _objectsGeneration, getUpdatedBufferObjects());
                 _objectsCurrentlyUpdated.store(false, std::memory_order_release);
             }
 
@@ -574,7 +609,9 @@ void Scene::textureUploadRun()
 #ifdef PROFILE
                 PROFILEGL("start " + texture->getName());
 #endif
+                Timer::get() << "textureUpload_" + texture->getName();
                 texture->update();
+                Timer::get() >> "textureUpload_" + texture->getName();
             }
 
             _textureUploadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
@@ -585,11 +622,8 @@ void Scene::textureUploadRun()
 #ifdef PROFILE
                 PROFILEGL("end " + texture->getName());
 #endif
-                auto texImage = dynamic_pointer_cast<Texture_Image>(texture);
-                if (texImage)
-                    texImage->flushPbo();
+                texture->flushPbo();
             }
-
             Timer::get() >> "textureUpload";
         }
 
@@ -629,12 +663,14 @@ void Scene::setAsMaster(const string& configFilePath)
         _objects["joystick"] = _joystick;
     if (_dragndrop)
         _objects["dragndrop"] = _dragndrop;
+    ++_objectsGeneration;
 
 #if HAVE_GPHOTO
     // Initialize the color calibration object
     _colorCalibrator = make_shared<ColorCalibrator>(this);
     _colorCalibrator->setName("colorCalibrator");
     _objects["colorCalibrator"] = dynamic_pointer_cast<BaseObject>(_colorCalibrator);
+    ++_objectsGeneration;
 #endif
 }
 
@@ -976,6 +1012,7 @@ void Scene::registerAttributes()
                 for (auto& localObject : _objects)
                     unlink(objectIt->second, localObject.second);
                 _objects.erase(objectIt);
+                ++_objectsGeneration;
             });
 
             return true;
@@ -986,10 +1023,28 @@ void Scene::registerAttributes()
     addAttribute("duration",
         [&](const Values& args) {
             Timer::get().setDuration(args[0].as<string>(), args[1].as<int>());
+            Timer::Stats stats;
+            if (Timer::statsFromValues(args, 2, stats))
+                Timer::get().setRemoteStats(args[0].as<string>(), stats);
             return true;
         },
         {'s', 'n'});
-    setAttributeDescription("duration", "Set the duration of the given timer");
+    setAttributeDescription("duration", "Set the duration of the given timer, optionally followed by its statistics (count, min, mean, p50, p95, p99, max)");
+
+    addAttribute("sendTimings", [&](const Values& args) {
+        addTask([=]() { sendTimingsToWorld(); });
+        return true;
+    });
+    setAttributeDescription("sendTimings", "Send the durations and statistics of the timers of this Scene to the World");
+
+    addAttribute("timerStatsWindow",
+        [&](const Values& args) {
+            Timer::get().setStatsWindow(args[0].as<int64_t>());
+            Timer::get().resetStats();
+            return true;
+        },
+        {'n'});
+    setAttributeDescription("timerStatsWindow", "Set the duration of the windows over which timer statistics are computed, in us, and clear the statistics");
 
     addAttribute("masterClock",
         [&](const Values& args) {
@@ -1095,6 +1150,7 @@ void Scene::registerAttributes()
                     object->setName(newName);
                     _objects[newName] = object;
                     _objects.erase(objIt);
+                    ++_objectsGeneration;
                 }
             });
 
@@ -1239,6 +1295,23 @@ void Scene::registerAttributes()
         },
         {'n'});
     setAttributeDescription("runInBackground", "If set to 1, Splash will run in the background (useful for background processing)");
+
+    addAttribute("workerAffinity", [&](const Values& args) {
+        vector<int> cores;
+        for (const auto& core : args)
+            cores.push_back(core.as<int>());
+        return ThreadPool::get().setAffinity(cores);
+    });
+    setAttributeDescription("workerAffinity", "Set the CPU cores the worker threads can run on. No argument removes the constraint");
+
+    addAttribute("workerThreads",
+        [&](const Values& args) {
+            ThreadPool::get().setWorkerCount(std::max(0, args[0].as<int>()));
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(ThreadPool::get().getWorkerCount())}; },
+        {'n'});
+    setAttributeDescription("workerThreads", "Set the number of worker threads used for parallel tasks. If set to 0, the number of cores is used");
 }
 
 } // end of namespace
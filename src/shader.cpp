@@ -4,6 +4,7 @@
 #include "shaderSources.h"
 #include "timer.h"
 
+#include <algorithm>
 #include <fstream>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -15,6 +16,93 @@ using namespace std;
 namespace Splash
 {
 
+namespace
+{
+/**
+ * Write raw data into the storage of a uniform, starting at the given index
+ */
+template <typename T, typename U>
+void writeData(const U* data, size_t count, vector<T>& storage, size_t& index, bool& changed)
+{
+    for (size_t i = 0; i < count && index < storage.size(); ++i, ++index)
+    {
+        auto value = static_cast<T>(data[i]);
+        if (storage[index] != value)
+        {
+            storage[index] = value;
+            changed = true;
+        }
+    }
+}
+
+/**
+ * Write a value into the storage of a uniform, starting at the given index. Nested Values and numeric arrays are flattened.
+ */
+template <typename T>
+void writeValue(const Value& value, vector<T>& storage, size_t& index, bool& changed)
+{
+    switch (value.getType())
+    {
+    default:
+        return;
+    case Value::Type::i:
+    case Value::Type::f:
+    case Value::Type::s:
+    {
+        auto number = value.as<T>();
+        writeData(&number, 1, storage, index, changed);
+        return;
+    }
+    case Value::Type::v:
+        for (int i = 0; i < value.size() && index < storage.size(); ++i)
+            writeValue(value[i], storage, index, changed);
+        return;
+    case Value::Type::fa:
+        writeData(static_cast<const float*>(value.data()), value.size(), storage, index, changed);
+        return;
+    case Value::Type::ia:
+        writeData(static_cast<const int32_t*>(value.data()), value.size(), storage, index, changed);
+        return;
+    }
+}
+
+/**
+ * Count the scalars held by a value, once flattened
+ */
+size_t countScalars(const Value& value)
+{
+    switch (value.getType())
+    {
+    default:
+        return 0;
+    case Value::Type::i:
+    case Value::Type::f:
+    case Value::Type::s:
+        return 1;
+    case Value::Type::v:
+    {
+        size_t count = 0;
+        for (int i = 0; i < value.size(); ++i)
+            count += countScalars(value[i]);
+        return count;
+    }
+    case Value::Type::fa:
+    case Value::Type::ia:
+        return value.size();
+    }
+}
+
+/**
+ * Check whether the first scalar held by a value is an integer
+ */
+bool isIntegerValue(const Value& value)
+{
+    if (value.getType() == Value::Type::v)
+        return value.size() != 0 && isIntegerValue(value[0]);
+    return value.getType() == Value::Type::i || value.getType() == Value::Type::ia;
+}
+} // namespace
+
 /*************/
 Shader::Shader(ProgramType type)
 {
@@ -61,6 +149,9 @@ Shader::~Shader()
 {
     if (glIsProgram(_program))
         glDeleteProgram(_program);
+    for (auto& u : _uniforms)
+        if (u.second.glBuffer != 0)
+            glDeleteBuffers(1, &u.second.glBuffer);
     for (auto& shader : _shaders)
         if (glIsShader(shader.second))
             glDeleteShader(shader.second);
@@ -83,13 +174,6 @@ void Shader::activate()
         }
 
         _activated = true;
-
-        for (auto& u : _uniforms)
-        {
-            if (u.second.type == "buffer")
-                glUniformBlockBinding(_program, u.second.glIndex, 1);
-        }
-
         glUseProgram(_program);
 
         if (_sideness == singleSided)
@@ -171,7 +255,16 @@ map<string, Values> Shader::getUniforms() const
 {
     map<string, Values> uniforms;
     for (auto& u : _uniforms)
-        uniforms[u.first] = u.second.values;
+    {
+        auto& uniform = u.second;
+        auto& values = uniforms[u.first];
+        if (uniform.type.empty())
+            values = uniform.pending;
+        else if (uniform.isInteger)
+            values = Values(uniform.ints.begin(), uniform.ints.end());
+        else
+            values = Values(uniform.floats.begin(), uniform.floats.end());
+    }
     return uniforms;
 }
 
@@ -264,12 +357,115 @@ void Shader::setTexture(const shared_ptr<Texture>& texture, const GLuint texture
         glUniform1i(uniform.glIndex, textureUnit);
 
         _textures.push_back(texture);
-        if ((uniformIt = _uniforms.find("_textureNbr")) != _uniforms.end())
-            if (uniformIt->second.glIndex != -1)
-            {
-                uniformIt->second.values = {(int)_textures.size()};
-                _uniformsToUpdate.push_back("_textureNbr");
-            }
+        int32_t textureNbr = _textures.size();
+        setUniform("_textureNbr", &textureNbr, 1);
+    }
+}
+
+/*************/
+void Shader::setUniform(const string& name, const Values& values)
+{
+    setUniformValues(name, values, 0);
+}
+
+/*************/
+void Shader::setUniform(const string& name, const float* data, size_t count)
+{
+    auto uniformIt = _uniforms.find(name);
+    if (uniformIt != _uniforms.end() && !uniformIt->second.type.empty())
+        writeUniform(uniformIt->second, data, count);
+    else if (!_isLinked)
+        setUniformValues(name, Values(data, data + count), 0);
+}
+
+/*************/
+void Shader::setUniform(const string& name, const int32_t* data, size_t count)
+{
+    auto uniformIt = _uniforms.find(name);
+    if (uniformIt != _uniforms.end() && !uniformIt->second.type.empty())
+        writeUniform(uniformIt->second, data, count);
+    else if (!_isLinked)
+        setUniformValues(name, Values(data, data + count), 0);
+}
+
+/*************/
+void Shader::setUniformValues(const string& name, const Values& values, size_t offset)
+{
+    auto uniformIt = _uniforms.find(name);
+    if (uniformIt == _uniforms.end())
+        uniformIt = _uniforms.emplace(name, Uniform()).first;
+
+    auto& uniform = uniformIt->second;
+    if (!uniform.type.empty())
+    {
+        writeUniform(uniform, values, offset);
+        return;
+    }
+
+    // The uniform is not declared in the program, or the program is not linked yet:
+    // keep the values for when it is parsed
+    if (uniform.pending.size() == values.size() - offset && equal(values.begin() + offset, values.end(), uniform.pending.begin()))
+        return;
+    uniform.pending = Values(values.begin() + offset, values.end());
+}
+
+/*************/
+void Shader::writeUniform(Uniform& uniform, const Values& values, size_t offset)
+{
+    if (uniform.type == "buffer")
+    {
+        size_t count = 0;
+        for (size_t i = offset; i < values.size(); ++i)
+            count += countScalars(values[i]);
+        bool isInteger = values.size() > offset && isIntegerValue(values[offset]);
+        if (count != (isInteger ? uniform.ints.size() : uniform.floats.size()) || isInteger != uniform.isInteger)
+        {
+            uniform.isInteger = isInteger;
+            uniform.ints.assign(isInteger ? count : 0, 0);
+            uniform.floats.assign(isInteger ? 0 : count, 0.f);
+            uniform.glBufferReady = false;
+        }
+    }
+
+    bool changed = !uniform.glBufferReady && uniform.type == "buffer";
+    size_t index = 0;
+    for (size_t i = offset; i < values.size(); ++i)
+    {
+        if (uniform.isInteger)
+            writeValue(values[i], uniform.ints, index, changed);
+        else
+            writeValue(values[i], uniform.floats, index, changed);
+    }
+
+    if (changed && !uniform.isDirty)
+    {
+        uniform.isDirty = true;
+        _uniformsToUpdate.push_back(&uniform);
+    }
+}
+
+/*************/
+template <typename T>
+void Shader::writeUniform(Uniform& uniform, const T* data, size_t count)
+{
+    if (uniform.type == "buffer" && count != (uniform.isInteger ? uniform.ints.size() : uniform.floats.size()))
+    {
+        uniform.ints.assign(uniform.isInteger ? count : 0, 0);
+        uniform.floats.assign(uniform.isInteger ? 0 : count, 0.f);
+        uniform.glBufferReady = false;
+    }
+
+    bool changed = !uniform.glBufferReady && uniform.type == "buffer";
+    size_t index = 0;
+    if (uniform.isInteger)
+        writeData(data, count, uniform.ints, index, changed);
+    else
+        writeData(data, count, uniform.floats, index, changed);
+
+    if (changed && !uniform.isDirty)
+    {
+        uniform.isDirty = true;
+        _uniformsToUpdate.push_back(&uniform);
     }
 }
 
@@ -279,23 +475,13 @@ void Shader::setModelViewProjectionMatrix(const glm::dmat4& mv, const glm::dmat4
     glm::mat4 floatMv = (glm::mat4)mv;
     glm::mat4 floatMp = (glm::mat4)mp;
     glm::mat4 floatMvp = (glm::mat4)(mp * mv);
+    glm::mat4 floatNormal = glm::transpose(glm::inverse(floatMv));
 
-    auto uniformIt = _uniforms.find("_modelViewProjectionMatrix");
-    if (uniformIt != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMvp));
-
-    if ((uniformIt = _uniforms.find("_modelViewMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMv));
-
-    if ((uniformIt = _uniforms.find("_projectionMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(floatMp));
-
-    if ((uniformIt = _uniforms.find("_normalMatrix")) != _uniforms.end())
-        if (uniformIt->second.glIndex != -1)
-            glUniformMatrix4fv(uniformIt->second.glIndex, 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(floatMv))));
+    // Sent along with the other uniforms by updateUniforms, and only if they changed
+    setUniform("_modelViewProjectionMatrix", glm::value_ptr(floatMvp), 16);
+    setUniform("_modelViewMatrix", glm::value_ptr(floatMv), 16);
+    setUniform("_projectionMatrix", glm::value_ptr(floatMp), 16);
+    setUniform("_normalMatrix", glm::value_ptr(floatNormal), 16);
 }
 
 /*************/
@@ -335,6 +521,7 @@ bool Shader::linkProgram()
         Log::get() << Log::DEBUGGING << "Shader::" << __FUNCTION__ << " - Shader program " << _currentProgramName << " linked successfully" << Log::endl;
 #endif
 
+        _uniformBlocks.clear();
         for (auto src : _shadersSource)
             parseUniforms(src.second);
 
@@ -412,10 +599,32 @@ void Shader::parseUniforms(const std::string& src)
             string next = line.substr(position + 23, string::npos);
             string name = next.substr(0, next.find(" "));
 
-            _uniforms[name].type = "buffer";
-            _uniforms[name].glIndex = glGetUniformBlockIndex(_program, name.c_str());
-            glGenBuffers(1, &_uniforms[name].glBuffer);
-            _uniforms[name].glBufferReady = false;
+            auto& uniform = _uniforms[name];
+            uniform.type = "buffer";
+            uniform.glIndex = glGetUniformBlockIndex(_program, name.c_str());
+            if (uniform.glIndex == -1)
+                continue;
+
+            // The camera block is shared by all shaders and filled by the cameras, other blocks have their own buffer
+            if (name == "CameraUniforms")
+            {
+                glUniformBlockBinding(_program, uniform.glIndex, cameraUniformsBinding);
+            }
+            else
+            {
+                glUniformBlockBinding(_program, uniform.glIndex, blockUniformsBinding);
+                if (uniform.glBuffer == 0)
+                    glCreateBuffers(1, &uniform.glBuffer);
+                uniform.glBufferReady = false;
+                if (find(_uniformBlocks.begin(), _uniformBlocks.end(), &uniform) == _uniformBlocks.end())
+                    _uniformBlocks.push_back(&uniform);
+            }
+
+            if (!uniform.pending.empty())
+            {
+                writeUniform(uniform, uniform.pending, 0);
+                uniform.pending.clear();
+            }
         }
         else
         {
@@ -438,99 +647,34 @@ void Shader::parseUniforms(const std::string& src)
             else
                 _uniformsDocumentation[name] = "";
 
-            Values values;
-            if (_uniforms.find(name) != _uniforms.end())
-                values = _uniforms[name].values;
-
-            _uniforms[name].type = type;
-
-            // Get the location
-            _uniforms[name].glIndex = glGetUniformLocation(_program, name.c_str());
-
-            if (type == "int")
-                _uniforms[name].values = {0};
-            else if (type == "float")
-                _uniforms[name].values = {0.f};
-            else if (type == "vec2")
-                _uniforms[name].values = {0.f, 0.f};
-            else if (type == "vec3")
-                _uniforms[name].values = {0.f, 0.f, 0.f};
-            else if (type == "vec4")
-                _uniforms[name].values = {0.f, 0.f, 0.f, 0.f};
-            else if (type == "ivec2")
-                _uniforms[name].values = {0, 0};
-            else if (type == "ivec3")
-                _uniforms[name].values = {0, 0, 0};
-            else if (type == "ivec4")
-                _uniforms[name].values = {0, 0, 0, 0};
-            else if (type == "mat3")
-                _uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-            else if (type == "mat4")
-                _uniforms[name].values = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-            else if (type == "sampler2D" || type == "sampler2DRect" || type == "samplerCube")
-                _uniforms[name].values = {};
-            else
+            auto& uniform = _uniforms[name];
+            uniform.glIndex = glGetUniformLocation(_program, name.c_str());
+
+            // Get the array size from the program, as it can be defined by a preprocessor macro
+            GLint arraySize = 1;
+            GLuint uniformIndex = GL_INVALID_INDEX;
+            const GLchar* uniformName = name.c_str();
+            glGetUniformIndices(_program, 1, &uniformName, &uniformIndex);
+            if (uniformIndex != GL_INVALID_INDEX)
+                glGetActiveUniformsiv(_program, 1, &uniformIndex, GL_UNIFORM_SIZE, &arraySize);
+
+            if (uniform.type != type || uniform.arraySize != arraySize)
             {
-                _uniforms[name].glIndex = -1;
-                Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while parsing uniforms: " << name << " is of unhandled type " << type << Log::endl;
+                uniform.type = type;
+                uniform.arraySize = arraySize;
+                allocateUniform(name, uniform);
             }
-
-            if (values.size() != 0)
+            else if (uniform.glIndex != -1 && !uniform.isDirty)
             {
-                _uniforms[name].values = values;
-                _uniformsToUpdate.push_back(name);
+                // Keep the values previously set, they have to be sent to the new program
+                uniform.isDirty = true;
+                _uniformsToUpdate.push_back(&uniform);
             }
-            else
+
+            if (!uniform.pending.empty())
             {
-                // Save the default value
-                if (type == "int")
-                {
-                    int v;
-                    glGetUniformiv(_program, _uniforms[name].glIndex, &v);
-                    _uniforms[name].values = {v};
-                }
-                else if (type == "float")
-                {
-                    float v;
-                    glGetUniformfv(_program, _uniforms[name].glIndex, &v);
-                    _uniforms[name].values = {v};
-                }
-                else if (type == "vec2")
-                {
-                    float v[2];
-                    glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                    _uniforms[name].values = {v[0], v[1]};
-                }
-                else if (type == "vec3")
-                {
-                    float v[3];
-                    glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                    _uniforms[name].values = {v[0], v[1], v[2]};
-                }
-                else if (type == "vec4")
-                {
-                    float v[4];
-                    glGetUniformfv(_program, _uniforms[name].glIndex, v);
-                    _uniforms[name].values = {v[0], v[1], v[2], v[3]};
-                }
-                else if (type == "ivec2")
-                {
-                    int v[2];
-                    glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                    _uniforms[name].values = {v[0], v[1]};
-                }
-                else if (type == "ivec3")
-                {
-                    int v[3];
-                    glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                    _uniforms[name].values = {v[0], v[1], v[2]};
-                }
-                else if (type == "ivec4")
-                {
-                    int v[4];
-                    glGetUniformiv(_program, _uniforms[name].glIndex, v);
-                    _uniforms[name].values = {v[0], v[1], v[2], v[3]};
-                }
+                writeUniform(uniform, uniform.pending, 0);
+                uniform.pending.clear();
             }
         }
     }
@@ -552,6 +696,54 @@ void Shader::parseUniforms(const std::string& src)
     }
 }
 
+/*************/
+void Shader::allocateUniform(const string& name, Uniform& uniform)
+{
+    const auto& type = uniform.type;
+    if (type == "int")
+        uniform.components = 1;
+    else if (type == "ivec2")
+        uniform.components = 2;
+    else if (type == "ivec3")
+        uniform.components = 3;
+    else if (type == "ivec4")
+        uniform.components = 4;
+    else if (type == "float")
+        uniform.components = 1;
+    else if (type == "vec2")
+        uniform.components = 2;
+    else if (type == "vec3")
+        uniform.components = 3;
+    else if (type == "vec4")
+        uniform.components = 4;
+    else if (type == "mat3")
+        uniform.components = 9;
+    else if (type == "mat4")
+        uniform.components = 16;
+    else if (type == "sampler2D" || type == "sampler2DRect" || type == "samplerCube")
+        uniform.components = 0;
+    else
+    {
+        uniform.components = 0;
+        uniform.glIndex = -1;
+        Log::get() << Log::WARNING << "Shader::" << __FUNCTION__ << " - Error while parsing uniforms: " << name << " is of unhandled type " << type << Log::endl;
+    }
+
+    uniform.isInteger = type == "int" || type == "ivec2" || type == "ivec3" || type == "ivec4";
+    auto size = static_cast<size_t>(uniform.components * uniform.arraySize);
+    uniform.ints.assign(uniform.isInteger ? size : 0, 0);
+    uniform.floats.assign(uniform.isInteger ? 0 : size, 0.f);
+
+    // Save the default value, only available for single values
+    if (uniform.glIndex == -1 || uniform.components == 0 || uniform.arraySize != 1)
+        return;
+
+    if (uniform.isInteger)
+        glGetUniformiv(_program, uniform.glIndex, uniform.ints.data());
+    else
+        glGetUniformfv(_program, uniform.glIndex, uniform.floats.data());
+}
+
 /*************/
 string Shader::stringFromShaderType(int type)
 {
@@ -579,135 +771,69 @@ void Shader::updateUniforms()
 {
     if (_activated)
     {
-        for (int i = 0; i < _uniformsToUpdate.size(); ++i)
+        for (auto uniform : _uniformsToUpdate)
         {
-            string u = _uniformsToUpdate[i];
-
-            auto uniformIt = _uniforms.find(u);
-            if (uniformIt == _uniforms.end())
+            uniform->isDirty = false;
+            if (uniform->glIndex == -1)
                 continue;
 
-            auto tmpName = uniformIt->first;
-
-            auto& uniform = uniformIt->second;
-            if (uniform.glIndex == -1)
+            if (uniform->type == "buffer")
             {
-                uniform.values.clear(); // To make sure it is sent next time if the index is correctly set
+                if (uniform->glBuffer == 0)
+                    continue;
+
+                auto size = uniform->isInteger ? uniform->ints.size() * sizeof(int32_t) : uniform->floats.size() * sizeof(float);
+                auto data = uniform->isInteger ? static_cast<const void*>(uniform->ints.data()) : static_cast<const void*>(uniform->floats.data());
+                if (!uniform->glBufferReady)
+                {
+                    glNamedBufferData(uniform->glBuffer, size, nullptr, GL_DYNAMIC_DRAW);
+                    uniform->glBufferReady = true;
+                }
+                glNamedBufferSubData(uniform->glBuffer, 0, size, data);
                 continue;
             }
 
-            int size = uniform.values.size();
-            int type = uniform.values[0].getType();
-
-            if (type == Value::Type::i)
+            auto count = uniform->arraySize;
+            if (uniform->isInteger)
             {
-                if (size == 1)
-                    glUniform1i(uniform.glIndex, uniform.values[0].as<int>());
-                else if (size == 2)
-                    glUniform2i(uniform.glIndex, uniform.values[0].as<int>(), uniform.values[1].as<int>());
-                else if (size == 3)
-                    glUniform3i(uniform.glIndex, uniform.values[0].as<int>(), uniform.values[1].as<int>(), uniform.values[2].as<int>());
-                else if (size == 4)
-                    glUniform4i(uniform.glIndex, uniform.values[0].as<int>(), uniform.values[1].as<int>(), uniform.values[2].as<int>(), uniform.values[3].as<int>());
+                auto data = uniform->ints.data();
+                if (uniform->components == 1)
+                    glUniform1iv(uniform->glIndex, count, data);
+                else if (uniform->components == 2)
+                    glUniform2iv(uniform->glIndex, count, data);
+                else if (uniform->components == 3)
+                    glUniform3iv(uniform->glIndex, count, data);
+                else if (uniform->components == 4)
+                    glUniform4iv(uniform->glIndex, count, data);
             }
-            else if (type == Value::Type::f)
-            {
-                if (size == 1)
-                    glUniform1f(uniform.glIndex, uniform.values[0].as<float>());
-                else if (size == 2)
-                    glUniform2f(uniform.glIndex, uniform.values[0].as<float>(), uniform.values[1].as<float>());
-                else if (size == 3)
-                    glUniform3f(uniform.glIndex, uniform.values[0].as<float>(), uniform.values[1].as<float>(), uniform.values[2].as<float>());
-                else if (size == 4)
-                    glUniform4f(uniform.glIndex, uniform.values[0].as<float>(), uniform.values[1].as<float>(), uniform.values[2].as<float>(), uniform.values[3].as<float>());
-                else if (size == 9)
-                {
-                    vector<float> m(9);
-                    for (unsigned int i = 0; i < 9; ++i)
-                        m[i] = uniform.values[i].as<float>();
-                    glUniformMatrix3fv(uniform.glIndex, 1, GL_FALSE, m.data());
-                }
-                else if (size == 16)
-                {
-                    vector<float> m(16);
-                    for (unsigned int i = 0; i < 16; ++i)
-                        m[i] = uniform.values[i].as<float>();
-                    glUniformMatrix4fv(uniform.glIndex, 1, GL_FALSE, m.data());
-                }
-            }
-            else if (type == Value::Type::v && uniform.values[0].as<Values>().size() > 0)
+            else
             {
-                type = uniform.values[0].as<Values>()[0].getType();
-                if (type == Value::Type::i)
-                {
-                    vector<int> data;
-                    if (uniform.type == "buffer")
-                    {
-                        for (auto& v : uniform.values[0].as<Values>())
-                            data.push_back(v.as<int>());
-
-                        glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
-                        if (!uniform.glBufferReady)
-                        {
-                            glBufferData(GL_UNIFORM_BUFFER, data.size() * sizeof(int), NULL, GL_STATIC_DRAW);
-                            uniform.glBufferReady = true;
-                        }
-                        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(int), data.data());
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                        glBindBufferRange(GL_UNIFORM_BUFFER, 1, uniform.glBuffer, 0, data.size() * sizeof(int));
-                    }
-                    else
-                    {
-                        for (auto& v : uniform.values[0].as<Values>())
-                            data.push_back(v.as<int>());
-
-                        if (uniform.type == "int")
-                            glUniform1iv(uniform.glIndex, data.size(), data.data());
-                        else if (uniform.type == "ivec2")
-                            glUniform2iv(uniform.glIndex, data.size() / 2, data.data());
-                        else if (uniform.type == "ivec3")
-                            glUniform3iv(uniform.glIndex, data.size() / 3, data.data());
-                        else if (uniform.type == "ivec4")
-                            glUniform4iv(uniform.glIndex, data.size() / 4, data.data());
-                    }
-                }
-                else if (type == Value::Type::f)
-                {
-                    vector<float> data;
-                    if (uniform.type == "buffer")
-                    {
-                        for (auto& v : uniform.values[0].as<Values>())
-                            data.push_back(v.as<float>());
-
-                        glBindBuffer(GL_UNIFORM_BUFFER, uniform.glBuffer);
-                        if (!uniform.glBufferReady)
-                        {
-                            glBufferData(GL_UNIFORM_BUFFER, data.size() * sizeof(float), NULL, GL_STATIC_DRAW);
-                            uniform.glBufferReady = true;
-                        }
-                        glBufferSubData(GL_UNIFORM_BUFFER, 0, data.size() * sizeof(float), data.data());
-                        glBindBuffer(GL_UNIFORM_BUFFER, 0);
-                        glBindBufferRange(GL_UNIFORM_BUFFER, 1, uniform.glBuffer, 0, data.size() * sizeof(float));
-                    }
-                    else
-                    {
-                        for (auto& v : uniform.values[0].as<Values>())
-                            data.push_back(v.as<float>());
-
-                        if (uniform.type == "float")
-                            glUniform1fv(uniform.glIndex, data.size(), data.data());
-                        else if (uniform.type == "vec2")
-                            glUniform2fv(uniform.glIndex, data.size() / 2, data.data());
-                        else if (uniform.type == "vec3")
-                            glUniform3fv(uniform.glIndex, data.size() / 3, data.data());
-                        else if (uniform.type == "vec4")
-                            glUniform4fv(uniform.glIndex, data.size() / 4, data.data());
-                    }
-                }
+                auto data = uniform->floats.data();
+                if (uniform->components == 1)
+                    glUniform1fv(uniform->glIndex, count, data);
+                else if (uniform->components == 2)
+                    glUniform2fv(uniform->glIndex, count, data);
+                else if (uniform->components == 3)
+                    glUniform3fv(uniform->glIndex, count, data);
+                else if (uniform->components == 4)
+                    glUniform4fv(uniform->glIndex, count, data);
+                else if (uniform->components == 9)
+                    glUniformMatrix3fv(uniform->glIndex, count, GL_FALSE, data);
+                else if (uniform->components == 16)
+                    glUniformMatrix4fv(uniform->glIndex, count, GL_FALSE, data);
             }
         }
 
         _uniformsToUpdate.clear();
+
+        // The binding point of the blocks is shared with the other shaders, so they are bound at each activation
+        for (auto uniform : _uniformBlocks)
+        {
+            if (uniform->glIndex == -1 || !uniform->glBufferReady)
+                continue;
+            auto size = uniform->isInteger ? uniform->ints.size() * sizeof(int32_t) : uniform->floats.size() * sizeof(float);
+            glBindBufferRange(GL_UNIFORM_BUFFER, blockUniformsBinding, uniform->glBuffer, 0, size);
+        }
     }
 }
 
@@ -733,28 +859,7 @@ void Shader::registerAttributes()
         if (args.size() < 2)
             return false;
 
-        string uniformName = args[0].as<string>();
-        Values uniformArgs;
-        if (args[1].getType() != Value::Type::v)
-        {
-            for (int i = 1; i < args.size(); ++i)
-                uniformArgs.push_back(args[i]);
-        }
-        else
-        {
-            uniformArgs = args[1].as<Values>();
-        }
-
-        // Check if the values changed from previous use
-        auto uniformIt = _uniforms.find(uniformName);
-        if (uniformIt != _uniforms.end() && Value(uniformArgs) == Value(uniformIt->second.values))
-            return true;
-        else if (uniformIt == _uniforms.end())
-            uniformIt = (_uniforms.emplace(make_pair(uniformName, Uniform()))).first;
-
-        uniformIt->second.values = uniformArgs;
-        _uniformsToUpdate.push_back(uniformName);
-
+        setUniformValues(args[0].as<string>(), args, 1);
         return true;
     });
 }
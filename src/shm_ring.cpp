@@ -0,0 +1,237 @@
+#include "./shm_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./log.h"
+#include "./timer.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+const uint32_t ShmRing::maxSlots;
+const size_t ShmRing::maxNameLength;
+
+/*************/
+ShmRing::Mapping::~Mapping()
+{
+    if (data)
+        munmap(data, size);
+}
+
+/*************/
+ShmRing::ShmRing(const string& name, Mode mode, uint32_t slotCount)
+    : _name(name)
+    , _mode(mode)
+{
+    if (_name.size() >= maxNameLength)
+    {
+        Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Ring name " << _name << " is too long" << Log::endl;
+        return;
+    }
+
+    _mappings.resize(maxSlots);
+
+    int fd = -1;
+    if (_mode == Mode::Writer)
+    {
+        // Get rid of any leftover from a previous run
+        shm_unlink(_name.c_str());
+        fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0 && ftruncate(fd, sizeof(Control)) != 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+    else
+    {
+        fd = shm_open(_name.c_str(), O_RDWR, 0600);
+    }
+
+    if (fd < 0)
+    {
+        Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Unable to open shared memory " << _name << Log::endl;
+        return;
+    }
+
+    auto data = mmap(nullptr, sizeof(Control), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Unable to map shared memory " << _name << Log::endl;
+        return;
+    }
+
+    _controlMapping = make_shared<Mapping>(static_cast<char*>(data), sizeof(Control));
+    auto control = reinterpret_cast<Control*>(data);
+
+    if (_mode == Mode::Writer)
+    {
+        control->slotCount = std::min(std::max(slotCount, 1u), maxSlots);
+        for (uint32_t i = 0; i < maxSlots; ++i)
+        {
+            control->slots[i].sequence.store(0);
+            control->slots[i].pending.store(0);
+            control->slots[i].held.store(0);
+            control->slots[i].timestamp.store(0);
+        }
+        atomic_thread_fence(memory_order_release);
+        control->magic = _magic;
+    }
+    else if (control->magic != _magic)
+    {
+        Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Shared memory " << _name << " is not a valid ring" << Log::endl;
+        _controlMapping.reset();
+        return;
+    }
+
+    _control = control;
+}
+
+/*************/
+ShmRing::~ShmRing()
+{
+    if (_mode != Mode::Writer || !_control)
+        return;
+
+    for (uint32_t i = 0; i < _control->slotCount; ++i)
+        shm_unlink(getSlotName(i).c_str());
+    shm_unlink(_name.c_str());
+}
+
+/*************/
+bool ShmRing::acquireSlot(uint32_t slot)
+{
+    auto& s = _control->slots[slot];
+    if (s.held.load() != 0)
+        return false;
+    // A slot still waiting for readers is only reclaimed if its descriptor seems to have been lost
+    if (s.pending.load() > 0 && Timer::getTime() - s.timestamp.load() < _staleSlotTimeout)
+        return false;
+
+    // Invalidate the previous content, then check that no reader got hold of it in the meantime
+    s.sequence.store(++_sequence);
+    if (s.held.load() != 0)
+        return false;
+
+    s.pending.store(0);
+    return true;
+}
+
+/*************/
+shared_ptr<ShmRing::Mapping> ShmRing::mapSlot(uint32_t slot, size_t size)
+{
+    lock_guard<mutex> lock(_mappingsMutex);
+    auto& mapping = _mappings[slot];
+    if (mapping && mapping->size >= size)
+        return mapping;
+
+    auto slotName = getSlotName(slot);
+    int fd = shm_open(slotName.c_str(), _mode == Mode::Writer ? O_CREAT | O_RDWR : O_RDWR, 0600);
+    if (fd < 0)
+    {
+        Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Unable to open shared memory " << slotName << Log::endl;
+        return {nullptr};
+    }
+    OnScopeExit { close(fd); };
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+        return {nullptr};
+
+    auto segmentSize = static_cast<size_t>(fileStat.st_size);
+    // Segments only grow, so that readers holding an older mapping are not affected
+    if (_mode == Mode::Writer && segmentSize < size)
+    {
+        if (ftruncate(fd, size) != 0)
+        {
+            Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Unable to resize shared memory " << slotName << " to " << size << " bytes" << Log::endl;
+            return {nullptr};
+        }
+        segmentSize = size;
+    }
+
+    if (segmentSize < size || segmentSize == 0)
+        return {nullptr};
+
+    auto data = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED)
+    {
+        Log::get() << Log::WARNING << "ShmRing::" << __FUNCTION__ << " - Unable to map shared memory " << slotName << Log::endl;
+        return {nullptr};
+    }
+
+    mapping = make_shared<Mapping>(static_cast<char*>(data), segmentSize);
+    return mapping;
+}
+
+/*************/
+bool ShmRing::write(const char* data, size_t size, uint32_t readers, Descriptor& descriptor)
+{
+    if (!_control || _mode != Mode::Writer || readers == 0 || size == 0)
+        return false;
+
+    auto slotCount = _control->slotCount;
+    for (uint32_t i = 0; i < slotCount; ++i)
+    {
+        auto slot = (_nextSlot + i) % slotCount;
+        if (!acquireSlot(slot))
+            continue;
+
+        auto mapping = mapSlot(slot, size);
+        if (!mapping)
+            return false;
+
+        memcpy(mapping->data, data, size);
+
+        auto& s = _control->slots[slot];
+        s.timestamp.store(Timer::getTime());
+        s.pending.store(readers);
+
+        strncpy(descriptor.ring, _name.c_str(), maxNameLength);
+        descriptor.slot = slot;
+        descriptor.sequence = s.sequence.load();
+        descriptor.size = size;
+
+        _nextSlot = (slot + 1) % slotCount;
+        return true;
+    }
+
+    return false;
+}
+
+/*************/
+shared_ptr<SerializedObject> ShmRing::read(const Descriptor& descriptor)
+{
+    if (!_control || _mode != Mode::Reader || descriptor.slot >= _control->slotCount)
+        return {nullptr};
+
+    auto slot = &_control->slots[descriptor.slot];
+    slot->held.fetch_add(1);
+    if (slot->sequence.load() != descriptor.sequence)
+    {
+        // The writer reclaimed the slot, its content is not the one described anymore
+        slot->held.fetch_sub(1);
+        return {nullptr};
+    }
+    slot->pending.fetch_sub(1);
+
+    auto mapping = mapSlot(descriptor.slot, descriptor.size);
+    if (!mapping)
+    {
+        slot->held.fetch_sub(1);
+        return {nullptr};
+    }
+
+    // The mappings are captured to keep them alive as long as the buffer is in use
+    auto controlMapping = _controlMapping;
+    auto buffer = ResizableArray<char>(mapping->data, descriptor.size, [slot, mapping, controlMapping](char*) { slot->held.fetch_sub(1); });
+    return make_shared<SerializedObject>(std::move(buffer));
+}
+
+} // end of namespace
@@ -39,7 +39,7 @@ Sink::~Sink()
 /*************/
 string Sink::getCaps() const
 {
-    return "video/x-raw,format=(string)" + _spec.format + ",width=(int)" + to_string(_spec.width) + ",height=(int)" + to_string(_spec.height) + ",framerate=(fraction)" +
+    return "video/x-raw,format=(string)" + ImageBufferSpec::formatToString(_spec.format) + ",width=(int)" + to_string(_spec.width) + ",height=(int)" + to_string(_spec.height) + ",framerate=(fraction)" +
            to_string(_framerate) + "/1,pixel-aspect-ratio=(fraction)1/1";
 }
 
@@ -0,0 +1,142 @@
+#include "./task_queue.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+TaskQueue::TaskQueue(size_t capacity)
+{
+    setCapacity(capacity);
+}
+
+/*************/
+void TaskQueue::setCapacity(size_t capacity)
+{
+    uint64_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+
+    _cells = unique_ptr<Cell[]>(new Cell[size]);
+    for (uint64_t i = 0; i < size; ++i)
+        _cells[i].sequence.store(i, memory_order_relaxed);
+    _mask = size - 1;
+    _enqueuePosition.store(0, memory_order_relaxed);
+    _dequeuePosition.store(0, memory_order_relaxed);
+}
+
+/*************/
+void TaskQueue::push(Task task, const string& key)
+{
+    auto position = _enqueuePosition.load(memory_order_relaxed);
+    while (true)
+    {
+        if (_isOverflowing.load(memory_order_acquire))
+            break;
+
+        auto& cell = _cells[position & _mask];
+        auto sequence = cell.sequence.load(memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - position);
+
+        if (diff == 0)
+        {
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                cell.task = std::move(task);
+                cell.key = key;
+                cell.sequence.store(position + 1, memory_order_release);
+                return;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The ring is full
+            break;
+        }
+        else
+        {
+            position = _enqueuePosition.load(memory_order_relaxed);
+        }
+    }
+
+    pushToOverflow(std::move(task), key);
+}
+
+/*************/
+void TaskQueue::pushToOverflow(Task&& task, const string& key)
+{
+    lock_guard<Spinlock> lock(_overflowMutex);
+    _overflow.push_back({std::move(task), key});
+    _isOverflowing.store(true, memory_order_release);
+}
+
+/*************/
+size_t TaskQueue::run()
+{
+    unique_lock<mutex> lock(_runMutex, try_to_lock);
+    if (!lock.owns_lock())
+        return 0;
+
+    // Tasks added from now on are left for the next call
+    auto end = _enqueuePosition.load(memory_order_acquire);
+    auto position = _dequeuePosition.load(memory_order_relaxed);
+    while (position < end)
+    {
+        auto& cell = _cells[position & _mask];
+        // Stop at the first task which is still being written, to keep the order
+        if (cell.sequence.load(memory_order_acquire) != position + 1)
+            break;
+
+        _runningTasks.push_back({std::move(cell.task), std::move(cell.key)});
+        cell.task = nullptr;
+        cell.sequence.store(position + _mask + 1, memory_order_release);
+        ++position;
+    }
+    _dequeuePosition.store(position, memory_order_release);
+
+    // The overflow only holds tasks added after those in the ring, so it is taken when the ring is empty
+    if (_isOverflowing.load(memory_order_acquire))
+    {
+        lock_guard<Spinlock> lockOverflow(_overflowMutex);
+        if (position == _enqueuePosition.load(memory_order_acquire))
+        {
+            for (auto& entry : _overflow)
+                _runningTasks.push_back(std::move(entry));
+            _overflow.clear();
+            _isOverflowing.store(false, memory_order_release);
+        }
+    }
+
+    _lastKeyIndex.clear();
+    for (size_t index = 0; index < _runningTasks.size(); ++index)
+        if (!_runningTasks[index].key.empty())
+            _lastKeyIndex[_runningTasks[index].key] = index;
+
+    for (size_t index = 0; index < _runningTasks.size(); ++index)
+    {
+        auto& entry = _runningTasks[index];
+        if (!entry.key.empty() && _lastKeyIndex[entry.key] != index)
+            continue;
+        if (entry.task)
+            entry.task();
+    }
+
+    auto taskCount = _runningTasks.size();
+    _runningTasks.clear();
+    return taskCount;
+}
+
+/*************/
+size_t TaskQueue::getDepth() const
+{
+    auto depth = _enqueuePosition.load(memory_order_relaxed) - _dequeuePosition.load(memory_order_relaxed);
+    if (_isOverflowing.load(memory_order_acquire))
+    {
+        lock_guard<Spinlock> lock(_overflowMutex);
+        depth += _overflow.size();
+    }
+    return depth;
+}
+
+} // end of namespace
@@ -4,6 +4,7 @@
 
 #include "image.h"
 #include "log.h"
+#include "thread_pool.h"
 #include "timer.h"
 
 #define SPLASH_TEXTURE_COPY_THREADS 2
@@ -13,6 +14,9 @@ using namespace std;
 namespace Splash
 {
 
+/*************/
+atomic<uint64_t> Texture_Image::_imageLinksVersion{0};
+
 /*************/
 Texture_Image::Texture_Image(RootObject* root)
     : Texture(root)
@@ -37,14 +41,19 @@ Texture_Image::~Texture_Image()
 #ifdef DEBUG
     Log::get() << Log::DEBUGGING << "Texture_Image::~Texture_Image - Destructor" << Log::endl;
 #endif
+    flushPbo();
+    deletePbos();
     glDeleteTextures(1, &_glTex);
-    glDeleteBuffers(2, _pbos);
 }
 
 /*************/
 Texture_Image& Texture_Image::operator=(const shared_ptr<Image>& img)
 {
-    _img = weak_ptr<Image>(img);
+    {
+        lock_guard<mutex> lock(_mutex);
+        _img = weak_ptr<Image>(img);
+    }
+    ++_imageLinksVersion;
     return *this;
 }
 
@@ -62,6 +71,13 @@ void Texture_Image::generateMipmap() const
     glGenerateTextureMipmap(_glTex);
 }
 
+/*************/
+shared_ptr<Image> Texture_Image::getImage() const
+{
+    lock_guard<mutex> lock(_mutex);
+    return _img.lock();
+}
+
 /*************/
 RgbValue Texture_Image::getMeanValue() const
 {
@@ -101,8 +117,13 @@ bool Texture_Image::linkTo(const std::shared_ptr<BaseObject>& obj)
     if (dynamic_pointer_cast<Image>(obj).get() != nullptr)
     {
         auto img = dynamic_pointer_cast<Image>(obj);
+        {
+            lock_guard<mutex> lock(_mutex);
+            _img = weak_ptr<Image>(img);
+        }
+        // The link must be visible before the image is marked as updated, for the upload to find this texture
+        ++_imageLinksVersion;
         img->setDirty();
-        _img = weak_ptr<Image>(img);
         return true;
     }
 
@@ -138,35 +159,35 @@ void Texture_Image::reset(int width, int height, const string& pixelFormat, cons
 
     if (realPixelFormat == "RGBA")
     {
-        _spec = ImageBufferSpec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+        _spec = ImageBufferSpec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA);
         _texInternalFormat = GL_RGBA8;
         _texFormat = GL_RGBA;
         _texType = GL_UNSIGNED_INT_8_8_8_8_REV;
     }
     else if (realPixelFormat == "sRGBA")
     {
-        _spec = ImageBufferSpec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+        _spec = ImageBufferSpec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA);
         _texInternalFormat = GL_SRGB8_ALPHA8;
         _texFormat = GL_RGBA;
         _texType = GL_UNSIGNED_INT_8_8_8_8_REV;
     }
     else if (realPixelFormat == "RGBA16")
     {
-        _spec = ImageBufferSpec(width, height, 4, 64, ImageBufferSpec::Type::UINT8, "RGBA");
+        _spec = ImageBufferSpec(width, height, 4, 64, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA);
         _texInternalFormat = GL_RGBA16;
         _texFormat = GL_RGBA;
         _texType = GL_UNSIGNED_INT_8_8_8_8_REV;
     }
     else if (realPixelFormat == "RGB")
     {
-        _spec = ImageBufferSpec(width, height, 3, 24, ImageBufferSpec::Type::UINT8, "RGB");
+        _spec = ImageBufferSpec(width, height, 3, 24, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGB);
         _texInternalFormat = GL_RGBA8;
         _texFormat = GL_RGB;
         _texType = GL_UNSIGNED_BYTE;
     }
     else if (realPixelFormat == "R16")
     {
-        _spec = ImageBufferSpec(width, height, 1, 16, ImageBufferSpec::Type::UINT16, "R");
+        _spec = ImageBufferSpec(width, height, 1, 16, ImageBufferSpec::Type::UINT16, ImageBufferSpec::Format::R);
         _texInternalFormat = GL_R16;
         _texFormat = GL_RED;
         _texType = GL_UNSIGNED_SHORT;
@@ -180,7 +201,7 @@ void Texture_Image::reset(int width, int height, const string& pixelFormat, cons
     }
     else if (realPixelFormat == "D")
     {
-        _spec = ImageBufferSpec(width, height, 1, 24, ImageBufferSpec::Type::UINT16, "R");
+        _spec = ImageBufferSpec(width, height, 1, 24, ImageBufferSpec::Type::UINT16, ImageBufferSpec::Format::R);
         _texInternalFormat = GL_DEPTH_COMPONENT24;
         _texFormat = GL_DEPTH_COMPONENT;
         _texType = GL_FLOAT;
@@ -270,30 +291,31 @@ void Texture_Image::unbind()
 /*************/
 GLenum Texture_Image::getChannelOrder(const ImageBufferSpec& spec)
 {
-    GLenum glChannelOrder = GL_RGB;
-
-    if (spec.format == "BGR")
-        glChannelOrder = GL_BGR;
-    else if (spec.format == "RGB")
-        glChannelOrder = GL_RGB;
-    else if (spec.format == "BGRA")
-        glChannelOrder = GL_BGRA;
-    else if (spec.format == "RGBA")
-        glChannelOrder = GL_RGBA;
-    else if (spec.format == "RGB" || spec.format == "RGB_DXT1")
-        glChannelOrder = GL_RGB;
-    else if (spec.format == "RGBA" || spec.format == "RGBA_DXT5")
-        glChannelOrder = GL_RGBA;
-    else if (spec.format == "YUYV" || spec.format == "UYVY")
-        glChannelOrder = GL_RG;
-    else if (spec.channels == 1)
-        glChannelOrder = GL_RED;
-    else if (spec.channels == 3)
-        glChannelOrder = GL_RGB;
-    else if (spec.channels == 4)
-        glChannelOrder = GL_RGBA;
+    switch (spec.format)
+    {
+    case ImageBufferSpec::Format::BGR:
+        return GL_BGR;
+    case ImageBufferSpec::Format::RGB:
+    case ImageBufferSpec::Format::RGB_DXT1:
+        return GL_RGB;
+    case ImageBufferSpec::Format::BGRA:
+        return GL_BGRA;
+    case ImageBufferSpec::Format::RGBA:
+    case ImageBufferSpec::Format::RGBA_DXT5:
+        return GL_RGBA;
+    case ImageBufferSpec::Format::YUYV:
+    case ImageBufferSpec::Format::UYVY:
+        return GL_RG;
+    default:
+        break;
+    }
 
-    return glChannelOrder;
+    if (spec.channels == 1)
+        return GL_RED;
+    else if (spec.channels == 4)
+        return GL_RGBA;
+    else
+        return GL_RGB;
 }
 
 /*************/
@@ -319,10 +341,13 @@ void Texture_Image::update()
     }
 
     auto spec = img->getSpec();
+    static const AttributeHandle srgbAttribute("srgb");
+    static const AttributeHandle flipAttribute("flip");
+    static const AttributeHandle flopAttribute("flop");
     Values srgb, flip, flop;
-    img->getAttribute("srgb", srgb);
-    img->getAttribute("flip", flip);
-    img->getAttribute("flop", flop);
+    img->getAttribute(srgbAttribute, srgb);
+    img->getAttribute(flipAttribute, flip);
+    img->getAttribute(flopAttribute, flop);
 
     if (!(bool)glIsTexture(_glTex))
         glCreateTextures(GL_TEXTURE_2D, 1, &_glTex);
@@ -333,20 +358,22 @@ void Texture_Image::update()
 
     // If the texture is compressed, we need to modify a few values
     bool isCompressed = false;
-    if (spec.format == "RGB_DXT1")
+    switch (spec.format)
     {
+    case ImageBufferSpec::Format::RGB_DXT1:
         isCompressed = true;
         spec.height *= 2;
         spec.channels = 3;
-    }
-    else if (spec.format == "RGBA_DXT5")
-    {
+        break;
+    case ImageBufferSpec::Format::RGBA_DXT5:
         isCompressed = true;
         spec.channels = 4;
-    }
-    else if (spec.format == "YCoCg_DXT5")
-    {
+        break;
+    case ImageBufferSpec::Format::YCoCg_DXT5:
         isCompressed = true;
+        break;
+    default:
+        break;
     }
 
     // Get GL parameters
@@ -388,33 +415,56 @@ void Texture_Image::update()
     }
     else if (isCompressed)
     {
-        if (spec.format == "RGB_DXT1")
+        switch (spec.format)
         {
+        case ImageBufferSpec::Format::RGB_DXT1:
             if (srgb[0].as<int>() > 0)
                 internalFormat = GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
             else
                 internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
-        }
-        else if (spec.format == "RGBA_DXT5")
-        {
+            break;
+        case ImageBufferSpec::Format::RGBA_DXT5:
             if (srgb[0].as<int>() > 0)
                 internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
             else
                 internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
-        }
-        else if (spec.format == "YCoCg_DXT5")
-        {
+            break;
+        case ImageBufferSpec::Format::YCoCg_DXT5:
             internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
-        }
-        else
-        {
+            break;
+        default:
             Log::get() << Log::WARNING << "Texture_Image::" << __FUNCTION__ << " - Unknown compressed format" << Log::endl;
             return;
         }
     }
 
-    // Update the textures if the format changed
-    if (spec != _spec || !spec.videoFrame)
+    // Finish the copy started during the previous update, if flushPbo has not been called
+    flushPbo();
+
+    // Upload directly from the image, used when the texture is (re)created or if the PBO ring is not available
+    auto uploadFromImage = [&]() {
+        img->lockWrite();
+        if (!isCompressed)
+            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, img->data());
+        else
+            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, img->data());
+        img->unlockWrite();
+    };
+
+    // Upload from the given slot of the PBO ring, and fence the slot until the upload is done
+    auto uploadFromPbo = [&](int index) {
+        auto offset = reinterpret_cast<const GLvoid*>(index * _pboSlotSize);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbo);
+        if (!isCompressed)
+            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, offset);
+        else
+            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, offset);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        _pboFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    };
+
+    // The texture storage is immutable, so it is only recreated if the size or format changed
+    if (spec != _spec || internalFormat != static_cast<GLenum>(_texInternalFormat))
     {
         // glTexStorage2D is immutable, so we have to delete the texture first
         glDeleteTextures(1, &_glTex);
@@ -437,85 +487,76 @@ void Texture_Image::update()
             glTextureParameteri(_glTex, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
         }
 
-        // Create or update the texture parameters
-        if (!isCompressed)
-        {
-#ifdef DEBUG
-            Log::get() << Log::DEBUGGING << "Texture_Image::" << __FUNCTION__ << " - Creating a new texture" << Log::endl;
-#endif
-            img->lockWrite();
-            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, img->data());
-            img->unlockWrite();
-        }
-        else if (isCompressed)
-        {
 #ifdef DEBUG
-            Log::get() << Log::DEBUGGING << "Texture_Image::" << __FUNCTION__ << " - Creating a new compressed texture" << Log::endl;
+        Log::get() << Log::DEBUGGING << "Texture_Image::" << __FUNCTION__ << " - Creating a new texture" << Log::endl;
 #endif
+        glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
+        uploadFromImage();
 
-            img->lockWrite();
-            glTextureStorage2D(_glTex, _texLevels, internalFormat, spec.width, spec.height);
-            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, img->data());
-            img->unlockWrite();
-        }
-        updatePbos(spec.width, spec.height, spec.pixelBytes());
+        // The ring only grows, and the frame which was being prepared does not match the new texture
+        updatePbos(imageDataSize);
+        _pboPendingIndex = -1;
 
-        // Fill one of the PBOs right now
-        GLubyte* pixels = (GLubyte*)glMapNamedBufferRange(_pbos[0], 0, imageDataSize, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
-        if (pixels != NULL)
+        _spec = spec;
+        _texInternalFormat = internalFormat;
+        if (!isCompressed)
         {
-            img->lockWrite();
-            memcpy((void*)pixels, img->data(), imageDataSize);
-            glUnmapNamedBuffer(_pbos[0]);
-            img->unlockWrite();
+            _texFormat = glChannelOrder;
+            _texType = dataFormat;
         }
-
-        // And copy it to the second PBO
-        glCopyNamedBufferSubData(_pbos[0], _pbos[1], 0, 0, imageDataSize);
-        _spec = spec;
     }
-    // Update the content of the texture, i.e the image
+    else if (!updatePbos(imageDataSize))
+    {
+        uploadFromImage();
+    }
+    // Still images are copied and uploaded right away, there is no reason to delay them by a frame
+    else if (!spec.videoFrame)
+    {
+        auto index = _pboWriteIndex;
+        _pboWriteIndex = (_pboWriteIndex + 1) % _pboCount;
+
+        auto pixels = acquirePboSlot(index);
+        img->lockWrite();
+        memcpy(pixels, img->data(), imageDataSize);
+        img->unlockWrite();
+        uploadFromPbo(index);
+    }
+    // Video frames: upload the frame copied during the last update, and start copying the new one
     else
     {
-        // Copy the pixels from the current PBO to the texture
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbos[_pboReadIndex]);
-        if (!isCompressed)
-            glTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, glChannelOrder, dataFormat, 0);
-        else
-            glCompressedTextureSubImage2D(_glTex, 0, 0, 0, spec.width, spec.height, internalFormat, imageDataSize, 0);
-        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (_pboPendingIndex >= 0)
+            uploadFromPbo(_pboPendingIndex);
+
+        auto index = _pboWriteIndex;
+        _pboWriteIndex = (_pboWriteIndex + 1) % _pboCount;
 
-        _pboReadIndex = (_pboReadIndex + 1) % 2;
+        // Fill the next slot with the image pixels, the copy is waited for in flushPbo
+        auto pixels = acquirePboSlot(index);
+        img->lockWrite();
 
-        // Fill the next PBO with the image pixels
-        GLubyte* pixels = (GLubyte*)glMapNamedBufferRange(_pbos[_pboReadIndex], 0, imageDataSize, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
-        if (pixels != NULL)
+        int stride = SPLASH_TEXTURE_COPY_THREADS;
+        int size = imageDataSize;
+        for (int i = 0; i < stride - 1; ++i)
         {
-            img->lockWrite();
-
-            int stride = SPLASH_TEXTURE_COPY_THREADS;
-            int size = imageDataSize;
-            for (int i = 0; i < stride - 1; ++i)
-            {
-                _pboCopyThreads.push_back(
-                    async(launch::async, [=]() { copy((char*)img->data() + size / stride * i, (char*)img->data() + size / stride * (i + 1), (char*)pixels + size / stride * i); }));
-            }
             _pboCopyThreads.push_back(
-                async(launch::async, [=]() { copy((char*)img->data() + size / stride * (stride - 1), (char*)img->data() + size, (char*)pixels + size / stride * (stride - 1)); }));
+                ThreadPool::get().enqueue([=]() { copy((char*)img->data() + size / stride * i, (char*)img->data() + size / stride * (i + 1), (char*)pixels + size / stride * i); }));
         }
+        _pboCopyThreads.push_back(ThreadPool::get().enqueue(
+            [=]() { copy((char*)img->data() + size / stride * (stride - 1), (char*)img->data() + size, (char*)pixels + size / stride * (stride - 1)); }));
+
+        _pboPendingIndex = index;
     }
 
     // If needed, specify some uniforms for the shader which will use this texture
     _shaderUniforms.clear();
-    if (spec.format == "YCoCg_DXT5")
+    if (spec.format == ImageBufferSpec::Format::YCoCg_DXT5)
         _shaderUniforms["YCoCg"] = {1};
     else
         _shaderUniforms["YCoCg"] = {0};
 
-    if (spec.format == "UYVY")
+    if (spec.format == ImageBufferSpec::Format::UYVY)
         _shaderUniforms["YUV"] = {1};
-    else if (spec.format == "YUYV")
+    else if (spec.format == ImageBufferSpec::Format::YUYV)
         _shaderUniforms["YUV"] = {2};
     else
         _shaderUniforms["YUV"] = {0};
@@ -533,10 +574,10 @@ void Texture_Image::flushPbo()
 {
     if (!_pboCopyThreads.empty())
     {
-        _pboCopyThreads.clear(); // This waits for the threaded copies to finish
-
-        glUnmapNamedBuffer(_pbos[_pboReadIndex]);
+        ThreadPool::get().waitFor(_pboCopyThreads);
+        _pboCopyThreads.clear();
 
+        // The ring is mapped coherently, so there is nothing to unmap or flush here
         if (!_img.expired())
             _img.lock()->unlockWrite();
     }
@@ -553,15 +594,76 @@ void Texture_Image::init()
         return;
 
     _timestamp = Timer::getTime();
+}
 
-    glCreateBuffers(2, _pbos);
+/*************/
+bool Texture_Image::updatePbos(size_t size)
+{
+    if (_pboMapping && size <= _pboSlotSize)
+        return true;
+
+    deletePbos();
+
+    auto slotSize = (size + _pboAlignment - 1) / _pboAlignment * _pboAlignment;
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &_pbo);
+    glNamedBufferStorage(_pbo, slotSize * _pboCount, nullptr, flags);
+    _pboMapping = static_cast<GLubyte*>(glMapNamedBufferRange(_pbo, 0, slotSize * _pboCount, flags));
+
+    if (!_pboMapping)
+    {
+        Log::get() << Log::WARNING << "Texture_Image::" << __FUNCTION__ << " - Unable to map the PBO ring, falling back to direct uploads" << Log::endl;
+        glDeleteBuffers(1, &_pbo);
+        _pbo = 0;
+        return false;
+    }
+
+    _pboSlotSize = slotSize;
+    _pboWriteIndex = 0;
+    _pboPendingIndex = -1;
+    return true;
 }
 
 /*************/
-void Texture_Image::updatePbos(int width, int height, int bytes)
+GLubyte* Texture_Image::acquirePboSlot(int index)
 {
-    glNamedBufferData(_pbos[0], width * height * bytes, 0, GL_STREAM_DRAW);
-    glNamedBufferData(_pbos[1], width * height * bytes, 0, GL_STREAM_DRAW);
+    auto& fence = _pboFences[index];
+    if (fence)
+    {
+        // The upload from this slot has been issued at least a frame ago, so this should rarely wait
+        while (true)
+        {
+            auto status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            if (status != GL_TIMEOUT_EXPIRED)
+                break;
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    return _pboMapping + index * _pboSlotSize;
+}
+
+/*************/
+void Texture_Image::deletePbos()
+{
+    for (int i = 0; i < _pboCount; ++i)
+    {
+        if (!_pboFences[i])
+            continue;
+        glClientWaitSync(_pboFences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(_pboFences[i]);
+        _pboFences[i] = nullptr;
+    }
+
+    if (_pboMapping)
+        glUnmapNamedBuffer(_pbo);
+    if (_pbo)
+        glDeleteBuffers(1, &_pbo);
+
+    _pbo = 0;
+    _pboMapping = nullptr;
+    _pboSlotSize = 0;
 }
 
 /*************/
@@ -0,0 +1,53 @@
+#include "./texture_upload_list.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+/*************/
+vector<shared_ptr<Texture_Image>> TextureUploadList::getTextures(
+    const unordered_map<string, shared_ptr<BaseObject>>& objects, uint64_t objectsGeneration, const unordered_set<string>& updatedBufferObjects)
+{
+    // Read before going through the objects, so that a link made meanwhile triggers a rebuild next time
+    auto imageLinksVersion = Texture_Image::getImageLinksVersion();
+    if (!_isBuilt || objectsGeneration != _objectsGeneration || imageLinksVersion != _imageLinksVersion)
+    {
+        _texturesPerImage.clear();
+        for (auto& obj : objects)
+        {
+            auto texture = dynamic_pointer_cast<Texture_Image>(obj.second);
+            if (!texture)
+                continue;
+
+            auto image = texture->getImage();
+            if (!image)
+                continue;
+
+            _texturesPerImage[image->getName()].push_back(texture);
+        }
+
+        _isBuilt = true;
+        _objectsGeneration = objectsGeneration;
+        _imageLinksVersion = imageLinksVersion;
+    }
+
+    vector<shared_ptr<Texture_Image>> textures;
+    for (auto& name : updatedBufferObjects)
+    {
+        auto texturesIt = _texturesPerImage.find(name);
+        if (texturesIt == _texturesPerImage.end())
+            continue;
+
+        for (auto& weakTexture : texturesIt->second)
+        {
+            auto texture = weakTexture.lock();
+            if (texture)
+                textures.push_back(texture);
+        }
+    }
+
+    return textures;
+}
+
+} // end of namespace
@@ -0,0 +1,248 @@
+#include "./thread_pool.h"
+
+#include <algorithm>
+
+#include "./log.h"
+#include "./osUtils.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+namespace
+{
+// Worker running in the current thread, if any
+thread_local const ThreadPool* currentPool{nullptr};
+thread_local int currentWorkerIndex{-1};
+}
+
+/*************/
+ThreadPool::ThreadPool(unsigned int workerCount)
+{
+    startWorkers(workerCount);
+}
+
+/*************/
+ThreadPool::~ThreadPool()
+{
+    unique_lock<shared_timed_mutex> lock(_workersMutex);
+    stopWorkers();
+}
+
+/*************/
+future<void> ThreadPool::enqueue(const function<void()>& task)
+{
+    auto packagedTask = make_shared<packaged_task<void()>>(task);
+    auto future = packagedTask->get_future();
+
+    // Workers can not be replaced while one of them is running, so they do not need to lock
+    auto workerIndex = getCurrentWorkerIndex();
+    shared_lock<shared_timed_mutex> lock(_workersMutex, defer_lock);
+    if (workerIndex < 0)
+    {
+        lock.lock();
+        workerIndex = _nextWorker.fetch_add(1) % _workers.size();
+    }
+
+    {
+        auto& worker = _workers[workerIndex];
+        lock_guard<Spinlock> workerLock(worker->mutex);
+        worker->tasks.emplace_back([packagedTask]() { (*packagedTask)(); });
+    }
+
+    _pendingTasks.fetch_add(1);
+    {
+        // Locking prevents a worker from missing the notification while going to sleep
+        lock_guard<mutex> sleepLock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+
+    return future;
+}
+
+/*************/
+void ThreadPool::waitFor(vector<future<void>>& futures)
+{
+    for (auto& future : futures)
+        waitFor(future);
+}
+
+/*************/
+void ThreadPool::waitFor(future<void>& future)
+{
+    if (!future.valid())
+        return;
+
+    // Other threads only block: they can hold locks which the queued tasks need, and must not be held up by unrelated tasks
+    auto workerIndex = getCurrentWorkerIndex();
+    if (workerIndex < 0)
+    {
+        future.wait();
+        return;
+    }
+
+    while (future.wait_for(chrono::seconds(0)) != future_status::ready)
+    {
+        // If there is nothing left to run, the awaited task is being run by another thread
+        Task task;
+        if (popTask(workerIndex, task))
+            task();
+        else
+            future.wait();
+    }
+}
+
+/*************/
+void ThreadPool::setWorkerCount(unsigned int workerCount)
+{
+    if (getCurrentWorkerIndex() >= 0)
+    {
+        Log::get() << Log::WARNING << "ThreadPool::" << __FUNCTION__ << " - Workers can not be replaced from inside a task" << Log::endl;
+        return;
+    }
+
+    unique_lock<shared_timed_mutex> lock(_workersMutex);
+    stopWorkers();
+    startWorkers(workerCount);
+}
+
+/*************/
+bool ThreadPool::setAffinity(const vector<int>& cores)
+{
+    auto coreCount = Utils::getCoreCount();
+    for (auto core : cores)
+        if (core < 0 || core >= coreCount)
+            return false;
+
+    if (getCurrentWorkerIndex() >= 0)
+    {
+        Log::get() << Log::WARNING << "ThreadPool::" << __FUNCTION__ << " - Affinity can not be changed from inside a task" << Log::endl;
+        return false;
+    }
+
+    unique_lock<shared_timed_mutex> lock(_workersMutex);
+    auto workerCount = _workerCount.load();
+    stopWorkers();
+    _affinity = cores;
+    startWorkers(workerCount);
+
+    return true;
+}
+
+/*************/
+void ThreadPool::startWorkers(unsigned int workerCount)
+{
+    if (workerCount == 0)
+        workerCount = std::max(Utils::getCoreCount(), 1);
+
+    _stopWorkers = false;
+    _workers.clear();
+    for (unsigned int i = 0; i < workerCount; ++i)
+        _workers.emplace_back(new Worker());
+    for (unsigned int i = 0; i < workerCount; ++i)
+        _workers[i]->thread = thread([=]() { workerLoop(i); });
+
+    _workerCount = workerCount;
+}
+
+/*************/
+void ThreadPool::stopWorkers()
+{
+    {
+        lock_guard<mutex> sleepLock(_sleepMutex);
+        _stopWorkers = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+        if (worker->thread.joinable())
+            worker->thread.join();
+
+    _workers.clear();
+}
+
+/*************/
+int ThreadPool::getCurrentWorkerIndex() const
+{
+    if (currentPool != this)
+        return -1;
+    return currentWorkerIndex;
+}
+
+/*************/
+bool ThreadPool::popTask(int workerIndex, Task& task)
+{
+    auto workerCount = static_cast<int>(_workers.size());
+    if (workerCount == 0)
+        return false;
+
+    // Workers run their own tasks in LIFO order, which keeps nested tasks hot in cache
+    if (workerIndex >= 0)
+    {
+        auto& worker = _workers[workerIndex];
+        lock_guard<Spinlock> lock(worker->mutex);
+        if (!worker->tasks.empty())
+        {
+            task = std::move(worker->tasks.back());
+            worker->tasks.pop_back();
+            _pendingTasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // Then steal the oldest tasks from the other workers
+    auto start = workerIndex >= 0 ? workerIndex + 1 : 0;
+    for (int i = 0; i < workerCount; ++i)
+    {
+        auto index = (start + i) % workerCount;
+        if (index == workerIndex)
+            continue;
+
+        auto& worker = _workers[index];
+        lock_guard<Spinlock> lock(worker->mutex);
+        if (!worker->tasks.empty())
+        {
+            task = std::move(worker->tasks.front());
+            worker->tasks.pop_front();
+            _pendingTasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*************/
+void ThreadPool::workerLoop(unsigned int workerIndex)
+{
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+
+    // Without a specified affinity, workers can run on all cores
+    auto cores = _affinity;
+    if (cores.empty())
+        for (int core = 0; core < Utils::getCoreCount(); ++core)
+            cores.push_back(core);
+    Utils::setAffinity(cores);
+
+    while (true)
+    {
+        Task task;
+        if (popTask(workerIndex, task))
+        {
+            task();
+            continue;
+        }
+
+        unique_lock<mutex> lock(_sleepMutex);
+        if (_stopWorkers)
+            break;
+        _sleepCondition.wait(lock, [&]() { return _stopWorkers || _pendingTasks > 0; });
+    }
+
+    currentPool = nullptr;
+    currentWorkerIndex = -1;
+}
+
+} // end of namespace
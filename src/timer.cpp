@@ -0,0 +1,40 @@
+#include "./timer.h"
+
+#include "./log.h"
+
+using namespace std;
+
+namespace Splash
+{
+
+const Timer::Handle Timer::_maxEntries;
+
+/*************/
+Timer::Handle Timer::getHandle(const string& name)
+{
+    lock_guard<mutex> lock(_entriesMutex);
+    auto handleIt = _handles.find(name);
+    if (handleIt != _handles.end())
+        return handleIt->second;
+
+    // Past the maximum number of timers, the returned handle is valid but nothing gets recorded
+    auto handle = _entryCount.load(memory_order_relaxed);
+    if (handle == _maxEntries)
+    {
+        if (_handles.size() == _maxEntries)
+            Log::get() << Log::WARNING << "Timer::" << __FUNCTION__ << " - Maximum number of timers reached (" << _maxEntries << "), timer " << name
+                       << " and the following ones are not recorded" << Log::endl;
+        _handles[name] = handle;
+        return handle;
+    }
+
+    auto& block = _entryBlocks[handle / _entriesPerBlock];
+    if (!block)
+        block = make_unique<unique_ptr<Entry>[]>(_entriesPerBlock);
+    block[handle % _entriesPerBlock] = make_unique<Entry>(name, getTime());
+    _entryCount.store(handle + 1, memory_order_release);
+    _handles[name] = handle;
+    return handle;
+}
+
+} // end of namespace
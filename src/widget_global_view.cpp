@@ -101,7 +101,8 @@ void GuiGlobalView::render()
             camera->render();
 
             Values size;
-            camera->getAttribute("size", size);
+            static const AttributeHandle sizeAttribute("size");
+            camera->getAttribute(sizeAttribute, size);
 
             int w = ImGui::GetWindowWidth() - 4 * leftMargin;
             int h = w * size[1].as<int>() / size[0].as<int>();
@@ -145,7 +146,8 @@ void GuiGlobalView::render()
         if (_camera != nullptr)
         {
             Values size;
-            _camera->getAttribute("size", size);
+            static const AttributeHandle sizeAttribute("size");
+            _camera->getAttribute(sizeAttribute, size);
 
             int w = ImGui::GetWindowWidth() - 2 * leftMargin;
             int h = w * size[1].as<int>() / size[0].as<int>();
@@ -154,7 +156,8 @@ void GuiGlobalView::render()
             _camHeight = h;
 
             Values reprojectionError;
-            _camera->getAttribute("getReprojectionError", reprojectionError);
+            static const AttributeHandle getReprojectionErrorAttribute("getReprojectionError");
+            _camera->getAttribute(getReprojectionErrorAttribute, reprojectionError);
             ImGui::Text(("Current camera: " + _camera->getName() + " - Reprojection error: " + reprojectionError[0].as<string>()).c_str());
 
             ImGui::Image((void*)(intptr_t)_camera->getTexture()->getTexId(), ImVec2(w, h), ImVec2(0, 1), ImVec2(1, 0));
@@ -12,7 +12,8 @@ void GuiGraph::render()
 {
     if (ImGui::CollapsingHeader(_name.c_str()))
     {
-        auto& durationMap = Timer::get().getDurationMap();
+        auto durationMap = Timer::get().getDurations();
+        auto statsMap = Timer::get().getAllStats();
 
         for (auto& t : durationMap)
         {
@@ -42,8 +43,21 @@ void GuiGraph::render()
 
             maxValue = ceil(maxValue * 0.1f) * 10.f;
 
-            ImGui::PlotLines(
-                "", values.data(), values.size(), values.size(), (duration.first + " - " + to_string((int)maxValue) + "ms").c_str(), 0.f, maxValue, ImVec2(width - 30, 80));
+            auto label = duration.first + " - " + to_string((int)maxValue) + "ms";
+            auto statsIt = statsMap.find(duration.first);
+            if (statsIt != statsMap.end() && statsIt->second.count != 0)
+            {
+                char statsLabel[96];
+                snprintf(statsLabel,
+                    sizeof(statsLabel),
+                    " - p50 %.2fms / p99 %.2fms / max %.2fms",
+                    statsIt->second.p50 * 0.001f,
+                    statsIt->second.p99 * 0.001f,
+                    statsIt->second.max * 0.001f);
+                label += statsLabel;
+            }
+
+            ImGui::PlotLines("", values.data(), values.size(), values.size(), label.c_str(), 0.f, maxValue, ImVec2(width - 30, 80));
         }
     }
 }
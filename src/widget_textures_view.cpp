@@ -27,7 +27,8 @@ void GuiTexturesView::render()
             cameraAsObj->render();
 
             Values size;
-            cameraAsObj->getAttribute("size", size);
+            static const AttributeHandle sizeAttribute("size");
+            cameraAsObj->getAttribute(sizeAttribute, size);
 
             int w = ImGui::GetWindowWidth() / 2;
             int h = w * size[1].as<int>() / size[0].as<int>();
@@ -55,7 +56,8 @@ void GuiTexturesView::render()
         for (auto& object : objects)
         {
             Values size;
-            object->getAttribute("size", size);
+            static const AttributeHandle sizeAttribute("size");
+            object->getAttribute(sizeAttribute, size);
 
             if (size[0].as<int>() == 0)
                 continue;
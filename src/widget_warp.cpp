@@ -68,11 +68,13 @@ void GuiWarp::render()
             Values values;
             ImGui::PushID(warp->getName().c_str());
 
-            warp->getAttribute("patchResolution", values);
+            static const AttributeHandle patchResolutionAttribute("patchResolution");
+            warp->getAttribute(patchResolutionAttribute, values);
             if (ImGui::InputInt("patchResolution", (int*)values[0].data(), 1, 32, ImGuiInputTextFlags_EnterReturnsTrue))
                 setObjectAttribute(warp->getName(), "patchResolution", {values[0].as<int>()});
 
-            warp->getAttribute("patchSize", values);
+            static const AttributeHandle patchSizeAttribute("patchSize");
+            warp->getAttribute(patchSizeAttribute, values);
             vector<int> tmp;
             tmp.push_back(values[0].as<int>());
             tmp.push_back(values[1].as<int>());
@@ -1,21 +1,27 @@
 #include "world.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <getopt.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <iterator>
 #include <regex>
 #include <spawn.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "./buffer_pool.h"
 #include "./image.h"
 #include "./link.h"
 #include "./log.h"
 #include "./mesh.h"
+#include "./mesh_cache.h"
 #include "./osUtils.h"
 #include "./queue.h"
 #include "./scene.h"
+#include "./thread_pool.h"
 #include "./timer.h"
 
 // Included only for creating the documentation through the --info flag
@@ -82,6 +88,7 @@ void World::run()
             // Read and serialize new buffers
             Timer::get() << "serialize";
             unordered_map<string, shared_ptr<SerializedObject>> serializedObjects;
+            unordered_map<string, shared_ptr<BufferObject>> sharedObjects; // Sent to the inner Scene, serialized only if needed
             {
                 vector<future<void>> threads;
                 for (auto& o : _objects)
@@ -95,23 +102,45 @@ void World::run()
                     if (!serializedObjectIt.second)
                         continue; // Error while inserting the object in the map
 
-                    threads.push_back(async(launch::async, [=, &o]() {
+                    // Buffers which no Scene consumes are kept as updated, to be sent once a Scene needs them
+                    auto destinations = _bufferConsumers.getDestinations(bufferObj->getDistantName());
+                    bool hasConsumer = destinations != nullptr;
+
+                    // Buffers consumed by the inner Scene are shared with it as is, references to map elements staying valid.
+                    // They are still serialized here if other Scenes consume them.
+                    shared_ptr<BufferObject>* sharedObject = nullptr;
+                    bool hasOuterConsumer = hasConsumer;
+                    if (hasConsumer && _link->getInProcessTransfer())
+                    {
+                        auto isInnerPeer = [&](const string& scene) { return _link->isInnerPeer(scene); };
+                        if (any_of(destinations->begin(), destinations->end(), isInnerPeer))
+                            sharedObject = &sharedObjects[bufferObj->getDistantName()];
+                        hasOuterConsumer = !all_of(destinations->begin(), destinations->end(), isInnerPeer);
+                    }
+
+                    threads.push_back(ThreadPool::get().enqueue([=, &o]() {
                         // Update the local objects
                         o.second->update();
 
                         // Send them the their destinations
-                        if (bufferObj.get() != nullptr)
+                        if (bufferObj.get() != nullptr && hasConsumer)
                         {
                             if (bufferObj->wasUpdated()) // if the buffer has been updated
                             {
-                                auto obj = bufferObj->serialize();
+                                if (hasOuterConsumer)
+                                {
+                                    auto obj = bufferObj->serialize();
+                                    if (obj)
+                                        serializedObjectIt.first->second = obj;
+                                }
                                 bufferObj->setNotUpdated();
-                                if (obj)
-                                    serializedObjectIt.first->second = obj;
+                                if (sharedObject)
+                                    *sharedObject = bufferObj;
                             }
                         }
                     }));
                 }
+                ThreadPool::get().waitFor(threads);
             }
             Timer::get() >> "serialize";
 
@@ -121,15 +150,52 @@ void World::run()
 
             // Ask for the upload of the new buffers, during the next world loop
             Timer::get() << "upload";
+            // Shared objects go to the inner Scene only, the other Scenes getting their serialized version
+            auto filterDestinations = [&](const vector<string>& destinations, bool inner) {
+                vector<string> filtered;
+                copy_if(destinations.begin(), destinations.end(), back_inserter(filtered), [&](const string& scene) { return _link->isInnerPeer(scene) == inner; });
+                return filtered;
+            };
+
             for (auto& o : serializedObjects)
-                if (o.second)
-                    _link->sendBuffer(o.first, std::move(o.second));
+            {
+                auto destinations = _bufferConsumers.getDestinations(o.first);
+                if (!o.second || !destinations)
+                    continue;
+
+                if (sharedObjects.find(o.first) == sharedObjects.end())
+                {
+                    _link->sendBuffer(o.first, std::move(o.second), *destinations);
+                }
+                else
+                {
+                    auto outerDestinations = filterDestinations(*destinations, false);
+                    if (!outerDestinations.empty())
+                        _link->sendBuffer(o.first, std::move(o.second), outerDestinations);
+                }
+            }
+            for (auto& o : sharedObjects)
+            {
+                auto destinations = _bufferConsumers.getDestinations(o.first);
+                if (!o.second || !destinations)
+                    continue;
+
+                auto innerDestinations = filterDestinations(*destinations, true);
+                if (!innerDestinations.empty())
+                    _link->sendBuffer(o.first, o.second, innerDestinations);
+            }
         }
 
-        // Update the distant attributes
+        // Messages sent from here to flushMessageBatch() are batched into a single frame
+        _link->beginMessageBatch();
+
+        // Update the distant attributes. Only those which changed since the last loop are sent,
+        // unless a full synchronization has been asked for, to give their state to new objects and Scenes
+        ++_distantAttributesTick;
+        auto sinceTick = _fullDistantSync.exchange(false) ? 0 : _distantAttributesTick - 1;
         for (auto& o : _objects)
         {
-            auto attribs = o.second->getDistantAttributes();
+            auto attribs = o.second->getDistantAttributes(_distantAttributesTick, sinceTick);
             for (auto& attrib : attribs)
             {
                 sendMessage(o.second->getName(), attrib.first, attrib.second);
@@ -139,10 +205,22 @@ void World::run()
         // If the master scene is not an inner scene, we have to send it some information
         if (_scenes[_masterSceneName] != -1)
         {
-            // Send current timings to all Scenes, for display purpose
-            auto& durationMap = Timer::get().getDurationMap();
-            for (auto& d : durationMap)
-                sendMessage(_masterSceneName, "duration", {d.first, (int)d.second});
+            // Send current timings to all Scenes, for display purpose, along with their statistics
+            if (Timer::getTime() - _lastTimingsSent >= _timingsPeriod)
+            {
+                _lastTimingsSent = Timer::getTime();
+                auto durations = Timer::get().getDurations();
+                auto stats = Timer::get().getAllStats();
+                for (auto& d : durations)
+                {
+                    Values timing{d.first, (int)d.second};
+                    auto statsIt = stats.find(d.first);
+                    if (statsIt != stats.end())
+                        for (auto& v : Timer::statsToValues(statsIt->second))
+                            timing.push_back(v);
+                    sendMessage(_masterSceneName, "duration", timing);
+                }
+            }
             // Also send the master clock if needed
             Values clock;
             if (Timer::get().getMasterClock(clock))
@@ -154,6 +232,11 @@ void World::run()
                 sendMessage(_masterSceneName, "log", {log.first, (int)log.second});
         }
 
+        _link->flushMessageBatch();
+
+        if (_benchmarkDuration > 0)
+            updateBenchmark();
+
         if (_quit)
         {
             for (auto& s : _scenes)
@@ -217,6 +300,8 @@ void World::applyConfig()
     _scenes.clear();
     _objects.clear();
     _objectDest.clear();
+    _bufferConsumers.clear();
+    _fullDistantSync = true;
     _masterSceneName = "";
 
     try
@@ -403,6 +488,11 @@ void World::applyConfig()
             sendMessage(SPLASH_ALL_PEERS, "configurationPath", {_configurationPath});
             sendMessage(SPLASH_ALL_PEERS, "mediaPath", {_configurationPath});
             sendMessage(SPLASH_ALL_PEERS, "runInBackground", {_runInBackground});
+
+            // The buffer pool of each process gets the same configuration
+            sendMessage(SPLASH_ALL_PEERS, "bufferPoolSize", {static_cast<int>(BufferPool::get().getCacheSize() / (1024 * 1024))});
+            sendMessage(SPLASH_ALL_PEERS, "bufferPoolMaxAge", {static_cast<float>(BufferPool::get().getMaxAge()) / 1e6f});
+            sendMessage(SPLASH_ALL_PEERS, "bufferPoolHugePages", {BufferPool::get().getHugePages()});
         }
 
         // Make sure all objects have been created in every Scene, by sending a sync message
@@ -1150,6 +1240,7 @@ void World::parseArguments(int argc, char** argv)
     while (true)
     {
         static struct option longOptions[] = {
+            {"benchmark", required_argument, 0, 'b'},
             {"debug", no_argument, 0, 'd'},
 #if HAVE_LINUX
             {"forceDisplay", required_argument, 0, 'D'},
@@ -1168,7 +1259,7 @@ void World::parseArguments(int argc, char** argv)
         };
 
         int optionIndex = 0;
-        auto ret = getopt_long(argc, argv, "+cdD:S:hHilo:p:P:st", longOptions, &optionIndex);
+        auto ret = getopt_long(argc, argv, "+b:cdD:S:hHilo:p:P:st", longOptions, &optionIndex);
 
         if (ret == -1)
             break;
@@ -1183,6 +1274,9 @@ void World::parseArguments(int argc, char** argv)
             cout << "Basic usage: splash [arguments] [config.json] -- [python script argument]" << endl;
             cout << "Options:" << endl;
             cout << "\t-o (--open) [filename] : set [filename] as the configuration file to open" << endl;
+            cout << "\t-b (--benchmark) [seconds] : run hidden for the given duration, then print the timings and quit" << endl;
+            cout << "                  loads benchmark.json if no configuration file is given. To run without GPU:" << endl;
+            cout << "                  LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -s \"-screen 0 1920x1080x24\" splash -S 99 -b 30" << endl;
             cout << "\t-d (--debug) : activate debug messages (if Splash was compiled with -DDEBUG)" << endl;
             cout << "\t-t (--timer) : activate more timers, at the cost of performance" << endl;
 #if HAVE_LINUX
@@ -1200,6 +1294,20 @@ void World::parseArguments(int argc, char** argv)
             cout << endl;
             exit(0);
         }
+        case 'b':
+        {
+            auto duration = atof(optarg);
+            if (duration <= 0.0)
+            {
+                Log::get() << Log::WARNING << "World::" << __FUNCTION__ << " - " << string(optarg) << ": argument expects a positive duration in seconds" << Log::endl;
+                exit(0);
+            }
+            _benchmarkDuration = static_cast<int64_t>(duration * 1e6);
+            _runInBackground = true;
+            if (defaultFile)
+                filename = string(DATADIR) + "benchmark.json";
+            break;
+        }
         case 'd':
         {
             Log::get().setVerbosity(Log::DEBUGGING);
@@ -1372,6 +1480,98 @@ void World::parseArguments(int argc, char** argv)
         Log::get() << Log::MESSAGE << "Loading file " << filename << Log::endl;
 }
 
+/*************/
+void World::printBenchmarkReport()
+{
+    // Scenes running in their own process send their timings periodically, get the latest ones
+    for (const auto& scene : _scenes)
+    {
+        if (scene.second == -1)
+            continue;
+        sendMessage(scene.first, "sendTimings", {});
+        sendMessageWithAnswer(scene.first, "sync", {}, 1e6);
+    }
+
+    auto stats = Timer::get().getAllStats();
+    auto duration = static_cast<double>(_benchmarkDuration) * 1e-6;
+
+    auto printTimer = [&](const string& label, const string& timerName) {
+        auto statsIt = stats.find(timerName);
+        if (statsIt == stats.end() || statsIt->second.count == 0)
+        {
+            printf("  %-16s %s\n", label.c_str(), "no measure");
+            return;
+        }
+
+        const auto& timer = statsIt->second;
+        printf("  %-16s %10.3f %10.3f %10.3f %10.3f %10.3f %10llu %8.1f\n",
+            label.c_str(),
+            timer.mean * 1e-3,
+            timer.p50 * 1e-3,
+            timer.p95 * 1e-3,
+            timer.p99 * 1e-3,
+            timer.max * 1e-3,
+            static_cast<unsigned long long>(timer.count),
+            timer.count / duration);
+    };
+
+    printf("\nBenchmark results, over %.1f seconds (durations in ms)\n", duration);
+    printf("  %-16s %10s %10s %10s %10s %10s %10s %8s\n", "", "mean", "p50", "p95", "p99", "max", "count", "per sec");
+    printf("World\n");
+    printTimer("loop", "loop_world");
+    printTimer("serialization", "serialize");
+    // Measured for each buffer, from the moment it is sent to the moment all its destinations released it
+    printTimer("link transfer", "bufferSendLatency_" + _name);
+
+    for (const auto& scene : _scenes)
+    {
+        // Timers of the inner Scene are shared with the World, the other ones are prefixed with the Scene name
+        auto prefix = scene.second == -1 ? string() : scene.first + "/";
+        printf("Scene %s\n", scene.first.c_str());
+        printTimer("texture upload", prefix + "textureUpload");
+        printTimer("render", prefix + "rendering");
+        printTimer("swap", prefix + "swap");
+        printTimer("loop", prefix + "loop_scene");
+    }
+    fflush(stdout);
+}
+
+/*************/
+void World::updateBenchmark()
+{
+    auto currentTime = Timer::getTime();
+    if (_benchmarkStart == 0)
+    {
+        _benchmarkStart = currentTime + _benchmarkWarmup;
+        Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Benchmark warmup" << Log::endl;
+        return;
+    }
+
+    if (!_benchmarkStarted)
+    {
+        if (currentTime < _benchmarkStart)
+            return;
+
+        // Statistics are computed over the whole duration of the measures
+        auto window = _benchmarkDuration * 2;
+        Timer::get().setStatsWindow(window);
+        Timer::get().resetStats();
+        for (const auto& scene : _scenes)
+            if (scene.second != -1)
+                sendMessage(scene.first, "timerStatsWindow", {window});
+
+        _benchmarkStarted = true;
+        Log::get() << Log::MESSAGE << "World::" << __FUNCTION__ << " - Benchmark started, for " << _benchmarkDuration * 1e-6 << " seconds" << Log::endl;
+        return;
+    }
+
+    if (currentTime - _benchmarkStart < _benchmarkDuration)
+        return;
+
+    printBenchmarkReport();
+    _quit = true;
+}
+
 /*************/
 void World::setAttribute(const string& name, const string& attrib, const Values& args)
 {
@@ -1408,6 +1608,8 @@ void World::registerAttributes()
 
                 auto path = Utils::getPathFromFilePath(_configFilename);
                 set(name, "configFilePath", {path}, false);
+
+                _fullDistantSync = true;
             });
 
             return true;
@@ -1418,11 +1620,30 @@ void World::registerAttributes()
     addAttribute("sceneLaunched", [&](const Values& args) {
         lock_guard<mutex> lockChildProcess(_childProcessMutex);
         _sceneLaunched = true;
+        _fullDistantSync = true;
         _childProcessConditionVariable.notify_all();
         return true;
     });
     setAttributeDescription("sceneLaunched", "Message sent by Scenes to confirm they are running");
 
+    addAttribute("sceneDuration",
+        [&](const Values& args) {
+            // Inner Scenes share their timers with the World
+            auto sceneName = args[0].as<string>();
+            auto sceneIt = _scenes.find(sceneName);
+            if (sceneIt == _scenes.end() || sceneIt->second == -1)
+                return true;
+
+            auto timerName = sceneName + "/" + args[1].as<string>();
+            Timer::get().setDuration(timerName, args[2].as<int>());
+            Timer::Stats stats;
+            if (Timer::statsFromValues(args, 3, stats))
+                Timer::get().setRemoteStats(timerName, stats);
+            return true;
+        },
+        {'s', 's', 'n'});
+    setAttributeDescription("sceneDuration", "Message sent by Scenes with the duration of one of their timers, optionally followed by its statistics");
+
     addAttribute("deleteObject",
         [&](const Values& args) {
             addTask([=]() {
@@ -1494,6 +1715,80 @@ void World::registerAttributes()
     setAttributeDescription("forceRealtime", "Ask the scheduler to run Splash with realtime priority.");
 #endif
 
+    addAttribute("bufferConsumers",
+        [&](const Values& args) {
+            auto sceneName = args[0].as<string>();
+            unordered_set<string> consumers;
+            for (size_t i = 1; i < args.size(); ++i)
+                consumers.insert(args[i].as<string>());
+
+            addTask([=]() {
+                lock_guard<recursive_mutex> lockObjects(_objectsMutex);
+
+                // Messages from Scenes which went away, for example during a configuration reload, are ignored
+                if (_scenes.find(sceneName) == _scenes.end())
+                {
+                    _bufferConsumers.removeScene(sceneName);
+                    return;
+                }
+
+                // Buffers newly consumed by the Scene are sent even if they did not change
+                auto newConsumers = _bufferConsumers.setConsumers(sceneName, consumers);
+                for (auto& o : _objects)
+                {
+                    auto bufferObj = dynamic_pointer_cast<BufferObject>(o.second);
+                    if (bufferObj && newConsumers.find(bufferObj->getDistantName()) != newConsumers.end())
+                        bufferObj->setDirty();
+                }
+            });
+
+            return true;
+        },
+        {'s'});
+    setAttributeDescription("bufferConsumers", "Message sent by Scenes with the names of the buffers they consume, which are the only ones sent to them");
+
+    addAttribute("bufferTransport",
+        [&](const Values& args) {
+            auto transport = args[0].as<string>();
+            if (transport == "shm")
+                _link->setBufferTransport(Link::BufferTransport::shm);
+            else if (transport == "zmq")
+                _link->setBufferTransport(Link::BufferTransport::zmq);
+            else
+                return false;
+            return true;
+        },
+        [&]() -> Values { return {_link->getBufferTransport() == Link::BufferTransport::shm ? "shm" : "zmq"}; },
+        {'s'});
+    setAttributeDescription("bufferTransport", "Transport used to send buffers to the scenes: zmq (default), or shm for a shared memory ring");
+
+    addAttribute("inProcessBuffers",
+        [&](const Values& args) {
+            _link->setInProcessTransfer(args[0].as<bool>());
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(_link->getInProcessTransfer())}; },
+        {'n'});
+    setAttributeDescription("inProcessBuffers", "If set to 1 (default), buffers are shared with the Scene running in the World process without being serialized nor copied");
+
+    addAttribute("meshCacheDirectory",
+        [&](const Values& args) {
+            MeshCache::get().setDirectory(args[0].as<string>());
+            return true;
+        },
+        [&]() -> Values { return {MeshCache::get().getDirectory()}; },
+        {'s'});
+    setAttributeDescription("meshCacheDirectory", "Directory where meshes loaded from files are cached, to be loaded faster on the next start. The cache is disabled if empty, which is the default");
+
+    addAttribute("meshCacheSize",
+        [&](const Values& args) {
+            MeshCache::get().setMaxSize(static_cast<size_t>(std::max(0, args[0].as<int>())) * 1024 * 1024);
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(MeshCache::get().getMaxSize() / (1024 * 1024))}; },
+        {'n'});
+    setAttributeDescription("meshCacheSize", "Maximum size of the mesh cache in MB, the least recently used meshes being removed first");
+
     addAttribute("framerate",
         [&](const Values& args) {
             _worldFramerate = std::max(1, args[0].as<int>());
@@ -1503,6 +1798,15 @@ void World::registerAttributes()
         {'n'});
     setAttributeDescription("framerate", "Set the minimum refresh rate for the world (adapted to video framerate)");
 
+    addAttribute("timingsPeriod",
+        [&](const Values& args) {
+            _timingsPeriod = std::max(0, args[0].as<int>()) * 1000;
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(_timingsPeriod / 1000)}; },
+        {'n'});
+    setAttributeDescription("timingsPeriod", "Period at which the timings are sent to the master Scene, in milliseconds");
+
     addAttribute("getAttribute",
         [&](const Values& args) {
             addTask([=]() {
@@ -1686,6 +1990,7 @@ void World::registerAttributes()
                 // Update the name in the Scenes
                 for (const auto& scene : _scenes)
                     sendMessage(scene.first, "renameObject", {name, newName});
+                _fullDistantSync = true;
             });
 
             return true;
@@ -1759,6 +2064,30 @@ void World::registerAttributes()
         {'n'});
     setAttributeDescription("logToFile", "If set to 1, the process holding the World will try to write log to file");
 
+    addAttribute("workerAffinity", [&](const Values& args) {
+        vector<int> cores;
+        for (const auto& core : args)
+            cores.push_back(core.as<int>());
+        if (!ThreadPool::get().setAffinity(cores))
+            return false;
+
+        Values values = args;
+        values.push_front("workerAffinity");
+        setAttribute("sendAllScenes", values);
+        return true;
+    });
+    setAttributeDescription("workerAffinity", "Set the CPU cores the worker threads of all processes can run on. No argument removes the constraint");
+
+    addAttribute("workerThreads",
+        [&](const Values& args) {
+            ThreadPool::get().setWorkerCount(std::max(0, args[0].as<int>()));
+            setAttribute("sendAllScenes", {"workerThreads", args[0]});
+            return true;
+        },
+        [&]() -> Values { return {static_cast<int>(ThreadPool::get().getWorkerCount())}; },
+        {'n'});
+    setAttributeDescription("workerThreads", "Set the number of worker threads used for parallel tasks in each process. If set to 0, the number of cores is used");
+
     addAttribute("sendAll",
         [&](const Values& args) {
             addTask([=]() {
@@ -0,0 +1,112 @@
+#include <memory>
+#include <string>
+
+#include "./base_object.h"
+#include "./benchmark.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class BenchObject : public BaseObject
+{
+  public:
+    BenchObject()
+        : BaseObject(nullptr)
+    {
+        addAttribute("fov",
+            [&](const Values& args) {
+                _fov = args[0].as<float>();
+                return true;
+            },
+            [&]() -> Values { return {_fov}; },
+            {'n'});
+
+        // A few more attributes, for the map to be of a realistic size
+        for (int i = 0; i < 32; ++i)
+            addAttribute("someAttribute_" + to_string(i), [](const Values&) { return true; }, {'n'});
+
+        setAttribute("defaultAttribute", {1, 2, 3});
+    }
+
+  private:
+    float _fov{35.f};
+};
+} // end of anonymous namespace
+
+/*************/
+BENCHMARK_CASE("BaseObject - set attribute by name")
+{
+    BenchObject object;
+    Values args{50.f};
+    while (state.keepRunning())
+        object.setAttribute("fov", args);
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("BaseObject - set attribute by handle")
+{
+    BenchObject object;
+    AttributeHandle fovAttribute("fov");
+    Values args{50.f};
+    while (state.keepRunning())
+        object.setAttribute(fovAttribute, args);
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("BaseObject - get attribute by name")
+{
+    BenchObject object;
+    Values values;
+    while (state.keepRunning())
+    {
+        object.getAttribute("fov", values);
+        Benchmark::doNotOptimize(values);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("BaseObject - get attribute by handle")
+{
+    BenchObject object;
+    AttributeHandle fovAttribute("fov");
+    Values values;
+    while (state.keepRunning())
+    {
+        object.getAttribute(fovAttribute, values);
+        Benchmark::doNotOptimize(values);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("BaseObject - get default attribute by name")
+{
+    BenchObject object;
+    Values values;
+    while (state.keepRunning())
+    {
+        object.getAttribute("defaultAttribute", values, true);
+        Benchmark::doNotOptimize(values);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("BaseObject - get default attribute by handle")
+{
+    BenchObject object;
+    AttributeHandle defaultAttribute("defaultAttribute");
+    Values values;
+    while (state.keepRunning())
+    {
+        object.getAttribute(defaultAttribute, values, true);
+        Benchmark::doNotOptimize(values);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
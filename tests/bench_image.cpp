@@ -0,0 +1,123 @@
+#include <string>
+
+#include "./benchmark.h"
+#include "./image.h"
+#include "./root_object.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+void benchmarkSerialize(Benchmark::State& state, int width, int height)
+{
+    RootObject root;
+    Image image(&root);
+    ImageBuffer buffer(ImageBufferSpec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA));
+    buffer.zero();
+    image.set(buffer);
+
+    while (state.keepRunning())
+    {
+        auto serializedImage = image.serialize();
+        Benchmark::doNotOptimize(serializedImage);
+    }
+    state.setBytesProcessed(state.getIterations() * buffer.getSize());
+}
+
+/*************/
+void benchmarkDeserialize(Benchmark::State& state, int width, int height)
+{
+    RootObject root;
+    Image source(&root);
+    ImageBuffer buffer(ImageBufferSpec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA));
+    buffer.zero();
+    source.set(buffer);
+    auto serializedImage = source.serialize();
+
+    Image image(&root);
+    while (state.keepRunning())
+    {
+        image.deserialize(serializedImage);
+        image.update();
+    }
+    state.setBytesProcessed(state.getIterations() * buffer.getSize());
+}
+}
+
+/*************/
+BENCHMARK_CASE("ImageBufferSpec - write header")
+{
+    ImageBufferSpec spec(3840, 2160, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA);
+    char header[ImageBufferSpec::headerSize];
+    while (state.keepRunning())
+    {
+        spec.writeHeader(header);
+        Benchmark::doNotOptimize(header);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("ImageBufferSpec - read header")
+{
+    char header[ImageBufferSpec::headerSize];
+    ImageBufferSpec(3840, 2160, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::RGBA).writeHeader(header);
+    while (state.keepRunning())
+    {
+        ImageBufferSpec spec;
+        spec.readHeader(header, sizeof(header));
+        Benchmark::doNotOptimize(spec);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("ImageBufferSpec - compare")
+{
+    ImageBufferSpec spec(3840, 2160, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::YCoCg_DXT5);
+    ImageBufferSpec otherSpec = spec;
+    while (state.keepRunning())
+    {
+        auto isDifferent = spec != otherSpec;
+        Benchmark::doNotOptimize(isDifferent);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("Image - serialize HD")
+{
+    benchmarkSerialize(state, 1920, 1080);
+}
+
+/*************/
+BENCHMARK_CASE("Image - serialize 4K")
+{
+    benchmarkSerialize(state, 3840, 2160);
+}
+
+/*************/
+BENCHMARK_CASE("Image - serialize 8K")
+{
+    benchmarkSerialize(state, 7680, 4320);
+}
+
+/*************/
+BENCHMARK_CASE("Image - deserialize HD")
+{
+    benchmarkDeserialize(state, 1920, 1080);
+}
+
+/*************/
+BENCHMARK_CASE("Image - deserialize 4K")
+{
+    benchmarkDeserialize(state, 3840, 2160);
+}
+
+/*************/
+BENCHMARK_CASE("Image - deserialize 8K")
+{
+    benchmarkDeserialize(state, 7680, 4320);
+}
@@ -0,0 +1,360 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <unistd.h>
+
+#include "./benchmark.h"
+#include "./imageBuffer.h"
+#include "./root_object.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+
+/*************/
+class LinkPeer : public RootObject
+{
+  public:
+    LinkPeer(const string& name)
+    {
+        _name = name;
+        _linkSocketPrefix = "bench_" + to_string(getpid());
+        _link = make_shared<Link>(this, _name);
+
+        addAttribute("count", [&](const Values& args) {
+            lock_guard<mutex> lock(_receivedMutex);
+            ++_messagesReceived;
+            _receivedCondition.notify_one();
+            return true;
+        });
+    }
+
+    Link* getLink() const { return _link.get(); }
+
+    /**
+     * \brief Wait for the given number of buffers to have been received
+     * \param count Buffer count
+     * \return Return false if the timeout has been reached
+     */
+    bool waitForBuffers(uint64_t count)
+    {
+        unique_lock<mutex> lock(_receivedMutex);
+        return _receivedCondition.wait_for(lock, chrono::seconds(1), [&]() { return _received >= count; });
+    }
+
+    /**
+     * \brief Wait for the given number of messages to have been received
+     * \param count Message count
+     * \return Return false if the timeout has been reached
+     */
+    bool waitForMessages(uint64_t count)
+    {
+        unique_lock<mutex> lock(_receivedMutex);
+        return _receivedCondition.wait_for(lock, chrono::seconds(1), [&]() { return _messagesReceived >= count; });
+    }
+
+  protected:
+    void handleSerializedObject(const string& name, shared_ptr<SerializedObject> obj) final
+    {
+        // Touch the buffer, as a deserialization would
+        volatile char firstByte = obj->data()[0];
+        volatile char lastByte = obj->data()[obj->size() - 1];
+        (void)firstByte;
+        (void)lastByte;
+
+        lock_guard<mutex> lock(_receivedMutex);
+        ++_received;
+        _receivedCondition.notify_one();
+    }
+
+  private:
+    mutex _receivedMutex{};
+    condition_variable _receivedCondition{};
+    uint64_t _received{0};
+    uint64_t _messagesReceived{0};
+};
+
+/*************/
+shared_ptr<LinkPeer> getReceiver()
+{
+    static auto receiver = make_shared<LinkPeer>("bench_receiver");
+    return receiver;
+}
+
+/*************/
+shared_ptr<LinkPeer> getSender()
+{
+    static auto sender = make_shared<LinkPeer>("bench_sender");
+    static bool connected = false;
+    if (!connected)
+    {
+        getReceiver();
+        sender->getLink()->connectTo("bench_receiver");
+        connected = true;
+    }
+    return sender;
+}
+
+/*************/
+// Reference implementation of the previous message encoding, with one frame per Value
+class LegacyMessageChannel
+{
+  public:
+    LegacyMessageChannel()
+    {
+        auto path = "ipc:///tmp/splash_bench_" + to_string(getpid()) + "_legacy";
+        _context = make_shared<zmq::context_t>(1);
+        _socketIn = make_shared<zmq::socket_t>(*_context, ZMQ_SUB);
+        int hwm = 1000;
+        _socketIn->setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
+        _socketIn->bind(path.c_str());
+        _socketIn->setsockopt(ZMQ_SUBSCRIBE, NULL, 0);
+
+        _socketOut = make_shared<zmq::socket_t>(*_context, ZMQ_PUB);
+        hwm = 0;
+        _socketOut->setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
+        _socketOut->connect(path.c_str());
+
+        _thread = thread([&]() { receive(); });
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+
+    ~LegacyMessageChannel()
+    {
+        int lingerValue = 0;
+        _socketOut->setsockopt(ZMQ_LINGER, &lingerValue, sizeof(lingerValue));
+        _socketOut.reset();
+        _context.reset();
+        _thread.join();
+    }
+
+    void send(const string& name, const string& attribute, const Values& message)
+    {
+        zmq::message_t msg(name.size() + 1);
+        memcpy(msg.data(), name.c_str(), name.size() + 1);
+        _socketOut->send(msg, ZMQ_SNDMORE);
+
+        msg.rebuild(attribute.size() + 1);
+        memcpy(msg.data(), attribute.c_str(), attribute.size() + 1);
+        _socketOut->send(msg, ZMQ_SNDMORE);
+
+        sendValues(msg, message);
+    }
+
+    bool waitForMessages(uint64_t count)
+    {
+        unique_lock<mutex> lock(_receivedMutex);
+        return _receivedCondition.wait_for(lock, chrono::seconds(1), [&]() { return _received >= count; });
+    }
+
+  private:
+    shared_ptr<zmq::context_t> _context;
+    shared_ptr<zmq::socket_t> _socketIn;
+    shared_ptr<zmq::socket_t> _socketOut;
+    thread _thread;
+
+    mutex _receivedMutex{};
+    condition_variable _receivedCondition{};
+    uint64_t _received{0};
+
+    void sendValues(zmq::message_t& msg, const Values& message)
+    {
+        int size = message.size();
+        msg.rebuild(sizeof(size));
+        memcpy(msg.data(), &size, sizeof(size));
+        if (message.size() == 0)
+            _socketOut->send(msg);
+        else
+            _socketOut->send(msg, ZMQ_SNDMORE);
+
+        for (size_t i = 0; i < message.size(); ++i)
+        {
+            auto v = message[i];
+            auto valueType = v.getType();
+            msg.rebuild(sizeof(valueType));
+            memcpy(msg.data(), &valueType, sizeof(valueType));
+            _socketOut->send(msg, ZMQ_SNDMORE);
+
+            auto valueName = v.getName();
+            msg.rebuild(valueName.size() + 1);
+            memcpy(msg.data(), valueName.c_str(), valueName.size() + 1);
+            _socketOut->send(msg, ZMQ_SNDMORE);
+
+            if (valueType == Value::Type::v)
+            {
+                sendValues(msg, v.as<Values>());
+            }
+            else
+            {
+                int valueSize = (valueType == Value::Type::s) ? v.size() + 1 : v.size();
+                msg.rebuild(valueSize);
+                memcpy(msg.data(), v.data(), valueSize);
+                if (i != message.size() - 1)
+                    _socketOut->send(msg, ZMQ_SNDMORE);
+                else
+                    _socketOut->send(msg);
+            }
+        }
+    }
+
+    Values receiveValues(zmq::message_t& msg)
+    {
+        _socketIn->recv(&msg);
+        int size = *(int*)msg.data();
+
+        Values values;
+        for (int i = 0; i < size; ++i)
+        {
+            _socketIn->recv(&msg);
+            auto valueType = *(Value::Type*)msg.data();
+            _socketIn->recv(&msg);
+            string valueName(static_cast<char*>(msg.data()));
+
+            if (valueType == Value::Type::v)
+            {
+                values.push_back(receiveValues(msg));
+            }
+            else
+            {
+                _socketIn->recv(&msg);
+                if (valueType == Value::Type::i)
+                    values.push_back(*(int64_t*)msg.data());
+                else if (valueType == Value::Type::f)
+                    values.push_back(*(double*)msg.data());
+                else if (valueType == Value::Type::s)
+                    values.push_back(string((char*)msg.data()));
+            }
+
+            if (!valueName.empty())
+                values.back().setName(valueName);
+        }
+        return values;
+    }
+
+    void receive()
+    {
+        try
+        {
+            zmq::message_t msg;
+            while (true)
+            {
+                _socketIn->recv(&msg);
+                string name((char*)msg.data());
+                _socketIn->recv(&msg);
+                string attribute((char*)msg.data());
+                auto values = receiveValues(msg);
+
+                lock_guard<mutex> lock(_receivedMutex);
+                ++_received;
+                _receivedCondition.notify_one();
+            }
+        }
+        catch (const zmq::error_t&)
+        {
+        }
+        _socketIn.reset();
+    }
+};
+
+/*************/
+// Messages similar to what is sent each World loop: distant attributes, timings and logs
+const size_t messagesPerLoop = 64;
+const Values attributeMessage{Values({1.0, 2.0, 3.0}), Values({0.0, 0.0, 1.0}), 35.0};
+const Values timingMessage{"loop_world", 16666};
+const Values logMessage{"World::run - Some log message, of an average length", 1};
+
+enum class MessageMode
+{
+    legacy,
+    single,
+    batched
+};
+
+/*************/
+void benchmarkLink(Benchmark::State& state, Link::BufferTransport transport, size_t width, size_t height)
+{
+    auto receiver = getReceiver();
+    auto sender = getSender();
+    static uint64_t sent = 0;
+
+    sender->getLink()->setBufferTransport(transport);
+    if (sender->getLink()->getBufferTransport() != transport)
+    {
+        state.skip("transport not available");
+        return;
+    }
+
+    // Synthetic RGBA frame, with a header the size of the one of Image
+    auto frameSize = width * height * 4 + ImageBufferSpec::headerSize;
+    auto frame = make_shared<SerializedObject>(frameSize);
+    memset(frame->data(), 128, frameSize);
+
+    while (state.keepRunning())
+    {
+        sender->getLink()->sendBuffer("frame", frame);
+        // The receiving socket only keeps one buffer, so we wait for each of them
+        if (!receiver->waitForBuffers(++sent))
+        {
+            state.skip("buffer lost");
+            return;
+        }
+        sender->getLink()->waitForBufferSending(chrono::milliseconds(1000));
+    }
+
+    state.setBytesProcessed(state.getIterations() * frameSize);
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+void benchmarkMessages(Benchmark::State& state, MessageMode mode)
+{
+    static uint64_t received = 0;
+    static uint64_t legacyReceived = 0;
+    static LegacyMessageChannel legacyChannel;
+
+    auto receiver = getReceiver();
+    auto link = getSender()->getLink();
+
+    while (state.keepRunning())
+    {
+        if (mode == MessageMode::batched)
+            link->beginMessageBatch();
+
+        for (size_t i = 0; i < messagesPerLoop; ++i)
+        {
+            const auto& message = i % 4 == 3 ? logMessage : (i % 2 ? timingMessage : attributeMessage);
+            if (mode == MessageMode::legacy)
+                legacyChannel.send("bench_receiver", "count", message);
+            else
+                link->sendMessage("bench_receiver", "count", message);
+        }
+
+        if (mode == MessageMode::batched)
+            link->flushMessageBatch();
+
+        auto waitResult = mode == MessageMode::legacy ? legacyChannel.waitForMessages(legacyReceived += messagesPerLoop) : receiver->waitForMessages(received += messagesPerLoop);
+        if (!waitResult)
+        {
+            state.skip("message lost");
+            return;
+        }
+    }
+
+    state.setItemsProcessed(state.getIterations() * messagesPerLoop);
+}
+
+} // end of anonymous namespace
+
+/*************/
+BENCHMARK_CASE("Link::sendBuffer - zmq - 4K frame") { benchmarkLink(state, Link::BufferTransport::zmq, 3840, 2160); }
+BENCHMARK_CASE("Link::sendBuffer - shm - 4K frame") { benchmarkLink(state, Link::BufferTransport::shm, 3840, 2160); }
+BENCHMARK_CASE("Link::sendBuffer - zmq - 8K frame") { benchmarkLink(state, Link::BufferTransport::zmq, 7680, 4320); }
+BENCHMARK_CASE("Link::sendBuffer - shm - 8K frame") { benchmarkLink(state, Link::BufferTransport::shm, 7680, 4320); }
+
+/*************/
+BENCHMARK_CASE("Link::sendMessage - previous multipart encoding") { benchmarkMessages(state, MessageMode::legacy); }
+BENCHMARK_CASE("Link::sendMessage - one frame per message") { benchmarkMessages(state, MessageMode::single); }
+BENCHMARK_CASE("Link::sendMessage - batched") { benchmarkMessages(state, MessageMode::batched); }
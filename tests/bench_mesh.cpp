@@ -0,0 +1,305 @@
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <unistd.h>
+
+#include "./benchmark.h"
+#include "./mesh.h"
+#include "./mesh_cache.h"
+#include "./meshLoader.h"
+#include "./root_object.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+// Mesh filled with a synthetic triangle soup
+class SyntheticMesh : public Mesh
+{
+  public:
+    SyntheticMesh(RootObject* root, int vertexCount)
+        : Mesh(root)
+    {
+        vertexCount -= vertexCount % 3;
+        MeshContainer mesh;
+        mesh.vertices.resize(vertexCount);
+        mesh.uvs.resize(vertexCount);
+        mesh.normals.resize(vertexCount);
+        mesh.annexe.resize(vertexCount);
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            auto position = static_cast<float>(i) / static_cast<float>(vertexCount);
+            mesh.vertices[i] = glm::vec4(position, 1.f - position, 0.f, 1.f);
+            mesh.uvs[i] = glm::vec2(position, position);
+            mesh.normals[i] = glm::vec4(0.f, 0.f, 1.f, 0.f);
+            mesh.annexe[i] = glm::vec4(0.f);
+        }
+        _mesh = make_shared<MeshContainer>(std::move(mesh));
+    }
+};
+
+/*************/
+// Grids of quads written as OBJ files, generated once and removed on exit
+class ObjFiles
+{
+  public:
+    ~ObjFiles()
+    {
+        for (const auto& file : _files)
+            unlink(file.second.c_str());
+    }
+
+    /**
+     * \brief Get a file holding at least the given number of vertices
+     * \param vertexCount Vertex count
+     * \return Return the file path
+     */
+    const string& get(int vertexCount)
+    {
+        auto fileIt = _files.find(vertexCount);
+        if (fileIt != _files.end())
+            return fileIt->second;
+
+        auto filename = "/tmp/splash_bench_" + to_string(getpid()) + "_" + to_string(vertexCount) + ".obj";
+        int side = 2;
+        while (side * side < vertexCount)
+            ++side;
+
+        ofstream file(filename, ios::out);
+        for (int y = 0; y < side; ++y)
+            for (int x = 0; x < side; ++x)
+                file << "v " << static_cast<float>(x) / side << " " << static_cast<float>(y) / side << " 0.0\n";
+        for (int y = 0; y < side; ++y)
+            for (int x = 0; x < side; ++x)
+                file << "vt " << static_cast<float>(x) / side << " " << static_cast<float>(y) / side << "\n";
+        file << "vn 0.0 0.0 1.0\n";
+        for (int y = 0; y < side - 1; ++y)
+        {
+            for (int x = 0; x < side - 1; ++x)
+            {
+                auto index = y * side + x + 1;
+                file << "f " << index << "/" << index << "/1 " << index + 1 << "/" << index + 1 << "/1 " << index + side + 1 << "/" << index + side + 1 << "/1 " << index + side
+                     << "/" << index + side << "/1\n";
+            }
+        }
+
+        return _files[vertexCount] = filename;
+    }
+
+  private:
+    map<int, string> _files{};
+};
+
+/*************/
+ObjFiles& getObjFiles()
+{
+    static ObjFiles files;
+    return files;
+}
+
+/*************/
+// Mesh cache in a temporary directory, emptied on exit
+class TemporaryMeshCache
+{
+  public:
+    TemporaryMeshCache()
+        : _previousDirectory(MeshCache::get().getDirectory())
+        , _directory("/tmp/splash_bench_" + to_string(getpid()) + "_meshCache/")
+    {
+        MeshCache::get().setDirectory(_directory);
+    }
+
+    ~TemporaryMeshCache()
+    {
+        auto maxSize = MeshCache::get().getMaxSize();
+        MeshCache::get().setMaxSize(0);
+        MeshCache::get().setMaxSize(maxSize);
+        rmdir(_directory.c_str());
+        MeshCache::get().setDirectory(_previousDirectory);
+    }
+
+  private:
+    string _previousDirectory;
+    string _directory;
+};
+
+/*************/
+void benchmarkSerialize(Benchmark::State& state, int vertexCount)
+{
+    RootObject root;
+    SyntheticMesh mesh(&root, vertexCount);
+    while (state.keepRunning())
+    {
+        auto serializedMesh = mesh.serialize();
+        Benchmark::doNotOptimize(serializedMesh);
+    }
+    state.setItemsProcessed(state.getIterations() * vertexCount);
+}
+
+/*************/
+void benchmarkDeserialize(Benchmark::State& state, int vertexCount)
+{
+    RootObject root;
+    SyntheticMesh source(&root, vertexCount);
+    auto serializedMesh = source.serialize();
+
+    Mesh mesh(&root);
+    while (state.keepRunning())
+    {
+        mesh.deserialize(serializedMesh);
+        mesh.update();
+    }
+    state.setItemsProcessed(state.getIterations() * vertexCount);
+}
+
+/*************/
+void benchmarkObjLoader(Benchmark::State& state, int vertexCount)
+{
+    const auto& filename = getObjFiles().get(vertexCount);
+    Loader::Obj loader;
+    while (state.keepRunning())
+    {
+        if (!loader.load(filename))
+        {
+            state.skip("unable to load " + filename);
+            break;
+        }
+        Benchmark::doNotOptimize(loader.getFaces());
+    }
+    state.setItemsProcessed(state.getIterations() * vertexCount);
+}
+
+/*************/
+void benchmarkMeshRead(Benchmark::State& state, int vertexCount, bool warmCache)
+{
+    const auto& filename = getObjFiles().get(vertexCount);
+    TemporaryMeshCache meshCache;
+    auto cachePath = MeshCache::get().getCachePath(filename);
+
+    RootObject root;
+    Mesh mesh(&root);
+    if (warmCache && !mesh.read(filename))
+    {
+        state.skip("unable to load " + filename);
+        return;
+    }
+
+    while (state.keepRunning())
+    {
+        if (!warmCache)
+            unlink(cachePath.c_str());
+        if (!mesh.read(filename))
+        {
+            state.skip("unable to load " + filename);
+            break;
+        }
+    }
+    state.setItemsProcessed(state.getIterations() * vertexCount);
+}
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - serialize 10k vertices")
+{
+    benchmarkSerialize(state, 10000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - serialize 500k vertices")
+{
+    benchmarkSerialize(state, 500000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - serialize 1M vertices")
+{
+    benchmarkSerialize(state, 1000000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - serialize 5M vertices")
+{
+    benchmarkSerialize(state, 5000000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - serialize 10M vertices")
+{
+    benchmarkSerialize(state, 10000000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - deserialize 10k vertices")
+{
+    benchmarkDeserialize(state, 10000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - deserialize 500k vertices")
+{
+    benchmarkDeserialize(state, 500000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - deserialize 1M vertices")
+{
+    benchmarkDeserialize(state, 1000000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - deserialize 5M vertices")
+{
+    benchmarkDeserialize(state, 5000000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - deserialize 10M vertices")
+{
+    benchmarkDeserialize(state, 10000000);
+}
+
+/*************/
+BENCHMARK_CASE("Loader::Obj - 10k vertices")
+{
+    benchmarkObjLoader(state, 10000);
+}
+
+/*************/
+BENCHMARK_CASE("Loader::Obj - 500k vertices")
+{
+    benchmarkObjLoader(state, 500000);
+}
+
+/*************/
+// The grid holds about 5M quad faces, split in parallel into chunks of lines
+BENCHMARK_CASE("Loader::Obj - 5M vertices")
+{
+    benchmarkObjLoader(state, 5000000);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - read 500k vertices, cold cache")
+{
+    benchmarkMeshRead(state, 500000, false);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - read 500k vertices, warm cache")
+{
+    benchmarkMeshRead(state, 500000, true);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - read 5M vertices, cold cache")
+{
+    benchmarkMeshRead(state, 5000000, false);
+}
+
+/*************/
+BENCHMARK_CASE("Mesh - read 5M vertices, warm cache")
+{
+    benchmarkMeshRead(state, 5000000, true);
+}
@@ -0,0 +1,94 @@
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./base_object.h"
+#include "./benchmark.h"
+#include "./render_list.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class BenchObject : public BaseObject
+{
+  public:
+    BenchObject(Priority priority)
+        : BaseObject(nullptr)
+    {
+        _renderingPriority = priority;
+    }
+
+    void render() final { ++_renderCount; }
+
+  private:
+    uint64_t _renderCount{0};
+};
+
+/*************/
+// A large project: a thousand objects of various priorities, some of them not rendered
+unordered_map<string, shared_ptr<BaseObject>> createObjects()
+{
+    const vector<BaseObject::Priority> priorities{BaseObject::Priority::NO_RENDER,
+        BaseObject::Priority::MEDIA,
+        BaseObject::Priority::BLENDING,
+        BaseObject::Priority::FILTER,
+        BaseObject::Priority::CAMERA,
+        BaseObject::Priority::POST_CAMERA,
+        BaseObject::Priority::WARP,
+        BaseObject::Priority::WINDOW};
+
+    unordered_map<string, shared_ptr<BaseObject>> objects;
+    for (int i = 0; i < 1000; ++i)
+        objects["object_" + to_string(i)] = make_shared<BenchObject>(priorities[(i * 7) % priorities.size()]);
+    return objects;
+}
+} // end of anonymous namespace
+
+/*************/
+BENCHMARK_CASE("Scene - render list rebuilt, 1000 objects")
+{
+    auto objects = createObjects();
+    while (state.keepRunning())
+    {
+        // As Scene::render used to do
+        map<BaseObject::Priority, vector<shared_ptr<BaseObject>>> objectList{};
+        for (auto& obj : objects)
+        {
+            if (obj.second->isGhost())
+                continue;
+
+            auto priority = obj.second->getRenderingPriority();
+            if (priority == BaseObject::Priority::NO_RENDER)
+                continue;
+
+            objectList[priority].push_back(obj.second);
+        }
+
+        for (auto& objPriority : objectList)
+            for (auto& obj : objPriority.second)
+                obj->render();
+    }
+    state.setItemsProcessed(state.getIterations() * objects.size());
+}
+
+/*************/
+BENCHMARK_CASE("Scene - render list cached, 1000 objects")
+{
+    auto objects = createObjects();
+    RenderList renderList;
+    while (state.keepRunning())
+    {
+        renderList.update(objects, 1);
+
+        const auto& renderObjects = renderList.getObjects();
+        for (const auto& group : renderList.getGroups())
+            for (auto index = group.begin; index < group.end; ++index)
+                renderObjects[index]->render();
+    }
+    state.setItemsProcessed(state.getIterations() * objects.size());
+}
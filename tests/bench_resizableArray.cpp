@@ -0,0 +1,133 @@
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#include "./benchmark.h"
+#include "./resizable_array.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+const size_t hdSize = 1920 * 1080 * 4;
+const size_t uhdSize = 3840 * 2160 * 4;
+const size_t fullUhdSize = 7680 * 4320 * 4;
+
+/*************/
+void benchmarkAllocation(Benchmark::State& state, size_t size)
+{
+    while (state.keepRunning())
+    {
+        ResizableArray<uint8_t> buffer(size);
+        Benchmark::doNotOptimize(buffer.data());
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+void benchmarkCopy(Benchmark::State& state, size_t size)
+{
+    ResizableArray<uint8_t> buffer(size);
+    memset(buffer.data(), 1, buffer.size());
+    while (state.keepRunning())
+    {
+        ResizableArray<uint8_t> copy(buffer);
+        Benchmark::doNotOptimize(copy.data());
+    }
+    state.setBytesProcessed(state.getIterations() * size);
+}
+
+/*************/
+void benchmarkShrink(Benchmark::State& state, size_t size)
+{
+    while (state.keepRunning())
+    {
+        state.pauseTiming();
+        ResizableArray<uint8_t> buffer(size);
+        state.resumeTiming();
+        // Same as what is done when reading a buffer with a header, then its content
+        buffer.shift(4096);
+        buffer.resize(size / 2);
+        Benchmark::doNotOptimize(buffer.data());
+    }
+    state.setBytesProcessed(state.getIterations() * size);
+}
+
+/*************/
+// Each iteration is a frame: a decoded image and its serialized form are allocated and written to,
+// and the oldest of the frames in flight is released, as done by a media sent to the Scenes at 60fps
+template <typename Allocate>
+void benchmarkFramePattern(Benchmark::State& state, Allocate allocate)
+{
+    const size_t framesInFlight = 3;
+    deque<shared_ptr<uint8_t>> frames;
+    while (state.keepRunning())
+    {
+        // Serialized frames hold a small header on top of the image
+        for (auto size : {uhdSize, uhdSize + 128})
+        {
+            auto frame = allocate(size);
+            // Touching each page is enough to measure the cost of mapping new memory
+            for (size_t offset = 0; offset < size; offset += BufferPool::pageSize)
+                frame.get()[offset] = 1;
+            frames.push_back(frame);
+        }
+
+        while (frames.size() > framesInFlight * 2)
+            frames.pop_front();
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - allocate HD")
+{
+    benchmarkAllocation(state, hdSize);
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - allocate 8K")
+{
+    benchmarkAllocation(state, fullUhdSize);
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - copy HD")
+{
+    benchmarkCopy(state, hdSize);
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - copy 4K")
+{
+    benchmarkCopy(state, uhdSize);
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - copy 8K")
+{
+    benchmarkCopy(state, fullUhdSize);
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - shift and shrink 4K")
+{
+    benchmarkShrink(state, uhdSize);
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - 4K60 frames, pooled")
+{
+    benchmarkFramePattern(state, [](size_t size) {
+        auto array = make_shared<ResizableArray<uint8_t>>(size);
+        return shared_ptr<uint8_t>(array, array->data());
+    });
+}
+
+/*************/
+BENCHMARK_CASE("ResizableArray - 4K60 frames, new[]")
+{
+    benchmarkFramePattern(state, [](size_t size) { return shared_ptr<uint8_t>(new uint8_t[size], default_delete<uint8_t[]>()); });
+}
@@ -0,0 +1,91 @@
+#include <memory>
+#include <vector>
+
+#include "./benchmark.h"
+#include "./gl_context.h"
+#include "./image.h"
+#include "./root_object.h"
+#include "./texture_image.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+GlContext& getContext()
+{
+    static GlContext context;
+    return context;
+}
+
+/*************/
+void benchmarkUploads(Benchmark::State& state, int textureCount, bool videoFrame)
+{
+    if (!getContext())
+    {
+        state.skip("no OpenGL 4.5 context available");
+        return;
+    }
+
+    ImageBufferSpec spec(1920, 1080, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+    spec.videoFrame = videoFrame;
+    ImageBuffer buffer(spec);
+    buffer.zero();
+
+    RootObject root;
+    vector<shared_ptr<Image>> images;
+    vector<shared_ptr<Texture_Image>> textures;
+    for (int i = 0; i < textureCount; ++i)
+    {
+        auto image = make_shared<Image>(&root);
+        image->set(buffer);
+        auto texture = make_shared<Texture_Image>(&root);
+        texture->linkTo(image);
+        texture->update();
+        texture->flushPbo();
+        images.push_back(image);
+        textures.push_back(texture);
+    }
+    glFinish();
+
+    // Same sequence as Scene::textureUploadRun: update all textures, then flush all copies
+    while (state.keepRunning())
+    {
+        for (auto& image : images)
+            image->setDirty();
+        for (auto& texture : textures)
+            texture->update();
+        for (auto& texture : textures)
+            texture->flushPbo();
+        glFinish();
+    }
+
+    state.setBytesProcessed(state.getIterations() * textureCount * spec.rawSize());
+    state.setItemsProcessed(state.getIterations() * textureCount);
+}
+}
+
+/*************/
+BENCHMARK_CASE("Texture upload - 1080p still image")
+{
+    benchmarkUploads(state, 1, false);
+}
+
+/*************/
+BENCHMARK_CASE("Texture upload - 1080p video, 1 texture")
+{
+    benchmarkUploads(state, 1, true);
+}
+
+/*************/
+BENCHMARK_CASE("Texture upload - 1080p video, 4 textures")
+{
+    benchmarkUploads(state, 4, true);
+}
+
+/*************/
+BENCHMARK_CASE("Texture upload - 1080p video, 8 textures")
+{
+    benchmarkUploads(state, 8, true);
+}
@@ -0,0 +1,60 @@
+#include <atomic>
+#include <future>
+#include <vector>
+
+#include "./benchmark.h"
+#include "./thread_pool.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+const int tasksPerIteration = 8; // Same order of magnitude as the copy threads used for images and textures
+}
+
+/*************/
+BENCHMARK_CASE("Task dispatch - std::async")
+{
+    atomic_int counter{0};
+    while (state.keepRunning())
+    {
+        vector<future<void>> threads;
+        for (int i = 0; i < tasksPerIteration; ++i)
+            threads.push_back(async(launch::async, [&]() { counter.fetch_add(1, memory_order_relaxed); }));
+        for (auto& thread : threads)
+            thread.wait();
+    }
+    state.setItemsProcessed(state.getIterations() * tasksPerIteration);
+}
+
+/*************/
+BENCHMARK_CASE("Task dispatch - ThreadPool")
+{
+    atomic_int counter{0};
+    while (state.keepRunning())
+    {
+        vector<future<void>> threads;
+        for (int i = 0; i < tasksPerIteration; ++i)
+            threads.push_back(ThreadPool::get().enqueue([&]() { counter.fetch_add(1, memory_order_relaxed); }));
+        ThreadPool::get().waitFor(threads);
+    }
+    state.setItemsProcessed(state.getIterations() * tasksPerIteration);
+}
+
+/*************/
+BENCHMARK_CASE("Task dispatch - ThreadPool, nested")
+{
+    atomic_int counter{0};
+    while (state.keepRunning())
+    {
+        auto task = ThreadPool::get().enqueue([&]() {
+            vector<future<void>> threads;
+            for (int i = 0; i < tasksPerIteration; ++i)
+                threads.push_back(ThreadPool::get().enqueue([&]() { counter.fetch_add(1, memory_order_relaxed); }));
+            ThreadPool::get().waitFor(threads);
+        });
+        ThreadPool::get().waitFor(task);
+    }
+    state.setItemsProcessed(state.getIterations() * tasksPerIteration);
+}
@@ -0,0 +1,45 @@
+#include <string>
+
+#include "./benchmark.h"
+#include "./coretypes.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+BENCHMARK_CASE("Timer - string API")
+{
+    auto& timer = Timer::get();
+    while (state.keepRunning())
+    {
+        timer << "bench_timer_string";
+        timer >> "bench_timer_string";
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("Timer - handle")
+{
+    auto& timer = Timer::get();
+    auto handle = timer.getHandle("bench_timer_handle");
+    while (state.keepRunning())
+    {
+        timer.start(handle);
+        timer.stop(handle);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("Timer - statistics")
+{
+    auto& timer = Timer::get();
+    auto handle = timer.getHandle("bench_timer_stats");
+    for (int i = 0; i < 10000; ++i)
+        timer.record(handle, 16000 + i);
+
+    while (state.keepRunning())
+        Benchmark::doNotOptimize(timer.getStats(handle));
+    state.setItemsProcessed(state.getIterations());
+}
@@ -0,0 +1,179 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "./attribute.h"
+#include "./benchmark.h"
+#include "./value.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+// Typical content of an attribute message: a few numbers and strings
+Values createMessage()
+{
+    return {"objectName", "attributeName", 1, 2.f, Values({0.5f, 0.5f, 0.5f, 1.f}), "someString"};
+}
+}
+
+/*************/
+BENCHMARK_CASE("Value - construct scalars")
+{
+    while (state.keepRunning())
+    {
+        Value i(42);
+        Value f(3.14f);
+        Value s(string("a short string"));
+        Benchmark::doNotOptimize(i);
+        Benchmark::doNotOptimize(f);
+        Benchmark::doNotOptimize(s);
+    }
+    state.setItemsProcessed(state.getIterations() * 3);
+}
+
+/*************/
+BENCHMARK_CASE("Value - conversions")
+{
+    Value i(42);
+    Value f(3.14f);
+    Value s(string("2.71"));
+    while (state.keepRunning())
+    {
+        Benchmark::doNotOptimize(i.as<float>());
+        Benchmark::doNotOptimize(f.as<int>());
+        Benchmark::doNotOptimize(s.as<float>());
+        Benchmark::doNotOptimize(i.as<string>());
+    }
+    state.setItemsProcessed(state.getIterations() * 4);
+}
+
+/*************/
+BENCHMARK_CASE("Values - build message")
+{
+    while (state.keepRunning())
+    {
+        auto message = createMessage();
+        Benchmark::doNotOptimize(message);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("Values - copy message")
+{
+    auto message = createMessage();
+    while (state.keepRunning())
+    {
+        auto copy = message;
+        Benchmark::doNotOptimize(copy);
+    }
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("Values - copy 1k floats")
+{
+    Values values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(static_cast<float>(i));
+
+    while (state.keepRunning())
+    {
+        auto copy = values;
+        Benchmark::doNotOptimize(copy);
+    }
+    state.setItemsProcessed(state.getIterations() * values.size());
+}
+
+/*************/
+BENCHMARK_CASE("Values - copy 16 floats array")
+{
+    Values values;
+    for (int i = 0; i < 16; ++i)
+        values.push_back(static_cast<float>(i));
+    auto array = Value(values.begin(), values.end()).as<vector<float>>();
+    auto value = Value(array);
+
+    while (state.keepRunning())
+    {
+        auto copy = value;
+        Benchmark::doNotOptimize(copy);
+    }
+    state.setItemsProcessed(state.getIterations() * array.size());
+}
+
+/*************/
+BENCHMARK_CASE("AttributeFunctor - default set")
+{
+    AttributeFunctor attribute("attribute");
+    Values args{"name", 1, 2.f, Values({0.5f, 0.5f, 0.5f, 1.f})};
+    while (state.keepRunning())
+        Benchmark::doNotOptimize(attribute(args));
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+BENCHMARK_CASE("AttributeFunctor - set with setter")
+{
+    float color[4];
+    AttributeFunctor attribute("color",
+        [&](const Values& args) {
+            for (int i = 0; i < 4; ++i)
+                color[i] = args[i].as<float>();
+            return true;
+        },
+        {'n', 'n', 'n', 'n'});
+    Values args{0.5f, 0.5f, 0.5f, 1.f};
+    while (state.keepRunning())
+        Benchmark::doNotOptimize(attribute(args));
+    Benchmark::doNotOptimize(color);
+    state.setItemsProcessed(state.getIterations());
+}
+
+/*************/
+// Same steps as the "uniform" attribute of Shader, which needs a GL context to be instantiated
+BENCHMARK_CASE("AttributeFunctor - shader uniform update")
+{
+    map<string, Values> uniforms;
+    vector<string> uniformsToUpdate;
+    AttributeFunctor attribute("uniform", [&](const Values& args) {
+        if (args.size() < 2)
+            return false;
+
+        string uniformName = args[0].as<string>();
+        Values uniformArgs;
+        if (args[1].getType() != Value::Type::v)
+        {
+            uniformArgs.reserve(args.size() - 1);
+            for (int i = 1; i < args.size(); ++i)
+                uniformArgs.push_back(args[i]);
+        }
+        else
+        {
+            uniformArgs = args[1].as<Values>();
+        }
+
+        auto uniformIt = uniforms.find(uniformName);
+        if (uniformIt != uniforms.end() && uniformArgs == uniformIt->second)
+            return true;
+        else if (uniformIt == uniforms.end())
+            uniformIt = uniforms.emplace(make_pair(uniformName, Values())).first;
+
+        uniformIt->second = uniformArgs;
+        uniformsToUpdate.push_back(uniformName);
+        return true;
+    });
+
+    float brightness = 1.f;
+    while (state.keepRunning())
+    {
+        brightness = brightness > 1.f ? 0.f : brightness + 0.01f;
+        attribute({"_color", 0.5f, 0.5f, 0.5f, 1.f});
+        attribute({"_cameraAttributes", 0.05f, brightness});
+        uniformsToUpdate.clear();
+    }
+    state.setItemsProcessed(state.getIterations() * 2);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @benchmark.h
+ * Minimal benchmark harness, used by the benchmarks executable
+ */
+
+#ifndef SPLASH_BENCHMARK_H
+#define SPLASH_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Splash
+{
+namespace Benchmark
+{
+
+/**
+ * \brief Get the number of heap allocations done by the process so far, counted by the runner
+ * \return Return the allocation count
+ */
+uint64_t getAllocationCount();
+
+/*************/
+class State
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param iterations Number of iterations to run
+     */
+    explicit State(uint64_t iterations)
+        : _maxIterations(iterations)
+    {
+    }
+
+    /**
+     * \brief Loop condition of a benchmark case. Timing starts on the first call.
+     * \return Return true while iterations remain
+     */
+    bool keepRunning()
+    {
+        if (_iterations == 0)
+        {
+            _allocationsStart = getAllocationCount();
+            _start = std::chrono::steady_clock::now();
+        }
+
+        if (_iterations == _maxIterations)
+        {
+            _stop = std::chrono::steady_clock::now();
+            _allocations = getAllocationCount() - _allocationsStart - _pausedAllocations;
+            return false;
+        }
+
+        ++_iterations;
+        return true;
+    }
+
+    /**
+     * \brief Stop the timer, for example to exclude a setup step from the measure
+     */
+    void pauseTiming()
+    {
+        _pauseStart = std::chrono::steady_clock::now();
+        _pauseAllocations = getAllocationCount();
+    }
+
+    /**
+     * \brief Restart the timer after a call to pauseTiming
+     */
+    void resumeTiming()
+    {
+        _paused += std::chrono::steady_clock::now() - _pauseStart;
+        _pausedAllocations += getAllocationCount() - _pauseAllocations;
+    }
+
+    /**
+     * \brief Set the number of bytes processed during the whole run
+     * \param bytes Byte count
+     */
+    void setBytesProcessed(uint64_t bytes) { _bytes = bytes; }
+
+    /**
+     * \brief Set the number of items processed during the whole run
+     * \param items Item count
+     */
+    void setItemsProcessed(uint64_t items) { _items = items; }
+
+    /**
+     * \brief Mark the run as skipped, for example if a resource is missing
+     * \param reason Reason for skipping
+     */
+    void skip(const std::string& reason) { _skipReason = reason; }
+
+    uint64_t getIterations() const { return _iterations; }
+    uint64_t getBytesProcessed() const { return _bytes; }
+    uint64_t getItemsProcessed() const { return _items; }
+    const std::string& getSkipReason() const { return _skipReason; }
+
+    /**
+     * \brief Get the measured duration
+     * \return Return the duration in seconds
+     */
+    double getElapsed() const { return std::chrono::duration<double>(_stop - _start - _paused).count(); }
+
+    /**
+     * \brief Get the mean number of heap allocations per iteration, paused sections excluded
+     * \return Return the allocation count
+     */
+    double getAllocationsPerIteration() const { return _iterations == 0 ? 0.0 : static_cast<double>(_allocations) / static_cast<double>(_iterations); }
+
+  private:
+    uint64_t _maxIterations{1};
+    uint64_t _iterations{0};
+    uint64_t _bytes{0};
+    uint64_t _items{0};
+    std::string _skipReason{""};
+    std::chrono::steady_clock::time_point _start{};
+    std::chrono::steady_clock::time_point _stop{};
+    std::chrono::steady_clock::time_point _pauseStart{};
+    std::chrono::steady_clock::duration _paused{0};
+    uint64_t _allocationsStart{0};
+    uint64_t _pauseAllocations{0};
+    uint64_t _pausedAllocations{0};
+    uint64_t _allocations{0};
+};
+
+/**
+ * \brief Prevent the compiler from optimizing away the computation of the given value
+ * \param value Value to keep
+ */
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*************/
+struct Case
+{
+    std::string name;
+    std::function<void(State&)> function;
+};
+
+/**
+ * \brief Get the list of all registered benchmark cases
+ * \return Return the cases
+ */
+inline std::vector<Case>& getCases()
+{
+    static std::vector<Case> cases;
+    return cases;
+}
+
+/*************/
+struct Registrar
+{
+    Registrar(const std::string& name, const std::function<void(State&)>& function) { getCases().push_back({name, function}); }
+};
+
+} // end of namespace
+} // end of namespace
+
+#define BENCHMARK_CONCATENATE_IMPL(s1, s2) s1##s2
+#define BENCHMARK_CONCATENATE(s1, s2) BENCHMARK_CONCATENATE_IMPL(s1, s2)
+#define BENCHMARK_CASE_IMPL(function, name)                                                                                                                                        \
+    static void function(Splash::Benchmark::State& state);                                                                                                                         \
+    static Splash::Benchmark::Registrar BENCHMARK_CONCATENATE(function, _registrar)(name, function);                                                                              \
+    static void function(Splash::Benchmark::State& state)
+//! Define a benchmark case, which loops over state.keepRunning()
+#define BENCHMARK_CASE(name) BENCHMARK_CASE_IMPL(BENCHMARK_CONCATENATE(benchmark_, __LINE__), name)
+
+#endif // SPLASH_BENCHMARK_H
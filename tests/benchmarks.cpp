@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// All benchmarks are defined in bench_[feature].cpp
+// This file holds the runner, which calibrates the iteration count of each case
+// so that it runs for at least the given minimum time. Results can be written as JSON,
+// and compared to the JSON results of a previous run.
+// The global operator new is replaced to count the heap allocations done by each case.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+
+#include <json/json.h>
+
+#include "./benchmark.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+atomic<uint64_t> allocationCount{0};
+}
+
+/*************/
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* pointer = malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw bad_alloc();
+}
+
+/*************/
+void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+/*************/
+void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+/*************/
+uint64_t Benchmark::getAllocationCount()
+{
+    return allocationCount.load(memory_order_relaxed);
+}
+
+/*************/
+void printUsage()
+{
+    cout << "Usage: benchmarks [options]" << endl;
+    cout << "  -f, --filter <string>   Only run cases whose name contains the given string" << endl;
+    cout << "  -t, --min-time <sec>    Minimum duration of each case, in seconds (default: 0.5)" << endl;
+    cout << "  -o, --output <file>     Write the results to the given JSON file" << endl;
+    cout << "  -b, --baseline <file>   Compare the results to those of the given JSON file" << endl;
+    cout << "  -r, --threshold <pct>   Slowdown over which a case is flagged, in percent (default: 10)" << endl;
+    cout << "  -l, --list              List all cases" << endl;
+    cout << "  -h, --help              Show this help" << endl;
+}
+
+/*************/
+bool loadBaseline(const string& filename, map<string, double>& baseline)
+{
+    ifstream file(filename, ios::in | ios::binary);
+    if (!file.is_open())
+        return false;
+
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(file, root) || !root.isMember("benchmarks"))
+        return false;
+
+    for (const auto& result : root["benchmarks"])
+        baseline[result["name"].asString()] = result["time_per_iteration_ns"].asDouble();
+    return true;
+}
+
+/*************/
+int main(int argc, char** argv)
+{
+    string filter{""};
+    double minTime{0.5};
+    string outputFile{""};
+    string baselineFile{""};
+    double threshold{10.0};
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if ((arg == "-f" || arg == "--filter") && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if ((arg == "-t" || arg == "--min-time") && i + 1 < argc)
+        {
+            minTime = stod(argv[++i]);
+        }
+        else if ((arg == "-o" || arg == "--output") && i + 1 < argc)
+        {
+            outputFile = argv[++i];
+        }
+        else if ((arg == "-b" || arg == "--baseline") && i + 1 < argc)
+        {
+            baselineFile = argv[++i];
+        }
+        else if ((arg == "-r" || arg == "--threshold") && i + 1 < argc)
+        {
+            threshold = stod(argv[++i]);
+        }
+        else if (arg == "-l" || arg == "--list")
+        {
+            for (const auto& benchCase : Benchmark::getCases())
+                cout << benchCase.name << endl;
+            return 0;
+        }
+        else
+        {
+            printUsage();
+            return arg == "-h" || arg == "--help" ? 0 : 1;
+        }
+    }
+
+    map<string, double> baseline;
+    if (!baselineFile.empty() && !loadBaseline(baselineFile, baseline))
+    {
+        cerr << "Unable to read baseline results from " << baselineFile << endl;
+        return 1;
+    }
+
+    printf("%-48s %12s %14s %12s %14s %12s %14s\n", "Benchmark", "Iterations", "Time/iter (ns)", "MB/s", "Items/s", "Allocs/iter", baseline.empty() ? "" : "Baseline");
+
+    Json::Value results;
+    results["benchmarks"] = Json::Value(Json::arrayValue);
+    int slowdowns = 0;
+
+    for (const auto& benchCase : Benchmark::getCases())
+    {
+        if (!filter.empty() && benchCase.name.find(filter) == string::npos)
+            continue;
+
+        // Grow the iteration count until the case runs long enough
+        uint64_t iterations = 1;
+        Benchmark::State state(iterations);
+        while (true)
+        {
+            state = Benchmark::State(iterations);
+            benchCase.function(state);
+
+            if (!state.getSkipReason().empty() || state.getElapsed() >= minTime || iterations >= (1ull << 40))
+                break;
+
+            auto elapsed = std::max(state.getElapsed(), 1e-9);
+            auto scale = std::min(std::max(1.4 * minTime / elapsed, 2.0), 100.0);
+            iterations = static_cast<uint64_t>(iterations * scale);
+        }
+
+        if (!state.getSkipReason().empty())
+        {
+            printf("%-48s skipped: %s\n", benchCase.name.c_str(), state.getSkipReason().c_str());
+            continue;
+        }
+
+        auto elapsed = state.getElapsed();
+        auto timePerIteration = elapsed * 1e9 / static_cast<double>(state.getIterations());
+        auto bytesPerSecond = static_cast<double>(state.getBytesProcessed()) / elapsed / 1e6;
+        auto itemsPerSecond = static_cast<double>(state.getItemsProcessed()) / elapsed;
+        auto allocationsPerIteration = state.getAllocationsPerIteration();
+
+        // Compare to the baseline, a positive difference being a slowdown
+        string comparison{""};
+        auto baselineIt = baseline.find(benchCase.name);
+        if (baselineIt != baseline.end() && baselineIt->second > 0.0)
+        {
+            auto difference = (timePerIteration / baselineIt->second - 1.0) * 100.0;
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%+.1f%%%s", difference, difference > threshold ? " SLOWER" : "");
+            comparison = buffer;
+            if (difference > threshold)
+                ++slowdowns;
+        }
+
+        printf("%-48s %12llu %14.1f %12.1f %14.1f %12.2f %14s\n",
+            benchCase.name.c_str(),
+            static_cast<unsigned long long>(state.getIterations()),
+            timePerIteration,
+            bytesPerSecond,
+            itemsPerSecond,
+            allocationsPerIteration,
+            comparison.c_str());
+
+        Json::Value result;
+        result["name"] = benchCase.name;
+        result["iterations"] = static_cast<Json::UInt64>(state.getIterations());
+        result["time_per_iteration_ns"] = timePerIteration;
+        result["bytes_per_second"] = bytesPerSecond * 1e6;
+        result["items_per_second"] = itemsPerSecond;
+        result["allocations_per_iteration"] = allocationsPerIteration;
+        results["benchmarks"].append(result);
+    }
+
+    if (!outputFile.empty())
+    {
+        ofstream file(outputFile, ios::out | ios::binary);
+        if (!file.is_open())
+        {
+            cerr << "Unable to write results to " << outputFile << endl;
+            return 1;
+        }
+        file << results.toStyledString();
+    }
+
+    if (slowdowns > 0)
+    {
+        printf("%i case(s) slower than the baseline by more than %.1f%%\n", slowdowns, threshold);
+        return 2;
+    }
+
+    return 0;
+}
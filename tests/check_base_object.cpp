@@ -1,7 +1,9 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <doctest.h>
+#include <json/json.h>
 
 #include "./base_object.h"
 #include "./splash.h"
@@ -23,6 +25,7 @@ class BaseObjectMock : public BaseObject
     int _integer{0};
     float _float{0.f};
     string _string{""};
+    Values _array{};
 
     void registerAttributes()
     {
@@ -49,6 +52,18 @@ class BaseObjectMock : public BaseObject
             },
             [&]() -> Values { return {_string}; },
             {'s'});
+
+        addAttribute("array",
+            [&](const Values& args) {
+                _array = args;
+                return true;
+            },
+            [&]() -> Values { return _array; },
+            {});
+
+        // Integer and float are sent by the World to the Scenes
+        setAttributeParameter("integer", true, true);
+        setAttributeParameter("float", true, true);
     }
 };
 
@@ -110,3 +125,117 @@ TEST_CASE("Testing BaseObject attribute registering")
     object->setAttribute("someAttribute", {1337});
     CHECK(someString != otherString);
 }
+
+/*************/
+TEST_CASE("Testing BaseObject attribute handles")
+{
+    auto object = make_shared<BaseObjectMock>(nullptr);
+
+    auto integerHandle = AttributeHandle("integer");
+    CHECK(static_cast<bool>(integerHandle));
+    CHECK(integerHandle == AttributeHandle("integer"));
+    CHECK(integerHandle != AttributeHandle("float"));
+    CHECK(integerHandle.getName() == "integer");
+    CHECK(!static_cast<bool>(AttributeHandle()));
+
+    Values value;
+    CHECK(object->setAttribute(integerHandle, {42}));
+    CHECK(object->getAttribute(integerHandle, value));
+    REQUIRE(value.size() == 1);
+    CHECK(value[0].as<int>() == 42);
+    CHECK(object->getAttribute("integer", value));
+    CHECK(value[0].as<int>() == 42);
+    CHECK((*object)[integerHandle]()[0].as<int>() == 42);
+
+    // Attributes created after the handle are reachable through it
+    auto newHandle = AttributeHandle("someNewAttribute");
+    CHECK(object->getAttribute(newHandle, value) == false);
+    CHECK(value.empty());
+    object->setAttribute("someNewAttribute", {1, 2});
+    object->getAttribute(newHandle, value, true);
+    CHECK(value == Values({1, 2}));
+    object->setAttribute(newHandle, {3});
+    object->getAttribute("someNewAttribute", value, true);
+    CHECK(value == Values({3}));
+
+    CHECK(object->setAttribute(AttributeHandle(), {0}) == false);
+}
+
+/*************/
+TEST_CASE("Testing BaseObject distant attributes")
+{
+    // A hundred idle objects, as in a project where nothing changes
+    vector<shared_ptr<BaseObjectMock>> objects;
+    for (int i = 0; i < 100; ++i)
+        objects.push_back(make_shared<BaseObjectMock>(nullptr));
+
+    uint64_t tick = 0;
+    auto countMessages = [&](bool fullSync) {
+        ++tick;
+        size_t messages = 0;
+        for (auto& object : objects)
+            messages += object->getDistantAttributes(tick, fullSync ? 0 : tick - 1).size();
+        return messages;
+    };
+
+    // Sending all distant attributes at each tick, as the World used to do
+    for (int i = 0; i < 10; ++i)
+        CHECK(countMessages(true) == objects.size() * 2);
+
+    // Only changes are sent, so nothing at all once the first tick is done
+    CHECK(countMessages(false) == 0);
+    for (int i = 0; i < 10; ++i)
+        CHECK(countMessages(false) == 0);
+
+    objects[0]->setAttribute("integer", {42});
+    objects[1]->setAttribute("float", {2.f});
+    objects[2]->setAttribute("string", {"not distant"});
+    objects[3]->setAttribute("integer", {0}); // Same value as before
+    CHECK(countMessages(false) == 2);
+    CHECK(countMessages(false) == 0);
+
+    auto attributes = objects[0]->getDistantAttributes(++tick, 0);
+    REQUIRE(attributes.size() == 2);
+    CHECK(attributes["integer"][0].as<int>() == 42);
+
+    // A full synchronization still gives the whole state
+    CHECK(countMessages(true) == objects.size() * 2);
+    CHECK(countMessages(false) == 0);
+}
+
+/*************/
+TEST_CASE("Testing BaseObject configuration with numeric arrays")
+{
+    auto object = make_unique<BaseObjectMock>(nullptr);
+    auto floats = Value(vector<float>({0.5f, 1.5f, 2.5f}));
+    auto integers = Value(vector<int32_t>({1, -2, 3}));
+    object->setAttribute("array", {floats, integers});
+
+    // Numeric arrays are saved as Json arrays
+    Json::Value savedConfiguration;
+    Json::Reader reader;
+    REQUIRE(reader.parse(object->getConfigurationAsJson().toStyledString(), savedConfiguration));
+    const auto& savedArray = savedConfiguration["array"];
+    REQUIRE(savedArray.isArray());
+    REQUIRE(savedArray.size() == 2);
+    REQUIRE(savedArray[0].size() == 3);
+    REQUIRE(savedArray[1].size() == 3);
+
+    // Reloading them gives back the same numbers
+    Values reloadedArray;
+    for (const auto& jsArray : savedArray)
+    {
+        Values numbers;
+        for (const auto& jsNumber : jsArray)
+            numbers.push_back(jsNumber.isInt() ? Value(jsNumber.asInt()) : Value(jsNumber.asFloat()));
+        reloadedArray.push_back(numbers);
+    }
+
+    auto reloadedObject = make_unique<BaseObjectMock>(nullptr);
+    reloadedObject->setAttribute("array", reloadedArray);
+    Values value;
+    REQUIRE(reloadedObject->getAttribute("array", value));
+    REQUIRE(value.size() == 2);
+    CHECK(value[0].as<Values>() == floats.as<Values>());
+    CHECK(value[1].as<Values>() == integers.as<Values>());
+}
@@ -0,0 +1,100 @@
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./base_object.h"
+#include "./buffer_consumers.h"
+#include "./image.h"
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class ObjectMock : public BaseObject
+{
+  public:
+    ObjectMock(RootObject* root, Priority priority)
+        : BaseObject(root)
+    {
+        setRenderingPriority(priority);
+    }
+};
+}
+
+/*************/
+TEST_CASE("Testing BufferConsumers consumed buffers")
+{
+    RootObject root;
+    unordered_map<string, shared_ptr<BaseObject>> objects;
+    auto camera = make_shared<ObjectMock>(&root, BaseObject::Priority::CAMERA);
+    auto texture = make_shared<ObjectMock>(&root, BaseObject::Priority::NO_RENDER);
+    auto blender = make_shared<ObjectMock>(&root, BaseObject::Priority::MEDIA);
+    auto directImage = make_shared<Image>(&root);
+    auto indirectImage = make_shared<Image>(&root);
+    auto mediaImage = make_shared<Image>(&root);
+    auto unusedImage = make_shared<Image>(&root);
+    objects["camera"] = camera;
+    objects["texture"] = texture;
+    objects["blender"] = blender;
+    objects["direct_image"] = directImage;
+    objects["indirect_image"] = indirectImage;
+    objects["media_image"] = mediaImage;
+    objects["unused_image"] = unusedImage;
+
+    // Buffers are consumed when linked to a rendered object, directly or not
+    camera->linkTo(directImage);
+    camera->linkTo(texture);
+    texture->linkTo(indirectImage);
+    // Media do not consume the buffers linked to them
+    blender->linkTo(mediaImage);
+    CHECK(BufferConsumers::getConsumedBuffers(objects) == unordered_set<string>({"direct_image", "indirect_image"}));
+
+    // Objects which are not part of the Scene are not followed
+    objects.erase("texture");
+    CHECK(BufferConsumers::getConsumedBuffers(objects) == unordered_set<string>({"direct_image"}));
+
+    objects.erase("camera");
+    CHECK(BufferConsumers::getConsumedBuffers(objects).empty());
+}
+
+/*************/
+TEST_CASE("Testing BufferConsumers destinations")
+{
+    BufferConsumers consumers;
+    CHECK(consumers.getDestinations("image") == nullptr);
+
+    // Newly consumed buffers are returned, to be sent even if they did not change
+    CHECK(consumers.setConsumers("first_scene", {"image", "mesh"}) == unordered_set<string>({"image", "mesh"}));
+    CHECK(consumers.setConsumers("second_scene", {"image"}) == unordered_set<string>({"image"}));
+    CHECK(consumers.setConsumers("first_scene", {"image", "mesh", "video"}) == unordered_set<string>({"video"}));
+    CHECK(consumers.setConsumers("first_scene", {"image", "video"}).empty());
+
+    // Buffers which no Scene consumes have no destination, and are not sent
+    REQUIRE(consumers.getDestinations("image") != nullptr);
+    CHECK(*consumers.getDestinations("image") == vector<string>({"first_scene", "second_scene"}));
+    REQUIRE(consumers.getDestinations("video") != nullptr);
+    CHECK(*consumers.getDestinations("video") == vector<string>({"first_scene"}));
+    CHECK(consumers.getDestinations("mesh") == nullptr);
+    CHECK(consumers.getDestinations("unused_image") == nullptr);
+
+    // Scenes going away do not consume anything anymore
+    consumers.removeScene("first_scene");
+    REQUIRE(consumers.getDestinations("image") != nullptr);
+    CHECK(*consumers.getDestinations("image") == vector<string>({"second_scene"}));
+    CHECK(consumers.getDestinations("video") == nullptr);
+
+    // A Scene coming back consumes its buffers anew
+    CHECK(consumers.setConsumers("first_scene", {"video"}) == unordered_set<string>({"video"}));
+
+    consumers.clear();
+    CHECK(consumers.getDestinations("image") == nullptr);
+    CHECK(consumers.getDestinations("video") == nullptr);
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./buffer_pool.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing BufferPool size classes")
+{
+    CHECK(BufferPool::getClassSize(1) == BufferPool::cacheLineSize);
+    CHECK(BufferPool::getClassSize(64) == 64);
+    CHECK(BufferPool::getClassSize(65) == 128);
+    CHECK(BufferPool::getClassSize(4096) == 4096);
+    CHECK(BufferPool::getClassSize(4097) == 5120);
+
+    for (size_t size = 1; size < (1ul << 28); size = size * 3 + 1)
+    {
+        auto classSize = BufferPool::getClassSize(size);
+        CHECK(classSize >= size);
+        CHECK((classSize <= BufferPool::cacheLineSize || classSize - size < size / 4 + BufferPool::cacheLineSize));
+    }
+
+    // A 4K RGBA frame wastes less than a quarter of its size
+    const size_t uhdSize = 3840 * 2160 * 4;
+    CHECK(BufferPool::getClassSize(uhdSize) < uhdSize + uhdSize / 4);
+}
+
+/*************/
+TEST_CASE("Testing BufferPool allocation and accounting")
+{
+    auto& pool = BufferPool::get();
+    pool.trim();
+    auto initialInUse = pool.getBytesInUse();
+    CHECK(pool.getBytesCached() == 0);
+
+    const size_t size = 3 * 1024 * 1024 + 17;
+    size_t capacity = 0;
+    auto buffer = pool.allocate(size, capacity);
+    REQUIRE(buffer != nullptr);
+    CHECK(capacity == BufferPool::getClassSize(size));
+    CHECK(reinterpret_cast<uintptr_t>(buffer) % BufferPool::pageSize == 0);
+    CHECK(pool.getBytesInUse() == initialInUse + capacity);
+
+    // Released buffers are cached, and reused for the same size class
+    pool.release(buffer, capacity);
+    CHECK(pool.getBytesInUse() == initialInUse);
+    CHECK(pool.getBytesCached() == capacity);
+
+    size_t otherCapacity = 0;
+    auto otherBuffer = pool.allocate(size - 10, otherCapacity);
+    CHECK(otherBuffer == buffer);
+    CHECK(otherCapacity == capacity);
+    CHECK(pool.getBytesCached() == 0);
+    pool.release(otherBuffer, otherCapacity);
+
+    // Buffers exceeding the cache size are freed
+    pool.setCacheSize(capacity / 2);
+    CHECK(pool.getBytesCached() == 0);
+    buffer = pool.allocate(size, capacity);
+    pool.release(buffer, capacity);
+    CHECK(pool.getBytesCached() == 0);
+    pool.setCacheSize(256 * 1024 * 1024);
+
+    // Small buffers are aligned to a cache line
+    vector<pair<void*, size_t>> smallBuffers;
+    for (size_t smallSize = 1; smallSize < 4096; smallSize += 100)
+    {
+        smallBuffers.emplace_back(nullptr, 0);
+        smallBuffers.back().first = pool.allocate(smallSize, smallBuffers.back().second);
+        CHECK(reinterpret_cast<uintptr_t>(smallBuffers.back().first) % BufferPool::cacheLineSize == 0);
+    }
+    for (auto& smallBuffer : smallBuffers)
+        pool.release(smallBuffer.first, smallBuffer.second);
+    CHECK(pool.getBytesInUse() == initialInUse);
+
+    pool.trim();
+    CHECK(pool.getBytesCached() == 0);
+}
+
+/*************/
+TEST_CASE("Testing BufferPool eviction")
+{
+    auto& pool = BufferPool::get();
+    pool.trim();
+    auto cacheSize = pool.getCacheSize();
+    auto maxAge = pool.getMaxAge();
+
+    // When the cache is full, the least recently released buffers make room for the new ones, whatever their size
+    const size_t firstSize = 1024 * 1024;
+    const size_t secondSize = 2 * 1024 * 1024;
+    size_t firstCapacity = 0;
+    size_t secondCapacity = 0;
+    auto first = pool.allocate(firstSize, firstCapacity);
+    auto second = pool.allocate(secondSize, secondCapacity);
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+
+    pool.setCacheSize(secondCapacity);
+    pool.release(first, firstCapacity);
+    CHECK(pool.getBytesCached() == firstCapacity);
+    pool.release(second, secondCapacity);
+    CHECK(pool.getBytesCached() == secondCapacity);
+
+    size_t capacity = 0;
+    auto buffer = pool.allocate(secondSize, capacity);
+    CHECK(buffer == second);
+    pool.release(buffer, capacity);
+
+    // Buffers which have not been reused for long enough are released
+    pool.setMaxAge(1000000);
+    pool.releaseExpired();
+    CHECK(pool.getBytesCached() == secondCapacity);
+
+    this_thread::sleep_for(chrono::milliseconds(10));
+    pool.setMaxAge(5000);
+    pool.releaseExpired();
+    CHECK(pool.getBytesCached() == 0);
+
+    pool.setMaxAge(maxAge);
+    pool.setCacheSize(cacheSize);
+}
@@ -0,0 +1,116 @@
+#include <cstring>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./image.h"
+#include "./imageBuffer.h"
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+struct FormatCase
+{
+    ImageBufferSpec::Format format;
+    uint32_t channels;
+    uint8_t bpp;
+    ImageBufferSpec::Type type;
+};
+
+const vector<FormatCase> formatCases{{ImageBufferSpec::Format::R, 1, 16, ImageBufferSpec::Type::UINT16},
+    {ImageBufferSpec::Format::RG, 2, 16, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::RGB, 3, 24, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::RGBA, 4, 32, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::RGBA, 4, 128, ImageBufferSpec::Type::FLOAT},
+    {ImageBufferSpec::Format::BGR, 3, 24, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::BGRA, 4, 32, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::YUYV, 3, 16, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::UYVY, 3, 16, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::RGB_DXT1, 1, 8, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::RGBA_DXT5, 1, 8, ImageBufferSpec::Type::UINT8},
+    {ImageBufferSpec::Format::YCoCg_DXT5, 1, 8, ImageBufferSpec::Type::UINT8}};
+}
+
+/*************/
+TEST_CASE("Testing ImageBufferSpec format names")
+{
+    for (const auto& formatCase : formatCases)
+    {
+        auto name = ImageBufferSpec::formatToString(formatCase.format);
+        CHECK(!name.empty());
+        CHECK(ImageBufferSpec::formatFromString(name) == formatCase.format);
+    }
+
+    CHECK(ImageBufferSpec::formatFromString("NV12") == ImageBufferSpec::Format::UNKNOWN);
+    CHECK(ImageBufferSpec::formatToString(ImageBufferSpec::Format::UNKNOWN).empty());
+
+    // Formats given as strings are mapped, unknown ones being deduced from the channel count
+    CHECK(ImageBufferSpec(16, 16, 3, 16, ImageBufferSpec::Type::UINT8, "YUYV").format == ImageBufferSpec::Format::YUYV);
+    CHECK(ImageBufferSpec(16, 16, 3, 24, ImageBufferSpec::Type::UINT8, "").format == ImageBufferSpec::Format::RGB);
+    CHECK(ImageBufferSpec(16, 16, 2, 16, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::UNKNOWN).format == ImageBufferSpec::Format::RG);
+}
+
+/*************/
+TEST_CASE("Testing ImageBufferSpec binary header")
+{
+    ImageBufferSpec spec(1920, 1080, 4, 32, ImageBufferSpec::Type::UINT8, ImageBufferSpec::Format::BGRA);
+    spec.videoFrame = false;
+
+    vector<char> header(ImageBufferSpec::headerSize);
+    spec.writeHeader(header.data());
+
+    ImageBufferSpec readSpec;
+    REQUIRE(readSpec.readHeader(header.data(), header.size()));
+    CHECK(readSpec == spec);
+    CHECK(readSpec.videoFrame == false);
+
+    // Truncated or corrupted headers are rejected, and leave the spec untouched
+    ImageBufferSpec otherSpec;
+    CHECK_FALSE(otherSpec.readHeader(header.data(), header.size() - 1));
+    auto corruptedHeader = header;
+    corruptedHeader[0] = 0;
+    CHECK_FALSE(otherSpec.readHeader(corruptedHeader.data(), corruptedHeader.size()));
+    corruptedHeader = header;
+    corruptedHeader[4] = ImageBufferSpec::headerVersion + 1;
+    CHECK_FALSE(otherSpec.readHeader(corruptedHeader.data(), corruptedHeader.size()));
+    CHECK(otherSpec == ImageBufferSpec());
+}
+
+/*************/
+TEST_CASE("Testing Image serialization round trip")
+{
+    RootObject root;
+    for (const auto& formatCase : formatCases)
+    {
+        ImageBufferSpec spec(48, 32, formatCase.channels, formatCase.bpp, formatCase.type, formatCase.format);
+        ImageBuffer buffer(spec);
+        auto pixels = reinterpret_cast<uint8_t*>(buffer.data());
+        for (size_t i = 0; i < buffer.getSize(); ++i)
+            pixels[i] = static_cast<uint8_t>(i * 13 + static_cast<size_t>(formatCase.format));
+
+        Image source(&root);
+        source.set(buffer);
+        auto serializedImage = source.serialize();
+        REQUIRE(serializedImage);
+        CHECK(serializedImage->size() == ImageBufferSpec::headerSize + spec.rawSize());
+
+        Image image(&root);
+        REQUIRE(image.deserialize(serializedImage));
+        image.update();
+        CHECK(image.getSpec() == spec);
+        CHECK(memcmp(image.data(), buffer.data(), buffer.getSize()) == 0);
+    }
+
+    // A buffer shorter than what its header announces is rejected
+    Image source(&root);
+    source.set(ImageBuffer(ImageBufferSpec(16, 16, 4, 32)));
+    auto serializedImage = source.serialize();
+    serializedImage->resize(serializedImage->size() - 1);
+    Image image(&root);
+    CHECK_FALSE(image.deserialize(serializedImage));
+}
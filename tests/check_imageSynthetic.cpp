@@ -0,0 +1,58 @@
+#include <chrono>
+#include <thread>
+
+#include <doctest.h>
+
+#include "./image_synthetic.h"
+#include "./mesh.h"
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing Image_Synthetic frame generation")
+{
+    RootObject root;
+    Image_Synthetic image(&root);
+    CHECK(image.setAttribute("size", {64, 32}));
+    CHECK(image.setAttribute("framerate", {100}));
+    CHECK_FALSE(image.setAttribute("size", {0, 32}));
+
+    // Frames are generated continuously, each one scrolling the pattern by one line
+    uint8_t previousValue = 0;
+    int newFrames = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        this_thread::sleep_for(chrono::milliseconds(30));
+        image.update();
+
+        auto spec = image.getSpec();
+        REQUIRE(spec.width == 64);
+        REQUIRE(spec.height == 32);
+        REQUIRE(spec.channels == 4);
+
+        auto pixels = reinterpret_cast<const uint8_t*>(image.data());
+        CHECK(pixels[spec.width * 4] == static_cast<uint8_t>(pixels[0] + 1));
+        if (i > 0 && pixels[0] != previousValue)
+            ++newFrames;
+        previousValue = pixels[0];
+    }
+    CHECK(newFrames >= 5);
+}
+
+/*************/
+TEST_CASE("Testing Mesh vertex count")
+{
+    RootObject root;
+    Mesh mesh(&root);
+    CHECK(mesh.setAttribute("vertexCount", {100000}));
+
+    Values vertexCount;
+    CHECK(mesh.getAttribute("vertexCount", vertexCount));
+    REQUIRE(vertexCount.size() == 1);
+    CHECK(vertexCount[0].as<int>() >= 100000);
+    CHECK(vertexCount[0].as<int>() < 110000);
+    CHECK(mesh.getVertCoords().size() == vertexCount[0].as<size_t>() * 4);
+}
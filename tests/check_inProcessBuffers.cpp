@@ -0,0 +1,151 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <doctest.h>
+#include <unistd.h>
+
+#include "./image.h"
+#include "./mesh.h"
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class BufferPeer : public RootObject
+{
+  public:
+    BufferPeer(const string& name)
+    {
+        _name = name;
+        _linkSocketPrefix = "check_" + to_string(getpid());
+        _link = make_shared<Link>(this, _name);
+    }
+
+    Link* getLink() const { return _link.get(); }
+
+    void addObject(const string& name, const shared_ptr<BaseObject>& object)
+    {
+        object->setName(name);
+        _objects[name] = object;
+    }
+};
+
+/*************/
+class CountingImage : public Image
+{
+  public:
+    CountingImage(RootObject* root)
+        : Image(root)
+    {
+    }
+
+    shared_ptr<SerializedObject> serialize() const final
+    {
+        ++serializeCount;
+        return Image::serialize();
+    }
+
+    mutable atomic_int serializeCount{0};
+};
+
+/*************/
+bool waitForTimestamp(const shared_ptr<BufferObject>& object, int64_t previousTimestamp)
+{
+    for (int i = 0; i < 100 && object->getTimestamp() == previousTimestamp; ++i)
+        this_thread::sleep_for(chrono::milliseconds(10));
+    return object->getTimestamp() != previousTimestamp;
+}
+}
+
+/*************/
+TEST_CASE("Testing in-process buffer transfer")
+{
+    BufferPeer world("check_inprocess_world");
+    BufferPeer scene("check_inprocess_scene");
+    world.getLink()->connectTo("check_inprocess_scene", &scene);
+    REQUIRE(world.getLink()->isInnerPeer("check_inprocess_scene"));
+
+    auto worldImage = make_shared<CountingImage>(&world);
+    auto sceneImage = make_shared<Image>(&scene);
+    world.addObject("image", worldImage);
+    scene.addObject("image", sceneImage);
+
+    ImageBuffer frame(ImageBufferSpec(256, 128, 4, 32, ImageBufferSpec::Type::UINT8));
+    auto pixels = reinterpret_cast<uint8_t*>(frame.data());
+    for (size_t i = 0; i < frame.getSize(); ++i)
+        pixels[i] = static_cast<uint8_t>(i * 7);
+    worldImage->set(frame);
+    const auto frameSize = frame.getSize();
+
+    SUBCASE("Serialized path")
+    {
+        world.getLink()->setInProcessTransfer(false);
+        auto timestamp = sceneImage->getTimestamp();
+        CHECK(world.getLink()->sendBuffer("image", worldImage, {"check_inprocess_scene"}));
+
+        // The image is serialized once, then deserialized asynchronously into a buffer of its own
+        REQUIRE(waitForTimestamp(sceneImage, timestamp));
+        sceneImage->update();
+        CHECK(worldImage->serializeCount == 1);
+        CHECK(sceneImage->data() != worldImage->data());
+        CHECK(memcmp(sceneImage->data(), worldImage->data(), frameSize) == 0);
+    }
+
+    SUBCASE("Snapshot path")
+    {
+        world.getLink()->setInProcessTransfer(true);
+        auto timestamp = sceneImage->getTimestamp();
+        CHECK(world.getLink()->sendBuffer("image", worldImage, {"check_inprocess_scene"}));
+
+        // The image buffer is shared as is, without any serialization nor copy
+        REQUIRE(waitForTimestamp(sceneImage, timestamp));
+        sceneImage->update();
+        CHECK(worldImage->serializeCount == 0);
+        CHECK(sceneImage->data() == worldImage->data());
+        CHECK(memcmp(sceneImage->data(), pixels, frameSize) == 0);
+
+        // Shared buffers are never modified, the sending image gets a new one instead
+        worldImage->zero();
+        CHECK(sceneImage->data() != worldImage->data());
+        CHECK(memcmp(sceneImage->data(), pixels, frameSize) == 0);
+    }
+
+    SUBCASE("Snapshot path falls back to serialization")
+    {
+        // Objects unknown to the destination, or of another type, are handled through their serialized form
+        world.getLink()->setInProcessTransfer(true);
+        auto sceneMesh = make_shared<Mesh>(&scene);
+        scene.addObject("mesh_named_image", sceneMesh);
+        CHECK_FALSE(scene.setFromSnapshot("mesh_named_image", worldImage->getSnapshot()));
+        CHECK_FALSE(scene.setFromSnapshot("unknown_image", worldImage->getSnapshot()));
+
+        CHECK(world.getLink()->sendBuffer("unknown_image", worldImage, {"check_inprocess_scene"}));
+        CHECK(worldImage->serializeCount == 1);
+    }
+}
+
+/*************/
+TEST_CASE("Testing in-process mesh transfer")
+{
+    RootObject root;
+    auto worldMesh = make_shared<Mesh>(&root);
+    auto sceneMesh = make_shared<Mesh>(&root);
+    CHECK(worldMesh->setAttribute("vertexCount", {600}));
+    CHECK(worldMesh->getVertCoords() != sceneMesh->getVertCoords());
+
+    CHECK(sceneMesh->setSnapshot(worldMesh->getSnapshot()));
+    sceneMesh->update();
+    CHECK(worldMesh->getVertCoords() == sceneMesh->getVertCoords());
+    CHECK(worldMesh->getUVCoords() == sceneMesh->getUVCoords());
+
+    // Snapshots are typed, and an Image does not accept a mesh
+    Image image(&root);
+    CHECK_FALSE(image.setSnapshot(worldMesh->getSnapshot()));
+}
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./inflight_buffers.h"
+#include "./splash.h"
+#include "./timer.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing InFlightBuffers tracking")
+{
+    InFlightBuffers inFlight("check_inFlightLatency");
+    CHECK(inFlight.getCount() == 0);
+    CHECK(inFlight.waitForRelease(chrono::milliseconds(0)));
+
+    auto buffer = make_shared<SerializedObject>(1024);
+    weak_ptr<SerializedObject> weakBuffer = buffer;
+
+    vector<void*> hints;
+    for (int i = 0; i < 4; ++i)
+        hints.push_back(inFlight.track(buffer));
+    buffer.reset();
+    CHECK(inFlight.getCount() == 4);
+    CHECK(!weakBuffer.expired());
+    CHECK(!inFlight.waitForRelease(chrono::milliseconds(5)));
+
+    // Buffers can be released in any order
+    InFlightBuffers::release(nullptr, hints[2]);
+    InFlightBuffers::release(nullptr, hints[0]);
+    CHECK(inFlight.getCount() == 2);
+
+    // Released slots are reused
+    auto hint = inFlight.track(make_shared<SerializedObject>(16));
+    CHECK((hint == hints[0] || hint == hints[2]));
+    InFlightBuffers::release(nullptr, hint);
+
+    InFlightBuffers::release(nullptr, hints[3]);
+    InFlightBuffers::release(nullptr, hints[1]);
+    CHECK(inFlight.getCount() == 0);
+    CHECK(weakBuffer.expired());
+    CHECK(inFlight.waitForRelease(chrono::milliseconds(0)));
+
+    CHECK(Timer::get().getStats("check_inFlightLatency").count == 5);
+}
+
+/*************/
+TEST_CASE("Testing InFlightBuffers waiters wake up on the last release")
+{
+    InFlightBuffers inFlight("check_inFlightWakeUp");
+
+    const int bufferCount = 8;
+    vector<void*> hints;
+    for (int i = 0; i < bufferCount; ++i)
+        hints.push_back(inFlight.track(make_shared<SerializedObject>(64)));
+
+    atomic_bool released{false};
+    atomic<int64_t> wakeUpTime{0};
+    bool waitResult = false;
+    bool releasedOnWakeUp = false;
+    auto waiter = thread([&]() {
+        waitResult = inFlight.waitForRelease(chrono::milliseconds(5000));
+        wakeUpTime = Timer::getTime();
+        releasedOnWakeUp = released;
+    });
+
+    // Release the buffers one by one, as the ZMQ IO thread would
+    for (int i = 0; i < bufferCount - 1; ++i)
+    {
+        this_thread::sleep_for(chrono::milliseconds(2));
+        InFlightBuffers::release(nullptr, hints[i]);
+    }
+    this_thread::sleep_for(chrono::milliseconds(10));
+    CHECK(wakeUpTime == 0);
+
+    released = true;
+    auto releaseTime = Timer::getTime();
+    InFlightBuffers::release(nullptr, hints.back());
+    waiter.join();
+
+    CHECK(waitResult);
+    // The waiter must not return before the last buffer is released
+    CHECK(releasedOnWakeUp);
+    // Polling would add up to a millisecond, the waiter is expected to wake up well before that
+    auto wakeUpDelay = wakeUpTime - releaseTime;
+    MESSAGE("Waiter woke up " << wakeUpDelay << "us after the last release");
+    CHECK(wakeUpDelay < 1000);
+}
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <doctest.h>
+#include <unistd.h>
+
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class LinkPeer : public RootObject
+{
+  public:
+    LinkPeer(const string& name)
+    {
+        _name = name;
+        _linkSocketPrefix = "check_" + to_string(getpid());
+        _link = make_shared<Link>(this, _name);
+
+        addAttribute("record",
+            [&](const Values& args) {
+                lock_guard<mutex> lock(_receivedMutex);
+                _messages.push_back(args[0].as<string>());
+                _receivedCondition.notify_one();
+                return true;
+            },
+            {'s'});
+    }
+
+    Link* getLink() const { return _link.get(); }
+
+    std::set<string> getReceived()
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        return _received;
+    }
+
+    bool waitForBuffers(size_t count)
+    {
+        unique_lock<mutex> lock(_receivedMutex);
+        return _receivedCondition.wait_for(lock, chrono::seconds(1), [&]() { return _received.size() >= count; });
+    }
+
+    vector<string> getMessages()
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        return _messages;
+    }
+
+    bool waitForMessages(size_t count)
+    {
+        unique_lock<mutex> lock(_receivedMutex);
+        return _receivedCondition.wait_for(lock, chrono::seconds(1), [&]() { return _messages.size() >= count; });
+    }
+
+  protected:
+    void handleSerializedObject(const string& name, shared_ptr<SerializedObject> obj) final
+    {
+        lock_guard<mutex> lock(_receivedMutex);
+        _received.insert(name);
+        _receivedCondition.notify_one();
+    }
+
+  private:
+    mutex _receivedMutex{};
+    condition_variable _receivedCondition{};
+    std::set<string> _received{};
+    vector<string> _messages{};
+};
+}
+
+/*************/
+TEST_CASE("Testing Link buffer routing")
+{
+    // Two scenes showing disjoint media, and a World sending them their buffers
+    LinkPeer firstScene("check_first_scene");
+    LinkPeer secondScene("check_second_scene");
+    LinkPeer world("check_world");
+    world.getLink()->connectTo("check_first_scene");
+    world.getLink()->connectTo("check_second_scene");
+
+    auto buffer = make_shared<SerializedObject>(1024);
+    memset(buffer->data(), 0, buffer->size());
+
+    world.getLink()->sendBuffer("first_image", buffer, {"check_first_scene"});
+    world.getLink()->sendBuffer("first_mesh", buffer, {"check_first_scene"});
+    world.getLink()->sendBuffer("second_image", buffer, {"check_second_scene"});
+    world.getLink()->sendBuffer("unused_image", buffer, {"unknown_scene"});
+    // Without destinations, buffers are sent to all peers
+    world.getLink()->sendBuffer("shared_image", buffer);
+    CHECK(world.getLink()->waitForBufferSending(chrono::milliseconds(1000)));
+
+    CHECK(firstScene.waitForBuffers(3));
+    CHECK(secondScene.waitForBuffers(2));
+
+    CHECK(firstScene.getReceived() == set<string>({"first_image", "first_mesh", "shared_image"}));
+    CHECK(secondScene.getReceived() == set<string>({"second_image", "shared_image"}));
+}
+
+/*************/
+TEST_CASE("Testing Link messages to a peer connected during a batch")
+{
+    LinkPeer firstScene("check_first_scene");
+    LinkPeer secondScene("check_second_scene");
+    LinkPeer world("check_world");
+    world.getLink()->connectTo("check_first_scene");
+
+    // Names interned before the second scene connects must be defined again for it
+    world.getLink()->beginMessageBatch();
+    world.getLink()->sendMessage(SPLASH_ALL_PEERS, "record", {"before"});
+    world.getLink()->connectTo("check_second_scene");
+    world.getLink()->sendMessage(SPLASH_ALL_PEERS, "record", {"during"});
+    world.getLink()->flushMessageBatch();
+    world.getLink()->sendMessage(SPLASH_ALL_PEERS, "record", {"after"});
+
+    CHECK(firstScene.waitForMessages(3));
+    CHECK(firstScene.getMessages() == vector<string>({"before", "during", "after"}));
+    CHECK(secondScene.waitForMessages(3));
+    CHECK(secondScene.getMessages() == vector<string>({"before", "during", "after"}));
+}
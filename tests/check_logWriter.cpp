@@ -0,0 +1,150 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+#include <unistd.h>
+
+#include "./histogram.h"
+#include "./log_writer.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+string getLogPath(const string& name)
+{
+    return "/tmp/splash_check_" + name + "_" + to_string(getpid()) + ".log";
+}
+
+void removeLogFiles(const string& path, int backups)
+{
+    std::remove(path.c_str());
+    for (int i = 1; i <= backups; ++i)
+        std::remove((path + "." + to_string(i)).c_str());
+}
+
+vector<string> readLines(const string& path)
+{
+    vector<string> lines;
+    ifstream file(path);
+    string line;
+    while (getline(file, line))
+        lines.push_back(line);
+    return lines;
+}
+}
+
+/*************/
+TEST_CASE("Testing LogWriter writes records in order")
+{
+    auto path = getLogPath("log_writer");
+    removeLogFiles(path, 0);
+
+    {
+        LogWriter writer(path, 64, 0, 0);
+        REQUIRE(static_cast<bool>(writer));
+        for (int i = 0; i < 32; ++i)
+            CHECK(writer.push("record " + to_string(i)));
+        writer.flush();
+
+        auto lines = readLines(path);
+        REQUIRE(lines.size() == 32);
+        for (int i = 0; i < 32; ++i)
+            CHECK(lines[i] == "record " + to_string(i));
+
+        // Records pushed right before destruction are written too
+        CHECK(writer.push("last record"));
+    }
+
+    auto lines = readLines(path);
+    REQUIRE(lines.size() == 33);
+    CHECK(lines.back() == "last record");
+    CHECK(LogWriter("/nonexistent_directory/splash.log").push("record") == false);
+
+    removeLogFiles(path, 0);
+}
+
+/*************/
+TEST_CASE("Testing LogWriter rotation")
+{
+    auto path = getLogPath("log_writer_rotation");
+    removeLogFiles(path, 3);
+
+    const string record(99, 'x'); // 100 bytes with the end of line
+    {
+        LogWriter writer(path, 16, 1000, 2);
+        for (int i = 0; i < 35; ++i)
+        {
+            CHECK(writer.push(string(record)));
+            writer.flush();
+        }
+    }
+
+    CHECK(readLines(path).size() == 5);
+    CHECK(readLines(path + ".1").size() == 10);
+    CHECK(readLines(path + ".2").size() == 10);
+    CHECK(readLines(path + ".3").empty());
+
+    removeLogFiles(path, 3);
+}
+
+/*************/
+TEST_CASE("Testing LogWriter under heavy logging")
+{
+    auto path = getLogPath("log_writer_stress");
+    removeLogFiles(path, 0);
+
+    const int producerCount = 8;
+    const int recordsPerProducer = 20000;
+    Histogram latencies;
+    atomic_int pushed{0};
+
+    LogWriter writer(path, 256, 0, 0);
+    {
+        vector<thread> producers;
+        for (int p = 0; p < producerCount; ++p)
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < recordsPerProducer; ++i)
+                {
+                    auto record = "producer " + to_string(p) + " - a log message long enough to look like a real one, number " + to_string(i);
+                    auto start = chrono::steady_clock::now();
+                    auto success = writer.push(move(record));
+                    latencies.record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+                    if (success)
+                        pushed.fetch_add(1, memory_order_relaxed);
+                }
+            });
+        for (auto& producer : producers)
+            producer.join();
+    }
+    writer.flush();
+
+    // Producers never wait for the file, records which do not fit are dropped and counted
+    auto stats = latencies.getStats();
+    MESSAGE("push latency (ns): p50 " << stats.p50 << ", p99 " << stats.p99 << ", max " << stats.max << " - dropped " << writer.getDroppedCount());
+    CHECK(stats.count == producerCount * recordsPerProducer);
+    CHECK(stats.p99 < 100000);
+    CHECK(pushed + writer.getDroppedCount() == producerCount * recordsPerProducer);
+
+    // Every pushed record is written, followed by a line reporting the drops
+    auto lines = readLines(path);
+    int records = 0;
+    int reportedDrops = 0;
+    for (const auto& line : lines)
+    {
+        if (line.find("producer ") == 0)
+            ++records;
+        else if (line.find("LogWriter - ") == 0)
+            reportedDrops += stoi(line.substr(12));
+    }
+    CHECK(records == pushed);
+    CHECK(reportedDrops == writer.getDroppedCount());
+
+    removeLogFiles(path, 0);
+}
@@ -0,0 +1,98 @@
+#include <cstring>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./mesh.h"
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+// Mesh filled with arbitrary values, so that every attribute differs from the others
+class FilledMesh : public Mesh
+{
+  public:
+    FilledMesh(RootObject* root, int vertexCount, bool withAnnexe)
+        : Mesh(root)
+    {
+        MeshContainer mesh;
+        for (int i = 0; i < vertexCount; ++i)
+        {
+            auto value = static_cast<float>(i);
+            mesh.vertices.push_back(glm::vec4(value, value + 0.25f, value + 0.5f, 1.f));
+            mesh.uvs.push_back(glm::vec2(value * 0.5f, value * 0.25f));
+            mesh.normals.push_back(glm::vec4(0.f, -value, 1.f, 0.f));
+            if (withAnnexe)
+                mesh.annexe.push_back(glm::vec4(value * 2.f));
+        }
+        _mesh = make_shared<MeshContainer>(std::move(mesh));
+    }
+};
+
+/*************/
+bool isSameView(const Mesh::AttributeView& lhs, const Mesh::AttributeView& rhs)
+{
+    return lhs.size() == rhs.size() && (lhs.empty() || memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(float)) == 0);
+}
+}
+
+/*************/
+TEST_CASE("Testing Mesh serialization round trip")
+{
+    RootObject root;
+    for (auto withAnnexe : {false, true})
+    {
+        for (auto vertexCount : {0, 3, 3000})
+        {
+            FilledMesh source(&root, vertexCount, withAnnexe);
+            auto serializedMesh = source.serialize();
+            REQUIRE(serializedMesh);
+            CHECK(serializedMesh->size() == sizeof(int) + vertexCount * (withAnnexe ? 14 : 10) * sizeof(float));
+
+            Mesh mesh(&root);
+            REQUIRE(mesh.deserialize(serializedMesh));
+            mesh.update();
+            CHECK(mesh.getVertCoordsView().size() == static_cast<size_t>(vertexCount) * 4);
+            CHECK(isSameView(mesh.getVertCoordsView(), source.getVertCoordsView()));
+            CHECK(isSameView(mesh.getUVCoordsView(), source.getUVCoordsView()));
+            CHECK(isSameView(mesh.getNormalsView(), source.getNormalsView()));
+            CHECK(isSameView(mesh.getAnnexeView(), source.getAnnexeView()));
+            CHECK(mesh.getAnnexeView().empty() != withAnnexe);
+        }
+    }
+
+    // A buffer shorter than what its vertex count announces is rejected
+    FilledMesh source(&root, 30, false);
+    auto serializedMesh = source.serialize();
+    serializedMesh->resize(serializedMesh->size() - 1);
+    Mesh mesh(&root);
+    CHECK_FALSE(mesh.deserialize(serializedMesh));
+}
+
+/*************/
+TEST_CASE("Testing Mesh attribute views")
+{
+    RootObject root;
+    FilledMesh source(&root, 30, true);
+    auto vertices = source.getVertCoordsView();
+    auto normals = source.getNormalsView();
+
+    // Copies and views hold the same values, normals being padded with a null w
+    CHECK(source.getVertCoords() == vector<float>(vertices.begin(), vertices.end()));
+    REQUIRE(normals.size() == 30 * 4);
+    CHECK(normals[7 * 4 + 1] == -7.f);
+    CHECK(normals[7 * 4 + 3] == 0.f);
+
+    // Views stay valid once the mesh has been replaced
+    Mesh other(&root);
+    REQUIRE(source.deserialize(other.serialize()));
+    source.update();
+    CHECK(source.getVertCoordsView().size() != vertices.size());
+    REQUIRE(vertices.size() == 30 * 4);
+    CHECK(vertices[29 * 4] == 29.f);
+}
@@ -0,0 +1,154 @@
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <doctest.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./mesh.h"
+#include "./mesh_cache.h"
+#include "./root_object.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+// Cache directory and source file used by the tests, the previous cache settings being restored on exit
+class CacheFixture
+{
+  public:
+    CacheFixture()
+        : _previousDirectory(MeshCache::get().getDirectory())
+        , _previousMaxSize(MeshCache::get().getMaxSize())
+        , _directory("/tmp/splash_check_" + to_string(getpid()) + "_meshCache/")
+        , _sourcePath("/tmp/splash_check_" + to_string(getpid()) + "_meshCache.obj")
+    {
+        MeshCache::get().setDirectory(_directory);
+        writeSource(0.5f);
+    }
+
+    ~CacheFixture()
+    {
+        MeshCache::get().setDirectory(_directory);
+        MeshCache::get().setMaxSize(0);
+        rmdir(_directory.c_str());
+        unlink(_sourcePath.c_str());
+        MeshCache::get().setDirectory(_previousDirectory);
+        MeshCache::get().setMaxSize(_previousMaxSize);
+    }
+
+    const string& getSourcePath() const { return _sourcePath; }
+
+    /**
+     * \brief Write a grid of quads as the source file
+     * \param height Height of the grid, the file size staying the same as long as it is written with as many characters
+     */
+    void writeSource(float height)
+    {
+        const int side = 32;
+        stringstream content;
+        for (int y = 0; y < side; ++y)
+            for (int x = 0; x < side; ++x)
+                content << "v " << x << " " << y << " " << height << "\n";
+        for (int y = 0; y < side; ++y)
+            for (int x = 0; x < side; ++x)
+                content << "vt " << x << " " << y << "\n";
+        for (int y = 0; y < side - 1; ++y)
+        {
+            for (int x = 0; x < side - 1; ++x)
+            {
+                auto index = y * side + x + 1;
+                content << "f " << index << "/" << index << " " << index + 1 << "/" << index + 1 << " " << index + side + 1 << "/" << index + side + 1 << " " << index + side << "/"
+                        << index + side << "\n";
+            }
+        }
+
+        ofstream file(_sourcePath, ios::out | ios::trunc);
+        file << content.str();
+    }
+
+  private:
+    string _previousDirectory;
+    size_t _previousMaxSize;
+    string _directory;
+    string _sourcePath;
+};
+
+/*************/
+bool fileExists(const string& path)
+{
+    return access(path.c_str(), F_OK) == 0;
+}
+}
+
+/*************/
+TEST_CASE("Testing MeshCache")
+{
+    CacheFixture fixture;
+    auto& meshCache = MeshCache::get();
+    const auto& sourcePath = fixture.getSourcePath();
+    auto cachePath = meshCache.getCachePath(sourcePath);
+    REQUIRE(!cachePath.empty());
+    CHECK_FALSE(fileExists(cachePath));
+
+    vector<glm::vec4> vertices, normals;
+    vector<glm::vec2> uvs;
+    auto readCache = [&]() {
+        MeshCache::Source source;
+        return MeshCache::getSource(sourcePath, source) && meshCache.read(source, vertices, uvs, normals);
+    };
+    CHECK_FALSE(readCache());
+
+    // Loading a mesh from a file caches it, and the cached mesh is the same as the parsed one
+    RootObject root;
+    Mesh parsedMesh(&root);
+    REQUIRE(parsedMesh.read(sourcePath));
+    CHECK(fileExists(cachePath));
+    REQUIRE(readCache());
+    CHECK(vertices.size() == 31 * 31 * 6);
+
+    Mesh cachedMesh(&root);
+    REQUIRE(cachedMesh.read(sourcePath));
+    CHECK(cachedMesh.getVertCoords() == parsedMesh.getVertCoords());
+    CHECK(cachedMesh.getUVCoords() == parsedMesh.getUVCoords());
+    CHECK(cachedMesh.getNormals() == parsedMesh.getNormals());
+
+    // A source modified while keeping its size and modification time is detected through its content hash
+    struct stat sourceStat;
+    REQUIRE(stat(sourcePath.c_str(), &sourceStat) == 0);
+    fixture.writeSource(0.2f);
+    struct timespec times[2] = {sourceStat.st_atim, sourceStat.st_mtim};
+    REQUIRE(utimensat(AT_FDCWD, sourcePath.c_str(), times, 0) == 0);
+    CHECK_FALSE(readCache());
+
+    // The source is parsed again, and cached as such
+    Mesh modifiedMesh(&root);
+    REQUIRE(modifiedMesh.read(sourcePath));
+    CHECK(modifiedMesh.getVertCoords() != parsedMesh.getVertCoords());
+    REQUIRE(readCache());
+    CHECK(vertices[0].z == 0.2f);
+
+    // A truncated cache file is ignored
+    REQUIRE(truncate(cachePath.c_str(), 100) == 0);
+    CHECK_FALSE(readCache());
+
+    // Cache files are evicted once the cache exceeds its maximum size
+    MeshCache::Source source;
+    REQUIRE(MeshCache::getSource(sourcePath, source));
+    REQUIRE(meshCache.write(source, vertices, uvs, normals));
+    CHECK(fileExists(cachePath));
+    meshCache.setMaxSize(1024);
+    CHECK_FALSE(fileExists(cachePath));
+
+    // The cache can be disabled
+    meshCache.setDirectory("");
+    CHECK(meshCache.getCachePath(sourcePath).empty());
+    CHECK_FALSE(meshCache.isEnabled());
+    CHECK_FALSE(meshCache.write(source, vertices, uvs, normals));
+}
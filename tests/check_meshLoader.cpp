@@ -0,0 +1,379 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <doctest.h>
+#include <glob.h>
+#include <unistd.h>
+
+#include "./meshLoader.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+// Line-based OBJ loader Loader::Obj used to be, kept as a reference for its output.
+// The only change is that vertices default to w = 1, where glm could leave it uninitialized.
+class ReferenceObj
+{
+  public:
+    bool load(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::in);
+        if (!file.is_open())
+            return false;
+
+        _vertices.clear();
+        _uvs.clear();
+        _normals.clear();
+        _faces.clear();
+
+        // All objects are converted to a single one.
+        // This indices keeps track of the objects
+        int vertexShift = 0;
+        int uvShift = 0;
+        int normalShift = 0;
+
+        for (std::string line; std::getline(file, line);)
+        {
+
+            std::string::size_type pos;
+            if ((pos = line.find("o ")) == 0)
+            {
+                vertexShift = _vertices.size();
+                uvShift = _uvs.size();
+                normalShift = _normals.size();
+            }
+            else if ((pos = line.find("v ")) == 0)
+            {
+                pos += 1;
+                glm::vec4 vertex(0.f, 0.f, 0.f, 1.f);
+                int index = 0;
+                do
+                {
+                    pos++;
+                    line = line.substr(pos);
+                    vertex[index] = std::stof(line);
+                    index++;
+                    pos = line.find(" ");
+                } while (pos != std::string::npos && index < 4);
+
+                if (index < 3)
+                    vertex[3] = 1.f;
+
+                _vertices.push_back(vertex);
+            }
+            else if ((pos = line.find("vt ")) == 0)
+            {
+                pos += 2;
+                glm::vec2 uv;
+                int index = 0;
+                do
+                {
+                    pos++;
+                    line = line.substr(pos);
+                    uv[index] = std::stof(line);
+                    index++;
+                    pos = line.find(" ");
+                } while (pos != std::string::npos && index < 2);
+
+                _uvs.push_back(uv);
+            }
+            else if ((pos = line.find("vn ")) == 0)
+            {
+                pos += 2;
+                glm::vec3 normal;
+                int index = 0;
+                do
+                {
+                    pos++;
+                    line = line.substr(pos);
+                    normal[index] = std::stof(line);
+                    index++;
+                    pos = line.find(" ");
+                } while (pos != std::string::npos && index < 3);
+
+                _normals.push_back(normal);
+            }
+            else if ((pos = line.find("f ")) == 0)
+            {
+                pos += 1;
+
+                std::vector<FaceVertex> face;
+                std::string::size_type nextSlash, nextSpace;
+                do
+                {
+                    pos++;
+                    line = line.substr(pos);
+                    nextSpace = line.find(" ");
+
+                    FaceVertex faceVertex;
+                    faceVertex.vertexId = std::stoi(line) - 1;
+
+                    nextSlash = line.find("/");
+                    if (nextSlash != std::string::npos && (nextSpace == std::string::npos || nextSlash < nextSpace))
+                    {
+                        line = line.substr(nextSlash + 1);
+                        nextSlash = line.find("/");
+                        if (nextSlash != 0)
+                        {
+                            nextSpace = line.find(" ");
+                            faceVertex.uvId = std::stoi(line) - 1;
+                        }
+                    }
+                    else
+                        nextSlash = line.find("/");
+                    if (nextSlash != std::string::npos && (nextSpace == std::string::npos || nextSlash < nextSpace))
+                    {
+                        line = line.substr(nextSlash + 1);
+                        nextSpace = line.find(" ");
+                        faceVertex.normalId = std::stoi(line) - 1;
+                    }
+
+                    face.push_back(faceVertex);
+
+                    pos = nextSpace;
+                } while (pos != std::string::npos);
+
+                // We triangulate faces right away if needed
+                // Only tris and quads are supported
+                if (face.size() == 3)
+                {
+                    _faces.push_back(face);
+                }
+                else if (face.size() >= 4)
+                {
+                    std::vector<FaceVertex> newFace;
+                    newFace.push_back(face[0]);
+                    newFace.push_back(face[1]);
+                    newFace.push_back(face[2]);
+                    _faces.push_back(newFace);
+
+                    newFace.clear();
+                    newFace.push_back(face[2]);
+                    newFace.push_back(face[3]);
+                    newFace.push_back(face[0]);
+                    _faces.push_back(newFace);
+                }
+            }
+        }
+
+        // Check that we have faces, vertices and UVs
+        if (_vertices.size() == 0 || _faces.size() == 0)
+        {
+            _vertices.clear();
+            _faces.clear();
+            _uvs.clear();
+            _normals.clear();
+
+            return false;
+        }
+
+        return true;
+    }
+
+    /**/
+    std::vector<glm::vec4> getVertices() const
+    {
+        std::vector<glm::vec4> vertices;
+
+        for (auto& face : _faces)
+        {
+            vertices.push_back(_vertices[face[0].vertexId]);
+            vertices.push_back(_vertices[face[1].vertexId]);
+            vertices.push_back(_vertices[face[2].vertexId]);
+        }
+
+        return vertices;
+    }
+
+    /**/
+    std::vector<glm::vec2> getUVs() const
+    {
+        std::vector<glm::vec2> uvs;
+
+        for (auto& face : _faces)
+        {
+            if (face[0].uvId == -1)
+                for (auto& v : face)
+                    uvs.push_back(glm::vec2(0.f, 0.f));
+            else
+            {
+                uvs.push_back(_uvs[face[0].uvId]);
+                uvs.push_back(_uvs[face[1].uvId]);
+                uvs.push_back(_uvs[face[2].uvId]);
+            }
+        }
+
+        return uvs;
+    }
+
+    /**/
+    std::vector<glm::vec3> getNormals() const
+    {
+        std::vector<glm::vec3> normals;
+
+        for (auto& face : _faces)
+        {
+            if (face[0].normalId == -1)
+            {
+                auto edge1 = glm::vec3(_vertices[face[1].vertexId] - _vertices[face[0].vertexId]);
+                auto edge2 = glm::vec3(_vertices[face[2].vertexId] - _vertices[face[0].vertexId]);
+                auto normal = glm::normalize(glm::cross(edge1, edge2));
+
+                normals.push_back(normal);
+                normals.push_back(normal);
+                normals.push_back(normal);
+            }
+            else
+            {
+                normals.push_back(_normals[face[0].normalId]);
+                normals.push_back(_normals[face[1].normalId]);
+                normals.push_back(_normals[face[2].normalId]);
+            }
+        }
+
+        return normals;
+    }
+
+
+  private:
+    std::vector<glm::vec4> _vertices;
+    std::vector<glm::vec2> _uvs;
+    std::vector<glm::vec3> _normals;
+
+    struct FaceVertex
+    {
+        int vertexId{-1};
+        int uvId{-1};
+        int normalId{-1};
+    };
+    std::vector<std::vector<FaceVertex>> _faces;
+};
+
+/*************/
+// Temporary file, removed when going out of scope
+class TemporaryFile
+{
+  public:
+    TemporaryFile(const string& content)
+        : _filename("/tmp/splash_check_" + to_string(getpid()) + "_" + to_string(_index++) + ".obj")
+    {
+        ofstream file(_filename, ios::out | ios::binary);
+        file << content;
+    }
+    ~TemporaryFile() { unlink(_filename.c_str()); }
+
+    const string& getFilename() const { return _filename; }
+
+  private:
+    static int _index;
+    string _filename;
+};
+
+int TemporaryFile::_index = 0;
+
+/*************/
+void checkConformance(const string& filename)
+{
+    ReferenceObj reference;
+    Loader::Obj loader;
+    auto referenceLoaded = reference.load(filename);
+    REQUIRE(loader.load(filename) == referenceLoaded);
+    if (!referenceLoaded)
+        return;
+
+    CHECK(loader.getVertices() == reference.getVertices());
+    CHECK(loader.getUVs() == reference.getUVs());
+    CHECK(loader.getNormals() == reference.getNormals());
+}
+}
+
+/*************/
+TEST_CASE("Testing Loader::Obj conformance with the line-based loader")
+{
+    glob_t files;
+    REQUIRE(glob(SPLASH_DATA_PATH "*.obj", 0, nullptr, &files) == 0);
+    CHECK(files.gl_pathc > 0);
+    for (size_t i = 0; i < files.gl_pathc; ++i)
+    {
+        checkConformance(files.gl_pathv[i]);
+    }
+    globfree(&files);
+
+    // A file large enough to be split in chunks, mixing all face formats
+    stringstream content;
+    const int side = 400;
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x)
+            content << "v " << x * 0.01f << " " << y * 0.01f << " " << (x * y % 7) * 0.125f << "\n";
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x)
+            content << "vt " << static_cast<float>(x) / side << " " << static_cast<float>(y) / side << "\n";
+    content << "vn 0.0 0.0 1.0\nvn 0.0 1.0 0.0\n";
+    for (int y = 0; y < side - 1; ++y)
+    {
+        for (int x = 0; x < side - 1; ++x)
+        {
+            auto index = y * side + x + 1;
+            switch ((x + y) % 4)
+            {
+            case 0:
+                content << "f " << index << "/" << index << "/1 " << index + 1 << "/" << index + 1 << "/1 " << index + side + 1 << "/" << index + side + 1 << "/1 " << index + side
+                        << "/" << index + side << "/1\n";
+                break;
+            case 1:
+                content << "f " << index << "//2 " << index + 1 << "//2 " << index + side << "//2\n";
+                break;
+            case 2:
+                content << "f " << index << "/" << index << " " << index + 1 << "/" << index + 1 << " " << index + side << "/" << index + side << "\n";
+                break;
+            default:
+                content << "f " << index << " " << index + side + 1 << " " << index + side << "\n";
+                break;
+            }
+        }
+    }
+    TemporaryFile largeFile(content.str());
+    checkConformance(largeFile.getFilename());
+}
+
+/*************/
+TEST_CASE("Testing Loader::Obj parsing")
+{
+    // Quads are split in two triangles, and negative indices count backwards from the last element
+    TemporaryFile quadFile("o quad\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 1\nf -4/-2 -3/-2 -2/-1 -1/-1\n");
+    Loader::Obj loader;
+    REQUIRE(loader.load(quadFile.getFilename()));
+    auto vertices = loader.getVertices();
+    REQUIRE(vertices.size() == 6);
+    CHECK(vertices[0] == glm::vec4(0.f, 0.f, 0.f, 1.f));
+    CHECK(vertices[2] == glm::vec4(1.f, 1.f, 0.f, 1.f));
+    CHECK(vertices[3] == glm::vec4(1.f, 1.f, 0.f, 1.f));
+    CHECK(vertices[4] == glm::vec4(0.f, 1.f, 0.f, 1.f));
+    CHECK(vertices[5] == glm::vec4(0.f, 0.f, 0.f, 1.f));
+    auto uvs = loader.getUVs();
+    REQUIRE(uvs.size() == 6);
+    CHECK(uvs[2] == glm::vec2(1.f, 1.f));
+    CHECK(uvs[5] == glm::vec2(0.f, 0.f));
+    auto normals = loader.getNormals();
+    REQUIRE(normals.size() == 6);
+    CHECK(normals[0] == glm::vec3(0.f, 0.f, 1.f));
+
+    // The last line does not need a line feed, and windows line endings are supported
+    TemporaryFile noLineFeedFile("v 0 0 0\r\nv 1 0 0\r\nv 0 1 0\r\nf 1 2 3");
+    REQUIRE(loader.load(noLineFeedFile.getFilename()));
+    CHECK(loader.getVertices().size() == 3);
+
+    // Faces referring to missing vertices are rejected
+    TemporaryFile badIndexFile("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n");
+    CHECK_FALSE(loader.load(badIndexFile.getFilename()));
+    CHECK(loader.getVertices().empty());
+
+    CHECK_FALSE(loader.load("/nonexistent/file.obj"));
+}
@@ -0,0 +1,129 @@
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <doctest.h>
+
+#include "./image.h"
+#include "./queue.h"
+#include "./root_object.h"
+#include "./timer.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class QueueRoot : public RootObject
+{
+  public:
+    QueueRoot()
+    {
+        _name = "queueRoot";
+        _linkSocketPrefix = "check_queue_" + to_string(getpid());
+        _link = make_shared<Link>(this, _name);
+    }
+};
+
+/*************/
+// Generate a clip where the luma of frame N is 16 + 8 * N, and chroma identifies the clip
+bool generateClip(const string& filename, float duration, int chroma)
+{
+    auto command = "ffmpeg -y -loglevel error -f lavfi -i color=black:s=64x64:r=25:d=" + to_string(duration) + " -vf \"format=yuv420p,geq=lum='16+8*N':cb=" +
+                   to_string(chroma) + ":cr=128\" -c:v mpeg4 -g 25 -bf 2 -q:v 2 " + filename;
+    return system(command.c_str()) == 0;
+}
+}
+
+/*************/
+TEST_CASE("Testing Queue transitions")
+{
+    if (system("ffmpeg -version > /dev/null 2>&1") != 0)
+    {
+        MESSAGE("ffmpeg is not available, skipping Queue tests");
+        return;
+    }
+
+    auto prefix = "/tmp/splash_check_queue_" + to_string(getpid());
+    auto firstClip = prefix + "_first.mp4";
+    auto secondClip = prefix + "_second.mp4";
+    // The clips are removed on exit, whatever the outcome of the test
+    OnScopeExit
+    {
+        unlink(firstClip.c_str());
+        unlink(secondClip.c_str());
+    };
+
+    // The first clip is longer than its playlist entry, so that the queue cuts it
+    REQUIRE(generateClip(firstClip, 2.f, 64));
+    REQUIRE(generateClip(secondClip, 1.f, 192));
+
+    QueueRoot root;
+    Queue queue(&root);
+    queue.setAttribute("useClock", {1});
+    queue.setAttribute("playlist", {Values({"image_ffmpeg", firstClip, 0.f, 1.f, 0, Values()}), Values({"image_ffmpeg", secondClip, 1.f, 2.f, 0, Values()})});
+
+    // The master clock is paused at each step, so that the frames shown do not depend on the test scheduling
+    auto setClock = [](int milliseconds) {
+        auto frames = milliseconds * 120 / 1000;
+        Timer::get().setMasterClock({0, 0, 0, 0, 0, frames / 120, frames % 120, 1});
+    };
+
+    // Get the clip and the index of the frames sent by the queue, until one matches the predicate or for the given number of updates
+    struct SentFrame
+    {
+        bool fromFirstClip;
+        int index;
+    };
+    Image frame(&root);
+    auto getFrames = [&](int maxUpdates, const function<bool(const SentFrame&)>& stopAt) {
+        vector<SentFrame> frames;
+        for (int i = 0; i < maxUpdates; ++i)
+        {
+            queue.update();
+            if (frame.deserialize(queue.serialize()))
+            {
+                frame.update();
+                auto buffer = frame.get();
+                if (buffer.getSpec().format == ImageBufferSpec::Format::YUYV && buffer.getSize() >= 2)
+                {
+                    auto pixels = reinterpret_cast<const uint8_t*>(buffer.data());
+                    frames.push_back({pixels[1] < 128, static_cast<int>((pixels[0] - 16 + 4) / 8)});
+                    if (stopAt && stopAt(frames.back()))
+                        break;
+                }
+            }
+            this_thread::sleep_for(chrono::milliseconds(2));
+        }
+        return frames;
+    };
+
+    // The first clip is shown from its first frame
+    setClock(500);
+    auto frames = getFrames(2500, [](const SentFrame& sent) { return sent.fromFirstClip; });
+    REQUIRE(!frames.empty());
+    CHECK(frames.back().fromFirstClip);
+    CHECK(frames.back().index == 0);
+
+    // Right before the transition, while the second clip is prerolled, only the first one is shown
+    setClock(960);
+    for (const auto& sent : getFrames(50, nullptr))
+        CHECK(sent.fromFirstClip);
+
+    // From the transition on, only the second clip is shown, from its first frame
+    setClock(1000);
+    frames = getFrames(2500, [](const SentFrame& sent) { return !sent.fromFirstClip; });
+    REQUIRE(!frames.empty());
+    CHECK_FALSE(frames.back().fromFirstClip);
+    CHECK(frames.back().index == 0);
+    for (const auto& sent : getFrames(50, nullptr))
+        CHECK_FALSE(sent.fromFirstClip);
+
+}
@@ -0,0 +1,130 @@
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./base_object.h"
+#include "./render_list.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class RenderedObjectMock : public BaseObject
+{
+  public:
+    RenderedObjectMock(Priority priority) { _renderingPriority = priority; }
+};
+
+using ObjectMap = unordered_map<string, shared_ptr<BaseObject>>;
+
+/*************/
+// Order in which Scene::render used to go through the objects, rebuilt at every frame
+vector<shared_ptr<BaseObject>> getReferenceOrder(const ObjectMap& objects)
+{
+    map<BaseObject::Priority, vector<shared_ptr<BaseObject>>> objectList{};
+    for (auto& obj : objects)
+    {
+        if (obj.second->isGhost())
+            continue;
+
+        auto priority = obj.second->getRenderingPriority();
+        if (priority == BaseObject::Priority::NO_RENDER)
+            continue;
+
+        objectList[priority].push_back(obj.second);
+    }
+
+    vector<shared_ptr<BaseObject>> order;
+    for (auto& objPriority : objectList)
+        for (auto& obj : objPriority.second)
+            order.push_back(obj);
+    return order;
+}
+
+/*************/
+bool matchesReference(const RenderList& renderList, const ObjectMap& objects)
+{
+    if (renderList.getObjects() != getReferenceOrder(objects))
+        return false;
+
+    // Groups must cover the whole list, with strictly increasing priorities
+    size_t position = 0;
+    for (size_t i = 0; i < renderList.getGroups().size(); ++i)
+    {
+        const auto& group = renderList.getGroups()[i];
+        if (group.begin != position || group.end <= group.begin)
+            return false;
+        if (i > 0 && renderList.getGroups()[i - 1].priority >= group.priority)
+            return false;
+        for (auto index = group.begin; index < group.end; ++index)
+            if (renderList.getObjects()[index]->getRenderingPriority() != group.priority)
+                return false;
+        position = group.end;
+    }
+    return position == renderList.getObjects().size();
+}
+}
+
+/*************/
+TEST_CASE("Testing RenderList order")
+{
+    const vector<BaseObject::Priority> priorities{BaseObject::Priority::NO_RENDER,
+        BaseObject::Priority::MEDIA,
+        BaseObject::Priority::BLENDING,
+        BaseObject::Priority::FILTER,
+        BaseObject::Priority::CAMERA,
+        BaseObject::Priority::POST_CAMERA,
+        BaseObject::Priority::WARP,
+        BaseObject::Priority::WINDOW};
+
+    ObjectMap objects;
+    uint64_t generation = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        auto obj = make_shared<RenderedObjectMock>(priorities[(i * 7) % priorities.size()]);
+        if (i % 13 == 0)
+            obj->setAttribute("priorityShift", {2});
+        if (i % 17 == 0)
+            obj->setGhost(true);
+        objects["object_" + to_string(i)] = obj;
+    }
+    ++generation;
+
+    RenderList renderList;
+    CHECK(renderList.update(objects, generation));
+    CHECK(matchesReference(renderList, objects));
+    CHECK(renderList.getObjects().size() > 0);
+
+    // Nothing changed, the list is kept as is
+    CHECK(!renderList.update(objects, generation));
+
+    // A priority change triggers a rebuild
+    objects["object_3"]->setAttribute("priorityShift", {-3});
+    CHECK(renderList.update(objects, generation));
+    CHECK(matchesReference(renderList, objects));
+
+    // As does a ghost
+    objects["object_4"]->setGhost(true);
+    CHECK(renderList.update(objects, generation));
+    CHECK(matchesReference(renderList, objects));
+
+    // And objects being added or removed
+    objects["new_object"] = make_shared<RenderedObjectMock>(BaseObject::Priority::CAMERA);
+    ++generation;
+    CHECK(renderList.update(objects, generation));
+    CHECK(matchesReference(renderList, objects));
+
+    objects.erase("object_5");
+    objects.erase("object_6");
+    ++generation;
+    CHECK(renderList.update(objects, generation));
+    CHECK(matchesReference(renderList, objects));
+    CHECK(!renderList.update(objects, generation));
+}
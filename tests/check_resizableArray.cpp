@@ -68,3 +68,98 @@ TEST_CASE("Testing ResizableArray copy")
         for (int shift = 100; shift < 500; shift += 100)
             CHECK(checkCopy(size, shift) == size - shift);
 }
+
+/*************/
+TEST_CASE("Testing ResizableArray wrapping an external buffer")
+{
+    auto external = vector<uint8_t>(1024, 42);
+    int releaseCount = 0;
+
+    {
+        auto array = ResizableArray<uint8_t>(external.data(), external.size(), [&](uint8_t* data) {
+            CHECK(data == external.data());
+            ++releaseCount;
+        });
+        CHECK(array.size() == external.size());
+        CHECK(array.data() == external.data());
+
+        // A copy owns its buffer
+        auto copiedArray = array;
+        CHECK(copiedArray.data() != external.data());
+        CHECK(copiedArray[512] == 42);
+
+        // Moving does not release anything
+        auto movedArray = std::move(array);
+        CHECK(movedArray.data() == external.data());
+        CHECK(releaseCount == 0);
+    }
+
+    CHECK(releaseCount == 1);
+
+    auto array = ResizableArray<uint8_t>(external.data(), external.size(), [&](uint8_t*) { ++releaseCount; });
+    array.resize(2048);
+    CHECK(releaseCount == 2);
+    CHECK(array.data() != external.data());
+    CHECK(array[1023] == 42);
+}
+
+/*************/
+TEST_CASE("Testing ResizableArray with elements larger than a byte")
+{
+    const size_t size = 1000;
+    auto array = ResizableArray<uint32_t>(size);
+    for (size_t i = 0; i < size; ++i)
+        array[i] = static_cast<uint32_t>(i) * 3;
+
+    // Copies hold all elements, not only the first size() bytes
+    auto copiedArray(array);
+    REQUIRE(copiedArray.size() == size);
+    CHECK(copiedArray[size - 1] == (size - 1) * 3);
+
+    auto assignedArray = ResizableArray<uint32_t>(10);
+    assignedArray = array;
+    REQUIRE(assignedArray.size() == size);
+    CHECK(assignedArray[size - 1] == (size - 1) * 3);
+
+    // Growing keeps all elements, shifted ones included
+    array.shift(10);
+    array.resize(size * 4);
+    REQUIRE(array.size() == size * 4);
+    CHECK(array[0] == 30);
+    CHECK(array[size - 11] == (size - 1) * 3);
+
+    auto doubles = ResizableArray<double>(4);
+    doubles[3] = 0.25;
+    auto copiedDoubles = doubles;
+    CHECK(copiedDoubles[3] == 0.25);
+}
+
+/*************/
+TEST_CASE("Testing ResizableArray capacity")
+{
+    auto array = ResizableArray<float>(1000);
+    CHECK(array.capacity() >= 1000);
+    array[999] = 1.f;
+    auto data = array.data();
+
+    // Shrinking does not reallocate
+    array.resize(500);
+    CHECK(array.data() == data);
+    CHECK(array.size() == 500);
+
+    // Nor does growing within capacity
+    array.resize(1000);
+    CHECK(array.data() == data);
+    CHECK(array[999] == 1.f);
+
+    array.resize(array.capacity() + 1);
+    CHECK(array.data() != data);
+    CHECK(array[999] == 1.f);
+
+    // Buffers are at least aligned to a cache line
+    CHECK(reinterpret_cast<uintptr_t>(array.data()) % BufferPool::cacheLineSize == 0);
+
+    array.resize(0);
+    CHECK(array.size() == 0);
+    CHECK(array.capacity() == 0);
+}
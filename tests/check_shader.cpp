@@ -0,0 +1,74 @@
+#include <memory>
+#include <vector>
+
+#include <doctest.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "./gl_context.h"
+#include "./shader.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing Shader uniform updates")
+{
+    GlContext context;
+    if (!context)
+    {
+        MESSAGE("No OpenGL 4.5 context available, skipping Shader tests");
+        return;
+    }
+
+    // A scene of a few objects, each having its own shader as in Object
+    const int objectCount = 8;
+    vector<shared_ptr<Shader>> shaders;
+    for (int i = 0; i < objectCount; ++i)
+    {
+        auto shader = make_shared<Shader>();
+        shader->setAttribute("fill", {i % 2 ? "texture" : "color"});
+        shader->setAttribute("uniform", {"_color", 1.f, 0.5f, 0.25f, 1.f}); // Set before the program is linked
+        shaders.push_back(shader);
+    }
+
+    const float cameraAttributes[2] = {0.05f, 1.f};
+    const float fovAndColorBalance[4] = {0.8f, 0.6f, 1.f, 1.f};
+    auto view = glm::dmat4(1.0);
+    auto projection = glm::dmat4(2.0);
+
+    // Mimics Camera::render and Object::draw
+    auto renderFrame = [&]() {
+        for (int i = 0; i < objectCount; ++i)
+        {
+            auto& shader = shaders[i];
+            shader->activate();
+            shader->setUniform("_cameraAttributes", cameraAttributes, 2);
+            shader->setUniform("_fovAndColorBalance", fovAndColorBalance, 4);
+            shader->setAttribute("uniform", {"_normalExp", 0.f});
+            shader->setModelViewProjectionMatrix(view, projection);
+            shader->updateUniforms();
+            shader->deactivate();
+        }
+    };
+
+    // Frames where nothing changes, then where the view and the projection change
+    renderFrame();
+    renderFrame();
+    view = glm::translate(view, glm::dvec3(0.0, 1.0, 0.0));
+    projection = glm::scale(projection, glm::dvec3(1.0, 2.0, 1.0));
+    renderFrame();
+    view = glm::translate(view, glm::dvec3(1.0, 0.0, 0.0));
+    renderFrame();
+
+    // Values set before linking are applied
+    auto colorUniforms = shaders[0]->getUniforms();
+    REQUIRE(colorUniforms["_color"].size() == 4);
+    CHECK(colorUniforms["_color"][1].as<float>() == 0.5f);
+
+    // The texture fill gets the per-camera parameters through the CameraUniforms block
+    auto textureUniforms = shaders[1]->getUniforms();
+    CHECK(textureUniforms.find("CameraUniforms") != textureUniforms.end());
+    auto lutIt = textureUniforms.find("_colorLUT");
+    CHECK((lutIt == textureUniforms.end() || lutIt->second.empty()));
+}
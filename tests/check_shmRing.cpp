@@ -0,0 +1,75 @@
+#include <vector>
+
+#include <doctest.h>
+#include <unistd.h>
+
+#include "./shm_ring.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing ShmRing write and read")
+{
+    auto ringName = "/splash_check_ring_" + to_string(getpid());
+    ShmRing writer(ringName, ShmRing::Mode::Writer, 2);
+    REQUIRE(static_cast<bool>(writer));
+    ShmRing reader(ringName, ShmRing::Mode::Reader);
+    REQUIRE(static_cast<bool>(reader));
+
+    vector<char> data(1 << 20);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<char>(i % 127);
+
+    ShmRing::Descriptor descriptor;
+    CHECK(writer.write(data.data(), data.size(), 1, descriptor));
+    CHECK(descriptor.size == data.size());
+
+    auto buffer = reader.read(descriptor);
+    REQUIRE(buffer != nullptr);
+    CHECK(buffer->size() == data.size());
+    CHECK(memcmp(buffer->data(), data.data(), data.size()) == 0);
+
+    SUBCASE("Slots are held until released by the readers")
+    {
+        ShmRing::Descriptor otherDescriptor;
+        CHECK(writer.write(data.data(), 16, 1, otherDescriptor));
+        CHECK(!writer.write(data.data(), 16, 1, otherDescriptor));
+
+        buffer.reset();
+        CHECK(writer.write(data.data(), data.size(), 1, otherDescriptor));
+    }
+
+    SUBCASE("Slots grow to fit bigger buffers")
+    {
+        buffer.reset();
+        vector<char> biggerData(4 << 20, 42);
+        ShmRing::Descriptor otherDescriptor;
+        CHECK(writer.write(biggerData.data(), biggerData.size(), 1, otherDescriptor));
+        auto otherBuffer = reader.read(otherDescriptor);
+        REQUIRE(otherBuffer != nullptr);
+        CHECK(otherBuffer->size() == biggerData.size());
+        CHECK(otherBuffer->data()[biggerData.size() - 1] == 42);
+    }
+
+    SUBCASE("A buffer survives the reader ring")
+    {
+        ShmRing::Descriptor otherDescriptor;
+        CHECK(writer.write(data.data(), data.size(), 1, otherDescriptor));
+        shared_ptr<SerializedObject> otherBuffer;
+        {
+            ShmRing otherReader(ringName, ShmRing::Mode::Reader);
+            otherBuffer = otherReader.read(otherDescriptor);
+        }
+        REQUIRE(otherBuffer != nullptr);
+        CHECK(memcmp(otherBuffer->data(), data.data(), data.size()) == 0);
+    }
+}
+
+/*************/
+TEST_CASE("Testing ShmRing with no writer")
+{
+    ShmRing reader("/splash_check_ring_none", ShmRing::Mode::Reader);
+    CHECK(!static_cast<bool>(reader));
+}
@@ -0,0 +1,145 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./root_object.h"
+#include "./splash.h"
+#include "./task_queue.h"
+#include "./timer.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+class TaskRoot : public RootObject
+{
+  public:
+    TaskRoot() { _name = "check_taskRoot"; }
+    using RootObject::addTask;
+    using RootObject::runTasks;
+};
+}
+
+/*************/
+TEST_CASE("Testing TaskQueue order")
+{
+    TaskQueue queue(8);
+    vector<int> results;
+
+    // More tasks than slots, the overflowing ones must keep their order
+    for (int i = 0; i < 20; ++i)
+        queue.push([&, i]() { results.push_back(i); });
+    CHECK(queue.getDepth() == 20);
+
+    CHECK(queue.run() == 20);
+    REQUIRE(results.size() == 20);
+    for (int i = 0; i < 20; ++i)
+        CHECK(results[i] == i);
+    CHECK(queue.getDepth() == 0);
+
+    // Tasks added while running are run by the next call
+    results.clear();
+    queue.push([&]() {
+        results.push_back(0);
+        queue.push([&]() { results.push_back(1); });
+    });
+    CHECK(queue.run() == 1);
+    CHECK(results.size() == 1);
+    CHECK(queue.run() == 1);
+    CHECK(results.size() == 2);
+    CHECK(queue.run() == 0);
+}
+
+/*************/
+TEST_CASE("Testing TaskQueue coalescing")
+{
+    TaskQueue queue(16);
+    vector<string> results;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        queue.push([&, i]() { results.push_back("eye_" + to_string(i)); }, "camera/eye");
+        queue.push([&, i]() { results.push_back("target_" + to_string(i)); }, "camera/target");
+    }
+    queue.push([&]() { results.push_back("moveEye"); });
+    queue.push([&]() { results.push_back("moveEye"); });
+
+    CHECK(queue.run() == 202);
+    REQUIRE(results.size() == 4);
+    CHECK(results[0] == "eye_99");
+    CHECK(results[1] == "target_99");
+    CHECK(results[2] == "moveEye");
+    CHECK(results[3] == "moveEye");
+
+    // Coalescing only happens within a single run
+    results.clear();
+    queue.push([&]() { results.push_back("eye_0"); }, "camera/eye");
+    queue.run();
+    queue.push([&]() { results.push_back("eye_1"); }, "camera/eye");
+    queue.run();
+    CHECK(results == vector<string>({"eye_0", "eye_1"}));
+}
+
+/*************/
+TEST_CASE("Testing TaskQueue with concurrent producers")
+{
+    const int producerCount = 4;
+    const int tasksPerProducer = 10000;
+
+    TaskQueue queue(256);
+    vector<vector<int>> results(producerCount);
+    atomic_int finishedProducers{0};
+
+    vector<thread> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < tasksPerProducer; ++i)
+                queue.push([&, p, i]() { results[p].push_back(i); });
+            ++finishedProducers;
+        });
+    }
+
+    size_t taskCount = 0;
+    while (finishedProducers != producerCount)
+        taskCount += queue.run();
+    for (auto& producer : producers)
+        producer.join();
+    while (queue.getDepth() != 0)
+        taskCount += queue.run();
+
+    CHECK(taskCount == producerCount * tasksPerProducer);
+    // Tasks from a given producer are run in the order they were added
+    for (int p = 0; p < producerCount; ++p)
+    {
+        REQUIRE(results[p].size() == tasksPerProducer);
+        bool isOrdered = true;
+        for (int i = 0; i < tasksPerProducer; ++i)
+            isOrdered = isOrdered && results[p][i] == i;
+        CHECK(isOrdered);
+    }
+}
+
+/*************/
+TEST_CASE("Testing RootObject task queue depth")
+{
+    TaskRoot root;
+    int runCount = 0;
+    for (int i = 0; i < 5; ++i)
+        root.addTask([&]() { ++runCount; });
+    root.addTask([&]() { ++runCount; }, "coalesced");
+    root.addTask([&]() { ++runCount; }, "coalesced");
+
+    // The gauge holds the number of tasks waiting before they are run, coalesced ones included
+    root.runTasks();
+    CHECK(runCount == 6);
+    CHECK(Timer::get().getDuration("taskQueueDepth_check_taskRoot") == 7);
+
+    root.runTasks();
+    CHECK(Timer::get().getDuration("taskQueueDepth_check_taskRoot") == 0);
+}
@@ -0,0 +1,90 @@
+#include <cstring>
+#include <memory>
+
+#include <doctest.h>
+
+#include "./gl_context.h"
+#include "./image.h"
+#include "./root_object.h"
+#include "./splash.h"
+#include "./texture_image.h"
+
+using namespace std;
+using namespace Splash;
+
+namespace
+{
+/*************/
+ImageBuffer createFrame(int width, int height, uint8_t seed, bool videoFrame)
+{
+    ImageBufferSpec spec(width, height, 4, 32, ImageBufferSpec::Type::UINT8, "RGBA");
+    spec.videoFrame = videoFrame;
+    ImageBuffer buffer(spec);
+    auto pixels = reinterpret_cast<uint8_t*>(buffer.data());
+    for (size_t i = 0; i < buffer.getSize(); ++i)
+        pixels[i] = static_cast<uint8_t>(i * 7 + seed);
+    return buffer;
+}
+
+/*************/
+bool textureHolds(Texture_Image& texture, const ImageBuffer& buffer)
+{
+    auto readback = texture.read();
+    auto spec = readback->getSpec();
+    if (spec.width != buffer.getSpec().width || spec.height != buffer.getSpec().height)
+        return false;
+    return memcmp(readback->data(), buffer.data(), buffer.getSize()) == 0;
+}
+}
+
+/*************/
+TEST_CASE("Testing Texture_Image uploads")
+{
+    GlContext context;
+    if (!context)
+    {
+        MESSAGE("No OpenGL 4.5 context available, skipping Texture_Image tests");
+        return;
+    }
+
+    RootObject root;
+    auto image = make_shared<Image>(&root);
+    auto texture = make_shared<Texture_Image>(&root);
+    CHECK(texture->linkTo(image));
+
+    auto upload = [&](const ImageBuffer& buffer) {
+        image->set(buffer);
+        image->setDirty();
+        texture->update();
+        texture->flushPbo();
+    };
+
+    // First upload creates the texture
+    auto frame = createFrame(64, 32, 1, false);
+    upload(frame);
+    CHECK(textureHolds(*texture, frame));
+    auto texId = texture->getTexId();
+
+    // Still images with the same spec go through the PBO ring, without recreating the texture
+    frame = createFrame(64, 32, 2, false);
+    upload(frame);
+    CHECK(textureHolds(*texture, frame));
+    CHECK(texture->getTexId() == texId);
+
+    // Video frames are uploaded one update late, run more of them than there are slots in the ring
+    auto previousFrame = frame;
+    for (int i = 0; i < 8; ++i)
+    {
+        frame = createFrame(64, 32, 10 + i, true);
+        upload(frame);
+        if (i > 0)
+            CHECK(textureHolds(*texture, previousFrame));
+        previousFrame = frame;
+    }
+    CHECK(texture->getTexId() == texId);
+
+    // A size change recreates the texture and uploads the image right away
+    frame = createFrame(128, 64, 3, true);
+    upload(frame);
+    CHECK(textureHolds(*texture, frame));
+}
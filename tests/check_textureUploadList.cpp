@@ -0,0 +1,86 @@
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./gl_context.h"
+#include "./image.h"
+#include "./root_object.h"
+#include "./splash.h"
+#include "./texture_image.h"
+#include "./texture_upload_list.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing TextureUploadList")
+{
+    GlContext context;
+    if (!context)
+    {
+        MESSAGE("No OpenGL 4.5 context available, skipping TextureUploadList tests");
+        return;
+    }
+
+    // A project with mostly static images, and a single video
+    RootObject root;
+    unordered_map<string, shared_ptr<BaseObject>> objects;
+    uint64_t generation = 0;
+    for (int i = 0; i < 50; ++i)
+    {
+        auto image = make_shared<Image>(&root);
+        image->setName("image_" + to_string(i));
+        auto texture = make_shared<Texture_Image>(&root);
+        texture->setName("texture_" + to_string(i));
+        texture->linkTo(image);
+        objects[image->getName()] = image;
+        objects[texture->getName()] = texture;
+    }
+
+    auto video = make_shared<Image>(&root);
+    video->setName("video");
+    auto videoTexture = make_shared<Texture_Image>(&root);
+    videoTexture->setName("video_texture");
+    videoTexture->linkTo(video);
+    objects[video->getName()] = video;
+    objects[videoTexture->getName()] = videoTexture;
+    ++generation;
+
+    // Linking marks every image as updated, so all textures are uploaded once
+    TextureUploadList uploadList;
+    auto textures = uploadList.getTextures(objects, generation, root.getUpdatedBufferObjects());
+    CHECK(textures.size() == 51);
+
+    // Then only the video is uploaded, static textures are never touched
+    for (int frame = 0; frame < 10; ++frame)
+    {
+        video->setDirty();
+        textures = uploadList.getTextures(objects, generation, root.getUpdatedBufferObjects());
+        REQUIRE(textures.size() == 1);
+        CHECK(textures[0] == videoTexture);
+    }
+
+    // Nothing updated, nothing to upload
+    textures = uploadList.getTextures(objects, generation, root.getUpdatedBufferObjects());
+    CHECK(textures.empty());
+
+    // A texture linked to a new image is found without any change to the objects
+    auto newImage = make_shared<Image>(&root);
+    newImage->setName("new_image");
+    auto texture = dynamic_pointer_cast<Texture_Image>(objects["texture_3"]);
+    texture->linkTo(newImage);
+    textures = uploadList.getTextures(objects, generation, root.getUpdatedBufferObjects());
+    REQUIRE(textures.size() == 1);
+    CHECK(textures[0] == texture);
+
+    // Removed textures are not uploaded anymore
+    objects.erase("video_texture");
+    videoTexture.reset();
+    ++generation;
+    video->setDirty();
+    textures = uploadList.getTextures(objects, generation, root.getUpdatedBufferObjects());
+    CHECK(textures.empty());
+}
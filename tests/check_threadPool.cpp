@@ -0,0 +1,109 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./splash.h"
+#include "./thread_pool.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing ThreadPool tasks execution")
+{
+    ThreadPool pool(4);
+    CHECK(pool.getWorkerCount() == 4);
+
+    atomic_int counter{0};
+    vector<future<void>> futures;
+    for (int i = 0; i < 1000; ++i)
+        futures.push_back(pool.enqueue([&]() { counter.fetch_add(1); }));
+    pool.waitFor(futures);
+    CHECK(counter == 1000);
+
+    SUBCASE("Exceptions are forwarded to the future")
+    {
+        auto future = pool.enqueue([]() { throw runtime_error("error"); });
+        pool.waitFor(future);
+        CHECK_THROWS(future.get());
+    }
+}
+
+/*************/
+TEST_CASE("Testing ThreadPool nested tasks")
+{
+    // Every task waits for sub-tasks, which would deadlock if waiting threads did not help
+    ThreadPool pool(2);
+
+    atomic_int counter{0};
+    vector<future<void>> futures;
+    for (int i = 0; i < 16; ++i)
+    {
+        futures.push_back(pool.enqueue([&]() {
+            vector<future<void>> subFutures;
+            for (int j = 0; j < 16; ++j)
+                subFutures.push_back(pool.enqueue([&]() { counter.fetch_add(1); }));
+            pool.waitFor(subFutures);
+        }));
+    }
+    pool.waitFor(futures);
+    CHECK(counter == 16 * 16);
+}
+
+/*************/
+TEST_CASE("Testing ThreadPool wait from another thread")
+{
+    // Threads which are not workers can hold locks, so they must not run queued tasks while waiting
+    ThreadPool pool(1);
+
+    atomic_bool started{false};
+    atomic_bool release{false};
+    auto blockingFuture = pool.enqueue([&]() {
+        started = true;
+        while (!release)
+            this_thread::sleep_for(chrono::milliseconds(1));
+    });
+    while (!started)
+        this_thread::sleep_for(chrono::milliseconds(1));
+
+    thread::id taskThread;
+    auto future = pool.enqueue([&]() { taskThread = this_thread::get_id(); });
+    thread releaser([&]() {
+        this_thread::sleep_for(chrono::milliseconds(50));
+        release = true;
+    });
+
+    pool.waitFor(future);
+    CHECK(taskThread != this_thread::get_id());
+    pool.waitFor(blockingFuture);
+    releaser.join();
+}
+
+/*************/
+TEST_CASE("Testing ThreadPool configuration")
+{
+    ThreadPool pool(2);
+
+    atomic_int counter{0};
+    for (int i = 0; i < 100; ++i)
+        pool.enqueue([&]() { counter.fetch_add(1); });
+
+    // Pending tasks are run before the workers are replaced
+    pool.setWorkerCount(3);
+    CHECK(counter == 100);
+    CHECK(pool.getWorkerCount() == 3);
+
+    pool.setWorkerCount(0);
+    CHECK(pool.getWorkerCount() == static_cast<unsigned int>(Utils::getCoreCount()));
+
+    CHECK(pool.setAffinity({0}));
+    CHECK(!pool.setAffinity({Utils::getCoreCount()}));
+    CHECK(pool.setAffinity({}));
+
+    auto future = pool.enqueue([&]() { counter.fetch_add(1); });
+    pool.waitFor(future);
+    CHECK(counter == 101);
+}
@@ -0,0 +1,222 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <doctest.h>
+
+#include "./histogram.h"
+#include "./splash.h"
+
+using namespace std;
+using namespace Splash;
+
+/*************/
+TEST_CASE("Testing Histogram buckets")
+{
+    // Small values are exact, larger ones are within the sub-bucket precision
+    for (uint64_t value = 0; value < 32; ++value)
+        CHECK(Histogram::getBucketValue(Histogram::getBucketIndex(value)) == value);
+
+    for (uint64_t value = 32; value < (1ull << 30); value = value * 3 / 2 + 7)
+    {
+        auto bucketValue = Histogram::getBucketValue(Histogram::getBucketIndex(value));
+        CHECK(bucketValue + bucketValue / 32 >= value);
+        CHECK(bucketValue <= value + value / 32);
+    }
+
+    for (uint64_t value = 1; value < (1ull << 30); value *= 2)
+        CHECK(Histogram::getBucketIndex(value) > Histogram::getBucketIndex(value - 1));
+}
+
+/*************/
+TEST_CASE("Testing Histogram statistics")
+{
+    Histogram histogram;
+    CHECK(histogram.getStats().count == 0);
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+        histogram.record(value);
+
+    auto stats = histogram.getStats();
+    CHECK(stats.count == 1000);
+    CHECK(stats.min == 1);
+    CHECK(stats.max == 1000);
+    CHECK(stats.mean == 500);
+    CHECK(stats.p50 >= 490);
+    CHECK(stats.p50 <= 510);
+    CHECK(stats.p95 >= 930);
+    CHECK(stats.p95 <= 970);
+    CHECK(stats.p99 >= 970);
+    CHECK(stats.p99 <= 1000);
+
+    histogram.reset();
+    CHECK(histogram.getStats().count == 0);
+}
+
+/*************/
+TEST_CASE("Testing Histogram concurrent recording")
+{
+    Histogram histogram;
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]() {
+            for (uint64_t value = 0; value < 10000; ++value)
+                histogram.record(t * 10000 + value);
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    auto stats = histogram.getStats();
+    CHECK(stats.count == 40000);
+    CHECK(stats.min == 0);
+    CHECK(stats.max == 39999);
+}
+
+/*************/
+TEST_CASE("Testing Timer handles")
+{
+    auto& timer = Timer::get();
+    auto handle = timer.getHandle("check_timer_handle");
+    CHECK(timer.getHandle("check_timer_handle") == handle);
+    CHECK(timer.getHandle("check_timer_other_handle") != handle);
+
+    for (int i = 0; i < 20; ++i)
+        timer.record(handle, 1000 + i);
+    timer.record(handle, 50000);
+
+    auto stats = timer.getStats(handle);
+    CHECK(stats.count == 21);
+    CHECK(stats.min == 1000);
+    CHECK(stats.max == 50000);
+    CHECK(stats.p50 >= 1000);
+    CHECK(stats.p50 <= 1020);
+    CHECK(stats.p99 >= 48000);
+    CHECK(stats.p99 <= 50000);
+
+    // Stopping a timer which was not started from the current thread records nothing
+    thread([&]() { timer.stop(handle); }).join();
+    CHECK(timer.getStats(handle).count == 21);
+
+    timer.start(handle);
+    this_thread::sleep_for(chrono::milliseconds(2));
+    timer.stop(handle);
+    stats = timer.getStats(handle);
+    CHECK(stats.count == 22);
+    CHECK(stats.max == 50000);
+}
+
+/*************/
+TEST_CASE("Testing Timer with many handles")
+{
+    auto& timer = Timer::get();
+    vector<Timer::Handle> handles;
+    for (int i = 0; i < 2000; ++i)
+        handles.push_back(timer.getHandle("check_timer_many_" + to_string(i)));
+
+    for (size_t i = 0; i < handles.size(); ++i)
+        timer.record(handles[i], 1000 + i);
+
+    auto allStats = timer.getAllStats(false);
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        auto stats = timer.getStats(handles[i]);
+        CHECK(stats.count == 1);
+        CHECK(stats.max == 1000 + i);
+        CHECK(allStats.count("check_timer_many_" + to_string(i)) == 1);
+    }
+}
+
+/*************/
+TEST_CASE("Testing Timer string API")
+{
+    auto& timer = Timer::get();
+    for (int i = 0; i < 5; ++i)
+    {
+        timer << "check_timer_string";
+        this_thread::sleep_for(chrono::milliseconds(1));
+        timer >> "check_timer_string";
+    }
+
+    CHECK(timer["check_timer_string"] >= 1000);
+    CHECK(timer.getDurations().count("check_timer_string") == 1);
+
+    auto stats = timer.getStats("check_timer_string");
+    CHECK(stats.count == 5);
+    CHECK(stats.min >= 1000);
+    CHECK(stats.max >= stats.min);
+
+    // Timers added from multiple threads at once
+    vector<thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 100; ++i)
+            {
+                auto name = "check_timer_thread_" + to_string(t) + "_" + to_string(i);
+                timer << name;
+                timer >> name;
+            }
+        });
+    for (auto& thread : threads)
+        thread.join();
+
+    auto durations = timer.getDurations();
+    for (int t = 0; t < 4; ++t)
+        for (int i = 0; i < 100; ++i)
+            CHECK(durations.count("check_timer_thread_" + to_string(t) + "_" + to_string(i)) == 1);
+}
+
+/*************/
+TEST_CASE("Testing Timer gauges")
+{
+    auto& timer = Timer::get();
+    auto& gauge = timer.getGauge("check_timer_gauge");
+    CHECK(&timer.getGauge("check_timer_gauge") == &gauge);
+
+    // Gauges are set without any lookup, and read as durations
+    gauge = 12;
+    CHECK(timer.getDuration("check_timer_gauge") == 12);
+    timer.setDuration("check_timer_gauge", 7);
+    CHECK(gauge == 7);
+
+    // Gauges stay valid while other ones are added
+    for (int i = 0; i < 100; ++i)
+        timer.getGauge("check_timer_gauge_" + to_string(i));
+    gauge = 3;
+    CHECK(timer.getDurations()["check_timer_gauge"] == 3);
+}
+
+/*************/
+TEST_CASE("Testing Timer statistics transmission")
+{
+    Histogram::Stats stats;
+    stats.count = 120;
+    stats.min = 15000;
+    stats.mean = 16600;
+    stats.p50 = 16500;
+    stats.p95 = 17800;
+    stats.p99 = 24000;
+    stats.max = 33000;
+
+    // Timings are sent as {name, duration, stats...}
+    Values message{"check_timer_remote", 16000};
+    for (auto& v : Timer::statsToValues(stats))
+        message.push_back(v);
+
+    Histogram::Stats received;
+    CHECK(Timer::statsFromValues(message, 2, received));
+    CHECK(received.count == stats.count);
+    CHECK(received.min == stats.min);
+    CHECK(received.mean == stats.mean);
+    CHECK(received.p50 == stats.p50);
+    CHECK(received.p95 == stats.p95);
+    CHECK(received.p99 == stats.p99);
+    CHECK(received.max == stats.max);
+    CHECK_FALSE(Timer::statsFromValues(message, 3, received));
+
+    Timer::get().setRemoteStats("check_timer_remote", received);
+    CHECK(Timer::get().getStats("check_timer_remote").p99 == 24000);
+
+    auto allStats = Timer::get().getAllStats();
+    CHECK(allStats.count("check_timer_remote") == 1);
+    CHECK(Timer::get().getAllStats(false).count("check_timer_remote") == 0);
+}
@@ -82,3 +82,103 @@ TEST_CASE("Testing Values comparison")
     CHECK(values != valueInt);
     CHECK(valueString != valueFloat);
 }
+
+/*************/
+TEST_CASE("Testing compact storage")
+{
+    CHECK(sizeof(Value) <= 32);
+
+    SUBCASE("Short and long strings")
+    {
+        auto shortString = string("short string");
+        auto longString = string("a string too long to be stored inline");
+        auto shortValue = Value(shortString);
+        auto longValue = Value(longString);
+        CHECK(shortValue.as<string>() == shortString);
+        CHECK(longValue.as<string>() == longString);
+        CHECK(shortValue.size() == shortString.size());
+        CHECK(longValue.size() == longString.size());
+        CHECK(string(static_cast<char*>(shortValue.data())) == shortString);
+        CHECK(string(static_cast<char*>(longValue.data())) == longString);
+
+        shortValue = longValue;
+        CHECK(shortValue == longValue);
+        longValue = Value("tiny");
+        CHECK(longValue.as<string>() == "tiny");
+        CHECK(shortValue.as<string>() == longString);
+    }
+
+    SUBCASE("Names")
+    {
+        auto value = Value(42);
+        CHECK(!value.isNamed());
+        CHECK(value.getName() == "");
+        value.setName("answer");
+        CHECK(value.isNamed());
+        CHECK(value.getName() == "answer");
+        CHECK(value != Value(42));
+        CHECK(value == Value(42, "answer"));
+
+        auto copy = value;
+        CHECK(copy.getName() == "answer");
+        copy.setName("");
+        CHECK(!copy.isNamed());
+        CHECK(value.isNamed());
+    }
+
+    SUBCASE("Copy and move")
+    {
+        auto values = Value(Values({1, 2.0, "three", Values({4, "a string too long to be stored inline"})}));
+        auto copy = values;
+        CHECK(copy == values);
+
+        auto moved = std::move(copy);
+        CHECK(moved == values);
+        CHECK(copy.getType() == Value::Type::i);
+
+        moved = Value(5.f);
+        CHECK(moved.as<float>() == 5.f);
+        CHECK(values.size() == 4);
+        CHECK(values[3][1].as<string>() == "a string too long to be stored inline");
+    }
+}
+
+/*************/
+TEST_CASE("Testing numeric arrays")
+{
+    auto floats = Value(vector<float>({1.f, 2.f, 3.f, 4.f}));
+    CHECK(floats.getType() == Value::Type::fa);
+    CHECK(floats.getTypeAsChar() == 'v');
+    CHECK(floats.size() == 4);
+    CHECK(static_cast<float*>(floats.data())[2] == 3.f);
+    CHECK(floats == Value(vector<float>({1.f, 2.f, 3.f, 4.f})));
+    CHECK(floats != Value(vector<float>({1.f, 2.f, 3.f})));
+
+    auto asValues = floats.as<Values>();
+    REQUIRE(asValues.size() == 4);
+    CHECK(asValues[0].getType() == Value::Type::f);
+    CHECK(asValues[3].as<float>() == 4.f);
+
+    auto ints = Value(vector<int32_t>({1, 2, 3}));
+    CHECK(ints.getType() == Value::Type::ia);
+    CHECK(ints.as<vector<float>>() == vector<float>({1.f, 2.f, 3.f}));
+    CHECK(ints != floats);
+
+    auto fromValues = Value(Values({1, 2.5f, "3"}));
+    CHECK(fromValues.as<vector<float>>() == vector<float>({1.f, 2.5f, 3.f}));
+    CHECK(fromValues.as<vector<int32_t>>() == vector<int32_t>({1, 2, 3}));
+}
+
+/*************/
+TEST_CASE("Testing Values front operations")
+{
+    Values values{2, 3};
+    values.push_front(1);
+    REQUIRE(values.size() == 3);
+    CHECK(values[0].as<int>() == 1);
+    CHECK(values[2].as<int>() == 3);
+    values.pop_front();
+    values.pop_front();
+    REQUIRE(values.size() == 1);
+    CHECK(values[0].as<int>() == 3);
+}
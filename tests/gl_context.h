@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2017 Emmanuel Durand
+ *
+ * This file is part of Splash.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Splash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Splash.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * @gl_context.h
+ * Hidden OpenGL context for the tests and benchmarks which need one. Works with software renderers like llvmpipe.
+ */
+
+#ifndef SPLASH_GL_CONTEXT_H
+#define SPLASH_GL_CONTEXT_H
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+namespace Splash
+{
+
+/*************/
+class GlContext
+{
+  public:
+    /**
+     * \brief Constructor, creates a hidden window with a GL 4.5 core context and makes it current
+     */
+    GlContext()
+    {
+        if (!glfwInit())
+            return;
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, false);
+        _window = glfwCreateWindow(64, 64, "splash_tests", nullptr, nullptr);
+        if (!_window)
+            return;
+
+        glfwMakeContextCurrent(_window);
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            glfwDestroyWindow(_window);
+            _window = nullptr;
+        }
+    }
+
+    /**
+     * \brief Destructor
+     */
+    ~GlContext()
+    {
+        if (_window)
+        {
+            glfwMakeContextCurrent(nullptr);
+            glfwDestroyWindow(_window);
+        }
+        glfwTerminate();
+    }
+
+    GlContext(const GlContext&) = delete;
+    GlContext& operator=(const GlContext&) = delete;
+
+    /**
+     * \brief Safe bool idiom
+     */
+    explicit operator bool() const { return _window != nullptr; }
+
+  private:
+    GLFWwindow* _window{nullptr};
+};
+
+} // end of namespace
+
+#endif // SPLASH_GL_CONTEXT_H